@@ -40,18 +40,7 @@ namespace Katydid
 
     KTPSCollectionData& KTPSCollectionData::SetNComponents(unsigned components)
     {
-        unsigned oldSize = fSpectra.size();
-        // if components < oldSize
-        for (unsigned iComponent = components; iComponent < oldSize; ++iComponent)
-        {
-            DeleteSpectra(iComponent);
-        }
-        fSpectra.resize(components);
-        // if components > oldSize
-        for (unsigned iComponent = oldSize; iComponent < components; ++iComponent)
-        {
-            fSpectra[iComponent] = NULL;
-        }
+        ResizeComponents(components);
         return *this;
     }
 
@@ -87,7 +76,7 @@ namespace Katydid
 
             unsigned iSpectra = (int)((fEndTime - fStartTime) / (double)fDeltaT) + 1;
             KTWARN(scdlog, "Number of spectra in this new multips: " << iSpectra);
-            fSpectra[iComponent] = new KTMultiPS(NULL, iSpectra, fStartTime, fEndTime);
+            SetSpectra(new KTMultiPS(NULL, iSpectra, fStartTime, fEndTime), iComponent);
         }
 
         // When fSpectra is not empty, no 'Set' commands are used, only 'Get' for frequency and bin info
@@ -130,8 +130,8 @@ namespace Katydid
         fMaximumFrequency = rhs.fMaximumFrequency;
         fTimestamp = rhs.fTimestamp;
         fDescription = rhs.fDescription;
-        fChannelHeaders.clear();
-        fChannelHeaders.resize(rhs.fChannelHeaders.size());
+        SetNChannels(0);
+        fChannelHeaders.reserve(rhs.fChannelHeaders.size());
         for( vector< KTChannelHeader* >::const_iterator chIt = rhs.fChannelHeaders.begin(); chIt != rhs.fChannelHeaders.end(); ++chIt)
         {
             fChannelHeaders.push_back(new KTChannelHeader(**chIt));
@@ -0,0 +1,131 @@
+/**
+ @file KTFFTWTraits.hh
+ @brief Contains KTFFTWTraits
+ @details Maps a floating-point precision to the corresponding FFTW types and functions
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTFFTWTRAITS_HH_
+#define KTFFTWTRAITS_HH_
+
+#ifdef FFTW_FOUND
+#include <fftw3.h>
+#else
+#include "FFTWStandIn.hh"
+#endif
+
+#include <cstddef>
+
+namespace Katydid
+{
+
+    /*!
+     @struct KTFFTWTraits
+     @author agent
+
+     @brief Types and functions of the FFTW interface for a given precision.
+
+     @details
+     KTFFTWTraits< double > wraps the fftw_ interface; KTFFTWTraits< float > wraps the fftwf_ interface, and only exists if
+     Katydid was built with single-precision FFTW (i.e. FFTWF_FOUND is defined).  Code that is the same for both precisions
+     (the FFTW data classes, the plan cache, etc.) is templated on the floating-point type and uses these traits instead of
+     calling fftw_ or fftwf_ functions directly.
+
+     Without FFTW only the types are available (from FFTWStandIn.hh).
+    */
+    template< typename XFloatType >
+    struct KTFFTWTraits;
+
+    template<>
+    struct KTFFTWTraits< double >
+    {
+        typedef double real_type;
+        typedef fftw_complex complex_type;
+
+        /// Added to the wisdom filename for this precision
+        static const char* WisdomSuffix() {return "";}
+
+#ifdef FFTW_FOUND
+        typedef fftw_plan plan_type;
+
+        static void* Malloc(size_t n) {return fftw_malloc(n);}
+        static void Free(void* array) {fftw_free(array);}
+
+        static plan_type PlanManyDFT(int rank, const int* n, int howMany, complex_type* in, const int* inEmbed, int iStride, int iDist, complex_type* out, const int* onEmbed, int oStride, int oDist, int sign, unsigned flags)
+        {
+            return fftw_plan_many_dft(rank, n, howMany, in, inEmbed, iStride, iDist, out, onEmbed, oStride, oDist, sign, flags);
+        }
+        static plan_type PlanManyDFTR2C(int rank, const int* n, int howMany, real_type* in, const int* inEmbed, int iStride, int iDist, complex_type* out, const int* onEmbed, int oStride, int oDist, unsigned flags)
+        {
+            return fftw_plan_many_dft_r2c(rank, n, howMany, in, inEmbed, iStride, iDist, out, onEmbed, oStride, oDist, flags);
+        }
+        static plan_type PlanManyDFTC2R(int rank, const int* n, int howMany, complex_type* in, const int* inEmbed, int iStride, int iDist, real_type* out, const int* onEmbed, int oStride, int oDist, unsigned flags)
+        {
+            return fftw_plan_many_dft_c2r(rank, n, howMany, in, inEmbed, iStride, iDist, out, onEmbed, oStride, oDist, flags);
+        }
+        static void DestroyPlan(plan_type plan) {fftw_destroy_plan(plan);}
+
+        static void ExecuteDFT(const plan_type plan, complex_type* in, complex_type* out) {fftw_execute_dft(plan, in, out);}
+        static void ExecuteDFTR2C(const plan_type plan, real_type* in, complex_type* out) {fftw_execute_dft_r2c(plan, in, out);}
+        static void ExecuteDFTC2R(const plan_type plan, complex_type* in, real_type* out) {fftw_execute_dft_c2r(plan, in, out);}
+
+        static int ImportWisdomFromFilename(const char* filename) {return fftw_import_wisdom_from_filename(filename);}
+        static int ExportWisdomToFilename(const char* filename) {return fftw_export_wisdom_to_filename(filename);}
+        static void ForgetWisdom() {fftw_forget_wisdom();}
+
+#ifdef FFTW_NTHREADS
+        static int InitThreads() {return fftw_init_threads();}
+        static void CleanupThreads() {fftw_cleanup_threads();}
+        static void PlanWithNThreads(int nThreads) {fftw_plan_with_nthreads(nThreads);}
+#endif
+#endif
+    };
+
+#ifdef FFTWF_FOUND
+    template<>
+    struct KTFFTWTraits< float >
+    {
+        typedef float real_type;
+        typedef fftwf_complex complex_type;
+
+        /// Added to the wisdom filename for this precision
+        static const char* WisdomSuffix() {return ".float";}
+
+        typedef fftwf_plan plan_type;
+
+        static void* Malloc(size_t n) {return fftwf_malloc(n);}
+        static void Free(void* array) {fftwf_free(array);}
+
+        static plan_type PlanManyDFT(int rank, const int* n, int howMany, complex_type* in, const int* inEmbed, int iStride, int iDist, complex_type* out, const int* onEmbed, int oStride, int oDist, int sign, unsigned flags)
+        {
+            return fftwf_plan_many_dft(rank, n, howMany, in, inEmbed, iStride, iDist, out, onEmbed, oStride, oDist, sign, flags);
+        }
+        static plan_type PlanManyDFTR2C(int rank, const int* n, int howMany, real_type* in, const int* inEmbed, int iStride, int iDist, complex_type* out, const int* onEmbed, int oStride, int oDist, unsigned flags)
+        {
+            return fftwf_plan_many_dft_r2c(rank, n, howMany, in, inEmbed, iStride, iDist, out, onEmbed, oStride, oDist, flags);
+        }
+        static plan_type PlanManyDFTC2R(int rank, const int* n, int howMany, complex_type* in, const int* inEmbed, int iStride, int iDist, real_type* out, const int* onEmbed, int oStride, int oDist, unsigned flags)
+        {
+            return fftwf_plan_many_dft_c2r(rank, n, howMany, in, inEmbed, iStride, iDist, out, onEmbed, oStride, oDist, flags);
+        }
+        static void DestroyPlan(plan_type plan) {fftwf_destroy_plan(plan);}
+
+        static void ExecuteDFT(const plan_type plan, complex_type* in, complex_type* out) {fftwf_execute_dft(plan, in, out);}
+        static void ExecuteDFTR2C(const plan_type plan, real_type* in, complex_type* out) {fftwf_execute_dft_r2c(plan, in, out);}
+        static void ExecuteDFTC2R(const plan_type plan, complex_type* in, real_type* out) {fftwf_execute_dft_c2r(plan, in, out);}
+
+        static int ImportWisdomFromFilename(const char* filename) {return fftwf_import_wisdom_from_filename(filename);}
+        static int ExportWisdomToFilename(const char* filename) {return fftwf_export_wisdom_to_filename(filename);}
+        static void ForgetWisdom() {fftwf_forget_wisdom();}
+
+#ifdef FFTW_NTHREADS
+        static int InitThreads() {return fftwf_init_threads();}
+        static void CleanupThreads() {fftwf_cleanup_threads();}
+        static void PlanWithNThreads(int nThreads) {fftwf_plan_with_nthreads(nThreads);}
+#endif
+    };
+#endif /* FFTWF_FOUND */
+
+} /* namespace Katydid */
+#endif /* KTFFTWTRAITS_HH_ */
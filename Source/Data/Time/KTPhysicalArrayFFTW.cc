@@ -7,7 +7,10 @@
 
 #include "KTPhysicalArrayFFTW.hh"
 
+#include "KTBufferPool.hh"
+
 #include <cstring>
+#include <utility>
 
 using std::memcpy;
 
@@ -15,7 +18,8 @@ namespace Katydid
 {
 
 
-    KTPhysicalArray< 1, fftw_complex >::KTPhysicalArray() :
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >::KTPhysicalArray() :
             KTAxisProperties< 1 >(),
             fData(NULL),
             fTempCache()
@@ -24,17 +28,19 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::KTPhysicalArray(size_t nBins, double rangeMin, double rangeMax) :
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >::KTPhysicalArray(size_t nBins, double rangeMin, double rangeMax) :
             KTAxisProperties< 1 >(rangeMin, rangeMax),
             fData(NULL),
             fTempCache()
     {
         SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(nBins));
-        fData = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * nBins);
+        fData = (complex_type*) KTBufferPool::Allocate(sizeof(complex_type) * nBins);
     }
 
-    KTPhysicalArray< 1, fftw_complex >::KTPhysicalArray(fftw_complex value, size_t nBins, double rangeMin, double rangeMax) :
-            KTPhysicalArray< 1, fftw_complex>(nBins, rangeMin, rangeMax)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >::KTPhysicalArray(complex_type value, size_t nBins, double rangeMin, double rangeMax) :
+            KTPhysicalArray(nBins, rangeMin, rangeMax)
     {
         for (unsigned index = 0; index < nBins; ++index)
         {
@@ -44,83 +50,120 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::KTPhysicalArray(const KTPhysicalArray< 1, fftw_complex >& orig) :
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >::KTPhysicalArray(const KTPhysicalArray< 1, XFloatType[2] >& orig) :
             KTAxisProperties< 1 >(orig),
             fData(NULL),
             fTempCache()
     {
         SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(orig.size()));
-        fData = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * size());
-        memcpy( fData, orig.fData, orig.size() * sizeof( fftw_complex ) );
+        fData = (complex_type*) KTBufferPool::Allocate(sizeof(complex_type) * size());
+        memcpy( fData, orig.fData, orig.size() * sizeof( complex_type ) );
+    }
+
+
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >::KTPhysicalArray(KTPhysicalArray< 1, XFloatType[2] >&& orig) :
+            KTPhysicalArray()
+    {
+        swap(orig);
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::~KTPhysicalArray()
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >::~KTPhysicalArray()
     {
         if (fData != NULL)
         {
-            fftw_free(fData);
+            KTBufferPool::Release(fData);
         }
     }
 
 
-    const KTPhysicalArray< 1, fftw_complex >::array_type& KTPhysicalArray< 1, fftw_complex >::GetData() const
+    template< typename XFloatType >
+    const typename KTPhysicalArray< 1, XFloatType[2] >::array_type& KTPhysicalArray< 1, XFloatType[2] >::GetData() const
     {
         return fData;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::array_type& KTPhysicalArray< 1, fftw_complex >::GetData()
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::array_type& KTPhysicalArray< 1, XFloatType[2] >::GetData()
     {
         return fData;
     }
 
 
-    const std::string& KTPhysicalArray< 1, fftw_complex >::GetDataLabel() const
+    template< typename XFloatType >
+    const std::string& KTPhysicalArray< 1, XFloatType[2] >::GetDataLabel() const
     {
         return fLabel;
     }
 
-    void KTPhysicalArray< 1, fftw_complex >::SetDataLabel(const std::string& label)
+    template< typename XFloatType >
+    void KTPhysicalArray< 1, XFloatType[2] >::SetDataLabel(const std::string& label)
     {
         fLabel = label;
         return;
     }
 
-    const KTPhysicalArray< 1, fftw_complex >::value_type& KTPhysicalArray< 1, fftw_complex >::operator()(unsigned i) const
+    template< typename XFloatType >
+    const typename KTPhysicalArray< 1, XFloatType[2] >::value_type& KTPhysicalArray< 1, XFloatType[2] >::operator()(unsigned i) const
     {
         return fData[i];
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::value_type& KTPhysicalArray< 1, fftw_complex >::operator()(unsigned i)
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::value_type& KTPhysicalArray< 1, XFloatType[2] >::operator()(unsigned i)
     {
         return fData[i];
     }
 
 
-    bool KTPhysicalArray< 1, fftw_complex >::IsCompatibleWith(const KTPhysicalArray< 1, fftw_complex >& rhs) const
+    template< typename XFloatType >
+    bool KTPhysicalArray< 1, XFloatType[2] >::IsCompatibleWith(const KTPhysicalArray< 1, XFloatType[2] >& rhs) const
     {
         //return (this->size() == rhs.size() && this->GetRangeMin() == rhs.GetRangeMin() && this->GetRangeMax() == GetRangeMax());
         return (this->size() == rhs.size());
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator=(const KTPhysicalArray< 1, fftw_complex>& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator=(const KTPhysicalArray< 1, XFloatType[2] >& rhs)
     {
         if (fData != NULL)
         {
-            fftw_free(fData);
+            KTBufferPool::Release(fData);
         }
         SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(rhs.size()));
-        fData = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * size());
-        memcpy( fData, rhs.fData, rhs.size() * sizeof( fftw_complex ) );
+        fData = (complex_type*) KTBufferPool::Allocate(sizeof(complex_type) * size());
+        memcpy( fData, rhs.fData, rhs.size() * sizeof( complex_type ) );
         KTAxisProperties< 1 >::operator=(rhs);
         return *this;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator+=(const KTPhysicalArray< 1, fftw_complex>& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator=(KTPhysicalArray< 1, XFloatType[2] >&& rhs)
+    {
+        swap(rhs);
+        return *this;
+    }
+
+
+    template< typename XFloatType >
+    void KTPhysicalArray< 1, XFloatType[2] >::swap(KTPhysicalArray< 1, XFloatType[2] >& other)
+    {
+        std::swap(fData, other.fData);
+        fLabel.swap(other.fLabel);
+        SwapAxes(other);
+        return;
+    }
+
+
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator+=(const KTPhysicalArray< 1, XFloatType[2] >& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
         for (size_t iBin=0; iBin<rhs.size(); ++iBin)
@@ -132,7 +175,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator-=(const KTPhysicalArray< 1, fftw_complex>& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator-=(const KTPhysicalArray< 1, XFloatType[2] >& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
         for (size_t iBin=0; iBin<size(); ++iBin)
@@ -144,7 +188,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator*=(const KTPhysicalArray< 1, fftw_complex>& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator*=(const KTPhysicalArray< 1, XFloatType[2] >& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
         for (size_t iBin=0; iBin<size(); ++iBin)
@@ -158,7 +203,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator/=(const KTPhysicalArray< 1, fftw_complex>& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator/=(const KTPhysicalArray< 1, XFloatType[2] >& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
         double abs, arg;
@@ -175,7 +221,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator+=(const fftw_complex& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator+=(const complex_type& rhs)
     {
         for (size_t iBin=0; iBin<size(); ++iBin)
         {
@@ -186,7 +233,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator-=(const fftw_complex& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator-=(const complex_type& rhs)
     {
         for (size_t iBin=0; iBin<size(); ++iBin)
         {
@@ -197,7 +245,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator*=(const fftw_complex& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator*=(const complex_type& rhs)
     {
         for (size_t iBin=0; iBin<size(); ++iBin)
         {
@@ -210,7 +259,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator/=(const fftw_complex& rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator/=(const complex_type& rhs)
     {
         double abs, arg;
         double rhsabs = rhs[0]*rhs[0] + rhs[1]*rhs[1];
@@ -228,7 +278,8 @@ namespace Katydid
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >& KTPhysicalArray< 1, fftw_complex >::operator*=(double rhs)
+    template< typename XFloatType >
+    KTPhysicalArray< 1, XFloatType[2] >& KTPhysicalArray< 1, XFloatType[2] >::operator*=(double rhs)
     {
         for (size_t iBin=0; iBin<size(); ++iBin)
         {
@@ -240,50 +291,58 @@ namespace Katydid
 
 
 
-    KTPhysicalArray< 1, fftw_complex >::const_iterator KTPhysicalArray< 1, fftw_complex >::begin() const
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::const_iterator KTPhysicalArray< 1, XFloatType[2] >::begin() const
     {
         return fData;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::const_iterator KTPhysicalArray< 1, fftw_complex >::end() const
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::const_iterator KTPhysicalArray< 1, XFloatType[2] >::end() const
     {
         return fData + size();
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::iterator KTPhysicalArray< 1, fftw_complex >::begin()
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::iterator KTPhysicalArray< 1, XFloatType[2] >::begin()
     {
         return fData;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::iterator KTPhysicalArray< 1, fftw_complex >::end()
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::iterator KTPhysicalArray< 1, XFloatType[2] >::end()
     {
         return fData + size();
     }
 
 
 
-    KTPhysicalArray< 1, fftw_complex >::const_reverse_iterator KTPhysicalArray< 1, fftw_complex >::rbegin() const
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::const_reverse_iterator KTPhysicalArray< 1, XFloatType[2] >::rbegin() const
     {
         return fData + size() - 1;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::const_reverse_iterator KTPhysicalArray< 1, fftw_complex >::rend() const
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::const_reverse_iterator KTPhysicalArray< 1, XFloatType[2] >::rend() const
     {
         return fData - 1;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::reverse_iterator KTPhysicalArray< 1, fftw_complex >::rbegin()
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::reverse_iterator KTPhysicalArray< 1, XFloatType[2] >::rbegin()
     {
         return fData + size() - 1;
     }
 
 
-    KTPhysicalArray< 1, fftw_complex >::reverse_iterator KTPhysicalArray< 1, fftw_complex >::rend()
+    template< typename XFloatType >
+    typename KTPhysicalArray< 1, XFloatType[2] >::reverse_iterator KTPhysicalArray< 1, XFloatType[2] >::rend()
     {
         return fData - 1;
     }
@@ -291,8 +350,15 @@ namespace Katydid
 
 
 
+    template class KTPhysicalArray< 1, fftw_complex >;
+#ifdef FFTWF_FOUND
+    template class KTPhysicalArray< 1, fftwf_complex >;
+#endif
+
+
+
     //********************************************
-    // Operator implementations for fftw_complex
+    // Operator implementations for FFTW complex types
     //********************************************
 
     std::ostream&
@@ -302,5 +368,14 @@ namespace Katydid
         return ostr;
     }
 
+#ifdef FFTWF_FOUND
+    std::ostream&
+        operator<< (std::ostream& ostr, const fftwf_complex& rhs)
+    {
+        ostr << "(" << rhs[0] << "," << rhs[1] << ")";
+        return ostr;
+    }
+#endif
+
 
 } /* namespace Katydid */
@@ -8,32 +8,29 @@
 #ifndef KTPHYSICALARRAYFFTW_HH_
 #define KTPHYSICALARRAYFFTW_HH_
 
+#include "KTFFTWTraits.hh"
 #include "KTPhysicalArray.hh"
 
-#ifdef FFTW_FOUND
-#include <fftw3.h>
-#else
-#include "FFTWStandIn.hh"
-#endif
-
 namespace Katydid
 {
     
 
     //*************************
-    // 1-D array implementation; specialization for fftw_complex
+    // 1-D array implementation; specialization for FFTW complex types
     //*************************
 
-    template <>
-    class KTPhysicalArray< 1, fftw_complex > : public KTAxisProperties< 1 >
+    /// Used for fftw_complex (XFloatType = double) and, with single-precision FFTW, fftwf_complex (XFloatType = float)
+    template< typename XFloatType >
+    class KTPhysicalArray< 1, XFloatType[2] > : public KTAxisProperties< 1 >
     {
         public:
-            typedef fftw_complex value_type;
-            typedef fftw_complex* array_type;
-            typedef const fftw_complex* const_iterator;
-            typedef fftw_complex* iterator;
-            typedef const fftw_complex* const_reverse_iterator;
-            typedef fftw_complex* reverse_iterator;
+            typedef XFloatType complex_type[2];
+            typedef complex_type value_type;
+            typedef complex_type* array_type;
+            typedef const complex_type* const_iterator;
+            typedef complex_type* iterator;
+            typedef const complex_type* const_reverse_iterator;
+            typedef complex_type* reverse_iterator;
 
         private:
             typedef KTNBinsInArray< 1, FixedSize > XNBinsFunctor;
@@ -41,8 +38,10 @@ namespace Katydid
         public:
             KTPhysicalArray();
             explicit KTPhysicalArray(size_t nBins, double rangeMin=0., double rangeMax=1.);
-            explicit KTPhysicalArray(fftw_complex value, size_t nBins, double rangeMin=0., double rangeMax=1.);
-            KTPhysicalArray(const KTPhysicalArray< 1, fftw_complex >& orig);
+            explicit KTPhysicalArray(complex_type value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTPhysicalArray(const KTPhysicalArray< 1, complex_type >& orig);
+            /// Takes the data buffer from orig without copying; orig is left empty
+            KTPhysicalArray(KTPhysicalArray< 1, complex_type >&& orig);
             virtual ~KTPhysicalArray();
 
         public:
@@ -54,29 +53,34 @@ namespace Katydid
 
         protected:
             array_type fData;
-            fftw_complex fTempCache;
+            complex_type fTempCache;
             std:: string fLabel;
 
         public:
-            const fftw_complex& operator()(unsigned i) const;
-            fftw_complex& operator()(unsigned i);
+            const complex_type& operator()(unsigned i) const;
+            complex_type& operator()(unsigned i);
 
         public:
-            bool IsCompatibleWith(const KTPhysicalArray< 1, fftw_complex >& rhs) const;
+            bool IsCompatibleWith(const KTPhysicalArray< 1, complex_type >& rhs) const;
 
-            KTPhysicalArray< 1, fftw_complex >& operator=(const KTPhysicalArray< 1, fftw_complex >& rhs);
+            KTPhysicalArray< 1, complex_type >& operator=(const KTPhysicalArray< 1, complex_type >& rhs);
+            /// Exchanges contents with rhs, so the old buffer is released along with rhs
+            KTPhysicalArray< 1, complex_type >& operator=(KTPhysicalArray< 1, complex_type >&& rhs);
 
-            KTPhysicalArray< 1, fftw_complex >& operator+=(const KTPhysicalArray< 1, fftw_complex >& rhs);
-            KTPhysicalArray< 1, fftw_complex >& operator-=(const KTPhysicalArray< 1, fftw_complex >& rhs);
-            KTPhysicalArray< 1, fftw_complex >& operator*=(const KTPhysicalArray< 1, fftw_complex >& rhs);
-            KTPhysicalArray< 1, fftw_complex >& operator/=(const KTPhysicalArray< 1, fftw_complex >& rhs);
+            /// Exchanges the data buffers, labels, and axes of the two arrays without copying
+            void swap(KTPhysicalArray< 1, complex_type >& other);
 
-            KTPhysicalArray< 1, fftw_complex >& operator+=(const fftw_complex& rhs);
-            KTPhysicalArray< 1, fftw_complex >& operator-=(const fftw_complex& rhs);
-            KTPhysicalArray< 1, fftw_complex >& operator*=(const fftw_complex& rhs);
-            KTPhysicalArray< 1, fftw_complex >& operator/=(const fftw_complex& rhs);
+            KTPhysicalArray< 1, complex_type >& operator+=(const KTPhysicalArray< 1, complex_type >& rhs);
+            KTPhysicalArray< 1, complex_type >& operator-=(const KTPhysicalArray< 1, complex_type >& rhs);
+            KTPhysicalArray< 1, complex_type >& operator*=(const KTPhysicalArray< 1, complex_type >& rhs);
+            KTPhysicalArray< 1, complex_type >& operator/=(const KTPhysicalArray< 1, complex_type >& rhs);
 
-            KTPhysicalArray< 1, fftw_complex >& operator*=(double rhs);
+            KTPhysicalArray< 1, complex_type >& operator+=(const complex_type& rhs);
+            KTPhysicalArray< 1, complex_type >& operator-=(const complex_type& rhs);
+            KTPhysicalArray< 1, complex_type >& operator*=(const complex_type& rhs);
+            KTPhysicalArray< 1, complex_type >& operator/=(const complex_type& rhs);
+
+            KTPhysicalArray< 1, complex_type >& operator*=(double rhs);
 
         public:
             const_iterator begin() const;
@@ -92,11 +96,20 @@ namespace Katydid
     };
 
 
+    extern template class KTPhysicalArray< 1, fftw_complex >;
+#ifdef FFTWF_FOUND
+    extern template class KTPhysicalArray< 1, fftwf_complex >;
+#endif
+
+
     //****************************************
-    // Operator definitions for fftw_complex
+    // Operator definitions for FFTW complex types
     //****************************************
 
     std::ostream& operator<< (std::ostream& ostr, const fftw_complex& rhs);
+#ifdef FFTWF_FOUND
+    std::ostream& operator<< (std::ostream& ostr, const fftwf_complex& rhs);
+#endif
 
 
 
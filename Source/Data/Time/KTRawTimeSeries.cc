@@ -12,14 +12,16 @@ namespace Katydid
 
     KTRawTimeSeries::KTRawTimeSeries() :
             KTVarTypePhysicalArray< uint64_t >(),
-            fSampleSize(1)
+            fSampleSize(1),
+            fStorageHolder()
     {
         SetAt(0., 0);
     }
 
     KTRawTimeSeries::KTRawTimeSeries(size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax) :
             KTVarTypePhysicalArray< uint64_t >(dataTypeSize, dataFormat, nBins, rangeMin, rangeMax),
-            fSampleSize(1)
+            fSampleSize(1),
+            fStorageHolder()
     {
         for (unsigned iBin = 0; iBin < nBins; ++iBin)
         {
@@ -27,9 +29,24 @@ namespace Katydid
         }
     }
 
+    KTRawTimeSeries::KTRawTimeSeries(std::shared_ptr< const void > holder, const uint8_t* data, size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax) :
+            KTVarTypePhysicalArray< uint64_t >(data, dataTypeSize, dataFormat, nBins, rangeMin, rangeMax),
+            fSampleSize(1),
+            fStorageHolder(holder)
+    {
+    }
+
     KTRawTimeSeries::KTRawTimeSeries(const KTRawTimeSeries& orig) :
             KTVarTypePhysicalArray< uint64_t >(orig),
-            fSampleSize(orig.fSampleSize)
+            fSampleSize(orig.fSampleSize),
+            fStorageHolder()
+    {
+    }
+
+    KTRawTimeSeries::KTRawTimeSeries(KTRawTimeSeries&& orig) :
+            KTVarTypePhysicalArray< uint64_t >(std::move(orig)),
+            fSampleSize(orig.fSampleSize),
+            fStorageHolder(std::move(orig.fStorageHolder))
     {
     }
 
@@ -41,6 +58,16 @@ namespace Katydid
     {
         KTVarTypePhysicalArray< uint64_t >::operator=(rhs);
         fSampleSize = rhs.fSampleSize;
+        // the storage is now owned, so any borrowed buffer can be released
+        fStorageHolder.reset();
+        return *this;
+    }
+
+    KTRawTimeSeries& KTRawTimeSeries::operator=(KTRawTimeSeries&& rhs)
+    {
+        KTVarTypePhysicalArray< uint64_t >::operator=(std::move(rhs));
+        std::swap(fSampleSize, rhs.fSampleSize);
+        fStorageHolder.swap(rhs.fStorageHolder);
         return *this;
     }
 
@@ -6,6 +6,11 @@
  *
  *  NOTE: For complex sampling, KTRawTimeSeries consists of a single array with interleaved real and imaginary samples.
  *        A KTRawTimeSeries with N complex samples will have 2*N bins.
+ *
+ *  NOTE: A KTRawTimeSeries can borrow its storage from another buffer (e.g. a record read from an egg file) instead of owning a copy.
+ *        In that case the holder object passed to the constructor is kept alive for as long as the time series exists,
+ *        and the storage is read-only: it is copied the first time it is accessed for writing (SetAt() or GetWritableStorage()).
+ *        Copies of a borrowing time series own their storage.
  */
 
 #ifndef KTRAWTIMESERIES_HH_
@@ -15,6 +20,8 @@
 
 #include "KTMemberVariable.hh"
 
+#include <memory>
+
 namespace Katydid
 {
     
@@ -24,10 +31,15 @@ namespace Katydid
         public:
             KTRawTimeSeries();
             KTRawTimeSeries(size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax);
+            /// Borrowed-storage constructor: data is not copied; holder keeps the buffer containing data alive
+            KTRawTimeSeries(std::shared_ptr< const void > holder, const uint8_t* data, size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax);
             KTRawTimeSeries(const KTRawTimeSeries& orig);
+            /// Takes over the storage of orig (owned or borrowed, along with its holder) without copying it
+            KTRawTimeSeries(KTRawTimeSeries&& orig);
             virtual ~KTRawTimeSeries();
 
             KTRawTimeSeries& operator=(const KTRawTimeSeries& rhs);
+            KTRawTimeSeries& operator=(KTRawTimeSeries&& rhs);
 
             /// Create an interface object with a different interface type
             template< typename XInterfaceType >
@@ -35,6 +47,9 @@ namespace Katydid
 
             MEMBERVARIABLE(size_t, SampleSize);
 
+        private:
+            std::shared_ptr< const void > fStorageHolder;
+
     };
 
     template< typename XInterfaceType >
@@ -9,6 +9,8 @@
 
 #include "KTRawTimeSeries.hh"
 
+#include <utility>
+
 namespace Katydid
 {
     const std::string KTRawTimeSeriesData::sName("raw-time-series");
@@ -44,4 +46,16 @@ namespace Katydid
         return *this;
     }
 
+    void KTRawTimeSeriesData::SetTimeSeries(KTRawTimeSeries&& timeSeries, unsigned component)
+    {
+        if (component < fTimeSeries.size() && fTimeSeries[component] != NULL)
+        {
+            // reuse the existing time series object
+            *fTimeSeries[component] = std::move(timeSeries);
+            return;
+        }
+        SetTimeSeries(new KTRawTimeSeries(std::move(timeSeries)), component);
+        return;
+    }
+
 } /* namespace Katydid */
@@ -29,6 +29,8 @@ namespace Katydid
             const KTRawTimeSeries* GetTimeSeries(unsigned component = 0) const;
             KTRawTimeSeries* GetTimeSeries(unsigned component = 0);
             void SetTimeSeries(KTRawTimeSeries* record, unsigned component = 0);
+            /// Takes the contents of the time series (owned or borrowed storage) without copying them
+            void SetTimeSeries(KTRawTimeSeries&& timeSeries, unsigned component = 0);
 
         private:
             std::vector< KTRawTimeSeries* > fTimeSeries;
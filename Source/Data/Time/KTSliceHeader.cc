@@ -26,6 +26,7 @@ namespace Katydid
             fNonOverlapFrac(0.),
             fSampleRate(0.),
             fBinWidth(1.),
+            fFrequencyOffset(0.),
             fStartRecordNumber(0),
             fStartSampleNumber(0),
             fEndRecordNumber(0),
@@ -49,6 +50,7 @@ namespace Katydid
             fNonOverlapFrac(orig.fNonOverlapFrac),
             fSampleRate(orig.fSampleRate),
             fBinWidth(orig.fBinWidth),
+            fFrequencyOffset(orig.fFrequencyOffset),
             fStartRecordNumber(orig.fStartRecordNumber),
             fStartSampleNumber(orig.fStartSampleNumber),
             fEndRecordNumber(orig.fEndRecordNumber),
@@ -83,6 +85,7 @@ namespace Katydid
         fNonOverlapFrac = rhs.fNonOverlapFrac;
         fSampleRate = rhs.fSampleRate;
         fBinWidth = rhs.fBinWidth;
+        fFrequencyOffset = rhs.fFrequencyOffset;
         fStartRecordNumber = rhs.fStartRecordNumber;
         fStartSampleNumber = rhs.fStartSampleNumber;
         fEndRecordNumber = rhs.fEndRecordNumber;
@@ -104,6 +107,7 @@ namespace Katydid
                 "\tNon-Overlap Fraction: " << hdr.GetNonOverlapFrac() << '\n' <<
                 "\tSample Rate: " << hdr.GetSampleRate() << " Hz\n" <<
                 "\tBin Width: " << hdr.GetBinWidth() << " s\n" <<
+                "\tFrequency Offset: " << hdr.GetFrequencyOffset() << " Hz\n" <<
                 "\tTime in Run: " << hdr.GetTimeInRun() << " s\n" <<
                 "\tTime in Acq: " << hdr.GetTimeInAcq() << " s\n" <<
                 "\tIs New Acquisition?: " << hdr.GetIsNewAcquisition() << '\n' <<
@@ -46,6 +46,7 @@ namespace Katydid
             MEMBERVARIABLE(double, NonOverlapFrac); // fraction of the slice for which there is no overlap with another slice
             MEMBERVARIABLE(double, SampleRate); // in Hz
             MEMBERVARIABLE(double, BinWidth); // in sec
+            MEMBERVARIABLE(double, FrequencyOffset); // in Hz; the frequency that appears at DC in the time series (non-zero after downconversion)
 
             MEMBERVARIABLE(unsigned, StartRecordNumber); // record in the run in which the slice starts
             MEMBERVARIABLE(unsigned, StartSampleNumber); // sample number in the start record
@@ -0,0 +1,43 @@
+/*
+ * KTStreamSliceHeaderData.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTStreamSliceHeaderData.hh"
+
+namespace Katydid
+{
+    const std::string KTStreamSliceHeaderData::sName("stream-slice-headers");
+
+    KTStreamSliceHeaderData::KTStreamSliceHeaderData() :
+            KTExtensibleData< KTStreamSliceHeaderData >(),
+            fStreams()
+    {
+    }
+
+    KTStreamSliceHeaderData::~KTStreamSliceHeaderData()
+    {
+    }
+
+    void KTStreamSliceHeaderData::AddStream(const KTSliceHeader& header, unsigned nComponents)
+    {
+        PerStreamData newStream;
+        newStream.fSliceHeader.CopySliceHeaderOnly(header);
+        newStream.fFirstComponent = fStreams.empty() ? 0 : fStreams.back().fFirstComponent + fStreams.back().fNComponents;
+        newStream.fNComponents = nComponents;
+        fStreams.push_back(newStream);
+        return;
+    }
+
+    unsigned KTStreamSliceHeaderData::GetStreamOfComponent(unsigned component) const
+    {
+        for (unsigned iStream = 0; iStream < fStreams.size(); ++iStream)
+        {
+            if (component < fStreams[iStream].fFirstComponent + fStreams[iStream].fNComponents) return iStream;
+        }
+        return unsigned(fStreams.size());
+    }
+
+} /* namespace Katydid */
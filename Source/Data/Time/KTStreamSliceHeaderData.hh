@@ -0,0 +1,91 @@
+/*
+ * KTStreamSliceHeaderData.hh
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  When several streams are read at once, the components of a slice are grouped by stream:
+ *  the components of stream i are [GetFirstComponent(i), GetFirstComponent(i) + GetNComponents(i)).
+ *  Each stream keeps its own slice header, since the streams can differ in sample rate, record size, and acquisition timing.
+ */
+
+#ifndef KTSTREAMSLICEHEADERDATA_HH_
+#define KTSTREAMSLICEHEADERDATA_HH_
+
+#include "KTData.hh"
+
+#include "KTSliceHeader.hh"
+
+#include <vector>
+
+namespace Katydid
+{
+
+    class KTStreamSliceHeaderData : public Nymph::KTExtensibleData< KTStreamSliceHeaderData >
+    {
+        public:
+            KTStreamSliceHeaderData();
+            virtual ~KTStreamSliceHeaderData();
+
+            unsigned GetNStreams() const;
+            KTStreamSliceHeaderData& SetNStreams(unsigned num);
+
+            const KTSliceHeader& GetSliceHeader(unsigned stream = 0) const;
+            KTSliceHeader& GetSliceHeader(unsigned stream = 0);
+
+            unsigned GetFirstComponent(unsigned stream = 0) const;
+            unsigned GetNComponents(unsigned stream = 0) const;
+
+            /// Adds a stream after the existing ones; its components follow those of the previous stream
+            void AddStream(const KTSliceHeader& header, unsigned nComponents);
+
+            /// Returns the stream to which a component belongs
+            unsigned GetStreamOfComponent(unsigned component) const;
+
+        private:
+            struct PerStreamData
+            {
+                KTSliceHeader fSliceHeader;
+                unsigned fFirstComponent;
+                unsigned fNComponents;
+            };
+
+            std::vector< PerStreamData > fStreams;
+
+        public:
+            static const std::string sName;
+    };
+
+    inline unsigned KTStreamSliceHeaderData::GetNStreams() const
+    {
+        return unsigned(fStreams.size());
+    }
+
+    inline KTStreamSliceHeaderData& KTStreamSliceHeaderData::SetNStreams(unsigned num)
+    {
+        fStreams.resize(num);
+        return *this;
+    }
+
+    inline const KTSliceHeader& KTStreamSliceHeaderData::GetSliceHeader(unsigned stream) const
+    {
+        return fStreams[stream].fSliceHeader;
+    }
+
+    inline KTSliceHeader& KTStreamSliceHeaderData::GetSliceHeader(unsigned stream)
+    {
+        return fStreams[stream].fSliceHeader;
+    }
+
+    inline unsigned KTStreamSliceHeaderData::GetFirstComponent(unsigned stream) const
+    {
+        return fStreams[stream].fFirstComponent;
+    }
+
+    inline unsigned KTStreamSliceHeaderData::GetNComponents(unsigned stream) const
+    {
+        return fStreams[stream].fNComponents;
+    }
+
+} /* namespace Katydid */
+#endif /* KTSTREAMSLICEHEADERDATA_HH_ */
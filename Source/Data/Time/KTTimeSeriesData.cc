@@ -7,6 +7,11 @@
 
 #include "KTTimeSeriesData.hh"
 
+#include "KTTimeSeriesFFTW.hh"
+#include "KTTimeSeriesReal.hh"
+
+#include <utility>
+
 namespace Katydid
 {
     KTTimeSeriesDataCore::KTTimeSeriesDataCore() :
@@ -24,6 +29,38 @@ namespace Katydid
         }
     }
 
+    void KTTimeSeriesDataCore::SetTimeSeries(KTTimeSeriesReal&& timeSeries, unsigned component)
+    {
+        if (component < fTimeSeries.size())
+        {
+            // reuse the existing time series object if it has the same type
+            KTTimeSeriesReal* current = dynamic_cast< KTTimeSeriesReal* >(fTimeSeries[component]);
+            if (current != NULL)
+            {
+                *current = std::move(timeSeries);
+                return;
+            }
+        }
+        SetTimeSeries(new KTTimeSeriesReal(std::move(timeSeries)), component);
+        return;
+    }
+
+    void KTTimeSeriesDataCore::SetTimeSeries(KTTimeSeriesFFTW&& timeSeries, unsigned component)
+    {
+        if (component < fTimeSeries.size())
+        {
+            // reuse the existing time series object if it has the same type
+            KTTimeSeriesFFTW* current = dynamic_cast< KTTimeSeriesFFTW* >(fTimeSeries[component]);
+            if (current != NULL)
+            {
+                *current = std::move(timeSeries);
+                return;
+            }
+        }
+        SetTimeSeries(new KTTimeSeriesFFTW(std::move(timeSeries)), component);
+        return;
+    }
+
 
     const std::string KTTimeSeriesData::sName("time-series");
 
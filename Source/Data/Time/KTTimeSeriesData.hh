@@ -22,6 +22,8 @@ namespace Katydid
 {
     
     class KTTimeSeries;
+    class KTTimeSeriesFFTW;
+    class KTTimeSeriesReal;
 
     class KTTimeSeriesDataCore
     {
@@ -37,6 +39,9 @@ namespace Katydid
             virtual KTTimeSeriesDataCore& SetNComponents(unsigned num) = 0;
 
             void SetTimeSeries(KTTimeSeries* record, unsigned component = 0);
+            /// Takes the contents of the time series without copying them
+            void SetTimeSeries(KTTimeSeriesReal&& timeSeries, unsigned component = 0);
+            void SetTimeSeries(KTTimeSeriesFFTW&& timeSeries, unsigned component = 0);
 
         protected:
             std::vector< KTTimeSeries* > fTimeSeries;
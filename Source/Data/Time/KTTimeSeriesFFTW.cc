@@ -13,7 +13,10 @@
 #include "TH1.h"
 #endif
 
+#include <algorithm>
 #include <sstream>
+#include <stdexcept>
+#include <utility>
 
 using std::stringstream;
 
@@ -21,20 +24,23 @@ namespace Katydid
 {
     KTLOGGER(tslog, "KTTimeSeriesFFTW");
 
-    KTTimeSeriesFFTW::KTTimeSeriesFFTW() :
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >::KTTimeSeriesFFTWBase() :
             KTTimeSeries(),
-            KTPhysicalArray< 1, fftw_complex >()
+            array_base_type()
     {
     }
 
-    KTTimeSeriesFFTW::KTTimeSeriesFFTW(size_t nBins, double rangeMin, double rangeMax) :
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >::KTTimeSeriesFFTWBase(size_t nBins, double rangeMin, double rangeMax) :
             KTTimeSeries(),
-            KTPhysicalArray< 1, fftw_complex >(nBins, rangeMin, rangeMax)
+            array_base_type(nBins, rangeMin, rangeMax)
     {
     }
 
-    KTTimeSeriesFFTW::KTTimeSeriesFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin, double rangeMax) :
-            KTTimeSeriesFFTW(nBins, rangeMin, rangeMax)
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >::KTTimeSeriesFFTWBase(std::initializer_list< XFloatType > value, size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesFFTWBase(nBins, rangeMin, rangeMax)
     {
         if (value.size() != 2)
         {
@@ -42,32 +48,50 @@ namespace Katydid
         }
         for (unsigned iBin = 0; iBin < nBins; ++iBin)
         {
-            std::copy(value.begin(), value.end(), fData[iBin]);
+            std::copy(value.begin(), value.end(), this->fData[iBin]);
         }
     }
 
-    KTTimeSeriesFFTW::KTTimeSeriesFFTW(const KTTimeSeriesFFTW& orig) :
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >::KTTimeSeriesFFTWBase(const KTTimeSeriesFFTWBase< XFloatType >& orig) :
             KTTimeSeries(),
-            KTPhysicalArray< 1, fftw_complex >(orig)
+            array_base_type(orig)
     {
     }
 
-    KTTimeSeriesFFTW::~KTTimeSeriesFFTW()
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >::KTTimeSeriesFFTWBase(KTTimeSeriesFFTWBase< XFloatType >&& orig) :
+            KTTimeSeries(),
+            array_base_type(std::move(orig))
     {
     }
 
-    KTTimeSeriesFFTW& KTTimeSeriesFFTW::operator=(const KTTimeSeriesFFTW& rhs)
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >::~KTTimeSeriesFFTWBase()
+    {
+    }
+
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >& KTTimeSeriesFFTWBase< XFloatType >::operator=(const KTTimeSeriesFFTWBase< XFloatType >& rhs)
     {
-        KTPhysicalArray< 1, fftw_complex >::operator=(rhs);
+        array_base_type::operator=(rhs);
         return *this;
     }
 
-    void KTTimeSeriesFFTW::Print(unsigned startPrint, unsigned nToPrint) const
+    template< typename XFloatType >
+    KTTimeSeriesFFTWBase< XFloatType >& KTTimeSeriesFFTWBase< XFloatType >::operator=(KTTimeSeriesFFTWBase< XFloatType >&& rhs)
+    {
+        array_base_type::operator=(std::move(rhs));
+        return *this;
+    }
+
+    template< typename XFloatType >
+    void KTTimeSeriesFFTWBase< XFloatType >::Print(unsigned startPrint, unsigned nToPrint) const
     {
         stringstream printStream;
         for (unsigned iBin = startPrint; iBin < startPrint + nToPrint; ++iBin)
         {
-            printStream << "Bin " << iBin << ";   x = " << GetBinCenter(iBin) <<
+            printStream << "Bin " << iBin << ";   x = " << this->GetBinCenter(iBin) <<
                     ";   y = " << (*this)(iBin) << "\n";
         }
         KTDEBUG(tslog, "\n" << printStream.str());
@@ -75,10 +99,11 @@ namespace Katydid
     }
 
 #ifdef ROOT_FOUND
-    TH1D* KTTimeSeriesFFTW::CreateHistogram(const std::string& name) const
+    template< typename XFloatType >
+    TH1D* KTTimeSeriesFFTWBase< XFloatType >::CreateHistogram(const std::string& name) const
     {
-        unsigned nBins = GetNBins();
-        TH1D* hist = new TH1D(name.c_str(), "Time Series", (int)nBins, GetRangeMin(), GetRangeMax());
+        unsigned nBins = this->GetNBins();
+        TH1D* hist = new TH1D(name.c_str(), "Time Series", (int)nBins, this->GetRangeMin(), this->GetRangeMax());
         for (unsigned iBin=0; iBin<nBins; ++iBin)
         {
             hist->SetBinContent((int)iBin+1, (*this)(iBin)[0]);
@@ -88,7 +113,8 @@ namespace Katydid
         return hist;
     }
 
-    TH1D* KTTimeSeriesFFTW::CreateAmplitudeDistributionHistogram(const std::string& name) const
+    template< typename XFloatType >
+    TH1D* KTTimeSeriesFFTWBase< XFloatType >::CreateAmplitudeDistributionHistogram(const std::string& name) const
     {
         double tMaxMag = -1.;
         double tMinMag = 1.e9;
@@ -112,7 +138,97 @@ namespace Katydid
         hist->SetXTitle("Voltage (V)");
         return hist;
     }
+#endif
+
+    template class KTTimeSeriesFFTWBase< double >;
+#ifdef FFTWF_FOUND
+    template class KTTimeSeriesFFTWBase< float >;
+#endif
+
+
+    KTTimeSeriesFFTW::KTTimeSeriesFFTW() :
+            KTTimeSeriesFFTWBase< double >()
+    {
+    }
+
+    KTTimeSeriesFFTW::KTTimeSeriesFFTW(size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesFFTWBase< double >(nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesFFTW::KTTimeSeriesFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesFFTWBase< double >(value, nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesFFTW::KTTimeSeriesFFTW(const KTTimeSeriesFFTW& orig) :
+            KTTimeSeriesFFTWBase< double >(orig)
+    {
+    }
+
+    KTTimeSeriesFFTW::KTTimeSeriesFFTW(KTTimeSeriesFFTW&& orig) :
+            KTTimeSeriesFFTWBase< double >(std::move(orig))
+    {
+    }
+
+    KTTimeSeriesFFTW::~KTTimeSeriesFFTW()
+    {
+    }
+
+    KTTimeSeriesFFTW& KTTimeSeriesFFTW::operator=(const KTTimeSeriesFFTW& rhs)
+    {
+        KTTimeSeriesFFTWBase< double >::operator=(rhs);
+        return *this;
+    }
+
+    KTTimeSeriesFFTW& KTTimeSeriesFFTW::operator=(KTTimeSeriesFFTW&& rhs)
+    {
+        KTTimeSeriesFFTWBase< double >::operator=(std::move(rhs));
+        return *this;
+    }
+
+
+#ifdef FFTWF_FOUND
+    KTTimeSeriesFFTWF::KTTimeSeriesFFTWF() :
+            KTTimeSeriesFFTWBase< float >()
+    {
+    }
+
+    KTTimeSeriesFFTWF::KTTimeSeriesFFTWF(size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesFFTWBase< float >(nBins, rangeMin, rangeMax)
+    {
+    }
 
+    KTTimeSeriesFFTWF::KTTimeSeriesFFTWF(std::initializer_list<float> value, size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesFFTWBase< float >(value, nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesFFTWF::KTTimeSeriesFFTWF(const KTTimeSeriesFFTWF& orig) :
+            KTTimeSeriesFFTWBase< float >(orig)
+    {
+    }
+
+    KTTimeSeriesFFTWF::KTTimeSeriesFFTWF(KTTimeSeriesFFTWF&& orig) :
+            KTTimeSeriesFFTWBase< float >(std::move(orig))
+    {
+    }
+
+    KTTimeSeriesFFTWF::~KTTimeSeriesFFTWF()
+    {
+    }
+
+    KTTimeSeriesFFTWF& KTTimeSeriesFFTWF::operator=(const KTTimeSeriesFFTWF& rhs)
+    {
+        KTTimeSeriesFFTWBase< float >::operator=(rhs);
+        return *this;
+    }
+
+    KTTimeSeriesFFTWF& KTTimeSeriesFFTWF::operator=(KTTimeSeriesFFTWF&& rhs)
+    {
+        KTTimeSeriesFFTWBase< float >::operator=(std::move(rhs));
+        return *this;
+    }
 #endif
 
 } /* namespace Katydid */
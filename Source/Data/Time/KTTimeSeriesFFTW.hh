@@ -18,16 +18,27 @@ namespace Katydid
     
 
 
-    class KTTimeSeriesFFTW : public KTTimeSeries, public KTPhysicalArray< 1, fftw_complex >
+    /*!
+     Implementation shared by KTTimeSeriesFFTW and KTTimeSeriesFFTWF; values are stored as XFloatType[2] (fftw_complex or fftwf_complex),
+     but the KTTimeSeries interface uses doubles.
+    */
+    template< typename XFloatType >
+    class KTTimeSeriesFFTWBase : public KTTimeSeries, public KTPhysicalArray< 1, XFloatType[2] >
     {
         public:
-            KTTimeSeriesFFTW();
-            KTTimeSeriesFFTW(size_t nBins, double rangeMin=0., double rangeMax=1.);
-            KTTimeSeriesFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin=0., double rangeMax=1.);
-            KTTimeSeriesFFTW(const KTTimeSeriesFFTW& orig);
-            virtual ~KTTimeSeriesFFTW();
+            typedef KTPhysicalArray< 1, XFloatType[2] > array_base_type;
 
-            KTTimeSeriesFFTW& operator=(const KTTimeSeriesFFTW& rhs);
+        public:
+            KTTimeSeriesFFTWBase();
+            KTTimeSeriesFFTWBase(size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesFFTWBase(std::initializer_list< XFloatType > value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesFFTWBase(const KTTimeSeriesFFTWBase< XFloatType >& orig);
+            KTTimeSeriesFFTWBase(KTTimeSeriesFFTWBase< XFloatType >&& orig);
+            virtual ~KTTimeSeriesFFTWBase();
+
+            KTTimeSeriesFFTWBase< XFloatType >& operator=(const KTTimeSeriesFFTWBase< XFloatType >& rhs);
+            /// Takes rhs's data without copying; rhs is left with this time series' old contents
+            KTTimeSeriesFFTWBase< XFloatType >& operator=(KTTimeSeriesFFTWBase< XFloatType >&& rhs);
 
             virtual void Scale(double scale);
 
@@ -47,30 +58,75 @@ namespace Katydid
 #endif
     };
 
-    inline void KTTimeSeriesFFTW::Scale(double scale)
+    extern template class KTTimeSeriesFFTWBase< double >;
+#ifdef FFTWF_FOUND
+    extern template class KTTimeSeriesFFTWBase< float >;
+#endif
+
+
+    class KTTimeSeriesFFTW : public KTTimeSeriesFFTWBase< double >
+    {
+        public:
+            KTTimeSeriesFFTW();
+            KTTimeSeriesFFTW(size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesFFTW(const KTTimeSeriesFFTW& orig);
+            KTTimeSeriesFFTW(KTTimeSeriesFFTW&& orig);
+            virtual ~KTTimeSeriesFFTW();
+
+            KTTimeSeriesFFTW& operator=(const KTTimeSeriesFFTW& rhs);
+            /// Takes rhs's data without copying; rhs is left with this time series' old contents
+            KTTimeSeriesFFTW& operator=(KTTimeSeriesFFTW&& rhs);
+    };
+
+#ifdef FFTWF_FOUND
+    /// Single-precision version of KTTimeSeriesFFTW
+    class KTTimeSeriesFFTWF : public KTTimeSeriesFFTWBase< float >
+    {
+        public:
+            KTTimeSeriesFFTWF();
+            KTTimeSeriesFFTWF(size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesFFTWF(std::initializer_list<float> value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesFFTWF(const KTTimeSeriesFFTWF& orig);
+            KTTimeSeriesFFTWF(KTTimeSeriesFFTWF&& orig);
+            virtual ~KTTimeSeriesFFTWF();
+
+            KTTimeSeriesFFTWF& operator=(const KTTimeSeriesFFTWF& rhs);
+            /// Takes rhs's data without copying; rhs is left with this time series' old contents
+            KTTimeSeriesFFTWF& operator=(KTTimeSeriesFFTWF&& rhs);
+    };
+#endif
+
+
+    template< typename XFloatType >
+    inline void KTTimeSeriesFFTWBase< XFloatType >::Scale(double scale)
     {
-        this->KTPhysicalArray< 1, fftw_complex >::operator*=(scale);
+        this->array_base_type::operator*=(scale);
         return;
     }
 
-    inline unsigned KTTimeSeriesFFTW::GetNTimeBins() const
+    template< typename XFloatType >
+    inline unsigned KTTimeSeriesFFTWBase< XFloatType >::GetNTimeBins() const
     {
         return this->size();
     }
 
-    inline double KTTimeSeriesFFTW::GetTimeBinWidth() const
+    template< typename XFloatType >
+    inline double KTTimeSeriesFFTWBase< XFloatType >::GetTimeBinWidth() const
     {
         return this->GetBinWidth();
     }
 
-    inline void KTTimeSeriesFFTW::SetValue(unsigned bin, double value)
+    template< typename XFloatType >
+    inline void KTTimeSeriesFFTWBase< XFloatType >::SetValue(unsigned bin, double value)
     {
         (*this)(bin)[0] = value;
         (*this)(bin)[1] = 0.;
         return;
     }
 
-    inline double KTTimeSeriesFFTW::GetValue(unsigned bin) const
+    template< typename XFloatType >
+    inline double KTTimeSeriesFFTWBase< XFloatType >::GetValue(unsigned bin) const
     {
         return (*this)(bin)[0];
     }
@@ -14,6 +14,7 @@
 #endif
 
 #include <sstream>
+#include <utility>
 
 using std::stringstream;
 
@@ -21,49 +22,70 @@ namespace Katydid
 {
     KTLOGGER(tslog, "KTTimeSeriesReal");
 
-    KTTimeSeriesReal::KTTimeSeriesReal() :
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >::KTTimeSeriesRealBase() :
             KTTimeSeries(),
-            KTPhysicalArray< 1, double >()
+            array_base_type()
     {
     }
 
-    KTTimeSeriesReal::KTTimeSeriesReal(size_t nBins, double rangeMin, double rangeMax) :
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >::KTTimeSeriesRealBase(size_t nBins, double rangeMin, double rangeMax) :
             KTTimeSeries(),
-            KTPhysicalArray< 1, double >(nBins, rangeMin, rangeMax)
+            array_base_type(nBins, rangeMin, rangeMax)
     {
     }
 
-    KTTimeSeriesReal::KTTimeSeriesReal(double value, size_t nBins, double rangeMin, double rangeMax) :
-            KTTimeSeriesReal(nBins, rangeMin, rangeMax)
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >::KTTimeSeriesRealBase(XFloatType value, size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesRealBase(nBins, rangeMin, rangeMax)
     {
         for (unsigned iBin = 0; iBin < nBins; ++iBin)
         {
-            fData[iBin] = value;
+            this->fData[iBin] = value;
         }
     }
 
-    KTTimeSeriesReal::KTTimeSeriesReal(const KTTimeSeriesReal& orig) :
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >::KTTimeSeriesRealBase(const KTTimeSeriesRealBase< XFloatType >& orig) :
             KTTimeSeries(),
-            KTPhysicalArray< 1, double >(orig)
+            array_base_type(orig)
     {
     }
 
-    KTTimeSeriesReal::~KTTimeSeriesReal()
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >::KTTimeSeriesRealBase(KTTimeSeriesRealBase< XFloatType >&& orig) :
+            KTTimeSeries(),
+            array_base_type(std::move(orig))
     {
     }
 
-    KTTimeSeriesReal& KTTimeSeriesReal::operator=(const KTTimeSeriesReal& rhs)
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >::~KTTimeSeriesRealBase()
+    {
+    }
+
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >& KTTimeSeriesRealBase< XFloatType >::operator=(const KTTimeSeriesRealBase< XFloatType >& rhs)
     {
-        KTPhysicalArray< 1, double >::operator=(rhs);
+        array_base_type::operator=(rhs);
         return *this;
     }
 
-    void KTTimeSeriesReal::Print(unsigned startPrint, unsigned nToPrint) const
+    template< typename XFloatType >
+    KTTimeSeriesRealBase< XFloatType >& KTTimeSeriesRealBase< XFloatType >::operator=(KTTimeSeriesRealBase< XFloatType >&& rhs)
+    {
+        array_base_type::operator=(std::move(rhs));
+        return *this;
+    }
+
+    template< typename XFloatType >
+    void KTTimeSeriesRealBase< XFloatType >::Print(unsigned startPrint, unsigned nToPrint) const
     {
         stringstream printStream;
         for (unsigned iBin = startPrint; iBin < startPrint + nToPrint; ++iBin)
         {
-            printStream << "Bin " << iBin << ";   x = " << GetBinCenter(iBin) <<
+            printStream << "Bin " << iBin << ";   x = " << this->GetBinCenter(iBin) <<
                     ";   y = " << (*this)(iBin) << "\n";
         }
         KTDEBUG(tslog, "\n" << printStream.str());
@@ -71,10 +93,11 @@ namespace Katydid
     }
 
 #ifdef ROOT_FOUND
-    TH1D* KTTimeSeriesReal::CreateHistogram(const std::string& name) const
+    template< typename XFloatType >
+    TH1D* KTTimeSeriesRealBase< XFloatType >::CreateHistogram(const std::string& name) const
     {
-        unsigned nBins = GetNBins();
-        TH1D* hist = new TH1D(name.c_str(), "Time Series", (int)nBins, GetRangeMin(), GetRangeMax());
+        unsigned nBins = this->GetNBins();
+        TH1D* hist = new TH1D(name.c_str(), "Time Series", (int)nBins, this->GetRangeMin(), this->GetRangeMax());
         for (unsigned iBin=0; iBin<nBins; ++iBin)
         {
             hist->SetBinContent((int)iBin+1, (*this)(iBin));
@@ -95,7 +118,8 @@ namespace Katydid
         return hist;
     }
 
-    TH1D* KTTimeSeriesReal::CreateAmplitudeDistributionHistogram(const std::string& name) const
+    template< typename XFloatType >
+    TH1D* KTTimeSeriesRealBase< XFloatType >::CreateAmplitudeDistributionHistogram(const std::string& name) const
     {
         double tMaxMag = -1.;
         double tMinMag = 1.e9;
@@ -122,4 +146,95 @@ namespace Katydid
 
 #endif
 
+    template class KTTimeSeriesRealBase< double >;
+#ifdef FFTWF_FOUND
+    template class KTTimeSeriesRealBase< float >;
+#endif
+
+
+    KTTimeSeriesReal::KTTimeSeriesReal() :
+            KTTimeSeriesRealBase< double >()
+    {
+    }
+
+    KTTimeSeriesReal::KTTimeSeriesReal(size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesRealBase< double >(nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesReal::KTTimeSeriesReal(double value, size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesRealBase< double >(value, nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesReal::KTTimeSeriesReal(const KTTimeSeriesReal& orig) :
+            KTTimeSeriesRealBase< double >(orig)
+    {
+    }
+
+    KTTimeSeriesReal::KTTimeSeriesReal(KTTimeSeriesReal&& orig) :
+            KTTimeSeriesRealBase< double >(std::move(orig))
+    {
+    }
+
+    KTTimeSeriesReal::~KTTimeSeriesReal()
+    {
+    }
+
+    KTTimeSeriesReal& KTTimeSeriesReal::operator=(const KTTimeSeriesReal& rhs)
+    {
+        KTTimeSeriesRealBase< double >::operator=(rhs);
+        return *this;
+    }
+
+    KTTimeSeriesReal& KTTimeSeriesReal::operator=(KTTimeSeriesReal&& rhs)
+    {
+        KTTimeSeriesRealBase< double >::operator=(std::move(rhs));
+        return *this;
+    }
+
+
+#ifdef FFTWF_FOUND
+    KTTimeSeriesRealF::KTTimeSeriesRealF() :
+            KTTimeSeriesRealBase< float >()
+    {
+    }
+
+    KTTimeSeriesRealF::KTTimeSeriesRealF(size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesRealBase< float >(nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesRealF::KTTimeSeriesRealF(float value, size_t nBins, double rangeMin, double rangeMax) :
+            KTTimeSeriesRealBase< float >(value, nBins, rangeMin, rangeMax)
+    {
+    }
+
+    KTTimeSeriesRealF::KTTimeSeriesRealF(const KTTimeSeriesRealF& orig) :
+            KTTimeSeriesRealBase< float >(orig)
+    {
+    }
+
+    KTTimeSeriesRealF::KTTimeSeriesRealF(KTTimeSeriesRealF&& orig) :
+            KTTimeSeriesRealBase< float >(std::move(orig))
+    {
+    }
+
+    KTTimeSeriesRealF::~KTTimeSeriesRealF()
+    {
+    }
+
+    KTTimeSeriesRealF& KTTimeSeriesRealF::operator=(const KTTimeSeriesRealF& rhs)
+    {
+        KTTimeSeriesRealBase< float >::operator=(rhs);
+        return *this;
+    }
+
+    KTTimeSeriesRealF& KTTimeSeriesRealF::operator=(KTTimeSeriesRealF&& rhs)
+    {
+        KTTimeSeriesRealBase< float >::operator=(std::move(rhs));
+        return *this;
+    }
+#endif
+
 } /* namespace Katydid */
@@ -14,16 +14,26 @@
 namespace Katydid
 {
     
-    class KTTimeSeriesReal : public KTTimeSeries, public KTPhysicalArray< 1, double >
+    /*!
+     Implementation shared by KTTimeSeriesReal and KTTimeSeriesRealF; values are stored as XFloatType, but the KTTimeSeries interface uses doubles.
+    */
+    template< typename XFloatType >
+    class KTTimeSeriesRealBase : public KTTimeSeries, public KTPhysicalArray< 1, XFloatType >
     {
         public:
-            KTTimeSeriesReal();
-            KTTimeSeriesReal(size_t nBins, double rangeMin=0., double rangeMax=1.);
-            KTTimeSeriesReal(double value, size_t nBins, double rangeMin=0., double rangeMax=1.);
-            KTTimeSeriesReal(const KTTimeSeriesReal& orig);
-            virtual ~KTTimeSeriesReal();
+            typedef KTPhysicalArray< 1, XFloatType > array_base_type;
 
-            KTTimeSeriesReal& operator=(const KTTimeSeriesReal& rhs);
+        public:
+            KTTimeSeriesRealBase();
+            KTTimeSeriesRealBase(size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesRealBase(XFloatType value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesRealBase(const KTTimeSeriesRealBase< XFloatType >& orig);
+            KTTimeSeriesRealBase(KTTimeSeriesRealBase< XFloatType >&& orig);
+            virtual ~KTTimeSeriesRealBase();
+
+            KTTimeSeriesRealBase< XFloatType >& operator=(const KTTimeSeriesRealBase< XFloatType >& rhs);
+            /// Takes rhs's data without copying; rhs is left with this time series' old contents
+            KTTimeSeriesRealBase< XFloatType >& operator=(KTTimeSeriesRealBase< XFloatType >&& rhs);
 
             virtual void Scale(double scale);
 
@@ -43,29 +53,74 @@ namespace Katydid
 #endif
     };
 
-    inline void KTTimeSeriesReal::Scale(double scale)
+    extern template class KTTimeSeriesRealBase< double >;
+#ifdef FFTWF_FOUND
+    extern template class KTTimeSeriesRealBase< float >;
+#endif
+
+
+    class KTTimeSeriesReal : public KTTimeSeriesRealBase< double >
+    {
+        public:
+            KTTimeSeriesReal();
+            KTTimeSeriesReal(size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesReal(double value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesReal(const KTTimeSeriesReal& orig);
+            KTTimeSeriesReal(KTTimeSeriesReal&& orig);
+            virtual ~KTTimeSeriesReal();
+
+            KTTimeSeriesReal& operator=(const KTTimeSeriesReal& rhs);
+            /// Takes rhs's data without copying; rhs is left with this time series' old contents
+            KTTimeSeriesReal& operator=(KTTimeSeriesReal&& rhs);
+    };
+
+#ifdef FFTWF_FOUND
+    /// Single-precision version of KTTimeSeriesReal
+    class KTTimeSeriesRealF : public KTTimeSeriesRealBase< float >
+    {
+        public:
+            KTTimeSeriesRealF();
+            KTTimeSeriesRealF(size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesRealF(float value, size_t nBins, double rangeMin=0., double rangeMax=1.);
+            KTTimeSeriesRealF(const KTTimeSeriesRealF& orig);
+            KTTimeSeriesRealF(KTTimeSeriesRealF&& orig);
+            virtual ~KTTimeSeriesRealF();
+
+            KTTimeSeriesRealF& operator=(const KTTimeSeriesRealF& rhs);
+            /// Takes rhs's data without copying; rhs is left with this time series' old contents
+            KTTimeSeriesRealF& operator=(KTTimeSeriesRealF&& rhs);
+    };
+#endif
+
+
+    template< typename XFloatType >
+    inline void KTTimeSeriesRealBase< XFloatType >::Scale(double scale)
     {
-        this->KTPhysicalArray< 1, double >::operator*=(scale);
+        this->array_base_type::operator*=(scale);
         return;
     }
 
-    inline unsigned KTTimeSeriesReal::GetNTimeBins() const
+    template< typename XFloatType >
+    inline unsigned KTTimeSeriesRealBase< XFloatType >::GetNTimeBins() const
     {
         return this->size();
     }
 
-    inline double KTTimeSeriesReal::GetTimeBinWidth() const
+    template< typename XFloatType >
+    inline double KTTimeSeriesRealBase< XFloatType >::GetTimeBinWidth() const
     {
         return this->GetBinWidth();
     }
 
-    inline void KTTimeSeriesReal::SetValue(unsigned bin, double value)
+    template< typename XFloatType >
+    inline void KTTimeSeriesRealBase< XFloatType >::SetValue(unsigned bin, double value)
     {
         (*this)(bin) = value;
         return;
     }
 
-    inline double KTTimeSeriesReal::GetValue(unsigned bin) const
+    template< typename XFloatType >
+    inline double KTTimeSeriesRealBase< XFloatType >::GetValue(unsigned bin) const
     {
         return (*this)(bin);
     }
@@ -9,14 +9,16 @@
 
 namespace Katydid
 {
-    KTFrequencySpectrumDataFFTWCore::KTFrequencySpectrumDataFFTWCore() :
+    template< class XSpectrumType >
+    KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::KTFrequencySpectrumDataFFTWCoreBase() :
             KTFrequencySpectrumData(),
             fSpectra(1)
     {
         fSpectra[0] = NULL;
     }
 
-    KTFrequencySpectrumDataFFTWCore::~KTFrequencySpectrumDataFFTWCore()
+    template< class XSpectrumType >
+    KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::~KTFrequencySpectrumDataFFTWCoreBase()
     {
         while (! fSpectra.empty())
         {
@@ -25,6 +27,39 @@ namespace Katydid
         }
     }
 
+    template< class XSpectrumType >
+    void KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::ResizeSpectra(unsigned components)
+    {
+        unsigned oldSize = fSpectra.size();
+        // if components < oldSize
+        for (unsigned iComponent = components; iComponent < oldSize; ++iComponent)
+        {
+            delete fSpectra[iComponent];
+        }
+        fSpectra.resize(components);
+        // if components > oldSize
+        for (unsigned iComponent = oldSize; iComponent < components; ++iComponent)
+        {
+            fSpectra[iComponent] = NULL;
+        }
+        return;
+    }
+
+    template class KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTW >;
+#ifdef FFTWF_FOUND
+    template class KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTWF >;
+#endif
+
+
+    KTFrequencySpectrumDataFFTWCore::KTFrequencySpectrumDataFFTWCore() :
+            KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTW >()
+    {
+    }
+
+    KTFrequencySpectrumDataFFTWCore::~KTFrequencySpectrumDataFFTWCore()
+    {
+    }
+
 
     const std::string KTFrequencySpectrumDataFFTW::sName("frequency-spectrum-fftw");
 
@@ -40,20 +75,40 @@ namespace Katydid
 
     KTFrequencySpectrumDataFFTW& KTFrequencySpectrumDataFFTW::SetNComponents(unsigned components)
     {
-        unsigned oldSize = fSpectra.size();
-        // if components < oldSize
-        for (unsigned iComponent = components; iComponent < oldSize; ++iComponent)
-        {
-            delete fSpectra[iComponent];
-        }
-        fSpectra.resize(components);
-        // if components > oldSize
-        for (unsigned iComponent = oldSize; iComponent < components; ++iComponent)
-        {
-            fSpectra[iComponent] = NULL;
-        }
+        ResizeSpectra(components);
+        return *this;
+    }
+
+
+#ifdef FFTWF_FOUND
+    KTFrequencySpectrumDataFFTWFCore::KTFrequencySpectrumDataFFTWFCore() :
+            KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTWF >()
+    {
+    }
+
+    KTFrequencySpectrumDataFFTWFCore::~KTFrequencySpectrumDataFFTWFCore()
+    {
+    }
+
+
+    const std::string KTFrequencySpectrumDataFFTWF::sName("frequency-spectrum-fftwf");
+
+    KTFrequencySpectrumDataFFTWF::KTFrequencySpectrumDataFFTWF() :
+            KTFrequencySpectrumDataFFTWFCore(),
+            KTExtensibleData< KTFrequencySpectrumDataFFTWF >()
+    {
+    }
+
+    KTFrequencySpectrumDataFFTWF::~KTFrequencySpectrumDataFFTWF()
+    {
+    }
+
+    KTFrequencySpectrumDataFFTWF& KTFrequencySpectrumDataFFTWF::SetNComponents(unsigned components)
+    {
+        ResizeSpectra(components);
         return *this;
     }
+#endif
 
 
     const std::string KTFrequencySpectrumVarianceDataFFTW::sName("frequency-spectrum-variance-fftw");
@@ -14,25 +14,31 @@
 #include "KTFrequencySpectrumFFTW.hh"
 #include "KTFrequencySpectrumVarianceData.hh"
 
+#include <utility>
 #include <vector>
 
 namespace Katydid
 {
     
 
-    class KTFrequencySpectrumDataFFTWCore : public KTFrequencySpectrumData
+    /*!
+     Implementation shared by KTFrequencySpectrumDataFFTWCore and KTFrequencySpectrumDataFFTWFCore; XSpectrumType is
+     KTFrequencySpectrumFFTW or KTFrequencySpectrumFFTWF.
+    */
+    template< class XSpectrumType >
+    class KTFrequencySpectrumDataFFTWCoreBase : public KTFrequencySpectrumData
     {
         public:
-            typedef KTFrequencySpectrumFFTW spectrum_type;
+            typedef XSpectrumType spectrum_type;
 
         public:
-            KTFrequencySpectrumDataFFTWCore();
-            virtual ~KTFrequencySpectrumDataFFTWCore();
+            KTFrequencySpectrumDataFFTWCoreBase();
+            virtual ~KTFrequencySpectrumDataFFTWCoreBase();
 
             unsigned GetNComponents() const;
 
-            const KTFrequencySpectrumFFTW* GetSpectrumFFTW(unsigned component = 0) const;
-            KTFrequencySpectrumFFTW* GetSpectrumFFTW(unsigned component = 0);
+            const XSpectrumType* GetSpectrumFFTW(unsigned component = 0) const;
+            XSpectrumType* GetSpectrumFFTW(unsigned component = 0);
 
             const KTFrequencySpectrum* GetSpectrum(unsigned component = 0) const;
             KTFrequencySpectrum* GetSpectrum(unsigned component = 0);
@@ -40,15 +46,35 @@ namespace Katydid
             const KTFrequencyDomainArray* GetArray(unsigned component = 0) const;
             KTFrequencyDomainArray* GetArray(unsigned component = 0);
 
-            void SetSpectrum(KTFrequencySpectrumFFTW* record, unsigned component = 0);
+            void SetSpectrum(XSpectrumType* record, unsigned component = 0);
+            /// Takes the contents of spectrum without copying them
+            void SetSpectrum(XSpectrumType&& spectrum, unsigned component = 0);
 
-            virtual KTFrequencySpectrumDataFFTWCore& SetNComponents(unsigned channels) = 0;
+            virtual KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >& SetNComponents(unsigned channels) = 0;
 
         protected:
-            std::vector< KTFrequencySpectrumFFTW* > fSpectra;
+            /// Spectra beyond the new number of components are deleted; new components are NULL
+            void ResizeSpectra(unsigned components);
+
+            std::vector< XSpectrumType* > fSpectra;
 
     };
 
+    extern template class KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTW >;
+#ifdef FFTWF_FOUND
+    extern template class KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTWF >;
+#endif
+
+
+    class KTFrequencySpectrumDataFFTWCore : public KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTW >
+    {
+        public:
+            KTFrequencySpectrumDataFFTWCore();
+            virtual ~KTFrequencySpectrumDataFFTWCore();
+
+            virtual KTFrequencySpectrumDataFFTWCore& SetNComponents(unsigned channels) = 0;
+    };
+
 
     class KTFrequencySpectrumDataFFTW : public KTFrequencySpectrumDataFFTWCore, public Nymph::KTExtensibleData< KTFrequencySpectrumDataFFTW >
     {
@@ -64,6 +90,34 @@ namespace Katydid
     };
 
 
+#ifdef FFTWF_FOUND
+    /// Single-precision version of KTFrequencySpectrumDataFFTWCore
+    class KTFrequencySpectrumDataFFTWFCore : public KTFrequencySpectrumDataFFTWCoreBase< KTFrequencySpectrumFFTWF >
+    {
+        public:
+            KTFrequencySpectrumDataFFTWFCore();
+            virtual ~KTFrequencySpectrumDataFFTWFCore();
+
+            virtual KTFrequencySpectrumDataFFTWFCore& SetNComponents(unsigned channels) = 0;
+    };
+
+
+    /// Single-precision version of KTFrequencySpectrumDataFFTW
+    class KTFrequencySpectrumDataFFTWF : public KTFrequencySpectrumDataFFTWFCore, public Nymph::KTExtensibleData< KTFrequencySpectrumDataFFTWF >
+    {
+        public:
+            KTFrequencySpectrumDataFFTWF();
+            virtual ~KTFrequencySpectrumDataFFTWF();
+
+            virtual KTFrequencySpectrumDataFFTWF& SetNComponents(unsigned components);
+
+        public:
+            static const std::string sName;
+
+    };
+#endif
+
+
     class KTFrequencySpectrumVarianceDataFFTW : public KTFrequencySpectrumVarianceDataCore, public Nymph::KTExtensibleData< KTFrequencySpectrumVarianceDataFFTW >
     {
         public:
@@ -78,42 +132,50 @@ namespace Katydid
     };
 
 
-    inline const KTFrequencySpectrumFFTW* KTFrequencySpectrumDataFFTWCore::GetSpectrumFFTW(unsigned component) const
+    template< class XSpectrumType >
+    inline const XSpectrumType* KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetSpectrumFFTW(unsigned component) const
     {
         return fSpectra[component];
     }
 
-    inline KTFrequencySpectrumFFTW* KTFrequencySpectrumDataFFTWCore::GetSpectrumFFTW(unsigned component)
+    template< class XSpectrumType >
+    inline XSpectrumType* KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetSpectrumFFTW(unsigned component)
     {
         return fSpectra[component];
     }
 
-    inline const KTFrequencySpectrum* KTFrequencySpectrumDataFFTWCore::GetSpectrum(unsigned component) const
+    template< class XSpectrumType >
+    inline const KTFrequencySpectrum* KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetSpectrum(unsigned component) const
     {
         return fSpectra[component];
     }
 
-    inline KTFrequencySpectrum* KTFrequencySpectrumDataFFTWCore::GetSpectrum(unsigned component)
+    template< class XSpectrumType >
+    inline KTFrequencySpectrum* KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetSpectrum(unsigned component)
     {
         return fSpectra[component];
     }
 
-    inline const KTFrequencyDomainArray* KTFrequencySpectrumDataFFTWCore::GetArray(unsigned component) const
+    template< class XSpectrumType >
+    inline const KTFrequencyDomainArray* KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetArray(unsigned component) const
     {
         return fSpectra[component];
     }
 
-    inline KTFrequencyDomainArray* KTFrequencySpectrumDataFFTWCore::GetArray(unsigned component)
+    template< class XSpectrumType >
+    inline KTFrequencyDomainArray* KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetArray(unsigned component)
     {
         return fSpectra[component];
     }
 
-    inline unsigned KTFrequencySpectrumDataFFTWCore::GetNComponents() const
+    template< class XSpectrumType >
+    inline unsigned KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::GetNComponents() const
     {
         return unsigned(fSpectra.size());
     }
 
-    inline void KTFrequencySpectrumDataFFTWCore::SetSpectrum(KTFrequencySpectrumFFTW* record, unsigned component)
+    template< class XSpectrumType >
+    inline void KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::SetSpectrum(XSpectrumType* record, unsigned component)
     {
         if (component >= fSpectra.size()) SetNComponents(component+1);
         else delete fSpectra[component];
@@ -121,6 +183,19 @@ namespace Katydid
         return;
     }
 
+    template< class XSpectrumType >
+    inline void KTFrequencySpectrumDataFFTWCoreBase< XSpectrumType >::SetSpectrum(XSpectrumType&& spectrum, unsigned component)
+    {
+        if (component < fSpectra.size() && fSpectra[component] != NULL)
+        {
+            // reuse the existing spectrum object; its old buffer goes out with the moved-from spectrum
+            *fSpectra[component] = std::move(spectrum);
+            return;
+        }
+        SetSpectrum(new XSpectrumType(std::move(spectrum)), component);
+        return;
+    }
+
 
 } /* namespace Katydid */
 
@@ -11,7 +11,9 @@
 #include "KTPowerSpectrum.hh"
 #include "KTFrequencySpectrumPolar.hh"
 
+#include <algorithm>
 #include <sstream>
+#include <utility>
 
 #ifdef USE_OPENMP
 #include <omp.h>
@@ -23,22 +25,24 @@ namespace Katydid
 {
     KTLOGGER(fslog, "KTFrequencySpectrumFFTW");
 
-    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW() :
-            KTPhysicalArray< 1, fftw_complex >(),
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >::KTFrequencySpectrumFFTWBase() :
+            array_base_type(),
             KTFrequencySpectrum(),
             fIsArrayOrderFlipped(false),
             fIsSizeEven(true),
             fLeftOfCenterOffset(0),
             fCenterBin(0),
-            fConstBinAccess(&KTFrequencySpectrumFFTW::AsIsBinAccess),
-            fBinAccess(&KTFrequencySpectrumFFTW::AsIsBinAccess),
+            fConstBinAccess(&KTFrequencySpectrumFFTWBase< XFloatType >::AsIsBinAccess),
+            fBinAccess(&KTFrequencySpectrumFFTWBase< XFloatType >::AsIsBinAccess),
             fNTimeBins(0),
             fPointCache()
     {
     }
 
-    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
-            KTPhysicalArray< 1, fftw_complex >(nBins, rangeMin, rangeMax),
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >::KTFrequencySpectrumFFTWBase(size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
+            array_base_type(nBins, rangeMin, rangeMax),
             KTFrequencySpectrum(),
             fIsArrayOrderFlipped(arrayOrderIsFlipped),
             fIsSizeEven(nBins%2 == 0),
@@ -49,29 +53,31 @@ namespace Katydid
     {
         if (arrayOrderIsFlipped)
         {
-            fConstBinAccess = &KTFrequencySpectrumFFTW::ReorderedBinAccess;
-            fBinAccess = &KTFrequencySpectrumFFTW::ReorderedBinAccess;
+            fConstBinAccess = &KTFrequencySpectrumFFTWBase< XFloatType >::ReorderedBinAccess;
+            fBinAccess = &KTFrequencySpectrumFFTWBase< XFloatType >::ReorderedBinAccess;
         }
         else
         {
-            fConstBinAccess = &KTFrequencySpectrumFFTW::AsIsBinAccess;
-            fBinAccess = &KTFrequencySpectrumFFTW::AsIsBinAccess;
+            fConstBinAccess = &KTFrequencySpectrumFFTWBase< XFloatType >::AsIsBinAccess;
+            fBinAccess = &KTFrequencySpectrumFFTWBase< XFloatType >::AsIsBinAccess;
         }
         //KTINFO(fslog, "number of bins: " << nBins << "   is size even? " << fIsSizeEven);
         //KTINFO(fslog, "neg freq offset: " << fLeftOfCenterOffset);
     }
 
-    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
-            KTFrequencySpectrumFFTW(nBins, rangeMin, rangeMax, arrayOrderIsFlipped)
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >::KTFrequencySpectrumFFTWBase(std::initializer_list< XFloatType > value, size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
+            KTFrequencySpectrumFFTWBase(nBins, rangeMin, rangeMax, arrayOrderIsFlipped)
     {
         for (unsigned index = 0; index < nBins; ++index)
         {
-            std::copy(value.begin(), value.end(), fData[index]);
+            std::copy(value.begin(), value.end(), this->fData[index]);
         }
     }
 
-    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(const KTFrequencySpectrumFFTW& orig) :
-            KTPhysicalArray< 1, fftw_complex >(orig),
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >::KTFrequencySpectrumFFTWBase(const KTFrequencySpectrumFFTWBase< XFloatType >& orig) :
+            array_base_type(orig),
             KTFrequencySpectrum(),
             fIsArrayOrderFlipped(orig.fIsArrayOrderFlipped),
             fIsSizeEven(orig.fIsSizeEven),
@@ -84,13 +90,30 @@ namespace Katydid
     {
     }
 
-    KTFrequencySpectrumFFTW::~KTFrequencySpectrumFFTW()
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >::KTFrequencySpectrumFFTWBase(KTFrequencySpectrumFFTWBase< XFloatType >&& orig) :
+            array_base_type(std::move(orig)),
+            KTFrequencySpectrum(),
+            fIsArrayOrderFlipped(orig.fIsArrayOrderFlipped),
+            fIsSizeEven(orig.fIsSizeEven),
+            fLeftOfCenterOffset(orig.fLeftOfCenterOffset),
+            fCenterBin(orig.fCenterBin),
+            fConstBinAccess(orig.fConstBinAccess),
+            fBinAccess(orig.fBinAccess),
+            fNTimeBins(orig.fNTimeBins),
+            fPointCache()
     {
     }
 
-    KTFrequencySpectrumFFTW& KTFrequencySpectrumFFTW::operator=(const KTFrequencySpectrumFFTW& rhs)
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >::~KTFrequencySpectrumFFTWBase()
     {
-        KTPhysicalArray< 1, fftw_complex >::operator=(rhs);
+    }
+
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >& KTFrequencySpectrumFFTWBase< XFloatType >::operator=(const KTFrequencySpectrumFFTWBase< XFloatType >& rhs)
+    {
+        array_base_type::operator=(rhs);
         fIsArrayOrderFlipped = rhs.fIsArrayOrderFlipped;
         fIsSizeEven = rhs.fIsSizeEven;
         fLeftOfCenterOffset = rhs.fLeftOfCenterOffset;
@@ -101,70 +124,90 @@ namespace Katydid
         return *this;
     }
 
-    const KTAxisProperties< 1 >& KTFrequencySpectrumFFTW::GetAxis() const
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >& KTFrequencySpectrumFFTWBase< XFloatType >::operator=(KTFrequencySpectrumFFTWBase< XFloatType >&& rhs)
+    {
+        array_base_type::operator=(std::move(rhs));
+        std::swap(fIsArrayOrderFlipped, rhs.fIsArrayOrderFlipped);
+        std::swap(fIsSizeEven, rhs.fIsSizeEven);
+        std::swap(fLeftOfCenterOffset, rhs.fLeftOfCenterOffset);
+        std::swap(fCenterBin, rhs.fCenterBin);
+        std::swap(fConstBinAccess, rhs.fConstBinAccess);
+        std::swap(fBinAccess, rhs.fBinAccess);
+        std::swap(fNTimeBins, rhs.fNTimeBins);
+        return *this;
+    }
+
+    template< typename XFloatType >
+    const KTAxisProperties< 1 >& KTFrequencySpectrumFFTWBase< XFloatType >::GetAxis() const
     {
         return *this;
     }
 
-    KTAxisProperties< 1 >& KTFrequencySpectrumFFTW::GetAxis()
+    template< typename XFloatType >
+    KTAxisProperties< 1 >& KTFrequencySpectrumFFTWBase< XFloatType >::GetAxis()
     {
         return *this;
     }
 
-    KTFrequencySpectrumFFTW& KTFrequencySpectrumFFTW::CConjugate()
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >& KTFrequencySpectrumFFTWBase< XFloatType >::CConjugate()
     {
-        unsigned nBins = size();
+        unsigned nBins = this->size();
 #pragma omp parallel for
         for (unsigned iBin=0; iBin<nBins; ++iBin)
         {
-            // order doesn't matter, so use fData[] to access values
-            fData[iBin][1] = -fData[iBin][1];
+            // order doesn't matter, so use this->fData[] to access values
+            this->fData[iBin][1] = -this->fData[iBin][1];
         }
         return *this;
     }
 
-    KTFrequencySpectrumFFTW& KTFrequencySpectrumFFTW::AnalyticAssociate()
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >& KTFrequencySpectrumFFTWBase< XFloatType >::AnalyticAssociate()
     {
         // This is only valid if the original signal is Real only (not complex)
         // Note: the data storage array is accessed directly, so the FFTW data storage format is used.
         // Nyquist bin(s) and negative frequency bins are set to 0 (from size/2 to the end of the array)
         // DC bin stays as is (array position 0).
         // Positive frequency bins are multiplied by 2 (from array position 1 to size/2).
-        unsigned nBins = size();
+        unsigned nBins = this->size();
         unsigned nyquistPos = nBins / 2; // either the sole nyquist bin (if even # of bins) or the first of the two (if odd # of bins; bins are sequential in the array).
 #pragma omp parallel for
         for (unsigned arrayPos=1; arrayPos<nyquistPos; arrayPos++)
         {
-            fData[arrayPos][0] = fData[arrayPos][0] * 2.;
-            fData[arrayPos][1] = fData[arrayPos][1] * 2.;
+            this->fData[arrayPos][0] = this->fData[arrayPos][0] * 2.;
+            this->fData[arrayPos][1] = this->fData[arrayPos][1] * 2.;
         }
 #pragma omp parallel for
         for (unsigned arrayPos=nyquistPos; arrayPos<nBins; arrayPos++)
         {
-            fData[arrayPos][0] = 0.;
-            fData[arrayPos][1] = 0.;
+            this->fData[arrayPos][0] = 0.;
+            this->fData[arrayPos][1] = 0.;
         }
         return *this;
     }
 
-    KTFrequencySpectrumFFTW& KTFrequencySpectrumFFTW::Scale(double scale)
+    template< typename XFloatType >
+    KTFrequencySpectrumFFTWBase< XFloatType >& KTFrequencySpectrumFFTWBase< XFloatType >::Scale(double scale)
     {
-        unsigned nBins = size();
+        unsigned nBins = this->size();
 #pragma omp parallel for
         for (unsigned iBin=0; iBin<nBins; ++iBin)
         {
-            // order doesn't matter, so use fData[] to access values
-            fData[iBin][0] = scale * fData[iBin][0];
-            fData[iBin][1] = scale * fData[iBin][1];
+            // order doesn't matter, so use this->fData[] to access values
+            this->fData[iBin][0] = scale * this->fData[iBin][0];
+            this->fData[iBin][1] = scale * this->fData[iBin][1];
         }
         return *this;
     }
 
 
-    KTFrequencySpectrumPolar* KTFrequencySpectrumFFTW::CreateFrequencySpectrumPolar() const
+    template< typename XFloatType >
+    KTFrequencySpectrumPolar* KTFrequencySpectrumFFTWBase< XFloatType >::CreateFrequencySpectrumPolar() const
     {
-        unsigned nBins = size();
-        KTFrequencySpectrumPolar* newFS = new KTFrequencySpectrumPolar(nBins, GetRangeMin(), GetRangeMax());
+        unsigned nBins = this->size();
+        KTFrequencySpectrumPolar* newFS = new KTFrequencySpectrumPolar(nBins, this->GetRangeMin(), this->GetRangeMax());
         newFS->SetNTimeBins(fNTimeBins);
 #pragma omp parallel for
         for (unsigned iBin=0; iBin<nBins; ++iBin)
@@ -174,7 +217,8 @@ namespace Katydid
         return newFS;
     }
 
-    KTPowerSpectrum* KTFrequencySpectrumFFTW::CreatePowerSpectrum() const
+    template< typename XFloatType >
+    KTPowerSpectrum* KTFrequencySpectrumFFTWBase< XFloatType >::CreatePowerSpectrum() const
     {
         // This function creates a power spectrum that runs from the smallest to the largest absolute frequency.
         // It can handle frequency ranges that do or don't cross DC, and that are symmetric or asymmetric.
@@ -182,32 +226,32 @@ namespace Katydid
         // If the frequency range crosses DC, the power spectrum range will run from DC to the maximum absolute frequency
         // In this case negative-frequency bins are added to positive-frequency bins.
 
-        double maxFreq = std::max(fabs(GetRangeMin()), fabs(GetRangeMax()));
-        double minFreq = -0.5 * GetBinWidth();
-        unsigned nBins = (maxFreq - minFreq) / GetBinWidth();
-        if (GetRangeMax() < 0. || GetRangeMin() > 0.)
+        double maxFreq = std::max(fabs(this->GetRangeMin()), fabs(this->GetRangeMax()));
+        double minFreq = -0.5 * this->GetBinWidth();
+        unsigned nBins = (maxFreq - minFreq) / this->GetBinWidth();
+        if (this->GetRangeMax() < 0. || this->GetRangeMin() > 0.)
         {
-            minFreq = std::min(fabs(GetRangeMin()), fabs(GetRangeMax()));
-            nBins = size();
+            minFreq = std::min(fabs(this->GetRangeMin()), fabs(this->GetRangeMax()));
+            nBins = this->size();
         }
 
         KTPowerSpectrum* newPS = new KTPowerSpectrum(nBins, minFreq, maxFreq);
         for (unsigned iBin = 0; iBin < nBins; ++iBin) (*newPS)(iBin) = 0.;
 
-        int dcBin = FindBin(0.);
-        // default case: dcBin >= 0 && dcBin < size()
+        int dcBin = this->FindBin(0.);
+        // default case: dcBin >= 0 && dcBin < this->size()
         int firstPosFreqBin = dcBin;
-        int lastPosFreqBin = size();
+        int lastPosFreqBin = this->size();
         int firstNegFreqBin = 0;
         int lastNegFreqBin = dcBin;
-        if (dcBin >= (int)size())
+        if (dcBin >= (int)this->size())
         {
-            firstPosFreqBin = size(); // lastPosFreqBin = size();
-            lastNegFreqBin = size(); // firstNEgFreqBin = 0
+            firstPosFreqBin = this->size(); // lastPosFreqBin = this->size();
+            lastNegFreqBin = this->size(); // firstNEgFreqBin = 0
         }
         else if (dcBin < 0)
         {
-            firstPosFreqBin = 0; // lastPosFreqBin = size();
+            firstPosFreqBin = 0; // lastPosFreqBin = this->size();
             firstNegFreqBin = dcBin; // lastNegFreqBin = dcBin;
         }
         //KTWARN( fslog, "firstPosFreqBin = " << firstPosFreqBin << "; lastPosFreqBin = " << lastPosFreqBin << "; firstNegFreqBin = " << firstNegFreqBin << "; lastNegFreqBin = " << lastNegFreqBin);
@@ -233,17 +277,109 @@ namespace Katydid
         return newPS;
     }
 
-    void KTFrequencySpectrumFFTW::Print(unsigned startPrint, unsigned nToPrint) const
+    template< typename XFloatType >
+    void KTFrequencySpectrumFFTWBase< XFloatType >::Print(unsigned startPrint, unsigned nToPrint) const
     {
         stringstream printStream;
         for (unsigned iBin = startPrint; iBin < startPrint + nToPrint; ++iBin)
         {
             // order matters, so use (*this)() to access values
-            printStream << "Bin " << iBin << ";   x = " << GetBinCenter(iBin) <<
+            printStream << "Bin " << iBin << ";   x = " << this->GetBinCenter(iBin) <<
                     ";   y = " << (*this)(iBin) << "\n";
         }
         KTDEBUG(fslog, "\n" << printStream.str());
         return;
     }
 
+    template class KTFrequencySpectrumFFTWBase< double >;
+#ifdef FFTWF_FOUND
+    template class KTFrequencySpectrumFFTWBase< float >;
+#endif
+
+
+    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW() :
+            KTFrequencySpectrumFFTWBase< double >()
+    {
+    }
+
+    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
+            KTFrequencySpectrumFFTWBase< double >(nBins, rangeMin, rangeMax, arrayOrderIsFlipped)
+    {
+    }
+
+    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
+            KTFrequencySpectrumFFTWBase< double >(value, nBins, rangeMin, rangeMax, arrayOrderIsFlipped)
+    {
+    }
+
+    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(const KTFrequencySpectrumFFTW& orig) :
+            KTFrequencySpectrumFFTWBase< double >(orig)
+    {
+    }
+
+    KTFrequencySpectrumFFTW::KTFrequencySpectrumFFTW(KTFrequencySpectrumFFTW&& orig) :
+            KTFrequencySpectrumFFTWBase< double >(std::move(orig))
+    {
+    }
+
+    KTFrequencySpectrumFFTW::~KTFrequencySpectrumFFTW()
+    {
+    }
+
+    KTFrequencySpectrumFFTW& KTFrequencySpectrumFFTW::operator=(const KTFrequencySpectrumFFTW& rhs)
+    {
+        KTFrequencySpectrumFFTWBase< double >::operator=(rhs);
+        return *this;
+    }
+
+    KTFrequencySpectrumFFTW& KTFrequencySpectrumFFTW::operator=(KTFrequencySpectrumFFTW&& rhs)
+    {
+        KTFrequencySpectrumFFTWBase< double >::operator=(std::move(rhs));
+        return *this;
+    }
+
+
+#ifdef FFTWF_FOUND
+    KTFrequencySpectrumFFTWF::KTFrequencySpectrumFFTWF() :
+            KTFrequencySpectrumFFTWBase< float >()
+    {
+    }
+
+    KTFrequencySpectrumFFTWF::KTFrequencySpectrumFFTWF(size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
+            KTFrequencySpectrumFFTWBase< float >(nBins, rangeMin, rangeMax, arrayOrderIsFlipped)
+    {
+    }
+
+    KTFrequencySpectrumFFTWF::KTFrequencySpectrumFFTWF(std::initializer_list<float> value, size_t nBins, double rangeMin, double rangeMax, bool arrayOrderIsFlipped) :
+            KTFrequencySpectrumFFTWBase< float >(value, nBins, rangeMin, rangeMax, arrayOrderIsFlipped)
+    {
+    }
+
+    KTFrequencySpectrumFFTWF::KTFrequencySpectrumFFTWF(const KTFrequencySpectrumFFTWF& orig) :
+            KTFrequencySpectrumFFTWBase< float >(orig)
+    {
+    }
+
+    KTFrequencySpectrumFFTWF::KTFrequencySpectrumFFTWF(KTFrequencySpectrumFFTWF&& orig) :
+            KTFrequencySpectrumFFTWBase< float >(std::move(orig))
+    {
+    }
+
+    KTFrequencySpectrumFFTWF::~KTFrequencySpectrumFFTWF()
+    {
+    }
+
+    KTFrequencySpectrumFFTWF& KTFrequencySpectrumFFTWF::operator=(const KTFrequencySpectrumFFTWF& rhs)
+    {
+        KTFrequencySpectrumFFTWBase< float >::operator=(rhs);
+        return *this;
+    }
+
+    KTFrequencySpectrumFFTWF& KTFrequencySpectrumFFTWF::operator=(KTFrequencySpectrumFFTWF&& rhs)
+    {
+        KTFrequencySpectrumFFTWBase< float >::operator=(std::move(rhs));
+        return *this;
+    }
+#endif
+
 } /* namespace Katydid */
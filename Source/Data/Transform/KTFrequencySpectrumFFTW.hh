@@ -13,6 +13,7 @@
 #include "KTPhysicalArrayFFTW.hh"
 
 #include <cmath>
+#include <initializer_list>
 #include <string>
 
 namespace Katydid
@@ -20,14 +21,24 @@ namespace Katydid
     
     class KTFrequencySpectrumPolar;
 
-    class KTFrequencySpectrumFFTW : public KTPhysicalArray< 1, fftw_complex >, public KTFrequencySpectrum
+    /*!
+     Implementation shared by KTFrequencySpectrumFFTW and KTFrequencySpectrumFFTWF; values are stored as XFloatType[2] (fftw_complex or fftwf_complex),
+     but the KTFrequencySpectrum interface uses doubles.  The power spectrum it creates is always double precision.
+    */
+    template< typename XFloatType >
+    class KTFrequencySpectrumFFTWBase : public KTPhysicalArray< 1, XFloatType[2] >, public KTFrequencySpectrum
     {
         public:
-            KTFrequencySpectrumFFTW();
-            KTFrequencySpectrumFFTW(size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
-            KTFrequencySpectrumFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
-            KTFrequencySpectrumFFTW(const KTFrequencySpectrumFFTW& orig);
-            virtual ~KTFrequencySpectrumFFTW();
+            typedef KTPhysicalArray< 1, XFloatType[2] > array_base_type;
+            typedef typename array_base_type::complex_type complex_type;
+
+        public:
+            KTFrequencySpectrumFFTWBase();
+            KTFrequencySpectrumFFTWBase(size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
+            KTFrequencySpectrumFFTWBase(std::initializer_list< XFloatType > value, size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
+            KTFrequencySpectrumFFTWBase(const KTFrequencySpectrumFFTWBase< XFloatType >& orig);
+            KTFrequencySpectrumFFTWBase(KTFrequencySpectrumFFTWBase< XFloatType >&& orig);
+            virtual ~KTFrequencySpectrumFFTWBase();
 
         public:
             bool GetIsArrayOrderFlipped() const;
@@ -50,8 +61,8 @@ namespace Katydid
 
             // replace some of the KTPhysicalArray interface
 
-            const fftw_complex& operator()(unsigned i) const;
-            fftw_complex& operator()(unsigned i);
+            const complex_type& operator()(unsigned i) const;
+            complex_type& operator()(unsigned i);
 
             virtual double GetReal(unsigned bin) const;
             virtual double GetImag(unsigned bin) const;
@@ -70,29 +81,31 @@ namespace Katydid
             virtual void SetNTimeBins(unsigned bins);
 
         private:
-            typedef const fftw_complex& (KTFrequencySpectrumFFTW::*ConstOrderedBinAccessFunc)(unsigned) const;
-            typedef fftw_complex& (KTFrequencySpectrumFFTW::*OrderedBinAccessFunc)(unsigned);
+            typedef const complex_type& (KTFrequencySpectrumFFTWBase< XFloatType >::*ConstOrderedBinAccessFunc)(unsigned) const;
+            typedef complex_type& (KTFrequencySpectrumFFTWBase< XFloatType >::*OrderedBinAccessFunc)(unsigned);
 
             ConstOrderedBinAccessFunc fConstBinAccess;
             OrderedBinAccessFunc fBinAccess;
 
-            const fftw_complex& ReorderedBinAccess(unsigned i) const;
-            fftw_complex& ReorderedBinAccess(unsigned i);
+            const complex_type& ReorderedBinAccess(unsigned i) const;
+            complex_type& ReorderedBinAccess(unsigned i);
 
-            const fftw_complex& AsIsBinAccess(unsigned i) const;
-            fftw_complex& AsIsBinAccess(unsigned i);
+            const complex_type& AsIsBinAccess(unsigned i) const;
+            complex_type& AsIsBinAccess(unsigned i);
 
         public:
             // normal KTFrequencySpectrumPolar functions
 
-            virtual KTFrequencySpectrumFFTW& operator=(const KTFrequencySpectrumFFTW& rhs);
+            virtual KTFrequencySpectrumFFTWBase< XFloatType >& operator=(const KTFrequencySpectrumFFTWBase< XFloatType >& rhs);
+            /// Takes rhs's data without copying; rhs is left with this spectrum's old contents
+            virtual KTFrequencySpectrumFFTWBase< XFloatType >& operator=(KTFrequencySpectrumFFTWBase< XFloatType >&& rhs);
 
             /// In-place calculation of the complex conjugate
-            virtual KTFrequencySpectrumFFTW& CConjugate();
+            virtual KTFrequencySpectrumFFTWBase< XFloatType >& CConjugate();
             /// In-place calculation of the analytic associate
-            virtual KTFrequencySpectrumFFTW& AnalyticAssociate();
+            virtual KTFrequencySpectrumFFTWBase< XFloatType >& AnalyticAssociate();
 
-            virtual KTFrequencySpectrumFFTW& Scale(double scale);
+            virtual KTFrequencySpectrumFFTWBase< XFloatType >& Scale(double scale);
 
             virtual KTFrequencySpectrumPolar* CreateFrequencySpectrumPolar() const;
             virtual KTPowerSpectrum* CreatePowerSpectrum() const;
@@ -103,118 +116,179 @@ namespace Katydid
             unsigned fNTimeBins;
 
         protected:
-            mutable const fftw_complex* fPointCache;
+            mutable const complex_type* fPointCache;
+    };
+
+    extern template class KTFrequencySpectrumFFTWBase< double >;
+#ifdef FFTWF_FOUND
+    extern template class KTFrequencySpectrumFFTWBase< float >;
+#endif
+
+
+    class KTFrequencySpectrumFFTW : public KTFrequencySpectrumFFTWBase< double >
+    {
+        public:
+            KTFrequencySpectrumFFTW();
+            KTFrequencySpectrumFFTW(size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
+            KTFrequencySpectrumFFTW(std::initializer_list<double> value, size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
+            KTFrequencySpectrumFFTW(const KTFrequencySpectrumFFTW& orig);
+            KTFrequencySpectrumFFTW(KTFrequencySpectrumFFTW&& orig);
+            virtual ~KTFrequencySpectrumFFTW();
+
+            virtual KTFrequencySpectrumFFTW& operator=(const KTFrequencySpectrumFFTW& rhs);
+            /// Takes rhs's data without copying; rhs is left with this spectrum's old contents
+            virtual KTFrequencySpectrumFFTW& operator=(KTFrequencySpectrumFFTW&& rhs);
+    };
+
+#ifdef FFTWF_FOUND
+    /// Single-precision version of KTFrequencySpectrumFFTW
+    class KTFrequencySpectrumFFTWF : public KTFrequencySpectrumFFTWBase< float >
+    {
+        public:
+            KTFrequencySpectrumFFTWF();
+            KTFrequencySpectrumFFTWF(size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
+            KTFrequencySpectrumFFTWF(std::initializer_list<float> value, size_t nBins, double rangeMin=0., double rangeMax=1., bool arrayOrderIsFlipped=false);
+            KTFrequencySpectrumFFTWF(const KTFrequencySpectrumFFTWF& orig);
+            KTFrequencySpectrumFFTWF(KTFrequencySpectrumFFTWF&& orig);
+            virtual ~KTFrequencySpectrumFFTWF();
+
+            virtual KTFrequencySpectrumFFTWF& operator=(const KTFrequencySpectrumFFTWF& rhs);
+            /// Takes rhs's data without copying; rhs is left with this spectrum's old contents
+            virtual KTFrequencySpectrumFFTWF& operator=(KTFrequencySpectrumFFTWF&& rhs);
     };
+#endif
+
 
-    inline bool KTFrequencySpectrumFFTW::GetIsArrayOrderFlipped() const
+    template< typename XFloatType >
+    inline bool KTFrequencySpectrumFFTWBase< XFloatType >::GetIsArrayOrderFlipped() const
     {
         return fIsArrayOrderFlipped;
     }
 
-    inline bool KTFrequencySpectrumFFTW::GetIsSizeEven() const
+    template< typename XFloatType >
+    inline bool KTFrequencySpectrumFFTWBase< XFloatType >::GetIsSizeEven() const
     {
         return fIsSizeEven;
     }
 
-    inline size_t KTFrequencySpectrumFFTW::GetLeftOfCenterOffset() const
+    template< typename XFloatType >
+    inline size_t KTFrequencySpectrumFFTWBase< XFloatType >::GetLeftOfCenterOffset() const
     {
         return fLeftOfCenterOffset;
     }
 
-    inline size_t KTFrequencySpectrumFFTW::GetCenterBin() const
+    template< typename XFloatType >
+    inline size_t KTFrequencySpectrumFFTWBase< XFloatType >::GetCenterBin() const
     {
         return fCenterBin;
     }
 
-    inline const std::string& KTFrequencySpectrumFFTW::GetOrdinateLabel() const
+    template< typename XFloatType >
+    inline const std::string& KTFrequencySpectrumFFTWBase< XFloatType >::GetOrdinateLabel() const
     {
-        return GetDataLabel();
+        return this->GetDataLabel();
     }
 
-    inline const fftw_complex& KTFrequencySpectrumFFTW::operator()(unsigned i) const
+    template< typename XFloatType >
+    inline const typename KTFrequencySpectrumFFTWBase< XFloatType >::complex_type& KTFrequencySpectrumFFTWBase< XFloatType >::operator()(unsigned i) const
     {
         return (this->*fConstBinAccess)(i);
     }
 
-    inline fftw_complex& KTFrequencySpectrumFFTW::operator()(unsigned i)
+    template< typename XFloatType >
+    inline typename KTFrequencySpectrumFFTWBase< XFloatType >::complex_type& KTFrequencySpectrumFFTWBase< XFloatType >::operator()(unsigned i)
     {
         return (this->*fBinAccess)(i);
     }
 
-    inline const fftw_complex& KTFrequencySpectrumFFTW::ReorderedBinAccess(unsigned i) const
+    template< typename XFloatType >
+    inline const typename KTFrequencySpectrumFFTWBase< XFloatType >::complex_type& KTFrequencySpectrumFFTWBase< XFloatType >::ReorderedBinAccess(unsigned i) const
     {
-        return (i >= fCenterBin) ? fData[i - fCenterBin] : fData[i + fLeftOfCenterOffset];
+        return (i >= fCenterBin) ? this->fData[i - fCenterBin] : this->fData[i + fLeftOfCenterOffset];
     }
 
-    inline fftw_complex& KTFrequencySpectrumFFTW::ReorderedBinAccess(unsigned i)
+    template< typename XFloatType >
+    inline typename KTFrequencySpectrumFFTWBase< XFloatType >::complex_type& KTFrequencySpectrumFFTWBase< XFloatType >::ReorderedBinAccess(unsigned i)
     {
-        return (i >= fCenterBin) ? fData[i - fCenterBin] : fData[i + fLeftOfCenterOffset];
+        return (i >= fCenterBin) ? this->fData[i - fCenterBin] : this->fData[i + fLeftOfCenterOffset];
     }
 
-    inline const fftw_complex& KTFrequencySpectrumFFTW::AsIsBinAccess(unsigned i) const
+    template< typename XFloatType >
+    inline const typename KTFrequencySpectrumFFTWBase< XFloatType >::complex_type& KTFrequencySpectrumFFTWBase< XFloatType >::AsIsBinAccess(unsigned i) const
     {
-        return fData[i];
+        return this->fData[i];
     }
 
-    inline fftw_complex& KTFrequencySpectrumFFTW::AsIsBinAccess(unsigned i)
+    template< typename XFloatType >
+    inline typename KTFrequencySpectrumFFTWBase< XFloatType >::complex_type& KTFrequencySpectrumFFTWBase< XFloatType >::AsIsBinAccess(unsigned i)
     {
-        return fData[i];
+        return this->fData[i];
     }
 
-    inline double KTFrequencySpectrumFFTW::GetReal(unsigned bin) const
+    template< typename XFloatType >
+    inline double KTFrequencySpectrumFFTWBase< XFloatType >::GetReal(unsigned bin) const
     {
         return (*this)(bin)[0];
     }
 
-    inline double KTFrequencySpectrumFFTW::GetImag(unsigned bin) const
+    template< typename XFloatType >
+    inline double KTFrequencySpectrumFFTWBase< XFloatType >::GetImag(unsigned bin) const
     {
         return (*this)(bin)[1];
     }
 
-    inline void KTFrequencySpectrumFFTW::SetRect(unsigned bin, double real, double imag)
+    template< typename XFloatType >
+    inline void KTFrequencySpectrumFFTWBase< XFloatType >::SetRect(unsigned bin, double real, double imag)
     {
         fPointCache = &(*this)(bin);
-        (*const_cast< fftw_complex* >(fPointCache))[0] = real;
-        (*const_cast< fftw_complex* >(fPointCache))[1] = imag;
+        (*const_cast< complex_type* >(fPointCache))[0] = real;
+        (*const_cast< complex_type* >(fPointCache))[1] = imag;
         return;
     }
 
-    inline double KTFrequencySpectrumFFTW::GetAbs(unsigned bin) const
+    template< typename XFloatType >
+    inline double KTFrequencySpectrumFFTWBase< XFloatType >::GetAbs(unsigned bin) const
     {
         fPointCache = &(*this)(bin);
         return sqrt((*fPointCache)[0]*(*fPointCache)[0] + (*fPointCache)[1]*(*fPointCache)[1]);
     }
 
-    inline double KTFrequencySpectrumFFTW::GetArg(unsigned bin) const
+    template< typename XFloatType >
+    inline double KTFrequencySpectrumFFTWBase< XFloatType >::GetArg(unsigned bin) const
     {
         fPointCache = &(*this)(bin);
         return atan2((*fPointCache)[1], (*fPointCache)[0]);
     }
 
-    inline void KTFrequencySpectrumFFTW::SetPolar(unsigned bin, double abs, double arg)
+    template< typename XFloatType >
+    inline void KTFrequencySpectrumFFTWBase< XFloatType >::SetPolar(unsigned bin, double abs, double arg)
     {
         fPointCache = &(*this)(bin);
-        (*const_cast< fftw_complex* >(fPointCache))[0] = abs * cos(arg);
-        (*const_cast< fftw_complex* >(fPointCache))[1] = abs * sin(arg);
+        (*const_cast< complex_type* >(fPointCache))[0] = abs * cos(arg);
+        (*const_cast< complex_type* >(fPointCache))[1] = abs * sin(arg);
         return;
     }
 
-    inline unsigned KTFrequencySpectrumFFTW::GetNFrequencyBins() const
+    template< typename XFloatType >
+    inline unsigned KTFrequencySpectrumFFTWBase< XFloatType >::GetNFrequencyBins() const
     {
-        return size();
+        return this->size();
     }
 
-    inline double KTFrequencySpectrumFFTW::GetFrequencyBinWidth() const
+    template< typename XFloatType >
+    inline double KTFrequencySpectrumFFTWBase< XFloatType >::GetFrequencyBinWidth() const
     {
-        return GetBinWidth();
+        return this->GetBinWidth();
     }
 
-    inline unsigned KTFrequencySpectrumFFTW::GetNTimeBins() const
+    template< typename XFloatType >
+    inline unsigned KTFrequencySpectrumFFTWBase< XFloatType >::GetNTimeBins() const
     {
         return fNTimeBins;
     }
 
-    inline void KTFrequencySpectrumFFTW::SetNTimeBins(unsigned bins)
+    template< typename XFloatType >
+    inline void KTFrequencySpectrumFFTWBase< XFloatType >::SetNTimeBins(unsigned bins)
     {
         fNTimeBins = bins;
         return;
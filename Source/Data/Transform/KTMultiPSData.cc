@@ -9,27 +9,42 @@
 
 #include "KTLogger.hh"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Katydid
 {
     KTLOGGER(datalog, "KTMultiPSData");
 
     KTMultiPSDataCore::KTMultiPSDataCore() :
-            fSpectra()
+            fSpectra(),
+            fSpectrograms()
     {
     }
 
     KTMultiPSDataCore::~KTMultiPSDataCore()
     {
-        while (! fSpectra.empty())
+        for (unsigned iComponent = 0; iComponent < fSpectra.size(); ++iComponent)
         {
-            KTMultiPS* backSpectra = fSpectra.back();
-            for (KTMultiPS::iterator iter = backSpectra->begin(); iter != backSpectra->end(); iter++)
-            {
-                delete *iter;
-            }
-            delete backSpectra;
-            fSpectra.pop_back();
+            DeleteSpectra(iComponent);
+        }
+    }
+
+    void KTMultiPSDataCore::SetSpectra(KTMultiPS* spectra, unsigned component)
+    {
+        if (component >= fSpectra.size()) SetNComponents(component+1);
+        DeleteSpectra(component);
+        fSpectra[component] = spectra;
+        if (spectra == NULL) return;
+
+        // the first spectrum sets the frequency axis of the block
+        for (KTMultiPS::const_iterator iter = spectra->begin(); iter != spectra->end(); ++iter)
+        {
+            if (*iter == NULL) continue;
+            MakeSpectrogram((*iter)->size(), (*iter)->GetRangeMin(), (*iter)->GetRangeMax(), component);
+            break;
         }
+        return;
     }
 
     void KTMultiPSDataCore::SetSpectrum(KTPowerSpectrum* spectrum, unsigned iSpect, unsigned component)
@@ -42,21 +57,125 @@ namespace Katydid
         if (fSpectra[component] == NULL)
         {
             KTDEBUG(datalog, "Pointer to spectra is NULL; adding new spectra with " << iSpect + 1 << "bins");
-            fSpectra[component] = new KTMultiPS(iSpect+1, 0., 1.);
+            fSpectra[component] = new KTMultiPS(NULL, iSpect+1, 0., 1.);
+        }
+
+        KTPowerSpectrum*& entry = (*fSpectra[component])(iSpect);
+        if (entry != spectrum)
+        {
+            delete entry;
+            entry = spectrum;
+        }
+        if (spectrum == NULL)
+        {
+            if (fSpectrograms[component] != NULL)
+            {
+                KTMultiPSBlock::row_view row = fSpectrograms[component]->GetRow(iSpect);
+                std::fill(row.begin(), row.end(), 0.);
+            }
+            return;
         }
-        (*fSpectra[component])(iSpect) = spectrum;
+
+        if (fSpectrograms[component] == NULL)
+        {
+            // adopts spectrum along with any others that were put in the KTMultiPS directly
+            MakeSpectrogram(spectrum->size(), spectrum->GetRangeMin(), spectrum->GetRangeMax(), component);
+            return;
+        }
+        AdoptSpectrum(iSpect, component);
         return;
     }
 
-    void KTMultiPSDataCore::DeleteSpectra(unsigned component)
+    void KTMultiPSDataCore::RotateSpectra(unsigned nSpectra, unsigned component)
+    {
+        if (component >= fSpectra.size() || fSpectra[component] == NULL || fSpectra[component]->empty()) return;
+        KTMultiPS* spectra = fSpectra[component];
+        nSpectra = nSpectra % spectra->size();
+        if (nSpectra == 0) return;
+
+        std::rotate(spectra->begin(), spectra->begin() + nSpectra, spectra->end());
+
+        KTMultiPSBlock* spectrogram = fSpectrograms[component];
+        if (spectrogram == NULL) return;
+        std::rotate(spectrogram->begin(), spectrogram->begin() + nSpectra * spectrogram->GetStride(), spectrogram->end());
+        // each spectrum's values moved with it; point the views at their new rows
+        for (unsigned iSpect = 0; iSpect < spectra->size(); ++iSpect)
+        {
+            if ((*spectra)(iSpect) != NULL) (*spectra)(iSpect)->SetExternalData(spectrogram->GetRow(iSpect).GetData());
+        }
+        return;
+    }
+
+    void KTMultiPSDataCore::SetTimeRange(double startTime, double endTime, unsigned component)
     {
         if (component >= fSpectra.size() || fSpectra[component] == NULL) return;
-        for (KTMultiPS::iterator iter = fSpectra[component]->begin(); iter != fSpectra[component]->end(); ++iter)
+        fSpectra[component]->SetRange(startTime, endTime);
+        if (fSpectrograms[component] != NULL) fSpectrograms[component]->SetRange(1, startTime, endTime);
+        return;
+    }
+
+    void KTMultiPSDataCore::DeleteSpectra(unsigned component)
+    {
+        if (component >= fSpectra.size()) return;
+        if (fSpectra[component] != NULL)
         {
-            delete *iter;
+            // the spectra are deleted before the block that they view
+            for (KTMultiPS::iterator iter = fSpectra[component]->begin(); iter != fSpectra[component]->end(); ++iter)
+            {
+                delete *iter;
+            }
+            delete fSpectra[component];
+            fSpectra[component] = NULL;
+        }
+        delete fSpectrograms[component];
+        fSpectrograms[component] = NULL;
+        return;
+    }
+
+    void KTMultiPSDataCore::ResizeComponents(unsigned components)
+    {
+        unsigned oldSize = fSpectra.size();
+        // if components < oldSize
+        for (unsigned iComponent = components; iComponent < oldSize; ++iComponent)
+        {
+            DeleteSpectra(iComponent);
+        }
+        fSpectra.resize(components, NULL);
+        fSpectrograms.resize(components, NULL);
+        return;
+    }
+
+    void KTMultiPSDataCore::MakeSpectrogram(unsigned nFrequencyBins, double minFrequency, double maxFrequency, unsigned component)
+    {
+        KTMultiPS* spectra = fSpectra[component];
+        delete fSpectrograms[component];
+        fSpectrograms[component] = new KTMultiPSBlock(0., spectra->size(), spectra->GetRangeMin(), spectra->GetRangeMax(), nFrequencyBins, minFrequency, maxFrequency);
+        KTDEBUG(datalog, "Made a spectrogram block with " << spectra->size() << " x " << nFrequencyBins << " bins for component " << component);
+
+        for (unsigned iSpect = 0; iSpect < spectra->size(); ++iSpect)
+        {
+            if ((*spectra)(iSpect) != NULL) AdoptSpectrum(iSpect, component);
+        }
+        return;
+    }
+
+    void KTMultiPSDataCore::AdoptSpectrum(unsigned iSpect, unsigned component)
+    {
+        KTPowerSpectrum*& spectrum = (*fSpectra[component])(iSpect);
+        KTMultiPSBlock::row_view row = fSpectrograms[component]->GetRow(iSpect);
+        if (spectrum->size() != row.size())
+        {
+            KTERROR(datalog, "Spectrum " << iSpect << " has " << spectrum->size() << " bins, but the spectra of component " << component << " have " << row.size() << "; it will be dropped");
+            delete spectrum;
+            spectrum = NULL;
+            std::fill(row.begin(), row.end(), 0.);
+            return;
+        }
+        if (spectrum->GetData() != row.GetData())
+        {
+            memcpy(row.GetData(), spectrum->GetData(), row.size() * sizeof(double));
+            spectrum->SetExternalData(row.GetData());
         }
-        delete fSpectra[component];
-        fSpectra[component] = NULL;
         return;
     }
 
@@ -102,13 +221,14 @@ namespace Katydid
         KTINFO(datalog, "Frequency axis: " << firstPS->size() << " bins; range: " << hist->GetYaxis()->GetXmin() << " - " << hist->GetYaxis()->GetXmax() << " Hz");
         KTINFO(datalog, "Time axis: " << fSpectra[component]->size() << " bins; range: " << hist->GetXaxis()->GetXmin() << " - " << hist->GetXaxis()->GetXmax() << " s");
 
+        const KTMultiPSBlock* spectrogram = fSpectrograms[component];
         for (int iBinX=firstPSBin; iBinX<(int)fSpectra[component]->size(); ++iBinX)
         {
-            KTPowerSpectrum* ps = (*fSpectra[component])(iBinX);
-            if (ps == NULL) continue;
+            if ((*fSpectra[component])(iBinX) == NULL) continue;
+            KTMultiPSBlock::const_row_view row = spectrogram->GetRow(iBinX);
             for (int iBinY=0; iBinY<hist->GetNbinsY(); ++iBinY)
             {
-                hist->SetBinContent(iBinX, iBinY, (*ps)(iBinY));
+                hist->SetBinContent(iBinX, iBinY, row[iBinY]);
             }
         }
 
@@ -138,18 +258,7 @@ namespace Katydid
 
     KTMultiPSData& KTMultiPSData::SetNComponents(unsigned components)
     {
-        unsigned oldSize = fSpectra.size();
-        // if components < oldSize
-        for (unsigned iComponent = components; iComponent < oldSize; ++iComponent)
-        {
-            DeleteSpectra(iComponent);
-        }
-        fSpectra.resize(components);
-        // if components > oldSize
-        for (unsigned iComponent = oldSize; iComponent < components; ++iComponent)
-        {
-            fSpectra[iComponent] = NULL;
-        }
+        ResizeComponents(components);
         return *this;
     }
 
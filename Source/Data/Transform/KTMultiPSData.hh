@@ -21,7 +21,35 @@
 namespace Katydid
 {
     typedef KTPhysicalArray< 1, KTPowerSpectrum* > KTMultiPS;
-
+    /// Contiguous spectrogram: time on axis 1, frequency on axis 2; each power spectrum is a row
+    typedef KTPhysicalArray< 2, double > KTMultiPSBlock;
+
+    /*!
+     @class KTMultiPSDataCore
+     @author N. S. Oblath
+
+     @brief A series of power spectra in time (a spectrogram) for each component
+
+     @details
+     The values of each component are stored in one contiguous block (GetSpectrogram()), with time on axis 1 and frequency on axis 2.
+     Each spectrum is a contiguous row of the block, so algorithms that work on the spectrogram as a whole can use its rows, blocks
+     and strides (see KTPhysicalArray< 2, XDataType >) instead of following a pointer for each spectrum.
+
+     The per-spectrum interface (GetSpectra()) is unchanged: the KTPowerSpectrum objects are views of the rows of the block
+     (see KTPhysicalArray< 1, XDataType >::SetExternalData()), and they hold the per-spectrum metadata (frequency axis, mode, and label).
+     A NULL entry is a time bin that has not been filled; its row in the block is zero.
+
+     Spectra given to SetSpectrum() or SetSpectra() are adopted: their values are copied into the block, and they become views of it.
+     All of the spectra in a component must have the same number of bins; the block is made when the first spectrum is added.
+
+     The spectra are only available as const from outside of the class, so that they stay views of the block:
+     a spectrum that was replaced in the KTMultiPS, resized, or given new storage would no longer be part of the block.
+     To change the spectra:
+     - replace a spectrum with SetSpectrum(), or all of them with SetSpectra();
+     - change values in place through the rows of the block (GetSpectrogram()), which are the values of the spectra;
+     - shift the spectra in time with RotateSpectra(), and change the time axis with SetTimeRange().
+     (The entries of a const KTMultiPS are still KTPowerSpectrum*, since KTMultiPS is shared with other classes; they must not be used to change the spectra.)
+    */
     class KTMultiPSDataCore
     {
         public:
@@ -33,19 +61,39 @@ namespace Katydid
             virtual ~KTMultiPSDataCore();
 
             const KTMultiPS* GetSpectra(unsigned component = 0) const;
-            KTMultiPS* GetSpectra(unsigned component = 0);
+            /// Returns NULL if time bin iSpect has not been filled
+            const KTPowerSpectrum* GetSpectrum(unsigned iSpect, unsigned component = 0) const;
             unsigned GetNComponents() const;
 
+            /// Contiguous block with the values of all of the spectra of a component; NULL until the first spectrum is added
+            const KTMultiPSBlock* GetSpectrogram(unsigned component = 0) const;
+            KTMultiPSBlock* GetSpectrogram(unsigned component = 0);
+
+            /// Takes ownership of spectra and of the spectra in it
             void SetSpectra(KTMultiPS* spectra, unsigned component = 0);
+            /// Takes ownership of spectrum, which replaces (and deletes) the spectrum in time bin iSpect
             void SetSpectrum(KTPowerSpectrum* spectrum, unsigned iSpect, unsigned component = 0);
 
+            /// Moves spectrum i + nSpectra to time bin i, wrapping around at the end (i.e. rotates the spectrogram to earlier times)
+            void RotateSpectra(unsigned nSpectra, unsigned component = 0);
+            /// Sets the time axis of both the KTMultiPS and the block
+            void SetTimeRange(double startTime, double endTime, unsigned component = 0);
+
             void SetNSpectra(unsigned nSpectra);
             virtual KTMultiPSDataCore& SetNComponents(unsigned components) = 0;
 
         protected:
             void DeleteSpectra(unsigned component = 0);
+            /// Resizes the component vectors; used by SetNComponents() in the derived classes
+            void ResizeComponents(unsigned components);
+
+            /// Makes the block for a component, and adopts the spectra that are already in its KTMultiPS
+            void MakeSpectrogram(unsigned nFrequencyBins, double minFrequency, double maxFrequency, unsigned component);
+            /// Copies the values of the spectrum in time bin iSpect into the block, and makes the spectrum a view of that row
+            void AdoptSpectrum(unsigned iSpect, unsigned component);
 
             std::vector< KTMultiPS* > fSpectra;
+            std::vector< KTMultiPSBlock* > fSpectrograms;
 
 #ifdef ROOT_FOUND
         public:
@@ -59,9 +107,9 @@ namespace Katydid
         return fSpectra[component];
     }
 
-    inline KTMultiPS* KTMultiPSDataCore::GetSpectra(unsigned component)
+    inline const KTPowerSpectrum* KTMultiPSDataCore::GetSpectrum(unsigned iSpect, unsigned component) const
     {
-        return fSpectra[component];
+        return (*fSpectra[component])(iSpect);
     }
 
     inline unsigned KTMultiPSDataCore::GetNComponents() const
@@ -69,12 +117,14 @@ namespace Katydid
         return unsigned(fSpectra.size());
     }
 
-    inline void KTMultiPSDataCore::SetSpectra(KTMultiPS* spectra, unsigned component)
+    inline const KTMultiPSBlock* KTMultiPSDataCore::GetSpectrogram(unsigned component) const
+    {
+        return fSpectrograms[component];
+    }
+
+    inline KTMultiPSBlock* KTMultiPSDataCore::GetSpectrogram(unsigned component)
     {
-        if (component >= fSpectra.size()) SetNComponents(component+1);
-        DeleteSpectra(component);
-        fSpectra[component] = spectra;
-        return;
+        return fSpectrograms[component];
     }
 
 
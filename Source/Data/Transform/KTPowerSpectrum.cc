@@ -9,6 +9,8 @@
 
 #include "KTLogger.hh"
 
+#include <utility>
+
 namespace Katydid
 {
 
@@ -48,6 +50,13 @@ namespace Katydid
     {
     }
 
+    KTPowerSpectrum::KTPowerSpectrum(KTPowerSpectrum&& orig) :
+            KTPhysicalArray< 1, double >(std::move(orig)),
+            KTFrequencyDomainArray(orig),
+            fMode(orig.GetMode())
+    {
+    }
+
     KTPowerSpectrum::~KTPowerSpectrum()
     {
     }
@@ -84,6 +93,13 @@ namespace Katydid
         return *this;
     }
 
+    KTPowerSpectrum& KTPowerSpectrum::operator=(KTPowerSpectrum&& rhs)
+    {
+        KTPhysicalArray< 1, double >::operator=(std::move(rhs));
+        std::swap(fMode, rhs.fMode);
+        return *this;
+    }
+
     KTPowerSpectrum& KTPowerSpectrum::Scale(double scale)
     {
         (*this) *= scale;
@@ -32,6 +32,7 @@ namespace Katydid
             KTPowerSpectrum(size_t nBins=1, double rangeMin=0., double rangeMax=1.);
             KTPowerSpectrum(int values[], size_t nBins= 8192, double rangeMin=0., double rangeMax=1600.0);
             KTPowerSpectrum(const KTPowerSpectrum& orig);
+            KTPowerSpectrum(KTPowerSpectrum&& orig);
             virtual ~KTPowerSpectrum();
 
             unsigned GetNFrequencyBins() const;
@@ -50,6 +51,8 @@ namespace Katydid
 
         public:
             KTPowerSpectrum& operator=(const KTPowerSpectrum& rhs);
+            /// Takes rhs's data without copying; rhs is left with this spectrum's old contents
+            KTPowerSpectrum& operator=(KTPowerSpectrum&& rhs);
 
             KTPowerSpectrum& Scale(double scale);
 
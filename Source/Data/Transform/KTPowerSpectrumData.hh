@@ -13,6 +13,7 @@
 #include "KTFrequencySpectrumVarianceData.hh"
 #include "KTPowerSpectrum.hh"
 
+#include <utility>
 #include <vector>
 
 namespace Katydid
@@ -37,6 +38,8 @@ namespace Katydid
             KTFrequencyDomainArray* GetArray(unsigned component = 0);
 
             void SetSpectrum(KTPowerSpectrum* spectrum, unsigned component = 0);
+            /// Takes the contents of spectrum without copying them
+            void SetSpectrum(KTPowerSpectrum&& spectrum, unsigned component = 0);
 
             virtual KTPowerSpectrumDataCore& SetNComponents(unsigned channels) = 0;
 
@@ -107,6 +110,18 @@ namespace Katydid
         return;
     }
 
+    inline void KTPowerSpectrumDataCore::SetSpectrum(KTPowerSpectrum&& spectrum, unsigned component)
+    {
+        if (component < fSpectra.size() && fSpectra[component] != NULL)
+        {
+            // reuse the existing spectrum object; its old buffer goes out with the moved-from spectrum
+            *fSpectra[component] = std::move(spectrum);
+            return;
+        }
+        SetSpectrum(new KTPowerSpectrum(std::move(spectrum)), component);
+        return;
+    }
+
 
 } /* namespace Katydid */
 
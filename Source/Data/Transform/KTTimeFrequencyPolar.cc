@@ -14,6 +14,7 @@
 #include "TH2.h"
 #endif
 
+#include <algorithm>
 #include <sstream>
 
 #ifdef USE_OPENMP
@@ -41,13 +42,7 @@ namespace Katydid
     KTTimeFrequencyPolar::KTTimeFrequencyPolar(complexpolar< double > value, size_t nTimeBins, double timeRangeMin, double timeRangeMax, size_t nFreqBins, double freqRangeMin, double freqRangeMax) :
             KTTimeFrequencyPolar(nTimeBins, timeRangeMin, timeRangeMax, nFreqBins, freqRangeMin, freqRangeMax)
     {
-        for (unsigned xIndex = 0; xIndex < nTimeBins; ++xIndex)
-        {
-            for (unsigned yIndex = 0; yIndex < nFreqBins; ++yIndex)
-            {
-                fData(xIndex, yIndex) = value;
-            }
-        }
+        std::fill(begin(), end(), value);
     }
 
     KTTimeFrequencyPolar::KTTimeFrequencyPolar(const KTTimeFrequencyPolar& orig) :
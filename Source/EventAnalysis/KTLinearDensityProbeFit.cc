@@ -260,10 +260,19 @@ namespace Katydid
 
         double ps_xmin = fullSpectrogram.GetStartTime();
         double ps_xmax = fullSpectrogram.GetEndTime();
-        double ps_ymin = (*fullSpectrogram.GetSpectra())(0)->GetRangeMin();
+        // Time (axis 1) x frequency (axis 2); each spectrum is a contiguous row
+        const KTMultiPSBlock* spectrogram = fullSpectrogram.GetSpectrogram();
+        if (spectrogram == NULL)
+        {
+            KTERROR(evlog, "Spectrogram has no power spectra");
+            return false;
+        }
+
+        double ps_ymin = spectrogram->GetRangeMin(2);
         //     ps_ymax will not be necessary
         double ps_dx   = fullSpectrogram.GetDeltaT();
-        double ps_dy   = (*fullSpectrogram.GetSpectra())(0)->GetFrequencyBinWidth();
+        double ps_dy   = spectrogram->GetBinWidth(2);
+        int nFrequencyBins = spectrogram->size(2);
 
         // We add +1 for the underflow bin
         int xBinStart = floor( (data.GetStartTimeInAcq() - ps_xmin) / ps_dx ) + 1;
@@ -289,50 +298,50 @@ namespace Katydid
         KTSpline* spline = fGVData.GetSpline(trackComponent);
 
         // First we compute the unweighted projection
-        const KTPhysicalArray< 1, KTPowerSpectrum* > spectra = *fullSpectrogram.GetSpectra();
-        vector< double > unweighted(spectra.size());
-        for( KTPhysicalArray< 1, KTPowerSpectrum* >::const_iterator it = spectra.begin(); it != spectra.end(); ++it )
+        int nSpectra = spectrogram->size(1);
+        vector< double > unweighted(nSpectra);
+        for( iSpectrum = 0; iSpectrum < nSpectra; ++iSpectrum )
         {
+            KTMultiPSBlock::const_row_view spectrum = spectrogram->GetRow(iSpectrum);
+
             // Set x value and starting y-bin
             xVal = ps_xmin + (iSpectrum - 1) * ps_dx;
-            yBinStart = (*it)->FindBin( alphaBoundLower + q_fit * xVal );
+            yBinStart = spectrogram->FindBin( 2, alphaBoundLower + q_fit * xVal );
 
             // Unweighted power = sum of raw power spectrum
             unweighted[iSpectrum] = 0;
-            for( int iBin = yBinStart; iBin < yBinStart + yWindow && iBin < (*it)->GetNFrequencyBins(); ++iBin )
+            for( int iBin = yBinStart; iBin < yBinStart + yWindow && iBin < nFrequencyBins; ++iBin )
             {
                 yVal = ps_ymin + ps_dy * (iBin - 1);
 
                 // We reevaluate the spline rather than deal with the appropriate index of power_minus_bkgd
-                unweighted[iSpectrum] += (**it)(iBin) - spline->Evaluate( yVal );
+                unweighted[iSpectrum] += spectrum[iBin] - spline->Evaluate( yVal );
             }
-            ++iSpectrum;
         }
 
         KTDEBUG(evlog, "Computing weighted projection");
 
         // Weighted projection
         double cumulative = 0.;
-        iSpectrum = 0;
-        vector< double > weighted(spectra.size());
-        for( KTPhysicalArray< 1, KTPowerSpectrum* >::const_iterator it = spectra.begin(); it != spectra.end(); ++it )
+        vector< double > weighted(nSpectra);
+        for( iSpectrum = 0; iSpectrum < nSpectra; ++iSpectrum )
         {
+            KTMultiPSBlock::const_row_view spectrum = spectrogram->GetRow(iSpectrum);
             cumulative = 0.;
 
             xVal = ps_xmin + (iSpectrum - 1) * ps_dx;
-            yBinStart = (*it)->FindBin( alphaBoundLower + q_fit * xVal );
+            yBinStart = spectrogram->FindBin( 2, alphaBoundLower + q_fit * xVal );
 
-            for( int iBin = yBinStart; iBin < yBinStart + yWindow && iBin < (*it)->GetNFrequencyBins(); ++iBin )
+            for( int iBin = yBinStart; iBin < yBinStart + yWindow && iBin < nFrequencyBins; ++iBin )
             {
                 yVal = ps_ymin + ps_dy * (iBin - 1);
 
                 // Calculate delta-f using the fit values
                 delta_f = yVal - (q_fit * xVal + newData.GetIntercept(0));
-                cumulative += delta_f * ((**it)(iBin) - spline->Evaluate( yVal )) / unweighted[iSpectrum];
+                cumulative += delta_f * (spectrum[iBin] - spline->Evaluate( yVal )) / unweighted[iSpectrum];
             }
 
             weighted[iSpectrum] = cumulative;
-            ++iSpectrum;
         }
 
         // Discrete Cosine Transform (real -> real) of type I
@@ -21,7 +21,6 @@
 #include <algorithm>
 #include <numeric>
 
-using boost::shared_ptr;
 using std::vector;
 using std::string;
 
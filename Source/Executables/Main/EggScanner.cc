@@ -14,6 +14,7 @@
 #include "KTData.hh"
 #include "KTEggHeader.hh"
 #include "KTEgg1Reader.hh"
+#include "KTEggIndex.hh"
 #include "KTLogger.hh"
 #include "KTSliceHeader.hh"
 
@@ -41,6 +42,7 @@ static Nymph::KTCommandLineOption< bool > sUseEgg3("Egg Scanner", "Use the Egg3
 
 static Nymph::KTCommandLineOption< unsigned > sCLNBins("Egg Scanner", "Size of the slice", "slice-size", 's');
 static Nymph::KTCommandLineOption< bool > sScanRecords("Egg Scanner", "Scan records", "scan-records", 'r');
+static Nymph::KTCommandLineOption< bool > sBuildIndex("Egg Scanner", "Build the time/record index (egg2 and egg3 only)", "index", 'x');
 
 int main(int argc, char** argv)
 {
@@ -99,6 +101,7 @@ int main(int argc, char** argv)
     }
 
     bool scanRecords = clOpts->IsCommandLineOptSet("scan-records");
+    bool buildIndex = clOpts->IsCommandLineOptSet("index");
 
     //**************************
     // Doing-something phase
@@ -138,6 +141,35 @@ int main(int argc, char** argv)
            << "\tFS size (polar): " << fsSizePolar << '\n'
            << "\tMax frequency: " << fsMaxFreq << " Hz");
 
+    if (buildIndex)
+    {
+        // an existing, up-to-date index is reused
+        const KTEggIndex* index = NULL;
+#ifdef USE_MONARCH2
+        KTEgg2Reader* egg2Reader = dynamic_cast< KTEgg2Reader* >(reader);
+        if (egg2Reader != NULL && egg2Reader->LoadIndex(filename)) index = &egg2Reader->GetIndex();
+#endif
+#ifdef USE_MONARCH3
+        KTEgg3Reader* egg3Reader = dynamic_cast< KTEgg3Reader* >(reader);
+        if (egg3Reader != NULL && egg3Reader->LoadIndex()) index = &egg3Reader->GetIndex();
+#endif
+        if (index == NULL)
+        {
+            KTERROR(eggscan, "Unable to build the index");
+        }
+        else
+        {
+            uint64_t nRecords = 0;
+            for (unsigned iEntry = 0; iEntry < index->GetNEntries(); ++iEntry)
+            {
+                nRecords += index->GetEntry(iEntry).fNRecords;
+            }
+            KTPROG(eggscan, "Index:\n"
+                   << "\tAcquisitions: " << index->GetNEntries() << '\n'
+                   << "\tRecords: " << nRecords);
+        }
+    }
+
     if (scanRecords)
     {
         unsigned iSlice = 0;
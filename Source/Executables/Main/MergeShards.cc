@@ -0,0 +1,511 @@
+/*
+ * MergeShards.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *      Combines the output files from the shards of a run (see the "n-shards" and "shard" options of the egg processor)
+ *      into a single file.  The shard files must be given in order.
+ *
+ *      The file type is determined by the output file's extension:
+ *        .root --- Trees are concatenated and histograms are added, as with hadd (requires ROOT)
+ *        .h5   --- Groups are merged recursively.  Datasets with the same name are concatenated along their first dimension,
+ *                  in shard order, if they have the same type and the same extent in the other dimensions; other datasets
+ *                  whose names are already used get the suffix "_shard[n]", with a warning (requires HDF5)
+ *        .json --- Values with the same name are merged: objects are merged member by member, arrays are concatenated in
+ *                  shard order, and identical values (e.g. the egg header) are kept once.  If other values differ between
+ *                  shards, the value from the first shard is kept, with a warning.  Repeated members within a shard
+ *                  (e.g. one per slice) are merged the same way.
+ *
+ *      The slices of each shard are numbered as they are in the whole run (the egg reader starts a shard's numbering at the
+ *      number of slices in the acquisitions before it), so slice numbers continue from one shard to the next, as do times in the run.
+ *
+ *      Usage: bin/MergeShards -o [output file] [shard 0 file] [shard 1 file] ...
+ *
+ *      Command-line options
+ *        -o --- Output file
+ *        -w --- (optional) Overwrite the output file if it already exists
+ */
+
+#include "KTLogger.hh"
+
+#include "rapidjson/document.h"
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/filewritestream.h"
+#include "rapidjson/prettywriter.h"
+
+#ifdef ROOT_FOUND
+#include "TFileMerger.h"
+#endif
+
+#ifdef HDF5_FOUND
+#include "hdf5.h"
+#endif
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+KTLOGGER(mergelog, "MergeShards");
+
+bool MergeROOT(const vector< string >& inputs, const string& output);
+bool MergeHDF5(const vector< string >& inputs, const string& output);
+bool MergeJSON(const vector< string >& inputs, const string& output);
+
+int main(int argc, char** argv)
+{
+    string outputFileName("");
+    bool overwrite = false;
+
+    // parse the command line
+    int arg;
+    extern char *optarg;
+    extern int optind;
+    while ((arg = getopt(argc, argv, "o:w")) != -1)
+        switch (arg)
+        {
+            case 'o':
+                outputFileName = string(optarg);
+                break;
+            case 'w':
+                overwrite = true;
+                break;
+        }
+
+    vector< string > inputFileNames;
+    for (int iArg = optind; iArg < argc; ++iArg)
+    {
+        inputFileNames.push_back(string(argv[iArg]));
+    }
+
+    if (outputFileName.empty())
+    {
+        KTERROR(mergelog, "Please provide an output file name using '-o [filename]'");
+        return -1;
+    }
+    if (inputFileNames.empty())
+    {
+        KTERROR(mergelog, "Please provide the shard files, in order");
+        return -1;
+    }
+    if (! overwrite && boost::filesystem::exists(outputFileName))
+    {
+        KTERROR(mergelog, "Output file <" << outputFileName << "> already exists; use -w to overwrite it");
+        return -1;
+    }
+
+    string extension = boost::filesystem::path(outputFileName).extension().string();
+    KTINFO(mergelog, "Merging " << inputFileNames.size() << " shard files into <" << outputFileName << ">");
+
+    bool success = false;
+    if (extension == ".root")
+    {
+        success = MergeROOT(inputFileNames, outputFileName);
+    }
+    else if (extension == ".h5" || extension == ".hdf5")
+    {
+        success = MergeHDF5(inputFileNames, outputFileName);
+    }
+    else if (extension == ".json")
+    {
+        success = MergeJSON(inputFileNames, outputFileName);
+    }
+    else
+    {
+        KTERROR(mergelog, "Unknown file type <" << extension << ">");
+        return -1;
+    }
+
+    if (! success)
+    {
+        KTERROR(mergelog, "Merging failed");
+        return -1;
+    }
+
+    KTPROG(mergelog, "Shards merged into <" << outputFileName << ">");
+    return 0;
+}
+
+bool MergeROOT(const vector< string >& inputs, const string& output)
+{
+#ifdef ROOT_FOUND
+    TFileMerger merger(false);
+    if (! merger.OutputFile(output.c_str(), "RECREATE"))
+    {
+        KTERROR(mergelog, "Unable to open output file <" << output << ">");
+        return false;
+    }
+    for (vector< string >::const_iterator inputIt = inputs.begin(); inputIt != inputs.end(); ++inputIt)
+    {
+        if (! merger.AddFile(inputIt->c_str()))
+        {
+            KTERROR(mergelog, "Unable to add input file <" << *inputIt << ">");
+            return false;
+        }
+    }
+    return merger.Merge();
+#else
+    KTERROR(mergelog, "ROOT files can only be merged if ROOT is enabled");
+    return false;
+#endif
+}
+
+#ifdef HDF5_FOUND
+namespace
+{
+    struct HDF5CopyContext
+    {
+        hid_t fDest;
+        unsigned fShard;
+        bool fSuccess;
+    };
+
+    H5I_type_t GetHDF5ObjectType(hid_t group, const char* name)
+    {
+        hid_t object = H5Oopen(group, name, H5P_DEFAULT);
+        if (object < 0) return H5I_BADID;
+        H5I_type_t type = H5Iget_type(object);
+        H5Oclose(object);
+        return type;
+    }
+
+    // copies one attribute of an object to the destination object (passed through data)
+    herr_t CopyHDF5Attribute(hid_t srcObject, const char* name, const H5A_info_t*, void* data)
+    {
+        hid_t destObject = *static_cast< hid_t* >(data);
+        hid_t srcAttr = H5Aopen(srcObject, name, H5P_DEFAULT);
+        hid_t fileType = H5Aget_type(srcAttr);
+        hid_t memType = H5Tget_native_type(fileType, H5T_DIR_DEFAULT);
+        hid_t space = H5Aget_space(srcAttr);
+
+        vector< char > buffer(H5Tget_size(memType) * std::max< hssize_t >(H5Sget_simple_extent_npoints(space), 1));
+        herr_t status = H5Aread(srcAttr, memType, buffer.data());
+        if (status >= 0)
+        {
+            hid_t destAttr = H5Acreate2(destObject, name, fileType, space, H5P_DEFAULT, H5P_DEFAULT);
+            status = destAttr < 0 ? -1 : H5Awrite(destAttr, memType, buffer.data());
+            if (destAttr >= 0) H5Aclose(destAttr);
+            H5Dvlen_reclaim(memType, space, H5P_DEFAULT, buffer.data());
+        }
+
+        H5Sclose(space);
+        H5Tclose(memType);
+        H5Tclose(fileType);
+        H5Aclose(srcAttr);
+        return status < 0 ? -1 : 0;
+    }
+
+    // reads a block of rows from the source dataset and writes them to the destination dataset, starting at row destRow
+    bool CopyHDF5Rows(hid_t srcDataset, hid_t destDataset, hsize_t destRow)
+    {
+        hid_t fileType = H5Dget_type(srcDataset);
+        hid_t memType = H5Tget_native_type(fileType, H5T_DIR_DEFAULT);
+        hid_t srcSpace = H5Dget_space(srcDataset);
+        int rank = H5Sget_simple_extent_ndims(srcSpace);
+        vector< hsize_t > dims(rank);
+        H5Sget_simple_extent_dims(srcSpace, dims.data(), NULL);
+
+        vector< char > buffer(H5Tget_size(memType) * std::max< hssize_t >(H5Sget_simple_extent_npoints(srcSpace), 1));
+        bool success = H5Dread(srcDataset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, buffer.data()) >= 0;
+        if (success && H5Sget_simple_extent_npoints(srcSpace) > 0)
+        {
+            hid_t destSpace = H5Dget_space(destDataset);
+            vector< hsize_t > start(rank, 0);
+            start[0] = destRow;
+            H5Sselect_hyperslab(destSpace, H5S_SELECT_SET, start.data(), NULL, dims.data(), NULL);
+            hid_t memSpace = H5Screate_simple(rank, dims.data(), NULL);
+            success = H5Dwrite(destDataset, memType, memSpace, destSpace, H5P_DEFAULT, buffer.data()) >= 0;
+            H5Sclose(memSpace);
+            H5Sclose(destSpace);
+        }
+        if (H5Sget_simple_extent_npoints(srcSpace) > 0) H5Dvlen_reclaim(memType, srcSpace, H5P_DEFAULT, buffer.data());
+
+        H5Sclose(srcSpace);
+        H5Tclose(memType);
+        H5Tclose(fileType);
+        return success;
+    }
+
+    // copies a dataset into a new dataset that can be extended along its first dimension
+    bool CopyHDF5Dataset(hid_t srcGroup, const char* name, hid_t destGroup)
+    {
+        hid_t srcDataset = H5Dopen2(srcGroup, name, H5P_DEFAULT);
+        hid_t srcSpace = H5Dget_space(srcDataset);
+        int rank = H5Sget_simple_extent_ndims(srcSpace);
+        if (rank < 1)
+        {
+            // scalars can't be extended, so they're copied as they are
+            H5Sclose(srcSpace);
+            H5Dclose(srcDataset);
+            return H5Ocopy(srcGroup, name, destGroup, name, H5P_DEFAULT, H5P_DEFAULT) >= 0;
+        }
+
+        vector< hsize_t > dims(rank), maxDims(rank), chunkDims(rank);
+        H5Sget_simple_extent_dims(srcSpace, dims.data(), NULL);
+        for (int iDim = 0; iDim < rank; ++iDim)
+        {
+            maxDims[iDim] = dims[iDim];
+            chunkDims[iDim] = std::max< hsize_t >(dims[iDim], 1);
+        }
+        maxDims[0] = H5S_UNLIMITED;
+        chunkDims[0] = std::min< hsize_t >(chunkDims[0], 1024);
+
+        hid_t fileType = H5Dget_type(srcDataset);
+        hid_t destSpace = H5Screate_simple(rank, dims.data(), maxDims.data());
+        hid_t createProps = H5Pcreate(H5P_DATASET_CREATE);
+        H5Pset_chunk(createProps, rank, chunkDims.data());
+        hid_t destDataset = H5Dcreate2(destGroup, name, fileType, destSpace, H5P_DEFAULT, createProps, H5P_DEFAULT);
+
+        bool success = destDataset >= 0 && CopyHDF5Rows(srcDataset, destDataset, 0);
+        if (success) success = H5Aiterate2(srcDataset, H5_INDEX_NAME, H5_ITER_INC, NULL, CopyHDF5Attribute, &destDataset) >= 0;
+
+        if (destDataset >= 0) H5Dclose(destDataset);
+        H5Pclose(createProps);
+        H5Sclose(destSpace);
+        H5Tclose(fileType);
+        H5Sclose(srcSpace);
+        H5Dclose(srcDataset);
+        return success;
+    }
+
+    // appends a dataset to an existing one along the first dimension; returns false (without changing anything)
+    // if the types or the other dimensions don't match, or if the existing dataset can't be extended
+    bool AppendHDF5Dataset(hid_t srcGroup, const char* name, hid_t destGroup, bool& appended)
+    {
+        appended = false;
+        hid_t srcDataset = H5Dopen2(srcGroup, name, H5P_DEFAULT);
+        hid_t destDataset = H5Dopen2(destGroup, name, H5P_DEFAULT);
+        hid_t srcType = H5Dget_type(srcDataset);
+        hid_t destType = H5Dget_type(destDataset);
+        hid_t srcSpace = H5Dget_space(srcDataset);
+        hid_t destSpace = H5Dget_space(destDataset);
+
+        int rank = H5Sget_simple_extent_ndims(srcSpace);
+        bool matches = H5Tequal(srcType, destType) > 0 && rank > 0 && rank == H5Sget_simple_extent_ndims(destSpace);
+        vector< hsize_t > srcDims(std::max(rank, 1)), destDims(std::max(rank, 1)), destMaxDims(std::max(rank, 1));
+        if (matches)
+        {
+            H5Sget_simple_extent_dims(srcSpace, srcDims.data(), NULL);
+            H5Sget_simple_extent_dims(destSpace, destDims.data(), destMaxDims.data());
+            matches = destMaxDims[0] == H5S_UNLIMITED;
+            for (int iDim = 1; iDim < rank && matches; ++iDim)
+            {
+                matches = srcDims[iDim] == destDims[iDim];
+            }
+        }
+
+        bool success = true;
+        if (matches)
+        {
+            hsize_t destRow = destDims[0];
+            destDims[0] += srcDims[0];
+            success = H5Dset_extent(destDataset, destDims.data()) >= 0 && CopyHDF5Rows(srcDataset, destDataset, destRow);
+            appended = true;
+        }
+
+        H5Sclose(destSpace);
+        H5Sclose(srcSpace);
+        H5Tclose(destType);
+        H5Tclose(srcType);
+        H5Dclose(destDataset);
+        H5Dclose(srcDataset);
+        return success;
+    }
+
+    // merges one object into the destination group
+    herr_t CopyHDF5Object(hid_t srcGroup, const char* name, const H5L_info_t*, void* data)
+    {
+        HDF5CopyContext* context = static_cast< HDF5CopyContext* >(data);
+
+        H5I_type_t type = GetHDF5ObjectType(srcGroup, name);
+        if (type == H5I_BADID)
+        {
+            context->fSuccess = false;
+            return -1;
+        }
+
+        bool nameUsed = H5Lexists(context->fDest, name, H5P_DEFAULT) > 0;
+        if (type == H5I_GROUP && (! nameUsed || GetHDF5ObjectType(context->fDest, name) == H5I_GROUP))
+        {
+            // merge into the existing group, or a new one, so that the datasets in it are made extendable
+            hid_t srcSubGroup = H5Gopen2(srcGroup, name, H5P_DEFAULT);
+            hid_t destSubGroup = -1;
+            if (nameUsed)
+            {
+                destSubGroup = H5Gopen2(context->fDest, name, H5P_DEFAULT);
+            }
+            else
+            {
+                destSubGroup = H5Gcreate2(context->fDest, name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+                if (destSubGroup >= 0) H5Aiterate2(srcSubGroup, H5_INDEX_NAME, H5_ITER_INC, NULL, CopyHDF5Attribute, &destSubGroup);
+            }
+            if (destSubGroup < 0)
+            {
+                KTERROR(mergelog, "Unable to create group <" << name << ">");
+                H5Gclose(srcSubGroup);
+                context->fSuccess = false;
+                return -1;
+            }
+            HDF5CopyContext subContext = {destSubGroup, context->fShard, true};
+            H5Literate(srcSubGroup, H5_INDEX_NAME, H5_ITER_INC, NULL, CopyHDF5Object, &subContext);
+            H5Gclose(destSubGroup);
+            H5Gclose(srcSubGroup);
+            if (! subContext.fSuccess) context->fSuccess = false;
+            return subContext.fSuccess ? 0 : -1;
+        }
+
+        bool success = true;
+        if (type == H5I_DATASET && ! nameUsed)
+        {
+            success = CopyHDF5Dataset(srcGroup, name, context->fDest);
+        }
+        else if (type == H5I_DATASET && GetHDF5ObjectType(context->fDest, name) == H5I_DATASET)
+        {
+            bool appended = false;
+            success = AppendHDF5Dataset(srcGroup, name, context->fDest, appended);
+            if (success && ! appended)
+            {
+                string destName = string(name) + "_shard" + std::to_string(context->fShard);
+                KTWARN(mergelog, "Dataset <" << name << "> from shard " << context->fShard << " doesn't match the dataset from the earlier shards; it's copied to <" << destName << ">");
+                success = H5Ocopy(srcGroup, name, context->fDest, destName.c_str(), H5P_DEFAULT, H5P_DEFAULT) >= 0;
+            }
+        }
+        else
+        {
+            string destName(name);
+            if (nameUsed)
+            {
+                destName += "_shard" + std::to_string(context->fShard);
+                KTWARN(mergelog, "Object <" << name << "> from shard " << context->fShard << " can't be merged; it's copied to <" << destName << ">");
+            }
+            success = H5Ocopy(srcGroup, name, context->fDest, destName.c_str(), H5P_DEFAULT, H5P_DEFAULT) >= 0;
+        }
+
+        if (! success)
+        {
+            KTERROR(mergelog, "Unable to merge <" << name << "> from shard " << context->fShard);
+            context->fSuccess = false;
+            return -1;
+        }
+        return 0;
+    }
+}
+#endif
+
+bool MergeHDF5(const vector< string >& inputs, const string& output)
+{
+#ifdef HDF5_FOUND
+    hid_t outFile = H5Fcreate(output.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (outFile < 0)
+    {
+        KTERROR(mergelog, "Unable to open output file <" << output << ">");
+        return false;
+    }
+
+    bool success = true;
+    for (unsigned iShard = 0; iShard < inputs.size() && success; ++iShard)
+    {
+        hid_t inFile = H5Fopen(inputs[iShard].c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+        if (inFile < 0)
+        {
+            KTERROR(mergelog, "Unable to open input file <" << inputs[iShard] << ">");
+            success = false;
+            break;
+        }
+        HDF5CopyContext context = {outFile, iShard, true};
+        H5Literate(inFile, H5_INDEX_NAME, H5_ITER_INC, NULL, CopyHDF5Object, &context);
+        success = context.fSuccess;
+        H5Fclose(inFile);
+    }
+
+    H5Fclose(outFile);
+    return success;
+#else
+    KTERROR(mergelog, "HDF5 files can only be merged if HDF5 is enabled");
+    return false;
+#endif
+}
+
+namespace
+{
+    // merges src into dest; path is used to identify the value in warnings
+    void MergeJSONValue(rapidjson::Value& dest, const rapidjson::Value& src, rapidjson::Document::AllocatorType& allocator, const string& path)
+    {
+        if (dest.IsObject() && src.IsObject())
+        {
+            for (rapidjson::Value::ConstMemberIterator memberIt = src.MemberBegin(); memberIt != src.MemberEnd(); ++memberIt)
+            {
+                rapidjson::Value::MemberIterator destIt = dest.FindMember(memberIt->name);
+                if (destIt == dest.MemberEnd())
+                {
+                    rapidjson::Value name(memberIt->name, allocator);
+                    rapidjson::Value value(memberIt->value, allocator);
+                    dest.AddMember(name, value, allocator);
+                }
+                else
+                {
+                    MergeJSONValue(destIt->value, memberIt->value, allocator, path + "/" + memberIt->name.GetString());
+                }
+            }
+        }
+        else if (dest.IsArray() && src.IsArray())
+        {
+            for (rapidjson::Value::ConstValueIterator elementIt = src.Begin(); elementIt != src.End(); ++elementIt)
+            {
+                rapidjson::Value element(*elementIt, allocator);
+                dest.PushBack(element, allocator);
+            }
+        }
+        else if (dest != src)
+        {
+            KTWARN(mergelog, "Value of <" << path << "> differs between shards; the first value is kept");
+        }
+        return;
+    }
+}
+
+bool MergeJSON(const vector< string >& inputs, const string& output)
+{
+    char buffer[ 65536 ];
+
+    rapidjson::Document merged;
+    merged.SetObject();
+    for (vector< string >::const_iterator inputIt = inputs.begin(); inputIt != inputs.end(); ++inputIt)
+    {
+        FILE* inFile = fopen(inputIt->c_str(), "r");
+        if (inFile == NULL)
+        {
+            KTERROR(mergelog, "Unable to open input file <" << *inputIt << ">");
+            return false;
+        }
+        rapidjson::FileReadStream inStream(inFile, buffer, sizeof(buffer));
+        rapidjson::Document shard;
+        shard.ParseStream(inStream);
+        fclose(inFile);
+        if (shard.HasParseError() || ! shard.IsObject())
+        {
+            KTERROR(mergelog, "Unable to parse input file <" << *inputIt << ">");
+            return false;
+        }
+
+        MergeJSONValue(merged, shard, merged.GetAllocator(), "");
+    }
+
+    FILE* outFile = fopen(output.c_str(), "w");
+    if (outFile == NULL)
+    {
+        KTERROR(mergelog, "Unable to open output file <" << output << ">");
+        return false;
+    }
+    rapidjson::FileWriteStream outStream(outFile, buffer, sizeof(buffer));
+    rapidjson::PrettyWriter< rapidjson::FileWriteStream > writer(outStream);
+    merged.Accept(writer);
+    fclose(outFile);
+    return true;
+}
@@ -0,0 +1,380 @@
+/*
+ * TuneFFTWWisdom.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *      Finds the fastest FFTW plans for the transforms used in production, and stores them in a single wisdom file.
+ *      The FFT processors (forward-fftw, reverse-fftw, etc.) read the default wisdom file when they are initialized,
+ *      so if the tool's output is the default file (see KTFFTWPlanCache::GetDefaultWisdomFilename()), jobs start with the tuned plans
+ *      and without spending time on planning.
+ *
+ *      For each combination of size, kind and number of transforms, a plan is made with each rigor flag, from ESTIMATE up to
+ *      the maximum rigor, and the execution times of the plans are compared.  The wisdom of the fastest MEASURE-or-higher plan is kept;
+ *      since FFTW uses wisdom for plans of the same or lower rigor, processors using ESTIMATE or MEASURE also use it.
+ *      The plans are made with the same flags as the processors use; wisdom is specific to the number of threads,
+ *      so it should be generated for each "n-threads" setting in use (i.e. once per value of -t).
+ *
+ *      Unless -c is given, wisdom already in the output file is kept (new wisdom takes precedence, but
+ *      an existing entry for the same transform at a higher rigor can shadow it; use -c to tune from scratch).
+ *      The file is written atomically, and is then locked (made read-only), so that the processors read it
+ *      but do not replace it with wisdom from their own planning.
+ *
+ *      Usage: bin/TuneFFTWWisdom -s [sizes] [options]
+ *
+ *      Command-line options
+ *        -s --- Comma-separated list of transform sizes (the number of time bins in a slice)
+ *        -k --- (optional) Comma-separated list of transform kinds (default: r2c,c2c):
+ *                 r2c    --- forward, from a real time series (transform state r2c)
+ *                 c2c    --- forward, from a complex time series (transform state c2c)
+ *                 rasc2c --- forward, from a real time series treated as complex (transform state rasc2c)
+ *                 c2r    --- reverse, to a real time series
+ *                 rc2c   --- reverse, to a complex time series
+ *        -b --- (optional) Comma-separated list of numbers of transforms per batch (default: 1);
+ *               batches of more than 1 transform (as used by the batched forward FFT) are only tuned for the forward kinds
+ *        -r --- (optional) Maximum rigor: MEASURE, PATIENT (default) or EXHAUSTIVE
+ *        -n --- (optional) Number of times each plan is executed for timing (default: 100)
+ *        -t --- (optional) Number of threads per FFT, as in the processors' "n-threads" option (default: the FFTW_NTHREADS build setting)
+ *        -f --- (optional) Tune single-precision plans; the wisdom is written to [output file].float
+ *               (only available if Katydid was built with single-precision FFTW)
+ *        -o --- (optional) Output wisdom file (default: the processors' default wisdom file)
+ *        -c --- (optional) Do not keep the wisdom already in the output file
+ *        -w --- (optional) Overwrite the output file if it is locked
+ *        -u --- (optional) Leave the output file unlocked
+ */
+
+#include "KTFFTWPlanCache.hh"
+#include "KTFFTWTraits.hh"
+#include "KTLogger.hh"
+
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+using namespace Katydid;
+
+KTLOGGER(tunelog, "TuneFFTWWisdom");
+
+struct Transform
+{
+    string fName;
+    KTFFTWPlanCache::Kind fKind;
+    int fDirection;
+    unsigned fExtraFlags;
+    unsigned fSize;
+    unsigned fHowMany;
+    unsigned fBestRigor;
+};
+
+bool ParseList(const string& list, vector< string >& items);
+bool AddTransforms(const string& kind, unsigned size, unsigned howMany, vector< Transform >& transforms);
+template< typename XFloatType >
+double TimeExecution(typename KTFFTWTraits< XFloatType >::plan_type plan, const Transform& transform, unsigned nIterations);
+
+int main(int argc, char** argv)
+{
+    string sizeList("");
+    string kindList("r2c,c2c");
+    string batchList("1");
+    string maxRigorName("PATIENT");
+    unsigned nIterations = 100;
+    unsigned nThreads = KTFFTWPlanCache::GetDefaultNThreads();
+    bool singlePrecision = false;
+    string outputFileName(KTFFTWPlanCache::GetDefaultWisdomFilename());
+    bool clean = false;
+    bool overwrite = false;
+    bool lock = true;
+
+    // parse the command line
+    int arg;
+    extern char *optarg;
+    while ((arg = getopt(argc, argv, "s:k:b:r:n:t:fo:cwu")) != -1)
+        switch (arg)
+        {
+            case 's':
+                sizeList = string(optarg);
+                break;
+            case 'k':
+                kindList = string(optarg);
+                break;
+            case 'b':
+                batchList = string(optarg);
+                break;
+            case 'r':
+                maxRigorName = string(optarg);
+                break;
+            case 'n':
+                nIterations = strtoul(optarg, NULL, 10);
+                break;
+            case 't':
+                nThreads = strtoul(optarg, NULL, 10);
+                break;
+            case 'f':
+#ifdef FFTWF_FOUND
+                singlePrecision = true;
+                break;
+#else
+                KTERROR(tunelog, "Single-precision plans are not available; Katydid was built without single-precision FFTW");
+                return -1;
+#endif
+            case 'o':
+                outputFileName = string(optarg);
+                break;
+            case 'c':
+                clean = true;
+                break;
+            case 'w':
+                overwrite = true;
+                break;
+            case 'u':
+                lock = false;
+                break;
+        }
+
+    vector< string > sizeItems, kindItems, batchItems;
+    if (! ParseList(sizeList, sizeItems) || ! ParseList(kindList, kindItems) || ! ParseList(batchList, batchItems))
+    {
+        KTERROR(tunelog, "Please provide the transform sizes using '-s [size],[size],...'");
+        return -1;
+    }
+    if (nIterations == 0)
+    {
+        KTERROR(tunelog, "The number of iterations must be positive");
+        return -1;
+    }
+
+    vector< unsigned > rigors;
+    vector< string > rigorNames;
+    rigors.push_back(FFTW_ESTIMATE);
+    rigorNames.push_back("ESTIMATE");
+    rigors.push_back(FFTW_MEASURE);
+    rigorNames.push_back("MEASURE");
+    if (maxRigorName == "PATIENT" || maxRigorName == "EXHAUSTIVE")
+    {
+        rigors.push_back(FFTW_PATIENT);
+        rigorNames.push_back("PATIENT");
+    }
+    if (maxRigorName == "EXHAUSTIVE")
+    {
+        rigors.push_back(FFTW_EXHAUSTIVE);
+        rigorNames.push_back("EXHAUSTIVE");
+    }
+    else if (maxRigorName != "MEASURE" && maxRigorName != "PATIENT")
+    {
+        KTERROR(tunelog, "Invalid maximum rigor <" << maxRigorName << ">; options are MEASURE, PATIENT and EXHAUSTIVE");
+        return -1;
+    }
+
+    vector< Transform > transforms;
+    for (vector< string >::const_iterator sizeIt = sizeItems.begin(); sizeIt != sizeItems.end(); ++sizeIt)
+    {
+        unsigned size = strtoul(sizeIt->c_str(), NULL, 10);
+        for (vector< string >::const_iterator batchIt = batchItems.begin(); batchIt != batchItems.end(); ++batchIt)
+        {
+            unsigned howMany = strtoul(batchIt->c_str(), NULL, 10);
+            if (size == 0 || howMany == 0)
+            {
+                KTERROR(tunelog, "Invalid size <" << *sizeIt << "> or batch size <" << *batchIt << ">");
+                return -1;
+            }
+            for (vector< string >::const_iterator kindIt = kindItems.begin(); kindIt != kindItems.end(); ++kindIt)
+            {
+                if (! AddTransforms(*kindIt, size, howMany, transforms)) return -1;
+            }
+        }
+    }
+
+#ifdef FFTWF_FOUND
+    string wisdomFileName(outputFileName + (singlePrecision ? KTFFTWTraits< float >::WisdomSuffix() : KTFFTWTraits< double >::WisdomSuffix()));
+#else
+    string wisdomFileName(outputFileName + KTFFTWTraits< double >::WisdomSuffix());
+#endif
+    bool fileExists = boost::filesystem::exists(wisdomFileName);
+    if (KTFFTWPlanCache::GetWisdomIsLocked(wisdomFileName))
+    {
+        if (! overwrite)
+        {
+            KTERROR(tunelog, "Wisdom file <" << wisdomFileName << "> is locked; use -w to overwrite it");
+            return -1;
+        }
+        chmod(wisdomFileName.c_str(), S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    }
+
+    if (KTFFTWPlanCache::GetValidNThreads(nThreads) != nThreads)
+    {
+        KTWARN(tunelog, nThreads << " threads were requested; plans will use " << KTFFTWPlanCache::GetValidNThreads(nThreads));
+        nThreads = KTFFTWPlanCache::GetValidNThreads(nThreads);
+    }
+    KTINFO(tunelog, "Planning for " << nThreads << " thread(s)");
+
+    KTFFTWPlanCache* planCache = KTFFTWPlanCache::get_instance();
+
+    // Tuning starts without wisdom, so that each rigor is actually planned
+    planCache->ForgetWisdom(singlePrecision);
+    KTINFO(tunelog, "Tuning " << transforms.size() << " transform(s) with up to " << maxRigorName << " rigor");
+    for (vector< Transform >::iterator tfIt = transforms.begin(); tfIt != transforms.end(); ++tfIt)
+    {
+        double bestTime = -1.;
+        for (unsigned iRigor = 0; iRigor < rigors.size(); ++iRigor)
+        {
+            unsigned flags = rigors[iRigor] | tfIt->fExtraFlags;
+            double execTime = 0.;
+            chrono::steady_clock::time_point planStart = chrono::steady_clock::now();
+#ifdef FFTWF_FOUND
+            if (singlePrecision)
+            {
+                fftwf_plan plan = planCache->AcquirePlanF(tfIt->fKind, tfIt->fDirection, tfIt->fSize, flags, tfIt->fHowMany, nThreads);
+                if (plan == NULL) return -1;
+                execTime = TimeExecution< float >(plan, *tfIt, nIterations);
+                planCache->ReleasePlanF(plan);
+            }
+            else
+#endif
+            {
+                fftw_plan plan = planCache->AcquirePlan(tfIt->fKind, tfIt->fDirection, tfIt->fSize, flags, tfIt->fHowMany, nThreads);
+                if (plan == NULL) return -1;
+                execTime = TimeExecution< double >(plan, *tfIt, nIterations);
+                planCache->ReleasePlan(plan);
+            }
+            double totalTime = chrono::duration< double >(chrono::steady_clock::now() - planStart).count();
+
+            KTINFO(tunelog, tfIt->fName << " (size " << tfIt->fSize << " x " << tfIt->fHowMany << ") " << rigorNames[iRigor] << ": "
+                    << execTime * 1.e6 << " us per transform; planned and timed in " << totalTime << " s");
+
+            // ESTIMATE plans don't produce wisdom
+            if (rigors[iRigor] != FFTW_ESTIMATE && (bestTime < 0. || execTime < bestTime))
+            {
+                bestTime = execTime;
+                tfIt->fBestRigor = iRigor;
+            }
+        }
+        KTPROG(tunelog, tfIt->fName << " (size " << tfIt->fSize << " x " << tfIt->fHowMany << "): " << rigorNames[tfIt->fBestRigor]
+                << " is fastest, at " << bestTime * 1.e6 << " us per transform");
+    }
+
+    // The wisdom is rebuilt with only the fastest plan for each transform
+    planCache->ForgetWisdom(singlePrecision);
+    if (! clean && fileExists && ! planCache->ImportWisdom(wisdomFileName, singlePrecision))
+    {
+        KTWARN(tunelog, "Unable to read the existing wisdom from <" << wisdomFileName << ">");
+    }
+    for (vector< Transform >::const_iterator tfIt = transforms.begin(); tfIt != transforms.end(); ++tfIt)
+    {
+        unsigned flags = rigors[tfIt->fBestRigor] | tfIt->fExtraFlags;
+#ifdef FFTWF_FOUND
+        if (singlePrecision)
+        {
+            planCache->ReleasePlanF(planCache->AcquirePlanF(tfIt->fKind, tfIt->fDirection, tfIt->fSize, flags, tfIt->fHowMany, nThreads));
+        }
+        else
+#endif
+        {
+            planCache->ReleasePlan(planCache->AcquirePlan(tfIt->fKind, tfIt->fDirection, tfIt->fSize, flags, tfIt->fHowMany, nThreads));
+        }
+    }
+
+    if (! planCache->ExportWisdom(wisdomFileName, singlePrecision))
+    {
+        KTERROR(tunelog, "Unable to write wisdom to <" << wisdomFileName << ">");
+        return -1;
+    }
+    if (lock && chmod(wisdomFileName.c_str(), S_IRUSR | S_IRGRP | S_IROTH) != 0)
+    {
+        KTWARN(tunelog, "Unable to lock wisdom file <" << wisdomFileName << ">");
+    }
+
+    KTPROG(tunelog, "Wisdom for " << transforms.size() << " transform(s) written to <" << wisdomFileName << ">" << (lock ? " (locked)" : ""));
+    return 0;
+}
+
+bool ParseList(const string& list, vector< string >& items)
+{
+    stringstream listStream(list);
+    string item;
+    while (getline(listStream, item, ','))
+    {
+        if (! item.empty()) items.push_back(item);
+    }
+    return ! items.empty();
+}
+
+bool AddTransforms(const string& kind, unsigned size, unsigned howMany, vector< Transform >& transforms)
+{
+    // The flags match those used by KTForwardFFTW and KTReverseFFTW;
+    // batched transforms stage their input, so they don't use FFTW_PRESERVE_INPUT
+    Transform transform = {kind, KTFFTWPlanCache::kC2C, FFTW_FORWARD, 0, size, howMany, 1};
+    if (kind == "r2c")
+    {
+        transform.fKind = KTFFTWPlanCache::kR2C;
+    }
+    else if (kind == "c2c")
+    {
+        if (howMany == 1) transform.fExtraFlags = FFTW_PRESERVE_INPUT;
+    }
+    else if (kind == "rasc2c")
+    {
+    }
+    else if (kind == "c2r" || kind == "rc2c")
+    {
+        if (howMany != 1)
+        {
+            KTDEBUG(tunelog, "Skipping " << kind << " with " << howMany << " transforms per batch; reverse transforms are not batched");
+            return true;
+        }
+        transform.fKind = kind == "c2r" ? KTFFTWPlanCache::kC2R : KTFFTWPlanCache::kC2C;
+        transform.fDirection = FFTW_BACKWARD;
+        transform.fExtraFlags = FFTW_PRESERVE_INPUT;
+    }
+    else
+    {
+        KTERROR(tunelog, "Unknown transform kind <" << kind << ">; options are r2c, c2c, rasc2c, c2r and rc2c");
+        return false;
+    }
+    transforms.push_back(transform);
+    return true;
+}
+
+template< typename XFloatType >
+double TimeExecution(typename KTFFTWTraits< XFloatType >::plan_type plan, const Transform& transform, unsigned nIterations)
+{
+    typedef KTFFTWTraits< XFloatType > traits;
+    typedef typename traits::real_type real_type;
+    typedef typename traits::complex_type complex_type;
+
+    unsigned nReal = transform.fSize * transform.fHowMany;
+    unsigned nComplex = (transform.fKind == KTFFTWPlanCache::kC2C ? transform.fSize : transform.fSize / 2 + 1) * transform.fHowMany;
+    real_type* rArray = (real_type*) traits::Malloc(sizeof(real_type) * nReal);
+    complex_type* cInArray = (complex_type*) traits::Malloc(sizeof(complex_type) * nComplex);
+    complex_type* cOutArray = (complex_type*) traits::Malloc(sizeof(complex_type) * nComplex);
+    for (unsigned iBin = 0; iBin < nReal; ++iBin)
+    {
+        rArray[iBin] = cos(0.1 * iBin);
+    }
+    for (unsigned iBin = 0; iBin < nComplex; ++iBin)
+    {
+        cInArray[iBin][0] = cos(0.1 * iBin);
+        cInArray[iBin][1] = sin(0.1 * iBin);
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (unsigned iIteration = 0; iIteration < nIterations; ++iIteration)
+    {
+        if (transform.fKind == KTFFTWPlanCache::kR2C) traits::ExecuteDFTR2C(plan, rArray, cOutArray);
+        else if (transform.fKind == KTFFTWPlanCache::kC2R) traits::ExecuteDFTC2R(plan, cInArray, rArray);
+        else traits::ExecuteDFT(plan, cInArray, cOutArray);
+    }
+    double elapsed = chrono::duration< double >(chrono::steady_clock::now() - start).count();
+
+    traits::Free(rArray);
+    traits::Free(cInArray);
+    traits::Free(cOutArray);
+    return elapsed / double(nIterations * transform.fHowMany);
+}
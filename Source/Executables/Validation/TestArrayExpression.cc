@@ -0,0 +1,211 @@
+/*
+ * TestArrayExpression.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestArrayExpression
+ *
+ *  Purpose: Test the element-wise expressions on 1-D physical arrays (KTArrayExpression).
+ *  Expressions on double and float arrays use the SIMD packs that Katydid was compiled for (AVX, SSE2, or none),
+ *  and int arrays use the generic one-value packs; for each, the sizes include the empty array, arrays shorter than a pack,
+ *  and arrays with a partial pack at the end.  The results are compared with a bin-by-bin calculation.
+ *  Also tested: expressions that write to one of their inputs, the axis of an array made from an expression,
+ *  the handling of arrays of different sizes, and the printing of an expression.
+ */
+
+#include "KTPhysicalArray.hh"
+
+#include "KTLogger.hh"
+
+#include <cmath>
+#include <sstream>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestArrayExpression");
+
+template< typename XDataType >
+unsigned TestExpressions(const char* typeName, unsigned size, double tolerance);
+
+template< typename XDataType >
+unsigned CompareBins(const char* typeName, const char* exprName, const KTPhysicalArray< 1, XDataType >& result, const XDataType* expected, unsigned size, double tolerance);
+
+int main()
+{
+    unsigned nFailures = 0;
+
+    KTINFO(testlog, "Packs hold " << KTSIMD< double >::sWidth << " double(s), " << KTSIMD< float >::sWidth << " float(s), and " << KTSIMD< int >::sWidth << " int(s)");
+
+    //**************
+    // Values
+    //**************
+    KTINFO(testlog, "Testing the values of expressions");
+
+    const unsigned sizes[] = {0, 1, 7, 9, 64, 67};
+    for (unsigned iSize = 0; iSize < 6; ++iSize)
+    {
+        nFailures += TestExpressions< double >("double", sizes[iSize], 1.e-12);
+        nFailures += TestExpressions< float >("float", sizes[iSize], 1.e-5);
+        nFailures += TestExpressions< int >("int", sizes[iSize], 0.);
+    }
+
+    //**************
+    // Axes
+    //**************
+    KTINFO(testlog, "Testing the axis of an array made from an expression");
+
+    KTPhysicalArray< 1, double > a(1., 10, -5., 5.);
+    a.SetAxisLabel("Frequency (Hz)");
+    KTPhysicalArray< 1, double > b(2., 10, 100., 200.);
+
+    KTPhysicalArray< 1, double > sum = a + b;
+    KTPhysicalArray< 1, double > scaled = 2. * b;
+    KTPhysicalArray< 1, double > noAxis = KTArrayRef< double >(a.GetData(), a.size()) * 3.;
+    KTPhysicalArray< 1, double > givenAxis(a - b, 1., 2.);
+    if (sum.size() != 10 || sum(0) != 3. || sum.GetRangeMin() != -5. || sum.GetRangeMax() != 5. || sum.GetAxisLabel() != "Frequency (Hz)")
+    {
+        KTERROR(testlog, "a + b has " << sum.size() << " bins, a range of [" << sum.GetRangeMin() << ", " << sum.GetRangeMax() << "), and the label \"" << sum.GetAxisLabel() << "\"; expected the axis of a");
+        ++nFailures;
+    }
+    if (scaled.GetRangeMin() != 100. || scaled.GetRangeMax() != 200.)
+    {
+        KTERROR(testlog, "2 * b has a range of [" << scaled.GetRangeMin() << ", " << scaled.GetRangeMax() << "); expected the range of b");
+        ++nFailures;
+    }
+    if (noAxis.GetRangeMin() != 0. || noAxis.GetRangeMax() != 1. || noAxis(9) != 3.)
+    {
+        KTERROR(testlog, "An expression without an array has a range of [" << noAxis.GetRangeMin() << ", " << noAxis.GetRangeMax() << "); expected [0, 1)");
+        ++nFailures;
+    }
+    if (givenAxis.GetRangeMin() != 1. || givenAxis.GetRangeMax() != 2. || givenAxis(5) != -1.)
+    {
+        KTERROR(testlog, "An array made with a given range has a range of [" << givenAxis.GetRangeMin() << ", " << givenAxis.GetRangeMax() << "); expected [1, 2)");
+        ++nFailures;
+    }
+
+    //**************
+    // Sizes
+    //**************
+    KTINFO(testlog, "Testing arrays of different sizes");
+
+    // as before expressions were added, compound assignment of an array of a different size leaves the array unchanged,
+    // an expression of arrays of different sizes gives an empty array, and assignment resizes the array
+    KTPhysicalArray< 1, double > shorter(1., 9);
+    shorter += a;
+    if (shorter(0) != 1.)
+    {
+        KTERROR(testlog, "An array of " << a.size() << " bins was added to an array of " << shorter.size() << " bins");
+        ++nFailures;
+    }
+
+    KTPhysicalArray< 1, double > mismatch = a + shorter;
+    KTPhysicalArray< 1, double > nestedMismatch = 2. * (a - shorter) + a;
+    if (mismatch.size() != 0 || nestedMismatch.size() != 0)
+    {
+        KTERROR(testlog, "Expressions with arrays of " << a.size() << " and " << shorter.size() << " bins gave arrays of " << mismatch.size() << " and " << nestedMismatch.size() << " bins; expected empty arrays");
+        ++nFailures;
+    }
+
+    shorter.Assign(a * b);
+    if (shorter.size() != 10 || shorter(9) != 2. || shorter.GetRangeMin() != -5. || shorter.GetAxisLabel() != "Frequency (Hz)")
+    {
+        KTERROR(testlog, "After an expression of " << a.size() << " bins was assigned to an array of 9 bins, the array has " << shorter.size() << " bins and the label \"" << shorter.GetAxisLabel() << "\"; expected the size and axis of a");
+        ++nFailures;
+    }
+
+    //**************
+    // Printing
+    //**************
+    KTINFO(testlog, "Testing the printing of an expression");
+
+    std::stringstream printed;
+    printed << a + b;
+    if (printed.str().empty())
+    {
+        KTERROR(testlog, "Nothing was printed for a + b");
+        ++nFailures;
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Array expression test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Array expression test complete");
+    return 0;
+}
+
+template< typename XDataType >
+unsigned TestExpressions(const char* typeName, unsigned size, double tolerance)
+{
+    unsigned nFailures = 0;
+
+    // b is never zero, and b * b > a, so the square root is defined
+    KTPhysicalArray< 1, XDataType > a(size);
+    KTPhysicalArray< 1, XDataType > b(size);
+    for (unsigned iBin = 0; iBin < size; ++iBin)
+    {
+        a(iBin) = XDataType(int(iBin % 11) - 5);
+        b(iBin) = XDataType(int(iBin % 5) + 1);
+    }
+    XDataType* expected = new XDataType[size + 1];
+
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = a(iBin) + b(iBin);
+    KTPhysicalArray< 1, XDataType > sum = a + b;
+    nFailures += CompareBins(typeName, "a + b", sum, expected, size, tolerance);
+
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = XDataType(3) * a(iBin) - b(iBin) / XDataType(2) + XDataType(1);
+    KTPhysicalArray< 1, XDataType > mixed(size);
+    mixed = XDataType(3) * a - b / XDataType(2) + XDataType(1);
+    nFailures += CompareBins(typeName, "3 * a - b / 2 + 1", mixed, expected, size, tolerance);
+
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = -(a(iBin) * b(iBin)) / b(iBin);
+    KTPhysicalArray< 1, XDataType > quotient(size);
+    quotient.Assign(-(a * b) / b);
+    nFailures += CompareBins(typeName, "-(a * b) / b", quotient, expected, size, tolerance);
+
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = XDataType(std::sqrt(double(b(iBin) * b(iBin) - a(iBin) / XDataType(10))));
+    KTPhysicalArray< 1, XDataType > root = KTArraySqrt(b * b - a / XDataType(10));
+    nFailures += CompareBins(typeName, "sqrt(b * b - a / 10)", root, expected, size, tolerance);
+
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = sum(iBin) + a(iBin) * b(iBin);
+    sum += a * b;
+    nFailures += CompareBins(typeName, "sum += a * b", sum, expected, size, tolerance);
+
+    // the output is also an input
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = a(iBin) * a(iBin) + b(iBin);
+    a.Assign(a * a + b);
+    nFailures += CompareBins(typeName, "a = a * a + b", a, expected, size, tolerance);
+
+    for (unsigned iBin = 0; iBin < size; ++iBin) expected[iBin] = b(iBin) * b(iBin);
+    b *= b;
+    nFailures += CompareBins(typeName, "b *= b", b, expected, size, tolerance);
+
+    delete [] expected;
+    return nFailures;
+}
+
+template< typename XDataType >
+unsigned CompareBins(const char* typeName, const char* exprName, const KTPhysicalArray< 1, XDataType >& result, const XDataType* expected, unsigned size, double tolerance)
+{
+    if (result.size() != size)
+    {
+        KTERROR(testlog, exprName << " (" << typeName << "): the result has " << result.size() << " bins; expected " << size);
+        return 1;
+    }
+    unsigned nBadBins = 0;
+    for (unsigned iBin = 0; iBin < result.size(); ++iBin)
+    {
+        if (std::fabs(double(result(iBin)) - double(expected[iBin])) > tolerance * (1. + std::fabs(double(expected[iBin]))))
+        {
+            if (nBadBins == 0)
+            {
+                KTERROR(testlog, exprName << " (" << typeName << ", " << result.size() << " bins), bin " << iBin << ": " << result(iBin) << "; expected " << expected[iBin]);
+            }
+            ++nBadBins;
+        }
+    }
+    return nBadBins == 0 ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+/*
+ * TestArrayViews.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestArrayViews
+ *
+ *  Purpose: Test the row and block views of 2-D physical arrays, and the padding of the rows: every row must start on an
+ *  alignment boundary, the views must address the same bins as operator(), and the padding must not take part in the
+ *  array arithmetic or the minimum/maximum searches.
+ */
+
+#include "KTBufferPool.hh"
+#include "KTPhysicalArray.hh"
+
+#include "KTLogger.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestArrayViews");
+
+template< typename XDataType >
+unsigned TestLayout(const char* typeName, unsigned nRows, unsigned nColumns);
+
+int main()
+{
+    unsigned nFailures = 0;
+
+    //**************
+    // Row alignment and padding
+    //**************
+    KTINFO(testlog, "Testing the row alignment and padding");
+
+    const unsigned nColumnsToTest[] = {1, 3, 8, 13, 100};
+    for (unsigned iTest = 0; iTest < 5; ++iTest)
+    {
+        nFailures += TestLayout< double >("double", 5, nColumnsToTest[iTest]);
+        nFailures += TestLayout< float >("float", 5, nColumnsToTest[iTest]);
+        nFailures += TestLayout< int >("int", 5, nColumnsToTest[iTest]);
+    }
+
+    //**************
+    // Views
+    //**************
+    KTINFO(testlog, "Testing the row and block views");
+
+    const unsigned nRows = 4;
+    const unsigned nColumns = 5;
+    KTPhysicalArray< 2, double > array(nRows, 0., 1., nColumns, 0., 1.);
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        for (unsigned iColumn = 0; iColumn < nColumns; ++iColumn)
+        {
+            array(iRow, iColumn) = 100. * iRow + iColumn;
+        }
+    }
+
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        KTPhysicalArray< 2, double >::row_view row = array.GetRow(iRow);
+        if (row.size() != nColumns || row.GetData() != &array(iRow, 0))
+        {
+            KTERROR(testlog, "Row " << iRow << " has " << row.size() << " bins at " << row.GetData() << "; expected " << nColumns << " bins at " << &array(iRow, 0));
+            ++nFailures;
+            continue;
+        }
+        for (unsigned iColumn = 0; iColumn < nColumns; ++iColumn)
+        {
+            if (row[iColumn] != array(iRow, iColumn))
+            {
+                KTERROR(testlog, "Row " << iRow << ", bin " << iColumn << ": " << row[iColumn] << "; expected " << array(iRow, iColumn));
+                ++nFailures;
+            }
+        }
+    }
+
+    // writing through a view changes the array
+    array.GetRow(2)[3] = -1.;
+    if (array(2, 3) != -1.)
+    {
+        KTERROR(testlog, "A bin written through a row view was not changed in the array");
+        ++nFailures;
+    }
+    array(2, 3) = 203.;
+
+    KTPhysicalArray< 2, double >::block_view block = array.GetBlock(1, 2, 2, 3);
+    if (block.GetNRows() != 2 || block.GetNColumns() != 3 || block.GetStride() != array.GetStride())
+    {
+        KTERROR(testlog, "The block is " << block.GetNRows() << " x " << block.GetNColumns() << " with a stride of " << block.GetStride() << "; expected 2 x 3 with a stride of " << array.GetStride());
+        ++nFailures;
+    }
+    for (unsigned iRow = 0; iRow < 2; ++iRow)
+    {
+        for (unsigned iColumn = 0; iColumn < 3; ++iColumn)
+        {
+            double expected = 100. * (iRow + 1) + (iColumn + 2);
+            if (block(iRow, iColumn) != expected || block.GetRow(iRow)[iColumn] != expected)
+            {
+                KTERROR(testlog, "Block bin (" << iRow << ", " << iColumn << "): " << block(iRow, iColumn) << " and " << block.GetRow(iRow)[iColumn] << "; expected " << expected);
+                ++nFailures;
+            }
+        }
+    }
+
+    const KTPhysicalArray< 2, double >& constArray = array;
+    KTPhysicalArray< 2, double >::const_block_view columns = constArray.GetColumnBlock(4, 1);
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        if (columns.GetNRows() != nRows || columns(iRow, 0) != 100. * iRow + 4.)
+        {
+            KTERROR(testlog, "Column block bin (" << iRow << ", 0): " << columns(iRow, 0) << "; expected " << 100. * iRow + 4.);
+            ++nFailures;
+        }
+    }
+
+    // whole rows are contiguous only without padding
+    bool padded = array.GetStride() != nColumns;
+    if (array.GetBlock(0, nRows, 0, nColumns).IsContiguous() == padded || ! array.GetBlock(1, 1, 0, nColumns).IsContiguous())
+    {
+        KTERROR(testlog, "The contiguity of the blocks of whole rows is wrong (stride " << array.GetStride() << ", " << nColumns << " columns)");
+        ++nFailures;
+    }
+
+    //**************
+    // Copies
+    //**************
+    KTINFO(testlog, "Testing copies of a padded array");
+
+    KTPhysicalArray< 2, double > copy(array);
+    KTPhysicalArray< 2, double > assigned;
+    assigned = array;
+    KTPhysicalArray< 2, double > moved(std::move(KTPhysicalArray< 2, double >(array)));
+    const KTPhysicalArray< 2, double >* copies[3] = {&copy, &assigned, &moved};
+    for (unsigned iCopy = 0; iCopy < 3; ++iCopy)
+    {
+        const KTPhysicalArray< 2, double >& thisCopy = *copies[iCopy];
+        bool same = thisCopy.size(1) == nRows && thisCopy.size(2) == nColumns && thisCopy.GetStride() == array.GetStride();
+        for (unsigned iRow = 0; same && iRow < nRows; ++iRow)
+        {
+            same = std::equal(array.GetRow(iRow).begin(), array.GetRow(iRow).end(), thisCopy.GetRow(iRow).begin());
+        }
+        if (! same)
+        {
+            KTERROR(testlog, "Copy " << iCopy << " does not match the original array");
+            ++nFailures;
+        }
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Array views test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Array views test complete");
+    return 0;
+}
+
+template< typename XDataType >
+unsigned TestLayout(const char* typeName, unsigned nRows, unsigned nColumns)
+{
+    unsigned nFailures = 0;
+    const size_t alignment = KTBufferPool::GetAlignment();
+
+    KTPhysicalArray< 2, XDataType > array(nRows, 0., 1., nColumns, 0., 1.);
+    if (array.size(2) != nColumns || array.GetStride() < nColumns || (array.GetStride() * sizeof(XDataType)) % alignment != 0)
+    {
+        KTERROR(testlog, nRows << " x " << nColumns << " " << typeName << " array: the size is " << array.size(1) << " x " << array.size(2) << " and the stride is " << array.GetStride());
+        ++nFailures;
+    }
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        if (reinterpret_cast< uintptr_t >(array.GetRow(iRow).GetData()) % alignment != 0)
+        {
+            KTERROR(testlog, nRows << " x " << nColumns << " " << typeName << " array: row " << iRow << " is not aligned to " << alignment << " bytes");
+            ++nFailures;
+        }
+    }
+
+    // the padding of both arrays is zero, so an integer division that included it would fail
+    std::fill(array.begin(), array.end(), XDataType(0));
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        for (unsigned iColumn = 0; iColumn < nColumns; ++iColumn)
+        {
+            array(iRow, iColumn) = XDataType(10 + iRow * nColumns + iColumn);
+        }
+    }
+
+    KTPhysicalArray< 2, XDataType > ones(XDataType(0), nRows, 0., 1., nColumns, 0., 1.);
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        std::fill(ones.GetRow(iRow).begin(), ones.GetRow(iRow).end(), XDataType(1));
+    }
+    array /= ones;
+    array += ones;
+    array -= ones;
+    array *= ones;
+
+    unsigned maxRow = 0, maxColumn = 0, minRow = 0, minColumn = 0;
+    XDataType maxValue = array.GetMaximumBin(maxRow, maxColumn);
+    XDataType minValue = array.GetMinimumBin(minRow, minColumn);
+    if (maxValue != XDataType(10 + nRows * nColumns - 1) || maxRow != nRows - 1 || maxColumn != nColumns - 1 ||
+        minValue != XDataType(10) || minRow != 0 || minColumn != 0)
+    {
+        KTERROR(testlog, nRows << " x " << nColumns << " " << typeName << " array: the maximum is " << maxValue << " at (" << maxRow << ", " << maxColumn << ") and the minimum is " << minValue << " at (" << minRow << ", " << minColumn << ")");
+        ++nFailures;
+    }
+
+    // the padding must not be found by the searches, whatever it holds
+    for (typename KTPhysicalArray< 2, XDataType >::iterator it = array.begin(); it != array.end(); ++it)
+    {
+        *it = XDataType(100);
+    }
+    for (unsigned iRow = 0; iRow < nRows; ++iRow)
+    {
+        for (unsigned iColumn = 0; iColumn < nColumns; ++iColumn)
+        {
+            array(iRow, iColumn) = XDataType(-1) - XDataType(iColumn % 2);
+        }
+    }
+    std::pair< XDataType, XDataType > minMax = array.GetMinMaxBin(minRow, minColumn, maxRow, maxColumn);
+    XDataType expectedMin = nColumns > 1 ? XDataType(-2) : XDataType(-1);
+    if (minMax.first != expectedMin || minMax.second != XDataType(-1) || array.GetMaximumBin(maxRow, maxColumn) != XDataType(-1))
+    {
+        KTERROR(testlog, nRows << " x " << nColumns << " " << typeName << " array: the minimum and maximum are " << minMax.first << " and " << minMax.second << "; expected " << expectedMin << " and -1");
+        ++nFailures;
+    }
+
+    return nFailures;
+}
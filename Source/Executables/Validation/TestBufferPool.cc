@@ -0,0 +1,214 @@
+/*
+ * TestBufferPool.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestBufferPool
+ *
+ *  Purpose: Test KTBufferPool: the alignment and size-class rounding of the blocks, the reuse of released blocks,
+ *  the spill from a thread's cache to the shared cache, releasing a block in a different thread from the one that allocated it,
+ *  moving a thread's cache to the shared cache when the thread exits, Trim(), and the rejection of a second release of a cached block.
+ */
+
+#include "KTBufferPool.hh"
+#include "KTLogger.hh"
+
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestBufferPool");
+
+int main()
+{
+    unsigned nFailures = 0;
+    const size_t alignment = KTBufferPool::GetAlignment();
+    const size_t headerSize = alignment;
+
+    // start with empty caches, so that the number of cached bytes only counts the blocks of this test
+    KTBufferPool::Trim();
+
+    //**************
+    // Size classes
+    //**************
+    KTINFO(testlog, "Testing the alignment and size classes");
+
+    // each block is at least the request plus a header, and at most 25% larger (except for the smallest class)
+    srand(8731);
+    for (unsigned iTest = 0; iTest < 1000; ++iTest)
+    {
+        size_t nBytes = iTest < 100 ? iTest : size_t(rand()) % (size_t(1) << (8 + iTest % 16));
+        void* block = KTBufferPool::Allocate(nBytes);
+        if (block == NULL || reinterpret_cast< uintptr_t >(block) % alignment != 0)
+        {
+            KTERROR(testlog, "Block of " << nBytes << " bytes at " << block << " is not aligned to " << alignment << " bytes");
+            ++nFailures;
+            continue;
+        }
+        size_t cachedBefore = KTBufferPool::GetNCachedBytes();
+        KTBufferPool::Release(block);
+        size_t blockSize = KTBufferPool::GetNCachedBytes() - cachedBefore;
+        size_t minSize = nBytes + headerSize;
+        size_t maxSize = minSize <= 256 ? 256 : minSize + minSize / 4;
+        if (blockSize < minSize || blockSize > maxSize)
+        {
+            KTERROR(testlog, "Request of " << nBytes << " bytes was given a block of " << blockSize << " bytes; expected " << minSize << " to " << maxSize);
+            ++nFailures;
+        }
+        KTBufferPool::Trim();
+    }
+
+    // 1000 and 1200 bytes (+ the header) are in the class from 1024 to 1280 bytes; 1300 bytes is in the next one
+    void* first = KTBufferPool::Allocate(1000);
+    KTBufferPool::Release(first);
+    void* sameClass = KTBufferPool::Allocate(1200);
+    void* nextClass = KTBufferPool::Allocate(1300);
+    if (sameClass != first)
+    {
+        KTERROR(testlog, "A released block was not reused for a request in the same size class");
+        ++nFailures;
+    }
+    if (nextClass == first)
+    {
+        KTERROR(testlog, "A block was reused for a request in a larger size class");
+        ++nFailures;
+    }
+    KTBufferPool::Release(sameClass);
+    KTBufferPool::Release(nextClass);
+    KTBufferPool::Trim();
+
+    //**************
+    // Spill to the shared cache
+    //**************
+    KTINFO(testlog, "Testing the spill from the thread cache to the shared cache");
+
+    // with no room in the thread caches, released blocks go to the shared cache, where other threads can find them
+    size_t threadCacheLimit = KTBufferPool::GetThreadCacheLimit();
+    KTBufferPool::SetThreadCacheLimit(0);
+    void* spilled = KTBufferPool::Allocate(5000);
+    KTBufferPool::Release(spilled);
+    if (KTBufferPool::GetNCachedBytes() == 0)
+    {
+        KTERROR(testlog, "A block released with a full thread cache was not kept in the shared cache");
+        ++nFailures;
+    }
+    void* spilledInThread = NULL;
+    std::thread spillThread([&spilledInThread]() {
+        spilledInThread = KTBufferPool::Allocate(5000);
+        KTBufferPool::Release(spilledInThread);
+    });
+    spillThread.join();
+    if (spilledInThread != spilled)
+    {
+        KTERROR(testlog, "Another thread did not get the block from the shared cache");
+        ++nFailures;
+    }
+
+    // with no room in the shared cache either, released blocks are freed
+    size_t sharedCacheLimit = KTBufferPool::GetSharedCacheLimit();
+    KTBufferPool::SetSharedCacheLimit(0);
+    KTBufferPool::Trim();
+    KTBufferPool::Release(KTBufferPool::Allocate(5000));
+    if (KTBufferPool::GetNCachedBytes() != 0)
+    {
+        KTERROR(testlog, "A block was cached with both caches full");
+        ++nFailures;
+    }
+    KTBufferPool::SetThreadCacheLimit(threadCacheLimit);
+    KTBufferPool::SetSharedCacheLimit(sharedCacheLimit);
+
+    //**************
+    // Cross-thread release
+    //**************
+    KTINFO(testlog, "Testing the release of a block in a different thread");
+
+    // allocated in another thread and released here, so it goes to this thread's cache
+    void* fromThread = NULL;
+    std::thread allocThread([&fromThread]() {
+        fromThread = KTBufferPool::Allocate(7000);
+    });
+    allocThread.join();
+    size_t cachedBefore = KTBufferPool::GetNCachedBytes();
+    KTBufferPool::Release(fromThread);
+    size_t cachedAfter = KTBufferPool::GetNCachedBytes();
+    void* reused = KTBufferPool::Allocate(7000);
+    if (cachedAfter <= cachedBefore || reused != fromThread)
+    {
+        KTERROR(testlog, "A block allocated in another thread was not reused after being released in this one");
+        ++nFailures;
+    }
+    KTBufferPool::Release(reused);
+    KTBufferPool::Trim();
+
+    // released in another thread, which then exits; the block moves to the shared cache
+    void* toThread = KTBufferPool::Allocate(9000);
+    std::thread releaseThread([toThread]() {
+        KTBufferPool::Release(toThread);
+    });
+    releaseThread.join();
+    reused = KTBufferPool::Allocate(9000);
+    if (reused != toThread)
+    {
+        KTERROR(testlog, "A block released in a thread that exited was not reused");
+        ++nFailures;
+    }
+    KTBufferPool::Release(reused);
+
+    //**************
+    // Trim
+    //**************
+    KTINFO(testlog, "Testing Trim()");
+
+    void* blocks[10];
+    for (unsigned iBlock = 0; iBlock < 10; ++iBlock)
+    {
+        blocks[iBlock] = KTBufferPool::Allocate(1000 * (iBlock + 1));
+    }
+    for (unsigned iBlock = 0; iBlock < 10; ++iBlock)
+    {
+        KTBufferPool::Release(blocks[iBlock]);
+    }
+    if (KTBufferPool::GetNCachedBytes() == 0)
+    {
+        KTERROR(testlog, "No blocks were cached");
+        ++nFailures;
+    }
+    KTBufferPool::Trim();
+    if (KTBufferPool::GetNCachedBytes() != 0)
+    {
+        KTERROR(testlog, KTBufferPool::GetNCachedBytes() << " bytes are still cached after Trim()");
+        ++nFailures;
+    }
+
+    //**************
+    // Releasing a block twice
+    //**************
+    KTINFO(testlog, "Testing a second release of a block (an error message is expected)");
+
+    // the block must be cached once, or the next two allocations of its class would both get it
+    void* twice = KTBufferPool::Allocate(1000);
+    KTBufferPool::Release(twice);
+    size_t nCachedBytes = KTBufferPool::GetNCachedBytes();
+    KTBufferPool::Release(twice);
+    void* firstAfter = KTBufferPool::Allocate(1000);
+    void* secondAfter = KTBufferPool::Allocate(1000);
+    if (KTBufferPool::GetNCachedBytes() != 0 || nCachedBytes == 0 || firstAfter == secondAfter)
+    {
+        KTERROR(testlog, "A block released twice was cached twice");
+        ++nFailures;
+    }
+    KTBufferPool::Release(firstAfter);
+    KTBufferPool::Release(secondAfter);
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Buffer pool test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Buffer pool test complete");
+    return 0;
+}
@@ -0,0 +1,180 @@
+/*
+ * TestDataMoves.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestDataMoves
+ *
+ *  Purpose: Test the move operations of the 1-D arrays and of the spectrum and time-series classes built on them.
+ *  A move must take the data buffer of the original without copying it, along with its axis, label, and any other metadata;
+ *  a moved-from object must be left empty (move construction) or with the old contents of the target (move assignment);
+ *  and the rvalue SetSpectrum() and SetTimeSeries() must keep the existing component object while taking the moved buffer.
+ *  The copies of the raw time series, which had shared their storage, must be deep.
+ */
+
+#include "KTFrequencySpectrumDataFFTW.hh"
+#include "KTFrequencySpectrumFFTW.hh"
+#include "KTPhysicalArray.hh"
+#include "KTPowerSpectrum.hh"
+#include "KTRawTimeSeries.hh"
+#include "KTTimeSeriesData.hh"
+#include "KTTimeSeriesReal.hh"
+
+#include "KTLogger.hh"
+
+#include <utility>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestDataMoves");
+
+int main()
+{
+    unsigned nFailures = 0;
+
+    //**************
+    // Physical arrays
+    //**************
+    KTINFO(testlog, "Testing moves of 1-D physical arrays");
+
+    KTPhysicalArray< 1, double > original(2., 10, -5., 5.);
+    original.SetAxisLabel("Frequency (Hz)");
+    const double* originalData = original.GetData();
+
+    KTPhysicalArray< 1, double > moved(std::move(original));
+    if (moved.GetData() != originalData || moved.size() != 10 || moved(3) != 2. || moved.GetRangeMin() != -5. || moved.GetRangeMax() != 5. || moved.GetAxisLabel() != "Frequency (Hz)")
+    {
+        KTERROR(testlog, "A move-constructed array did not take the buffer, axis, and label of the original");
+        ++nFailures;
+    }
+    if (original.size() != 0)
+    {
+        KTERROR(testlog, "A moved-from array has " << original.size() << " bins; expected it to be empty");
+        ++nFailures;
+    }
+
+    KTPhysicalArray< 1, double > target(1., 3, 0., 1.);
+    const double* targetData = target.GetData();
+    target = std::move(moved);
+    if (target.GetData() != originalData || target.size() != 10 || target.GetRangeMax() != 5. || moved.GetData() != targetData || moved.size() != 3 || moved.GetRangeMax() != 1.)
+    {
+        KTERROR(testlog, "Move assignment did not exchange the contents of the two arrays");
+        ++nFailures;
+    }
+
+    moved.swap(target);
+    if (moved.GetData() != originalData || target.GetData() != targetData || moved.GetAxisLabel() != "Frequency (Hz)" || target.GetAxisLabel() != "")
+    {
+        KTERROR(testlog, "swap() did not exchange the contents of the two arrays");
+        ++nFailures;
+    }
+
+    //**************
+    // Spectra and time series
+    //**************
+    KTINFO(testlog, "Testing moves of spectra and time series");
+
+    // a flipped array order is metadata of the spectrum that must go with its buffer
+    KTFrequencySpectrumFFTW spectrum(9, -4.5, 4.5, true);
+    spectrum(2)[0] = 7.;
+    const fftw_complex* spectrumData = spectrum.GetData();
+    KTFrequencySpectrumFFTW movedSpectrum(std::move(spectrum));
+    if (movedSpectrum.GetData() != spectrumData || movedSpectrum(2)[0] != 7. || ! movedSpectrum.GetIsArrayOrderFlipped() || movedSpectrum.GetCenterBin() != 4 || spectrum.size() != 0)
+    {
+        KTERROR(testlog, "A move-constructed FFTW spectrum did not take the buffer and array order of the original");
+        ++nFailures;
+    }
+
+    KTPowerSpectrum power(4, 0., 100.);
+    power.SetMode(KTPowerSpectrum::kPSD);
+    const double* powerData = power.GetData();
+    KTPowerSpectrum movedPower(1, 0., 1.);
+    movedPower = std::move(power);
+    if (movedPower.GetData() != powerData || movedPower.GetMode() != KTPowerSpectrum::kPSD || movedPower.GetRangeMax() != 100. || power.size() != 1)
+    {
+        KTERROR(testlog, "Move assignment of a power spectrum did not exchange the buffers and modes");
+        ++nFailures;
+    }
+
+    KTTimeSeriesReal timeSeries(3., 8, 0., 1.e-6);
+    const double* timeSeriesData = timeSeries.GetData();
+    KTTimeSeriesReal movedTimeSeries(std::move(timeSeries));
+    if (movedTimeSeries.GetData() != timeSeriesData || movedTimeSeries.GetValue(7) != 3. || movedTimeSeries.GetRangeMax() != 1.e-6 || timeSeries.GetNTimeBins() != 0)
+    {
+        KTERROR(testlog, "A move-constructed real time series did not take the buffer of the original");
+        ++nFailures;
+    }
+
+    //**************
+    // Raw time series
+    //**************
+    KTINFO(testlog, "Testing copies and moves of raw time series");
+
+    KTRawTimeSeries raw(sizeof(uint16_t), sDigitizedUS, 6, 0., 1.);
+    raw.SetAt(300, 1);
+    const uint8_t* rawStorage = raw.GetStorage();
+
+    KTRawTimeSeries rawCopy(raw);
+    rawCopy.SetAt(5, 1);
+    if (rawCopy.GetStorage() == rawStorage || raw(1) != 300 || rawCopy(1) != 5)
+    {
+        KTERROR(testlog, "A copy of a raw time series shares the storage of the original");
+        ++nFailures;
+    }
+
+    KTRawTimeSeries rawMoved(std::move(raw));
+    if (rawMoved.GetStorage() != rawStorage || ! rawMoved.GetOwnsStorage() || rawMoved(1) != 300 || raw.GetNBins() != 0)
+    {
+        KTERROR(testlog, "A move-constructed raw time series did not take the storage of the original");
+        ++nFailures;
+    }
+
+    //**************
+    // Data objects
+    //**************
+    KTINFO(testlog, "Testing the rvalue setters of the data objects");
+
+    KTFrequencySpectrumDataFFTW fsData;
+    fsData.SetSpectrum(new KTFrequencySpectrumFFTW(5, 0., 1.));
+    const KTFrequencySpectrumFFTW* heldSpectrum = fsData.GetSpectrumFFTW(0);
+    KTFrequencySpectrumFFTW newSpectrum(9, -4.5, 4.5, true);
+    const fftw_complex* newSpectrumData = newSpectrum.GetData();
+    fsData.SetSpectrum(std::move(newSpectrum));
+    if (fsData.GetSpectrumFFTW(0) != heldSpectrum || heldSpectrum->GetData() != newSpectrumData || heldSpectrum->size() != 9 || ! heldSpectrum->GetIsArrayOrderFlipped())
+    {
+        KTERROR(testlog, "SetSpectrum() with an rvalue did not move the spectrum into the existing component");
+        ++nFailures;
+    }
+
+    KTFrequencySpectrumFFTW addedSpectrum(5, 0., 1.);
+    const fftw_complex* addedSpectrumData = addedSpectrum.GetData();
+    fsData.SetSpectrum(std::move(addedSpectrum), 1);
+    if (fsData.GetNComponents() != 2 || fsData.GetSpectrumFFTW(1) == NULL || fsData.GetSpectrumFFTW(1)->GetData() != addedSpectrumData)
+    {
+        KTERROR(testlog, "SetSpectrum() with an rvalue did not move the spectrum into a new component");
+        ++nFailures;
+    }
+
+    KTTimeSeriesData tsData;
+    tsData.SetTimeSeries(new KTTimeSeriesReal(4, 0., 1.));
+    const KTTimeSeries* heldTimeSeries = tsData.GetTimeSeries(0);
+    KTTimeSeriesReal newTimeSeries(2., 12, 0., 1.);
+    const double* newTimeSeriesData = newTimeSeries.GetData();
+    tsData.SetTimeSeries(std::move(newTimeSeries));
+    const KTTimeSeriesReal* heldReal = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(0));
+    if (tsData.GetTimeSeries(0) != heldTimeSeries || heldReal == NULL || heldReal->GetData() != newTimeSeriesData || heldReal->GetNTimeBins() != 12)
+    {
+        KTERROR(testlog, "SetTimeSeries() with an rvalue did not move the time series into the existing component");
+        ++nFailures;
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Data move test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Data move test complete");
+    return 0;
+}
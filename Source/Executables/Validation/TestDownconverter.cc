@@ -0,0 +1,191 @@
+/*
+ * TestDownconverter.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestDownconverter
+ *
+ *  Purpose: Downconvert contiguous slices of a real time series with a tone in the band and a tone outside of it.
+ *  The output must be the in-band tone, shifted by the center of the band, with the right amplitude and a phase that is continuous
+ *  across slices; the out-of-band tone must be filtered out.  The new slice header must describe the decimated slice, and
+ *  the forward FFT's "ts-downconverted" transform must put the tone at its absolute frequency (and reject the data in the r2c state).
+ */
+
+#include "KTDownconverter.hh"
+#include "KTForwardFFTW.hh"
+#include "KTFrequencySpectrumDataFFTW.hh"
+#include "KTFrequencySpectrumFFTW.hh"
+#include "KTSliceHeader.hh"
+#include "KTTimeSeriesData.hh"
+#include "KTTimeSeriesFFTW.hh"
+#include "KTTimeSeriesReal.hh"
+
+#include "KTLogger.hh"
+
+#include <cmath>
+#include <complex>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestDownconverter");
+
+int main()
+{
+    const double pi = 3.14159265358979;
+
+    const double sampleRate = 1.e6;
+    const unsigned sliceSize = 4096;
+    const unsigned nSlices = 3;
+    const double minFrequency = 200.e3;
+    const double maxFrequency = 250.e3;
+    const double centerFrequency = 0.5 * (minFrequency + maxFrequency);
+
+    const double toneFrequency = 231.e3;
+    const double toneAmplitude = 0.8;
+    const double tonePhase = 0.3;
+    const double outOfBandFrequency = 400.e3;
+    const double outOfBandAmplitude = 1.;
+
+    unsigned nFailures = 0;
+
+    KTDownconverter downconverter;
+    downconverter.SetMinFrequency(minFrequency);
+    downconverter.SetMaxFrequency(maxFrequency);
+
+    KTSliceHeader header;
+    header.SetNComponents(1);
+    header.SetSampleRate(sampleRate);
+    header.SetSliceSize(sliceSize);
+    header.SetRawSliceSize(sliceSize);
+    header.CalculateBinWidthAndSliceLength();
+
+    KTForwardFFTW complexFFT;
+    KTForwardFFTW realFFT;
+
+    for (unsigned iSlice = 0; iSlice < nSlices; ++iSlice)
+    {
+        double sliceStart = double(iSlice * sliceSize) / sampleRate;
+        header.SetIsNewAcquisition(iSlice == 0);
+        header.SetTimeInRun(sliceStart);
+        header.SetTimeInAcq(sliceStart);
+
+        KTTimeSeriesReal* ts = new KTTimeSeriesReal(sliceSize, 0., double(sliceSize) / sampleRate);
+        for (unsigned iBin = 0; iBin < sliceSize; ++iBin)
+        {
+            double time = sliceStart + double(iBin) / sampleRate;
+            (*ts)(iBin) = toneAmplitude * cos(2. * pi * toneFrequency * time + tonePhase) + outOfBandAmplitude * cos(2. * pi * outOfBandFrequency * time);
+        }
+        KTTimeSeriesData tsData;
+        tsData.SetTimeSeries(ts);
+
+        Nymph::KTDataPtr newData = downconverter.Downconvert(header, tsData);
+        if (! newData)
+        {
+            KTERROR(testlog, "Unable to downconvert slice " << iSlice);
+            return -1;
+        }
+
+        //**************
+        // Slice header
+        //**************
+
+        unsigned decimation = downconverter.GetActiveDecimation();
+        unsigned nOutput = sliceSize / decimation;
+        KTSliceHeader& newHeader = newData->Of< KTSliceHeader >();
+        if (newHeader.GetSliceSize() != nOutput || newHeader.GetRawSliceSize() != nOutput)
+        {
+            KTERROR(testlog, "Slice " << iSlice << ": the slice size and raw slice size are " << newHeader.GetSliceSize() << " and " << newHeader.GetRawSliceSize() << "; expected " << nOutput);
+            ++nFailures;
+        }
+        if (fabs(newHeader.GetSampleRate() - sampleRate / double(decimation)) > 1.e-6 || newHeader.GetFrequencyOffset() != centerFrequency)
+        {
+            KTERROR(testlog, "Slice " << iSlice << ": the sample rate is " << newHeader.GetSampleRate() << " Hz and the frequency offset is " << newHeader.GetFrequencyOffset() << " Hz");
+            ++nFailures;
+        }
+
+        //**************
+        // Time series
+        //**************
+
+        KTTimeSeriesData& newTSData = newData->Of< KTTimeSeriesData >();
+        const KTTimeSeriesFFTW* newTS = dynamic_cast< const KTTimeSeriesFFTW* >(newTSData.GetTimeSeries(0));
+        if (newTS == NULL || newTS->size() != nOutput)
+        {
+            KTERROR(testlog, "Slice " << iSlice << ": the output is not a complex time series of " << nOutput << " samples");
+            return -1;
+        }
+
+        // the filter starts from zeros, so the start of the first slice is skipped
+        unsigned firstOutput = iSlice == 0 ? downconverter.GetFilterCoefficients().size() / decimation + 1 : 0;
+        unsigned nBadSamples = 0;
+        for (unsigned iOutput = firstOutput; iOutput < nOutput; ++iOutput)
+        {
+            double time = newHeader.GetTimeInRun() + double(iOutput) / newHeader.GetSampleRate();
+            std::complex< double > expected = std::polar(toneAmplitude, 2. * pi * (toneFrequency - centerFrequency) * time + tonePhase);
+            std::complex< double > output((*newTS)(iOutput)[0], (*newTS)(iOutput)[1]);
+            if (std::abs(output - expected) > 1.e-2 * toneAmplitude)
+            {
+                if (nBadSamples == 0)
+                {
+                    KTERROR(testlog, "Slice " << iSlice << ", sample " << iOutput << ": " << output << "; expected " << expected);
+                }
+                ++nBadSamples;
+            }
+        }
+        if (nBadSamples != 0)
+        {
+            KTERROR(testlog, "Slice " << iSlice << " has " << nBadSamples << " sample(s) that differ from the downconverted tone");
+            ++nFailures;
+        }
+
+        //**************
+        // Spectrum
+        //**************
+
+        if (iSlice == 0)
+        {
+            complexFFT.InitializeForComplexTDD(nOutput);
+            realFFT.InitializeForRealTDD(nOutput);
+
+            if (realFFT.TransformDownconvertedData(newHeader, newTSData))
+            {
+                KTERROR(testlog, "Downconverted data were accepted by a forward FFT in the r2c state");
+                ++nFailures;
+            }
+        }
+
+        if (! complexFFT.TransformDownconvertedData(newHeader, newTSData))
+        {
+            KTERROR(testlog, "Slice " << iSlice << ": unable to transform the downconverted data");
+            ++nFailures;
+            continue;
+        }
+        const KTFrequencySpectrumFFTW* spectrum = newTSData.Of< KTFrequencySpectrumDataFFTW >().GetSpectrumFFTW(0);
+        unsigned peakBin = 0;
+        double peakMag = 0.;
+        for (unsigned iBin = 0; iBin < spectrum->size(); ++iBin)
+        {
+            double mag = (*spectrum)(iBin)[0] * (*spectrum)(iBin)[0] + (*spectrum)(iBin)[1] * (*spectrum)(iBin)[1];
+            if (mag > peakMag)
+            {
+                peakMag = mag;
+                peakBin = iBin;
+            }
+        }
+        if (fabs(spectrum->GetBinCenter(peakBin) - toneFrequency) > spectrum->GetBinWidth())
+        {
+            KTERROR(testlog, "Slice " << iSlice << ": the spectrum peaks at " << spectrum->GetBinCenter(peakBin) << " Hz; expected " << toneFrequency << " Hz");
+            ++nFailures;
+        }
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Downconverter test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Downconverter test complete");
+    return 0;
+}
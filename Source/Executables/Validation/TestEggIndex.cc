@@ -0,0 +1,251 @@
+/*
+ * TestEggIndex.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestEggIndex
+ *
+ *  Purpose: Test KTEggIndex.  An index built record by record is written to a sidecar file and read back, and the entries must
+ *  match; the time, record, and shard lookups and the numbering of the slices of a shard are checked on the result;
+ *  and stale and corrupt sidecars must be ignored.
+ *  The test makes a small stand-in egg file in the system's temporary directory, and removes it and its sidecar at the end.
+ */
+
+#include "KTEggIndex.hh"
+
+#include "KTLogger.hh"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestEggIndex");
+
+// three acquisitions of 4, 2, and 5 records, 10 ns long; the second acquisition starts after a gap
+const unsigned nAcqs = 3;
+const uint64_t acqIds[nAcqs] = {0, 1, 2};
+const uint64_t acqNRecords[nAcqs] = {4, 2, 5};
+const uint64_t acqStartTimes[nAcqs] = {1000, 1100, 1120};
+const uint64_t recordLength = 10;
+const uint64_t recordNBytes = 8;
+const unsigned recordSize = 10; // samples
+
+bool SameEntries(const KTEggIndex& index1, const KTEggIndex& index2);
+void WriteFile(const scarab::path& filename, const std::string& contents);
+
+int main()
+{
+    unsigned nFailures = 0;
+
+    scarab::path eggFilename = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("katydid-test-%%%%-%%%%.egg");
+    scarab::path sidecarFilename = KTEggIndex::GetSidecarFilename(eggFilename, 1);
+    // the stand-in egg file only has to be large enough to hold the records
+    WriteFile(eggFilename, std::string(11 * recordNBytes, 'x'));
+
+    //**************
+    // Building
+    //**************
+    KTINFO(testlog, "Testing an index built record by record");
+
+    KTEggIndex index;
+    uint64_t recordOffset = 0;
+    for (unsigned iAcq = 0; iAcq < nAcqs; ++iAcq)
+    {
+        for (uint64_t iRecord = 0; iRecord < acqNRecords[iAcq]; ++iRecord)
+        {
+            index.AddRecord(0, acqIds[iAcq], 10 + recordOffset, acqStartTimes[iAcq] + iRecord * recordLength, recordOffset);
+            ++recordOffset;
+        }
+    }
+    if (index.GetNEntries() != nAcqs)
+    {
+        KTERROR(testlog, "The index has " << index.GetNEntries() << " entries; expected " << nAcqs);
+        return -1;
+    }
+    for (unsigned iAcq = 0; iAcq < nAcqs; ++iAcq)
+    {
+        const KTEggIndex::Entry& entry = index.GetEntry(iAcq);
+        if (entry.fAcquisitionId != acqIds[iAcq] || entry.fNRecords != acqNRecords[iAcq] || entry.fTimeStamp != acqStartTimes[iAcq])
+        {
+            KTERROR(testlog, "Entry " << iAcq << " is acquisition " << entry.fAcquisitionId << " with " << entry.fNRecords << " records at " << entry.fTimeStamp << " ns");
+            ++nFailures;
+        }
+    }
+
+    //**************
+    // Round trip
+    //**************
+    KTINFO(testlog, "Testing the round trip through a sidecar file");
+
+    KTEggIndex readIndex;
+    if (! index.WriteSidecar(eggFilename, 0, 1) || ! readIndex.ReadSidecar(eggFilename, 0, 1, recordNBytes) || ! SameEntries(index, readIndex))
+    {
+        KTERROR(testlog, "The index read from the sidecar does not match the index that was written");
+        ++nFailures;
+    }
+
+    //**************
+    // Lookups
+    //**************
+    KTINFO(testlog, "Testing the lookups");
+
+    const KTEggIndex::Entry* entry = readIndex.FindTime(1025, recordLength);
+    if (entry == NULL || entry->fAcquisitionId != 0)
+    {
+        KTERROR(testlog, "1025 ns was not found in acquisition 0");
+        ++nFailures;
+    }
+    entry = readIndex.FindTime(1050, recordLength);
+    if (entry == NULL || entry->fAcquisitionId != 1)
+    {
+        KTERROR(testlog, "1050 ns, between acquisitions, did not give the next acquisition");
+        ++nFailures;
+    }
+    if (readIndex.FindTime(2000, recordLength) != NULL)
+    {
+        KTERROR(testlog, "A time after the end of the run was found");
+        ++nFailures;
+    }
+
+    uint64_t recordInEntry = 0;
+    entry = readIndex.FindRecordInRun(5, recordInEntry);
+    if (entry == NULL || entry->fAcquisitionId != 1 || recordInEntry != 1)
+    {
+        KTERROR(testlog, "Record 5 of the run was not found as record 1 of acquisition 1");
+        ++nFailures;
+    }
+    if (readIndex.FindRecordInRun(11, recordInEntry) != NULL)
+    {
+        KTERROR(testlog, "A record after the end of the run was found");
+        ++nFailures;
+    }
+
+    // 11 records in 2 shards: the first shard has the acquisitions that start in records 0-4
+    unsigned firstEntry = 0, lastEntry = 0;
+    if (! readIndex.GetShard(2, 0, firstEntry, lastEntry) || firstEntry != 0 || lastEntry != 1 ||
+        ! readIndex.GetShard(2, 1, firstEntry, lastEntry) || firstEntry != 2 || lastEntry != 2 ||
+        readIndex.GetShard(5, 4, firstEntry, lastEntry))
+    {
+        KTERROR(testlog, "The shards are not divided at acquisition boundaries as expected");
+        ++nFailures;
+    }
+
+    //**************
+    // Slice numbers
+    //**************
+    KTINFO(testlog, "Testing the number of slices before each acquisition");
+
+    // a stride of 4 samples fits each acquisition exactly; with a stride of 25, the last slice of each acquisition
+    // would have started in record 1 of the next; and with a stride of 70, the second acquisition is skipped, and the last would start in record 3
+    // of a following acquisition
+    const unsigned strides[] = {4, 4, 25, 25, 70, 70};
+    const unsigned sliceEntries[] = {1, 3, 1, 2, 2, 3};
+    const uint64_t expectedNSlices[] = {10, 28, 2, 3, 1, 2};
+    const uint64_t expectedStartRecords[] = {0, 0, 1, 1, 1, 3};
+    for (unsigned iCase = 0; iCase < 6; ++iCase)
+    {
+        uint64_t startRecord = 0;
+        uint64_t nSlices = readIndex.GetNSlicesBefore(sliceEntries[iCase], recordSize, strides[iCase], startRecord);
+        if (nSlices != expectedNSlices[iCase] || startRecord != expectedStartRecords[iCase])
+        {
+            KTERROR(testlog, "With a stride of " << strides[iCase] << ", there are " << nSlices << " slices before acquisition " << sliceEntries[iCase] <<
+                    ", and its first slice starts in record " << startRecord << "; expected " << expectedNSlices[iCase] << " and " << expectedStartRecords[iCase]);
+            ++nFailures;
+        }
+    }
+
+    //**************
+    // Bad sidecars
+    //**************
+    KTINFO(testlog, "Testing sidecars that must be ignored");
+
+    std::ifstream sidecarIn(sidecarFilename.native());
+    std::string header, entryLines[nAcqs];
+    std::getline(sidecarIn, header);
+    for (unsigned iAcq = 0; iAcq < nAcqs; ++iAcq)
+    {
+        std::getline(sidecarIn, entryLines[iAcq]);
+        entryLines[iAcq] += '\n';
+    }
+    sidecarIn.close();
+
+    // the number of entries is the last field of the header
+    std::string headerStart = header.substr(0, header.rfind(' ') + 1);
+    std::string allEntries = entryLines[0] + entryLines[1] + entryLines[2];
+    const std::string badSidecars[] = {headerStart + "10000000000000\n" + allEntries,
+                                       headerStart + "4\n" + allEntries,
+                                       headerStart + "2\n" + entryLines[0] + entryLines[2]};
+    const char* badDescriptions[] = {"a huge number of entries", "more entries than there are lines", "a gap between its entries"};
+    for (unsigned iBad = 0; iBad < 3; ++iBad)
+    {
+        WriteFile(sidecarFilename, badSidecars[iBad]);
+        KTEggIndex badIndex;
+        if (badIndex.ReadSidecar(eggFilename, 0, 1, recordNBytes))
+        {
+            KTERROR(testlog, "A sidecar with " << badDescriptions[iBad] << " was accepted");
+            ++nFailures;
+        }
+    }
+
+    // with records of 9 bytes, the egg file can only hold 9 of the 11 records
+    WriteFile(sidecarFilename, header + '\n' + allEntries);
+    KTEggIndex tooManyRecords;
+    if (tooManyRecords.ReadSidecar(eggFilename, 0, 1, recordNBytes + 1))
+    {
+        KTERROR(testlog, "A sidecar with more records than the egg file can hold was accepted");
+        ++nFailures;
+    }
+
+    KTEggIndex wrongStream;
+    if (wrongStream.ReadSidecar(eggFilename, 0, 0, recordNBytes))
+    {
+        KTERROR(testlog, "The sidecar of another stream was accepted");
+        ++nFailures;
+    }
+
+    WriteFile(eggFilename, std::string(12 * recordNBytes, 'x'));
+    KTEggIndex stale;
+    if (stale.ReadSidecar(eggFilename, 0, 1, recordNBytes))
+    {
+        KTERROR(testlog, "The sidecar of a changed egg file was accepted");
+        ++nFailures;
+    }
+
+    boost::filesystem::remove(sidecarFilename);
+    boost::filesystem::remove(eggFilename);
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Egg index test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Egg index test complete");
+    return 0;
+}
+
+bool SameEntries(const KTEggIndex& index1, const KTEggIndex& index2)
+{
+    if (index1.GetNEntries() != index2.GetNEntries()) return false;
+    for (unsigned iEntry = 0; iEntry < index1.GetNEntries(); ++iEntry)
+    {
+        const KTEggIndex::Entry& entry1 = index1.GetEntry(iEntry);
+        const KTEggIndex::Entry& entry2 = index2.GetEntry(iEntry);
+        if (entry1.fFile != entry2.fFile || entry1.fAcquisitionId != entry2.fAcquisitionId || entry1.fFirstRecordId != entry2.fFirstRecordId ||
+            entry1.fTimeStamp != entry2.fTimeStamp || entry1.fRecordOffset != entry2.fRecordOffset || entry1.fNRecords != entry2.fNRecords)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void WriteFile(const scarab::path& filename, const std::string& contents)
+{
+    std::ofstream file(filename.native());
+    file << contents;
+    return;
+}
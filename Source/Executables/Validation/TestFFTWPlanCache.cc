@@ -0,0 +1,151 @@
+/*
+ * TestFFTWPlanCache.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestFFTWPlanCache
+ *
+ *  Purpose: Test the keying and reference counting of KTFFTWPlanCache, and check that a shared plan transforms correctly
+ *  when executed on the per-thread scratch arrays (KTFFTWScratch).
+ */
+
+#include "KTFFTWPlanCache.hh"
+#include "KTFFTWScratch.hh"
+#include "KTLogger.hh"
+
+#include <cmath>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestFFTWPlanCache");
+
+int main()
+{
+    const double pi = 3.14159265358979;
+
+    KTFFTWPlanCache* planCache = KTFFTWPlanCache::get_instance();
+    unsigned nPlansStart = planCache->GetNPlans();
+    unsigned nFailures = 0;
+
+    //**************
+    // Keying
+    //**************
+    KTINFO(testlog, "Testing plan keying");
+
+    fftw_plan r2c = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, 64, FFTW_ESTIMATE);
+    if (r2c == NULL)
+    {
+        KTERROR(testlog, "Unable to make a plan");
+        return -1;
+    }
+
+    // the direction is ignored for R2C plans, so this is the same plan
+    fftw_plan r2cSame = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_BACKWARD, 64, FFTW_ESTIMATE);
+    if (r2cSame != r2c || planCache->GetNPlans() != nPlansStart + 1)
+    {
+        KTERROR(testlog, "Identical requests did not share a plan");
+        ++nFailures;
+    }
+
+    // each of these differs from the first plan in one part of the key
+    fftw_plan otherPlans[6];
+    otherPlans[0] = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, 128, FFTW_ESTIMATE); // size
+    otherPlans[1] = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, 64, FFTW_ESTIMATE | FFTW_UNALIGNED); // flags
+    otherPlans[2] = planCache->AcquirePlan(KTFFTWPlanCache::kC2C, FFTW_FORWARD, 64, FFTW_ESTIMATE); // kind
+    otherPlans[3] = planCache->AcquirePlan(KTFFTWPlanCache::kC2C, FFTW_BACKWARD, 64, FFTW_ESTIMATE); // direction (C2C)
+    otherPlans[4] = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, 64, FFTW_ESTIMATE, 4); // # of transforms
+    otherPlans[5] = planCache->AcquirePlan(KTFFTWPlanCache::kC2R, FFTW_BACKWARD, 64, FFTW_ESTIMATE); // kind
+    for (unsigned iPlan = 0; iPlan < 6; ++iPlan)
+    {
+        if (otherPlans[iPlan] == NULL || otherPlans[iPlan] == r2c)
+        {
+            KTERROR(testlog, "Request " << iPlan << " with a different key did not get its own plan");
+            ++nFailures;
+        }
+    }
+    if (planCache->GetNPlans() != nPlansStart + 7)
+    {
+        KTERROR(testlog, "Expected " << nPlansStart + 7 << " plans; found " << planCache->GetNPlans());
+        ++nFailures;
+    }
+
+    // the number of threads is part of the key only if there are multithreaded plans
+    fftw_plan threaded = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, 64, FFTW_ESTIMATE, 1, 2);
+    bool threadedShouldDiffer = KTFFTWPlanCache::GetValidNThreads(2) != 1;
+    if ((threaded != r2c) != threadedShouldDiffer)
+    {
+        KTERROR(testlog, "A plan for 2 threads was " << (threadedShouldDiffer ? "" : "not ") << "shared with the single-threaded plan");
+        ++nFailures;
+    }
+    planCache->ReleasePlan(threaded);
+
+#ifdef FFTWF_FOUND
+    fftwf_plan r2cF = planCache->AcquirePlanF(KTFFTWPlanCache::kR2C, FFTW_FORWARD, 64, FFTW_ESTIMATE);
+    if (r2cF == NULL || planCache->GetNPlans() != nPlansStart + 8)
+    {
+        KTERROR(testlog, "The single-precision plan was not kept separately from the double-precision plan");
+        ++nFailures;
+    }
+    planCache->ReleasePlanF(r2cF);
+#endif
+
+    //**************
+    // Releasing
+    //**************
+    KTINFO(testlog, "Testing plan release");
+
+    for (unsigned iPlan = 0; iPlan < 6; ++iPlan)
+    {
+        planCache->ReleasePlan(otherPlans[iPlan]);
+    }
+    planCache->ReleasePlan(NULL);
+
+    // r2c was acquired twice, so one release leaves it in the cache
+    planCache->ReleasePlan(r2cSame);
+    if (planCache->GetNPlans() != nPlansStart + 1)
+    {
+        KTERROR(testlog, "Expected " << nPlansStart + 1 << " plan after releasing one of two users; found " << planCache->GetNPlans());
+        ++nFailures;
+    }
+
+    //**************
+    // Execution
+    //**************
+    KTINFO(testlog, "Testing execution of a shared plan on the scratch arrays");
+
+    const unsigned size = 64;
+    const unsigned freqBin = 5;
+    double* input = KTFFTWScratch::GetReal(size);
+    fftw_complex* output = KTFFTWScratch::GetComplex(size / 2 + 1);
+    for (unsigned iBin = 0; iBin < size; ++iBin)
+    {
+        input[iBin] = cos(2. * pi * double(freqBin * iBin) / double(size));
+    }
+    fftw_execute_dft_r2c(r2c, input, output);
+    for (unsigned iBin = 0; iBin < size / 2 + 1; ++iBin)
+    {
+        double expected = iBin == freqBin ? 0.5 * double(size) : 0.;
+        if (fabs(output[iBin][0] - expected) > 1.e-9 || fabs(output[iBin][1]) > 1.e-9)
+        {
+            KTERROR(testlog, "Bin " << iBin << ": (" << output[iBin][0] << ", " << output[iBin][1] << "); expected (" << expected << ", 0)");
+            ++nFailures;
+        }
+    }
+
+    planCache->ReleasePlan(r2c);
+    if (planCache->GetNPlans() != nPlansStart)
+    {
+        KTERROR(testlog, "Expected " << nPlansStart << " plans after releasing all users; found " << planCache->GetNPlans());
+        ++nFailures;
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Plan cache test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Plan cache test complete");
+    return 0;
+}
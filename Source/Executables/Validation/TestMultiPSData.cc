@@ -0,0 +1,189 @@
+/*
+ * TestMultiPSData.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestMultiPSData
+ *
+ *  Purpose: Test the contiguous spectrogram block of KTMultiPSData.  Spectra given to SetSpectra() and SetSpectrum() must be
+ *  copied into the rows of the block and become views of those rows; spectra with the wrong number of bins must be dropped;
+ *  RotateSpectra() must move the spectra and their rows together, leaving each spectrum a view of its new row;
+ *  and values set in the block and the time range set with SetTimeRange() must be seen by both the spectra and the block.
+ */
+
+#include "KTMultiPSData.hh"
+
+#include "KTLogger.hh"
+
+#include <vector>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestMultiPSData");
+
+const unsigned nSpectra = 5;
+const unsigned nBins = 13;
+
+KTPowerSpectrum* MakeSpectrum(unsigned id);
+double ExpectedValue(unsigned id, unsigned iBin);
+unsigned CheckSpectra(const KTMultiPSData& data, const std::vector< int >& expectedIDs, const char* stage);
+
+int main()
+{
+    unsigned nFailures = 0;
+
+    //**************
+    // Adopting spectra
+    //**************
+    KTINFO(testlog, "Testing the adoption of spectra by the block");
+
+    // time bin 2 is left empty
+    KTMultiPS* spectra = new KTMultiPS(NULL, nSpectra, 0., 1.);
+    for (unsigned iSpect = 0; iSpect < nSpectra; ++iSpect)
+    {
+        if (iSpect != 2) (*spectra)(iSpect) = MakeSpectrum(iSpect);
+    }
+
+    KTMultiPSData data;
+    data.SetNComponents(1);
+    data.SetSpectra(spectra);
+
+    const KTMultiPSBlock* spectrogram = data.GetSpectrogram();
+    if (spectrogram == NULL || spectrogram->size(1) != nSpectra || spectrogram->size(2) != nBins)
+    {
+        KTERROR(testlog, "The spectrogram block was not made with " << nSpectra << " x " << nBins << " bins");
+        return -1;
+    }
+    int ids[nSpectra] = {0, 1, -1, 3, 4};
+    std::vector< int > expectedIDs(ids, ids + nSpectra);
+    nFailures += CheckSpectra(data, expectedIDs, "SetSpectra()");
+
+    // fill the empty time bin, and replace another spectrum
+    data.SetSpectrum(MakeSpectrum(12), 2);
+    data.SetSpectrum(MakeSpectrum(13), 3);
+    expectedIDs[2] = 12;
+    expectedIDs[3] = 13;
+    nFailures += CheckSpectra(data, expectedIDs, "SetSpectrum()");
+
+    // the values of a spectrum are the values of its row, and are changed through the block
+    data.GetSpectrogram()->GetRow(1)[4] = -1.;
+    if ((*data.GetSpectrum(1))(4) != -1.)
+    {
+        KTERROR(testlog, "A value set in the block was not changed in the spectrum");
+        ++nFailures;
+    }
+    data.GetSpectrogram()->GetRow(1)[4] = ExpectedValue(1, 4);
+
+    data.SetTimeRange(2., 3.);
+    if (data.GetSpectra()->GetRangeMin() != 2. || data.GetSpectra()->GetRangeMax() != 3. || spectrogram->GetRangeMin(1) != 2. || spectrogram->GetRangeMax(1) != 3.)
+    {
+        KTERROR(testlog, "SetTimeRange() did not set the time axis of both the spectra and the block");
+        ++nFailures;
+    }
+
+    //**************
+    // Wrong sizes
+    //**************
+    KTINFO(testlog, "Testing a spectrum with the wrong number of bins (an error message is expected)");
+
+    data.SetSpectrum(new KTPowerSpectrum(nBins + 1, 0., 100.), 4);
+    expectedIDs[4] = -1;
+    nFailures += CheckSpectra(data, expectedIDs, "SetSpectrum() with the wrong size");
+    data.SetSpectrum(MakeSpectrum(4), 4);
+    expectedIDs[4] = 4;
+
+    //**************
+    // Rotation
+    //**************
+    KTINFO(testlog, "Testing the rotation of the spectra");
+
+    data.SetSpectrum(NULL, 0);
+    expectedIDs[0] = -1;
+    const unsigned rotations[] = {2, 0, nSpectra, 2 * nSpectra + 1, nSpectra - 1};
+    for (unsigned iRotation = 0; iRotation < 5; ++iRotation)
+    {
+        data.RotateSpectra(rotations[iRotation]);
+        unsigned shift = rotations[iRotation] % nSpectra;
+        std::vector< int > rotatedIDs(nSpectra);
+        for (unsigned iSpect = 0; iSpect < nSpectra; ++iSpect)
+        {
+            rotatedIDs[iSpect] = expectedIDs[(iSpect + shift) % nSpectra];
+        }
+        expectedIDs = rotatedIDs;
+        nFailures += CheckSpectra(data, expectedIDs, "RotateSpectra()");
+    }
+
+    //**************
+    // New components
+    //**************
+    KTINFO(testlog, "Testing a spectrum set in a new component");
+
+    data.SetSpectrum(MakeSpectrum(20), 3, 1);
+    const KTMultiPSBlock* newSpectrogram = data.GetSpectrogram(1);
+    if (data.GetNComponents() != 2 || newSpectrogram == NULL || newSpectrogram->size(1) != 4 || newSpectrogram->size(2) != nBins ||
+        data.GetSpectrum(3, 1)->GetData() != newSpectrogram->GetRow(3).GetData() || (*newSpectrogram)(3, 5) != ExpectedValue(20, 5))
+    {
+        KTERROR(testlog, "A spectrum set in a new component was not adopted by a new block");
+        ++nFailures;
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Multi-PS data test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Multi-PS data test complete");
+    return 0;
+}
+
+KTPowerSpectrum* MakeSpectrum(unsigned id)
+{
+    KTPowerSpectrum* spectrum = new KTPowerSpectrum(nBins, 0., 100.);
+    for (unsigned iBin = 0; iBin < nBins; ++iBin)
+    {
+        (*spectrum)(iBin) = ExpectedValue(id, iBin);
+    }
+    return spectrum;
+}
+
+double ExpectedValue(unsigned id, unsigned iBin)
+{
+    return 100. * double(id) + double(iBin) + 1.;
+}
+
+// an ID of -1 is an empty time bin, whose row must be zero
+unsigned CheckSpectra(const KTMultiPSData& data, const std::vector< int >& expectedIDs, const char* stage)
+{
+    unsigned nFailures = 0;
+    const KTMultiPS* spectra = data.GetSpectra();
+    const KTMultiPSBlock* spectrogram = data.GetSpectrogram();
+    for (unsigned iSpect = 0; iSpect < nSpectra; ++iSpect)
+    {
+        const KTPowerSpectrum* spectrum = (*spectra)(iSpect);
+        KTMultiPSBlock::const_row_view row = spectrogram->GetRow(iSpect);
+        if ((spectrum == NULL) != (expectedIDs[iSpect] < 0))
+        {
+            KTERROR(testlog, stage << ": time bin " << iSpect << " is " << (spectrum == NULL ? "" : "not ") << "empty");
+            ++nFailures;
+            continue;
+        }
+        if (spectrum != NULL && (spectrum->GetData() != row.GetData() || spectrum->GetOwnsData()))
+        {
+            KTERROR(testlog, stage << ": the spectrum in time bin " << iSpect << " is not a view of its row of the block");
+            ++nFailures;
+        }
+        for (unsigned iBin = 0; iBin < nBins; ++iBin)
+        {
+            double expected = expectedIDs[iSpect] < 0 ? 0. : ExpectedValue(expectedIDs[iSpect], iBin);
+            if (row[iBin] != expected)
+            {
+                KTERROR(testlog, stage << ": bin (" << iSpect << ", " << iBin << ") of the block is " << row[iBin] << "; expected " << expected);
+                ++nFailures;
+                break;
+            }
+        }
+    }
+    return nFailures;
+}
@@ -0,0 +1,264 @@
+/*
+ * TestSlidingDFT.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestSlidingDFT
+ *
+ *  Purpose: Check that the sliding DFT mode of KTSTFT gives the same spectra as a direct FFT of each window.
+ *  The windows overlap and span slice boundaries, and the resync interval is long enough that most spectra come
+ *  from the recursive update.  The test is run over the full frequency range, and over a restricted band, for which
+ *  the bins outside of the band must be zero.
+ *  The STFT's outputs reuse the spectra of earlier outputs, but must not carry over the extensions added to them downstream.
+ */
+
+#include "KTEggHeader.hh"
+#include "KTForwardFFTW.hh"
+#include "KTFrequencySpectrumDataFFTW.hh"
+#include "KTFrequencySpectrumFFTW.hh"
+#include "KTPowerSpectrumData.hh"
+#include "KTSliceHeader.hh"
+#include "KTSTFT.hh"
+#include "KTTimeSeriesData.hh"
+#include "KTTimeSeriesReal.hh"
+
+#include "KTLogger.hh"
+
+#include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <vector>
+
+KTLOGGER(testlog, "TestSlidingDFT");
+
+namespace Katydid
+{
+    class SpectrumCollector : public Nymph::KTProcessor
+    {
+        public:
+            SpectrumCollector() :
+                    Nymph::KTProcessor(),
+                    fNStaleExtensions(0)
+            {
+                this->RegisterSlot("collect", this, &SpectrumCollector::Collect);
+            }
+            virtual ~SpectrumCollector() {}
+
+            bool Configure(const scarab::param_node*)
+            {
+                return true;
+            }
+
+            // the STFT reuses its output spectra, so they are copied
+            void Collect(Nymph::KTDataPtr dataPtr)
+            {
+                // an extension added here must not appear in a later output
+                if (dataPtr->Has< KTPowerSpectrumData >()) ++fNStaleExtensions;
+                dataPtr->Of< KTPowerSpectrumData >();
+
+                const KTSliceHeader& header = dataPtr->Of< KTSliceHeader >();
+                const KTFrequencySpectrumFFTW* spectrum = dataPtr->Of< KTFrequencySpectrumDataFFTW >().GetSpectrumFFTW(0);
+
+                fStartTimes.push_back(header.GetTimeInRun());
+                fSpectra.push_back(std::vector< std::complex< double > >(spectrum->size()));
+                for (unsigned iBin = 0; iBin < spectrum->size(); ++iBin)
+                {
+                    fSpectra.back()[iBin] = std::complex< double >((*spectrum)(iBin)[0], (*spectrum)(iBin)[1]);
+                }
+                return;
+            }
+
+            std::vector< double > fStartTimes;
+            std::vector< std::vector< std::complex< double > > > fSpectra;
+            unsigned fNStaleExtensions;
+    };
+}
+
+
+using namespace Katydid;
+
+unsigned CompareWithDirectFFT(const std::vector< double >& samples, double sampleRate, double minFrequency, double maxFrequency);
+
+const unsigned windowSize = 64;
+const unsigned hopSize = 8;
+const unsigned sliceSize = 100;
+const unsigned nSlices = 20;
+
+int main()
+{
+    const double pi = 3.14159265358979;
+    const double sampleRate = 1000.;
+
+    // a few tones and some noise; the sum stays within the range of the (default) DAC
+    std::vector< double > samples(sliceSize * nSlices);
+    srand(1234);
+    for (unsigned iSample = 0; iSample < samples.size(); ++iSample)
+    {
+        double time = double(iSample) / sampleRate;
+        samples[iSample] = 0.05 * sin(2. * pi * 93.75 * time) + 0.03 * cos(2. * pi * 211. * time + 0.4) + 0.01 * (double(rand()) / double(RAND_MAX) - 0.5);
+    }
+
+    unsigned nFailures = 0;
+
+    KTINFO(testlog, "Testing the sliding DFT over the full frequency range");
+    nFailures += CompareWithDirectFFT(samples, sampleRate, -1., 1.e9);
+
+    KTINFO(testlog, "Testing the sliding DFT over a restricted band");
+    nFailures += CompareWithDirectFFT(samples, sampleRate, 150., 300.);
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Sliding DFT test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Sliding DFT test complete");
+    return 0;
+}
+
+unsigned CompareWithDirectFFT(const std::vector< double >& samples, double sampleRate, double minFrequency, double maxFrequency)
+{
+    unsigned nFailures = 0;
+
+    KTSTFT stft;
+    stft.SetMode(KTSTFT::kSlidingDFT);
+    stft.SetWindowSize(windowSize);
+    stft.SetHopSize(hopSize);
+    stft.SetResyncInterval(1000);
+    stft.SetMinFrequency(minFrequency);
+    stft.SetMaxFrequency(maxFrequency);
+
+    SpectrumCollector collector;
+    stft.ConnectASlot("fft", &collector, "collect");
+
+    KTEggHeader eggHeader;
+    eggHeader.SetAcquisitionRate(sampleRate);
+    KTChannelHeader* channelHeader = new KTChannelHeader();
+    channelHeader->SetRawSliceSize(sliceSize);
+    channelHeader->SetSliceSize(sliceSize);
+    channelHeader->SetSliceStride(sliceSize);
+    channelHeader->SetDataTypeSize(1);
+    channelHeader->SetBitDepth(8);
+    channelHeader->SetBitAlignment(0);
+    channelHeader->SetVoltageOffset(-0.25);
+    channelHeader->SetVoltageRange(0.5);
+    channelHeader->SetDACGain(0.5 / 256.);
+    channelHeader->SetDataFormat(sDigitizedUS);
+    channelHeader->SetTSDataType(KTChannelHeader::kReal);
+    eggHeader.SetChannelHeader(channelHeader, 0);
+
+    if (! stft.InitializeWithHeader(eggHeader))
+    {
+        KTERROR(testlog, "Unable to initialize the STFT");
+        return 1;
+    }
+
+    // the slices are contiguous, and the windows span the slice boundaries
+    KTSliceHeader sliceHeader;
+    sliceHeader.SetNComponents(1);
+    sliceHeader.SetSampleRate(sampleRate);
+    sliceHeader.SetSliceSize(sliceSize);
+    sliceHeader.SetRawSliceSize(sliceSize);
+    sliceHeader.CalculateBinWidthAndSliceLength();
+    for (unsigned iSlice = 0; iSlice < nSlices; ++iSlice)
+    {
+        sliceHeader.SetIsNewAcquisition(iSlice == 0);
+        sliceHeader.SetTimeInRun(double(iSlice * sliceSize) / sampleRate);
+        sliceHeader.SetTimeInAcq(double(iSlice * sliceSize) / sampleRate);
+
+        KTTimeSeriesReal* ts = new KTTimeSeriesReal(sliceSize, 0., double(sliceSize) / sampleRate);
+        for (unsigned iBin = 0; iBin < sliceSize; ++iBin)
+        {
+            (*ts)(iBin) = samples[iSlice * sliceSize + iBin];
+        }
+        KTTimeSeriesData tsData;
+        tsData.SetTimeSeries(ts);
+
+        if (! stft.AddTimeSeriesData(sliceHeader, tsData))
+        {
+            KTERROR(testlog, "Unable to add slice " << iSlice);
+            return 1;
+        }
+    }
+
+    unsigned nExpected = (samples.size() - windowSize) / hopSize + 1;
+    if (collector.fSpectra.size() != nExpected)
+    {
+        KTERROR(testlog, "Expected " << nExpected << " spectra; received " << collector.fSpectra.size());
+        ++nFailures;
+    }
+    if (collector.fNStaleExtensions != 0)
+    {
+        KTERROR(testlog, collector.fNStaleExtensions << " spectra were emitted with an extension added to an earlier output");
+        ++nFailures;
+    }
+
+    KTForwardFFTW directFFT;
+    if (! directFFT.InitializeForRealTDD(windowSize))
+    {
+        KTERROR(testlog, "Unable to initialize the direct FFT");
+        return nFailures + 1;
+    }
+
+    double tolerance = 1.e-9;
+    for (unsigned iSpectrum = 0; iSpectrum < collector.fSpectra.size(); ++iSpectrum)
+    {
+        unsigned startSample = unsigned(collector.fStartTimes[iSpectrum] * sampleRate + 0.5);
+        if (startSample != iSpectrum * hopSize)
+        {
+            KTERROR(testlog, "Spectrum " << iSpectrum << " starts at sample " << startSample << "; expected " << iSpectrum * hopSize);
+            ++nFailures;
+            continue;
+        }
+
+        KTTimeSeriesReal window(windowSize, 0., double(windowSize) / sampleRate);
+        for (unsigned iBin = 0; iBin < windowSize; ++iBin)
+        {
+            window(iBin) = samples[startSample + iBin];
+        }
+        KTFrequencySpectrumFFTW* direct = directFFT.Transform(&window);
+
+        const std::vector< std::complex< double > >& sliding = collector.fSpectra[iSpectrum];
+        if (direct == NULL || direct->size() != sliding.size())
+        {
+            KTERROR(testlog, "The direct FFT of window " << iSpectrum << " does not match the size of the sliding-DFT spectrum");
+            delete direct;
+            return nFailures + 1;
+        }
+
+        unsigned nBadBins = 0;
+        for (unsigned iBin = 0; iBin < direct->size(); ++iBin)
+        {
+            // bins at the edges of the band may go either way
+            double frequency = direct->GetBinCenter(iBin);
+            double binWidth = direct->GetBinWidth();
+            std::complex< double > expected((*direct)(iBin)[0], (*direct)(iBin)[1]);
+            if (frequency < minFrequency - binWidth || frequency > maxFrequency + binWidth)
+            {
+                expected = 0.;
+            }
+            else if (frequency < minFrequency + binWidth || frequency > maxFrequency - binWidth)
+            {
+                continue;
+            }
+
+            if (std::abs(sliding[iBin] - expected) > tolerance)
+            {
+                if (nBadBins == 0)
+                {
+                    KTERROR(testlog, "Spectrum " << iSpectrum << ", bin " << iBin << ": " << sliding[iBin] << "; expected " << expected);
+                }
+                ++nBadBins;
+            }
+        }
+        if (nBadBins != 0)
+        {
+            KTERROR(testlog, "Spectrum " << iSpectrum << " has " << nBadBins << " bin(s) that differ from the direct FFT");
+            ++nFailures;
+        }
+        delete direct;
+    }
+
+    return nFailures;
+}
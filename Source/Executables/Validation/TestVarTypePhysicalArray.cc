@@ -0,0 +1,155 @@
+/*
+ * TestVarTypePhysicalArray.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ *
+ *  Usage: > ./TestVarTypePhysicalArray
+ *
+ *  Purpose: Test the borrowed storage of KTVarTypePhysicalArray.  Borrowed storage must be read in place, without a copy;
+ *  the first write (SetAt() or GetWritableStorage()) must replace it with an owned copy and leave the borrowed buffer unchanged;
+ *  and a write through an interface object (copyData = false) must be made in the storage of the array it was made from.
+ */
+
+#include "KTVarTypePhysicalArray.hh"
+
+#include "KTLogger.hh"
+
+#include <cstdint>
+
+using namespace Katydid;
+
+KTLOGGER(testlog, "TestVarTypePhysicalArray");
+
+const unsigned nBins = 10;
+
+int main()
+{
+    unsigned nFailures = 0;
+
+    uint16_t buffer[nBins];
+    for (unsigned iBin = 0; iBin < nBins; ++iBin)
+    {
+        buffer[iBin] = uint16_t(100 + iBin);
+    }
+    const uint8_t* bufferBytes = reinterpret_cast< const uint8_t* >(buffer);
+
+    //**************
+    // Reading
+    //**************
+    KTINFO(testlog, "Testing reads of borrowed storage");
+
+    KTVarTypePhysicalArray< int > reader(bufferBytes, sizeof(uint16_t), sDigitizedUS, nBins, 0., 1.);
+    if (! reader.GetReadOnlyStorage() || reader.GetOwnsStorage() || reader.GetStorage() != bufferBytes)
+    {
+        KTERROR(testlog, "An array made with borrowed storage does not use that storage read-only");
+        ++nFailures;
+    }
+    for (unsigned iBin = 0; iBin < nBins; ++iBin)
+    {
+        if (reader(iBin) != int(100 + iBin))
+        {
+            KTERROR(testlog, "Borrowed bin " << iBin << " is " << reader(iBin) << "; expected " << 100 + iBin);
+            ++nFailures;
+        }
+    }
+    if (reader.GetStorage() != bufferBytes)
+    {
+        KTERROR(testlog, "The borrowed storage was copied by a read");
+        ++nFailures;
+    }
+
+    //**************
+    // Writing
+    //**************
+    KTINFO(testlog, "Testing writes to borrowed storage");
+
+    KTVarTypePhysicalArray< int > setter(bufferBytes, sizeof(uint16_t), sDigitizedUS, nBins, 0., 1.);
+    setter.SetAt(7, 3);
+    if (setter.GetReadOnlyStorage() || ! setter.GetOwnsStorage() || setter.GetStorage() == bufferBytes)
+    {
+        KTERROR(testlog, "SetAt() did not replace the borrowed storage with an owned copy");
+        ++nFailures;
+    }
+    if (setter(3) != 7 || setter(4) != 104 || buffer[3] != 103)
+    {
+        KTERROR(testlog, "After SetAt(): bins 3 and 4 are " << setter(3) << " and " << setter(4) << ", and the borrowed bin 3 is " << buffer[3] << "; expected 7, 104, and 103");
+        ++nFailures;
+    }
+
+    KTVarTypePhysicalArray< int > writer(bufferBytes, sizeof(uint16_t), sDigitizedUS, nBins, 0., 1.);
+    uint8_t* writable = writer.GetWritableStorage();
+    if (writable == bufferBytes || writer.GetReadOnlyStorage() || writer.GetStorage() != writable)
+    {
+        KTERROR(testlog, "GetWritableStorage() did not replace the borrowed storage with an owned copy");
+        ++nFailures;
+    }
+    reinterpret_cast< uint16_t* >(writable)[5] = 55;
+    if (writer(5) != 55 || writer(6) != 106 || buffer[5] != 105)
+    {
+        KTERROR(testlog, "After a write to the writable storage: bins 5 and 6 are " << writer(5) << " and " << writer(6) << ", and the borrowed bin 5 is " << buffer[5] << "; expected 55, 106, and 105");
+        ++nFailures;
+    }
+
+    //**************
+    // Interfaces
+    //**************
+    KTINFO(testlog, "Testing writes through interface objects");
+
+    KTVarTypePhysicalArray< int > original(bufferBytes, sizeof(uint16_t), sDigitizedUS, nBins, 0., 1.);
+    KTVarTypePhysicalArray< double > interface(original, false);
+    if (! interface.GetReadOnlyStorage() || interface.GetStorage() != bufferBytes || interface(2) != 102.)
+    {
+        KTERROR(testlog, "An interface object of borrowed storage does not read the borrowed storage");
+        ++nFailures;
+    }
+    interface.SetAt(2.5, 2);
+    if (original(2) != 2 || original.GetReadOnlyStorage() || interface.GetStorage() != original.GetStorage() || buffer[2] != 102)
+    {
+        KTERROR(testlog, "A write through an interface object was not made in the original array's copy of the storage (original bin 2 is " << original(2) << "; expected 2)");
+        ++nFailures;
+    }
+    // both arrays now share the original's owned copy
+    original.SetAt(20, 8);
+    if (interface(8) != 20.)
+    {
+        KTERROR(testlog, "A write to the original array was not seen by the interface object");
+        ++nFailures;
+    }
+
+    KTVarTypePhysicalArray< int > owner(sizeof(uint16_t), sDigitizedUS, nBins, 0., 1.);
+    KTVarTypePhysicalArray< double > ownerInterface(owner, false);
+    ownerInterface.SetAt(9., 1);
+    if (ownerInterface.GetReadOnlyStorage() || ownerInterface.GetStorage() != owner.GetStorage() || owner(1) != 9)
+    {
+        KTERROR(testlog, "A write through an interface object of owned storage was not made in the original array");
+        ++nFailures;
+    }
+
+    // a copy owns its storage, so writes to it don't reach the original
+    KTVarTypePhysicalArray< int > copy(original, true);
+    copy.SetAt(1, 0);
+    if (copy.GetReadOnlyStorage() || ! copy.GetOwnsStorage() || original(0) != 100)
+    {
+        KTERROR(testlog, "A write to a copy changed the original array");
+        ++nFailures;
+    }
+
+    for (unsigned iBin = 0; iBin < nBins; ++iBin)
+    {
+        if (buffer[iBin] != uint16_t(100 + iBin))
+        {
+            KTERROR(testlog, "Borrowed bin " << iBin << " was changed to " << buffer[iBin]);
+            ++nFailures;
+        }
+    }
+
+    if (nFailures != 0)
+    {
+        KTERROR(testlog, "Var-type physical array test failed; " << nFailures << " problem(s) found");
+        return -1;
+    }
+
+    KTINFO(testlog, "Var-type physical array test complete");
+    return 0;
+}
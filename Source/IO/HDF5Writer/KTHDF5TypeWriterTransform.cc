@@ -175,10 +175,11 @@ namespace Katydid {
         // Resize Dataset
 
         // If sliceN is greater than the number of Slices per Record, then extend the dataset
-        // This probably happens because there is more than 1 record in the Egg file being processed
+        // This probably happens because there is more than 1 record in the Egg file being processed,
+        // or because the slices are from a shard of the run, which doesn't start at slice 0
         if ( fSliceNumber >= ds_dims[1] )
         {
-            ds_dims[1] = ds_dims[1] + fNumberOfSlices;
+            ds_dims[1] = ( fSliceNumber / fNumberOfSlices + 1 ) * fNumberOfSlices;
             fDSet->extend( ds_dims );
         }
 
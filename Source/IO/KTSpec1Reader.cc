@@ -436,7 +436,7 @@ namespace Katydid
                 KTDEBUG(eggreadlog, "Copying data to slice; " << bytesToCopy << " bytes in " << samplesToCopyFromThisRecord << " samples");
                 for( unsigned iChan = 0; iChan < nChannels; ++iChan )
                 {
-                    memcpy( newSlices[iChan]->GetStorage() + writePosBytes,
+                    memcpy( newSlices[iChan]->GetWritableStorage() + writePosBytes,
                             fM3Stream->GetChannelRecord( iChan )->GetData() + readPosBytes,
                             bytesToCopy );
                 }
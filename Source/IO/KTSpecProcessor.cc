@@ -1,14 +1,9 @@
-#include<iostream>
-#include <fstream>
 #include "KTSpecProcessor.hh"
 #include "KTCommandLineOption.hh"
 #include "KTData.hh"
 #include "KTProcSummary.hh"
-#include "KTPowerSpectrum.hh"
-#include "KTPowerSpectrumData.hh"
 
 using std::string;
-using namespace std;
 
 namespace Katydid
 {
@@ -21,15 +16,17 @@ namespace Katydid
 
     KTSpecProcessor::KTSpecProcessor(const std::string& name) :
             KTPrimaryProcessor(name),
+            fNSpectra(0),
             fProgressReportInterval(1),
             fFilenames(),
-            //fFreqChannels(8192),
-            //fNSpectra(0),
-            //fMinFreq(0.),
-            //fMaxFreq(1600.0),
-            //fBinWidth ((fMaxFreq - fMinFreq)/fFreqChannels),
-            //fHeaderSignal("header", this),
-            fDataSignal("ps", this)
+            fHeaderSize(32),
+            fNBins(8192),
+            fMinFrequency(0.),
+            fMaxFrequency(1.6e9),
+            fTimePerSpectrum(0.),
+            fDataSignal("ps", this),
+            fSpecDoneSignal("spec-done", this),
+            fSummarySignal("summary", this)
     {
     }
 
@@ -42,6 +39,9 @@ namespace Katydid
         // Config-file settings
         if (node != NULL)
         {
+            SetNSpectra(node->get_value< unsigned >("number-of-spectra", fNSpectra));
+            SetProgressReportInterval(node->get_value< unsigned >("progress-report-interval", fProgressReportInterval));
+
             if (node->has("filename"))
             {
                 KTDEBUG(speclog, "Adding single file to spec processor");
@@ -60,6 +60,13 @@ namespace Katydid
                     KTINFO(speclog, "Added file to spec processor: <" << fFilenames.back() << ">");
                 }
             }
+
+            // layout of the spectra in the file
+            SetHeaderSize(node->get_value< unsigned >("header-size", fHeaderSize));
+            SetNBins(node->get_value< unsigned >("n-bins", fNBins));
+            SetMinFrequency(node->get_value< double >("min-frequency", fMinFrequency));
+            SetMaxFrequency(node->get_value< double >("max-frequency", fMaxFrequency));
+            SetTimePerSpectrum(node->get_value< double >("time-per-spectrum", fTimePerSpectrum));
         }
 
         // Command-line settings
@@ -82,61 +89,78 @@ namespace Katydid
             return false;
         }
 
-        // open the file and load its contents into memblock
-        KTINFO(speclog, "Opening spec file <" << fFilenames[0] << ">");
-        streampos size;
-        char * memblock;
-        //ifstream file ("/home/brent/Desktop/SpecFiles/Freq_data_2020-03-25-17-36-18_000000.spec", ios::in|ios::binary|ios::ate);
-
-        std::ifstream file(fFilenames[0].c_str(), ios::in|ios::binary|ios::ate);
-        if (file.is_open())
+        KTSpecReader reader;
+        if (! reader.Configure(*this))
         {
-            size = file.tellg();
-            memblock = new char [size];
-            file.seekg (0, ios::beg);
-            file.read (memblock, size);
-            file.close();
+            KTERROR(speclog, "Unable to configure the spec reader");
+            return false;
         }
 
-        int a [8192];
-        for (int x = 0; x < 8192; x++)
+        KTPROG(speclog, "Proceeding with spectrum processing");
+
+        unsigned iSpectrum = 0, iProgress = 0;
+        // the most recent spectrum is held back until we know whether it's the last one
+        Nymph::KTDataPtr data;
+        bool done = false;
+        for (KTSpecReader::path_vec::const_iterator fileIt = fFilenames.begin(); fileIt != fFilenames.end() && ! done; ++fileIt)
+        {
+            if (! reader.OpenFile(*fileIt))
             {
-            a[x] =  memblock[x+32];
+                KTERROR(speclog, "Unable to open spec file <" << *fileIt << ">");
+                return false;
             }
 
-        KTINFO(speclog, "Spec file <" << fFilenames[0] << "> opened and read");
-
-        //KTDEBUG(speclog, "Parsing Spec file header");
-        //read header
-        //KTDEBUG(speclog, "Parsed header:\n" << fHeader);
+            while (true)
+            {
+                if (fNSpectra != 0 && iSpectrum >= fNSpectra)
+                {
+                    KTPROG(speclog, iSpectrum << "/" << fNSpectra << " spectra read; spectrum processing is complete");
+                    done = true;
+                    break;
+                }
 
-        //KTSpecHeader& header = headerPtr->Of< KTEggHeader >();
+                Nymph::KTDataPtr nextData = reader.HatchNextSpectrum();
+                if (! nextData) break;
 
-        //fHeaderSignal(headerPtr);
+                if (data) fDataSignal(data);
+                data = nextData;
+                ++iSpectrum;
+                ++iProgress;
 
-        //initialize an object of type KTPowerSpectrum with all 0
-        //values and 8192 channels from 0 to 1600 MHz
-        size_t bins = 8192;
-        double min = 0.0;
-        double max = 1600.00;
-        KTPowerSpectrum newSlice(a, bins, min, max);
+                if (iProgress == fProgressReportInterval)
+                {
+                    iProgress = 0;
+                    KTPROG(speclog, iSpectrum << " spectra processed");
+                }
+            }
 
-        Nymph::KTDataPtr data(new Nymph::KTData());
-        unsigned comp = 1;
-        KTPowerSpectrumData& psData = data->Of< KTPowerSpectrumData >().SetNComponents(comp);
+            // the emitted data do not refer to the file, so it can be closed before the last spectrum is emitted
+            reader.CloseFile();
+        }
 
-        KTINFO(speclog, "Setting spectrum object");
-        psData.SetSpectrum(&newSlice, comp);
+        if (data)
+        {
+            data->Of< Nymph::KTData >().SetLastData(true);
+            fDataSignal(data);
+        }
+        else
+        {
+            KTWARN(speclog, "No spectra were found in the spec file(s)");
+        }
 
-        KTINFO(speclog, "Output data signal");
-        fDataSignal(data);
-        KTINFO(speclog, "Data signal output");
+        fSpecDoneSignal();
 
-        //delete[] memblock;
+        KTProcSummary* summary = new KTProcSummary();
+        summary->SetNSlicesProcessed(reader.GetNSpectraProcessed());
+        summary->SetNRecordsProcessed(reader.GetNSpectraProcessed());
+        summary->SetIntegratedTime(reader.GetIntegratedTime());
+        KTDEBUG(speclog, "Summary of processing:\n" <<
+                "\tSpectra processed: " << summary->GetNSlicesProcessed() << '\n' <<
+                "\tIntegrated time: " << summary->GetIntegratedTime() << " s");
+        fSummarySignal(summary);
+        delete summary;
 
         return true;
     }
 
-
-
 } /* namespace Katydid */
@@ -1,16 +1,15 @@
-#ifndef KTEGGPROCESSOR_HH_
-#define KTEGGPROCESSOR_HH_
+#ifndef KTSPECPROCESSOR_HH_
+#define KTSPECPROCESSOR_HH_
 
 #include "KTPrimaryProcessor.hh"
 #include "KTData.hh"
-//#include "KTSpecHeader.hh"
 #include "KTSpecReader.hh"
 #include "KTSlot.hh"
 
 namespace Katydid
 {
 
-    class KTPowerSpectrumData;
+    class KTProcSummary;
 
     /*!
      @class KTSpecProcessor
@@ -18,25 +17,34 @@ namespace Katydid
 
      @brief reads a file with power spectrum data
 
+     @details
+     Each file is memory mapped and the spectra are read from it one at a time (see KTSpecReader for the file format);
+     a power spectrum is emitted for every spectrum in every file.
+
      Configuration name: "spec-processor"
 
      Available configuration options:
+     - "number-of-spectra": unsigned -- Number of spectra to process; 0 (default) processes all of the spectra in all of the files
      - "progress-report-interval": unsigned -- Interval (# of slices) between
         reports (mainly relevant for RELEASE builds); turn off by setting to 0
      - "filename": string -- Spec filename to use
         (will take priority over \"filenames\")
      - "filenames": array of strings -- Spec filenames to use
         (\"filename\" will take priority over this)
+     - "header-size": unsigned -- Size of the header of each spectrum, in bytes; default is 32
+     - "n-bins": unsigned -- Number of frequency bins in each spectrum (one byte each); default is 8192
+     - "min-frequency": double -- Frequency of the lower edge of the first bin, in Hz; default is 0
+     - "max-frequency": double -- Frequency of the upper edge of the last bin, in Hz; default is 1.6e9
+     - "time-per-spectrum": double -- Time covered by each spectrum, in s; the default (0) uses the inverse of the bin width
 
      Command-line options defined
      - -s (spec-file): spec filename to use
 
      Signals:
-     - "header": void (Nymph::KTDataPtr) -- emitted when the header is parsed.
-     - "psd": void (Nymph::KTDataPtr) -- emitted when the new power spectrum is
-        produced; Guarantees KTPowerSpectrumData
-     - "spec-done": void () --  emitted when a file is finished.
-     - "summary": void (const KTProcSummary*) -- emitted when a file is
+     - "ps": void (Nymph::KTDataPtr) -- emitted when the new power spectrum is
+        produced; Guarantees KTPowerSpectrumData and KTSliceHeader
+     - "spec-done": void () --  emitted when all of the files are finished.
+     - "summary": void (const KTProcSummary*) -- emitted when all of the files are
         finished (after "spec-done")
 
     */
@@ -52,14 +60,21 @@ namespace Katydid
 
             bool ProcessSpec();
 
+            MEMBERVARIABLE(unsigned, NSpectra);
             MEMBERVARIABLE(unsigned, ProgressReportInterval);
 
             MEMBERVARIABLEREF(KTSpecReader::path_vec, Filenames);
 
+            MEMBERVARIABLE(unsigned, HeaderSize);
+            MEMBERVARIABLE(unsigned, NBins);
+            MEMBERVARIABLE(double, MinFrequency);
+            MEMBERVARIABLE(double, MaxFrequency);
+            MEMBERVARIABLE(double, TimePerSpectrum);
+
         private:
-            //Nymph::KTSignalData fHeaderSignal;
             Nymph::KTSignalData fDataSignal;
-
+            Nymph::KTSignalOneArg< void > fSpecDoneSignal;
+            Nymph::KTSignalOneArg< const KTProcSummary* > fSummarySignal;
 
     };
 
@@ -1,5 +1,5 @@
 /*
- * KTEggReader.cc
+ * KTSpecReader.cc
  *
  *  Created on: Aug 20, 2012
  *      Author: nsoblath
@@ -7,10 +7,28 @@
 
 #include "KTSpecReader.hh"
 
+#include "KTLogger.hh"
+#include "KTPowerSpectrum.hh"
+#include "KTPowerSpectrumData.hh"
+#include "KTSliceHeader.hh"
+#include "KTSpecProcessor.hh"
+
 namespace Katydid
 {
+    KTLOGGER(specreadlog, "KTSpecReader");
 
-    KTSpecReader::KTSpecReader()
+    KTSpecReader::KTSpecReader() :
+            fHeaderSize(32),
+            fNBins(8192),
+            fMinFrequency(0.),
+            fMaxFrequency(1.6e9),
+            fTimePerSpectrum(0.),
+            fNSpectraProcessed(0),
+            fNFilesOpened(0),
+            fFile(),
+            fPacketSize(32 + 8192),
+            fNPacketsInFile(0),
+            fNextPacket(0)
     {
     }
 
@@ -18,4 +36,142 @@ namespace Katydid
     {
     }
 
+    bool KTSpecReader::Configure(const KTSpecProcessor& specProc)
+    {
+        SetHeaderSize(specProc.GetHeaderSize());
+        SetNBins(specProc.GetNBins());
+        SetMinFrequency(specProc.GetMinFrequency());
+        SetMaxFrequency(specProc.GetMaxFrequency());
+        SetTimePerSpectrum(specProc.GetTimePerSpectrum());
+
+        if (fNBins == 0)
+        {
+            KTERROR(specreadlog, "The number of bins must be greater than 0");
+            return false;
+        }
+        if (fMaxFrequency <= fMinFrequency)
+        {
+            KTERROR(specreadlog, "The maximum frequency (" << fMaxFrequency << " Hz) must be greater than the minimum frequency (" << fMinFrequency << " Hz)");
+            return false;
+        }
+        if (fHeaderSize < 32)
+        {
+            KTERROR(specreadlog, "The packet header must be at least 32 bytes");
+            return false;
+        }
+        fPacketSize = fHeaderSize + fNBins;
+        return true;
+    }
+
+    bool KTSpecReader::OpenFile(const scarab::path& filename)
+    {
+        CloseFile();
+
+        KTINFO(specreadlog, "Opening spec file <" << filename << ">");
+        if (! fFile.Open(filename.native()))
+        {
+            return false;
+        }
+
+        fNPacketsInFile = unsigned(fFile.GetSize() / fPacketSize);
+        if (fFile.GetSize() % fPacketSize != 0)
+        {
+            KTWARN(specreadlog, "The size of spec file <" << filename << "> (" << fFile.GetSize() << " bytes) is not a multiple of the packet size (" <<
+                    fPacketSize << " bytes); the last " << fFile.GetSize() % fPacketSize << " bytes will be ignored");
+        }
+        KTINFO(specreadlog, "Spec file <" << filename << "> contains " << fNPacketsInFile << " packets");
+
+        fNextPacket = 0;
+        ++fNFilesOpened;
+        return true;
+    }
+
+    void KTSpecReader::CloseFile()
+    {
+        fFile.Close();
+        fNPacketsInFile = 0;
+        fNextPacket = 0;
+        return;
+    }
+
+    Nymph::KTDataPtr KTSpecReader::HatchNextSpectrum()
+    {
+        PacketHeader header;
+        const char* packet = NULL;
+        while (fNextPacket < fNPacketsInFile)
+        {
+            packet = fFile.GetData() + std::size_t(fNextPacket) * std::size_t(fPacketSize);
+            ParsePacketHeader(packet, header);
+            // pages before this packet won't be used again
+            fFile.ReleaseBefore(std::size_t(fNextPacket) * std::size_t(fPacketSize));
+            ++fNextPacket;
+            if (header.fFreqNotTime) break;
+            KTDEBUG(specreadlog, "Skipping time-domain packet " << fNextPacket - 1);
+            packet = NULL;
+        }
+        if (packet == NULL) return Nymph::KTDataPtr();
+
+        double spectrumLength = GetSpectrumLength();
+        Nymph::KTDataPtr newData(new Nymph::KTData());
+
+        KTSliceHeader& sliceHeader = newData->Of< KTSliceHeader >().SetNComponents(1);
+        // a real-valued time series of (2 * nBins) samples gives nBins frequency bins over the bandwidth
+        sliceHeader.SetSampleRate(2. * (fMaxFrequency - fMinFrequency));
+        sliceHeader.SetRawSliceSize(2 * fNBins);
+        sliceHeader.SetSliceSize(2 * fNBins);
+        sliceHeader.CalculateBinWidthAndSliceLength();
+        sliceHeader.SetSliceLength(spectrumLength);
+        sliceHeader.SetNonOverlapFrac(1.);
+        sliceHeader.SetNSlicesIncluded(1);
+        sliceHeader.SetSliceNumber(fNSpectraProcessed);
+        sliceHeader.SetTimeInRun(double(fNSpectraProcessed) * spectrumLength);
+        sliceHeader.SetTimeInAcq(double(fNextPacket - 1) * spectrumLength);
+        sliceHeader.SetIsNewAcquisition(fNextPacket == 1);
+        sliceHeader.SetStartRecordNumber(fNSpectraProcessed);
+        sliceHeader.SetStartSampleNumber(0);
+        sliceHeader.SetEndRecordNumber(fNSpectraProcessed);
+        sliceHeader.SetEndSampleNumber(2 * fNBins - 1);
+        sliceHeader.SetRecordSize(2 * fNBins);
+        sliceHeader.SetTimeStamp(uint64_t(header.fUnixTime) * 1000000000);
+        sliceHeader.SetAcquisitionID(fNFilesOpened - 1);
+        sliceHeader.SetRecordID(fNSpectraProcessed);
+
+        KTPowerSpectrum* spectrum = new KTPowerSpectrum(fNBins, fMinFrequency, fMaxFrequency);
+        const unsigned char* values = reinterpret_cast< const unsigned char* >(packet + fHeaderSize);
+        for (unsigned iBin = 0; iBin < fNBins; ++iBin)
+        {
+            (*spectrum)(iBin) = double(values[iBin]);
+        }
+
+        KTPowerSpectrumData& psData = newData->Of< KTPowerSpectrumData >().SetNComponents(1);
+        psData.SetSpectrum(spectrum, 0);
+
+        ++fNSpectraProcessed;
+        return newData;
+    }
+
+    void KTSpecReader::ParsePacketHeader(const char* bytes, PacketHeader& header)
+    {
+        const unsigned char* uBytes = reinterpret_cast< const unsigned char* >(bytes);
+        uint64_t words[4];
+        for (unsigned iWord = 0; iWord < 4; ++iWord)
+        {
+            // big-endian (network order)
+            words[iWord] = 0;
+            for (unsigned iByte = 0; iByte < 8; ++iByte)
+            {
+                words[iWord] = (words[iWord] << 8) | uint64_t(uBytes[8 * iWord + iByte]);
+            }
+        }
+
+        header.fUnixTime = uint32_t(words[0] >> 32);
+        header.fPacketInBatch = uint32_t((words[0] >> 12) & 0xFFFFF);
+        header.fDigitalID = unsigned((words[0] >> 6) & 0x3F);
+        header.fIFID = unsigned(words[0] & 0x3F);
+        header.fUserData1 = uint32_t(words[1] >> 32);
+        header.fUserData0 = uint32_t(words[1] & 0xFFFFFFFF);
+        header.fFreqNotTime = (words[3] & 0x1) != 0;
+        return;
+    }
+
 } /* namespace Katydid */
@@ -1,5 +1,5 @@
 /*
- * KTEggReader.hh
+ * KTSpecReader.hh
  *
  *  Created on: Aug 20, 2012
  *      Author: nsoblath
@@ -9,30 +9,112 @@
 #define KTSPECREADER_HH_
 
 #include "KTData.hh"
+#include "KTMemberVariable.hh"
+#include "KTMemoryMappedFile.hh"
 
-#include "factory.hh"
 #include "path.hh"
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace Katydid
 {
 
     class KTSpecProcessor;
 
+    /*!
+     @class KTSpecReader
+     @author B. Graner
+
+     @brief Reads power spectra from .spec files
+
+     @details
+     A .spec file is a sequence of ROACH frequency-domain packets, each of which holds one spectrum:
+     - a header of fHeaderSize bytes (32 by default), made of four big-endian 64-bit words:
+       - word 0: unix time (32 bits), packet in batch (20 bits), digital ID (6 bits), IF ID (6 bits)
+       - word 1: user data 1 (32 bits), user data 0 (32 bits)
+       - word 2: reserved
+       - word 3: reserved (63 bits), frequency-not-time flag (1 bit)
+     - fNBins unsigned 8-bit power values, covering fMinFrequency to fMaxFrequency
+
+     Files are memory mapped and read in place; packets are decoded one at a time, so the memory used does not depend on the size of the file.
+     Time-domain packets (frequency-not-time flag is not set) are skipped.
+
+     Spectra are numbered (slice number and record ID) consecutively through all of the files that are read;
+     the time in the run assumes that the spectra are contiguous, each covering fTimePerSpectrum.
+    */
     class KTSpecReader
     {
         public:
             typedef std::vector< scarab::path > path_vec;
 
+            struct PacketHeader
+            {
+                uint32_t fUnixTime;
+                uint32_t fPacketInBatch;
+                unsigned fDigitalID;
+                unsigned fIFID;
+                uint32_t fUserData1;
+                uint32_t fUserData0;
+                bool fFreqNotTime;
+            };
+
         public:
             KTSpecReader();
             virtual ~KTSpecReader();
 
         public:
-            virtual bool Configure(const KTSpecProcessor& specProc) = 0;
+            bool Configure(const KTSpecProcessor& specProc);
+
+            /// Maps a file and checks its size; any previously-opened file is closed
+            bool OpenFile(const scarab::path& filename);
+            void CloseFile();
+
+            /// Returns the next spectrum in the current file, or an empty pointer when there are no more
+            Nymph::KTDataPtr HatchNextSpectrum();
+
+            /// Number of packets in the current file
+            unsigned GetNPacketsInFile() const;
+
+            MEMBERVARIABLE(unsigned, HeaderSize); // bytes
+            MEMBERVARIABLE(unsigned, NBins);
+            MEMBERVARIABLE(double, MinFrequency); // Hz
+            MEMBERVARIABLE(double, MaxFrequency); // Hz
+            MEMBERVARIABLE(double, TimePerSpectrum); // s; if 0, the inverse of the bin width is used
+
+            MEMBERVARIABLE_NOSET(unsigned, NSpectraProcessed);
+            MEMBERVARIABLE_NOSET(unsigned, NFilesOpened);
+
+        public:
+            double GetIntegratedTime() const;
+
+            static void ParsePacketHeader(const char* bytes, PacketHeader& header);
 
+        private:
+            double GetSpectrumLength() const;
+
+            KTMemoryMappedFile fFile;
+            unsigned fPacketSize;
+            unsigned fNPacketsInFile;
+            unsigned fNextPacket;
     };
 
+    inline unsigned KTSpecReader::GetNPacketsInFile() const
+    {
+        return fNPacketsInFile;
+    }
+
+    inline double KTSpecReader::GetIntegratedTime() const
+    {
+        return double(fNSpectraProcessed) * GetSpectrumLength();
+    }
+
+    inline double KTSpecReader::GetSpectrumLength() const
+    {
+        if (fTimePerSpectrum > 0.) return fTimePerSpectrum;
+        return double(fNBins) / (fMaxFrequency - fMinFrequency);
+    }
+
 } /* namespace Katydid */
 #endif /* KTSPECREADER_HH_ */
@@ -12,8 +12,6 @@
 #include "KTTimeSeriesDistData.hh"
 
 
-using boost::shared_ptr;
-
 namespace Katydid
 {
     KTLOGGER(avlog, "KTAmplitudeCounter");
@@ -8,6 +8,7 @@
 #include "KTConvolution.hh"
 
 #include "KTConvolvedSpectrumData.hh"
+#include "KTFFTWPlanCache.hh"
 #include "KTFrequencySpectrumPolar.hh"
 #include "KTFrequencySpectrumFFTW.hh"
 #include "KTPowerSpectrum.hh"
@@ -33,6 +34,7 @@ namespace Katydid
             fNormalizeKernel(false),
             fTransformType("convolution"),
             fTransformFlag("ESTIMATE"),
+            fNThreads(KTFFTWPlanCache::GetDefaultNThreads()),
             fRegularSize(0),
             fShortSize(0),
             fTransformFlagMap(),
@@ -63,6 +65,7 @@ namespace Katydid
             fGeneralReversePlan(),
             fGeneralForwardPlanShort(),
             fGeneralReversePlanShort(),
+            fGeneralIsReal(false),
             fTransformFlagUnsigned(FFTW_ESTIMATE),
             fKernelSize(0),
             fInitialized(false),
@@ -89,6 +92,7 @@ namespace Katydid
         SetBlockSize(node->get_value< unsigned >("block-size", GetBlockSize()));
         SetTransformType(node->get_value< std::string >("transform-type", GetTransformType()));
         SetTransformFlag(node->get_value< std::string >("transform-flag", GetTransformFlag()));
+        SetNThreads(node->get_value< unsigned >("n-threads", GetNThreads()));
 
         return FinishSetup();
     }
@@ -154,16 +158,18 @@ namespace Katydid
         fTransformedInputArrayFromReal = (fftw_complex*) fftw_malloc( sizeof( fftw_complex ) * (nSizeRegular/2 + 1) );
         fTransformedOutputArrayFromReal = (fftw_complex*) fftw_malloc( sizeof( fftw_complex ) * (nSizeRegular/2 + 1) );
 
-        // DFT plans
-        fRealToComplexPlan = fftw_plan_dft_r2c_1d( nSizeRegular, fInputArrayReal, fTransformedInputArrayFromReal, fTransformFlagUnsigned );
-        fComplexToRealPlan = fftw_plan_dft_c2r_1d( nSizeRegular, fTransformedOutputArrayFromReal, fOutputArrayReal, fTransformFlagUnsigned );
-        fC2CForwardPlan = fftw_plan_dft_1d( nSizeRegular, fInputArrayComplex, fTransformedInputArray, FFTW_FORWARD, fTransformFlagUnsigned );
-        fC2CReversePlan = fftw_plan_dft_1d( nSizeRegular, fTransformedOutputArray, fOutputArrayComplex, FFTW_BACKWARD, fTransformFlagUnsigned );
+        // DFT plans, shared with any other users of the same sizes
+        // They're executed on the arrays above with the new-array execute functions
+        KTFFTWPlanCache* planCache = KTFFTWPlanCache::get_instance();
+        fRealToComplexPlan = planCache->AcquirePlan( KTFFTWPlanCache::kR2C, FFTW_FORWARD, nSizeRegular, fTransformFlagUnsigned, 1, fNThreads );
+        fComplexToRealPlan = planCache->AcquirePlan( KTFFTWPlanCache::kC2R, FFTW_BACKWARD, nSizeRegular, fTransformFlagUnsigned, 1, fNThreads );
+        fC2CForwardPlan = planCache->AcquirePlan( KTFFTWPlanCache::kC2C, FFTW_FORWARD, nSizeRegular, fTransformFlagUnsigned, 1, fNThreads );
+        fC2CReversePlan = planCache->AcquirePlan( KTFFTWPlanCache::kC2C, FFTW_BACKWARD, nSizeRegular, fTransformFlagUnsigned, 1, fNThreads );
 
-        fRealToComplexPlanShort = fftw_plan_dft_r2c_1d( nSizeShort, fInputArrayReal, fTransformedInputArrayFromReal, fTransformFlagUnsigned );
-        fComplexToRealPlanShort = fftw_plan_dft_c2r_1d( nSizeShort, fTransformedOutputArrayFromReal, fOutputArrayReal, fTransformFlagUnsigned );
-        fC2CForwardPlanShort = fftw_plan_dft_1d( nSizeShort, fInputArrayComplex, fTransformedInputArray, FFTW_FORWARD, fTransformFlagUnsigned );
-        fC2CReversePlanShort = fftw_plan_dft_1d( nSizeShort, fTransformedOutputArray, fOutputArrayComplex, FFTW_BACKWARD, fTransformFlagUnsigned );
+        fRealToComplexPlanShort = planCache->AcquirePlan( KTFFTWPlanCache::kR2C, FFTW_FORWARD, nSizeShort, fTransformFlagUnsigned, 1, fNThreads );
+        fComplexToRealPlanShort = planCache->AcquirePlan( KTFFTWPlanCache::kC2R, FFTW_BACKWARD, nSizeShort, fTransformFlagUnsigned, 1, fNThreads );
+        fC2CForwardPlanShort = planCache->AcquirePlan( KTFFTWPlanCache::kC2C, FFTW_FORWARD, nSizeShort, fTransformFlagUnsigned, 1, fNThreads );
+        fC2CReversePlanShort = planCache->AcquirePlan( KTFFTWPlanCache::kC2C, FFTW_BACKWARD, nSizeShort, fTransformFlagUnsigned, 1, fNThreads );
 
         // All the same for short size
         // But we can skip this if the size is chosen right
@@ -226,43 +232,43 @@ namespace Katydid
 
         if( fRealToComplexPlan != nullptr )
         {
-            fftw_destroy_plan( fRealToComplexPlan );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fRealToComplexPlan );
             fRealToComplexPlan = nullptr;
         }
         if( fComplexToRealPlan != nullptr )
         {
-            fftw_destroy_plan( fComplexToRealPlan );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fComplexToRealPlan );
             fComplexToRealPlan = nullptr;
         }
         if( fC2CForwardPlan != nullptr )
         {
-            fftw_destroy_plan( fC2CForwardPlan );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fC2CForwardPlan );
             fC2CForwardPlan = nullptr;
         }
         if( fC2CReversePlan != nullptr )
         {
-            fftw_destroy_plan( fC2CReversePlan );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fC2CReversePlan );
             fC2CReversePlan = nullptr;
         }
 
         if( fRealToComplexPlanShort != nullptr )
         {
-            fftw_destroy_plan( fRealToComplexPlanShort );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fRealToComplexPlanShort );
             fRealToComplexPlanShort = nullptr;
         }
         if( fComplexToRealPlanShort != nullptr )
         {
-            fftw_destroy_plan( fComplexToRealPlanShort );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fComplexToRealPlanShort );
             fComplexToRealPlanShort = nullptr;
         }
         if( fC2CForwardPlanShort != nullptr )
         {
-            fftw_destroy_plan( fC2CForwardPlanShort );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fC2CForwardPlanShort );
             fC2CForwardPlanShort = nullptr;
         }
         if( fC2CReversePlanShort != nullptr )
         {
-            fftw_destroy_plan( fC2CReversePlanShort );
+            KTFFTWPlanCache::get_instance()->ReleasePlan( fC2CReversePlanShort );
             fC2CReversePlanShort = nullptr;
         }
 
@@ -369,6 +375,20 @@ namespace Katydid
         return CoreConvolve1D( static_cast< KTFrequencySpectrumDataPolarCore& >(data), newData );
     }
 
+    void KTConvolution1D::ExecuteGeneralForward( fftw_plan plan )
+    {
+        if( fGeneralIsReal ) fftw_execute_dft_r2c( plan, fInputArrayReal, fGeneralTransformedInputArray );
+        else fftw_execute_dft( plan, fInputArrayComplex, fGeneralTransformedInputArray );
+        return;
+    }
+
+    void KTConvolution1D::ExecuteGeneralReverse( fftw_plan plan )
+    {
+        if( fGeneralIsReal ) fftw_execute_dft_c2r( plan, fGeneralTransformedOutputArray, fOutputArrayReal );
+        else fftw_execute_dft( plan, fGeneralTransformedOutputArray, fOutputArrayComplex );
+        return;
+    }
+
     template< class XSpectraType >
     bool KTConvolution1D::SetUpGeneralVars()
     {
@@ -385,6 +405,7 @@ namespace Katydid
         fGeneralForwardPlanShort = fRealToComplexPlanShort;
         fGeneralReversePlan = fComplexToRealPlan;
         fGeneralReversePlanShort = fComplexToRealPlanShort;
+        fGeneralIsReal = true;
         nBinLimitRegular = fRegularSize/2 + 1;
         nBinLimitShort = fShortSize/2 + 1;
 
@@ -401,6 +422,7 @@ namespace Katydid
         fGeneralForwardPlanShort = fC2CForwardPlanShort;
         fGeneralReversePlan = fC2CReversePlan;
         fGeneralReversePlanShort = fC2CReversePlanShort;
+        fGeneralIsReal = false;
         nBinLimitRegular = fRegularSize;
         nBinLimitShort = fShortSize;
 
@@ -417,6 +439,7 @@ namespace Katydid
         fGeneralForwardPlanShort = fC2CForwardPlanShort;
         fGeneralReversePlan = fC2CReversePlan;
         fGeneralReversePlanShort = fC2CReversePlanShort;
+        fGeneralIsReal = false;
         nBinLimitRegular = fRegularSize;
         nBinLimitShort = fShortSize;
 
@@ -585,8 +608,8 @@ namespace Katydid
             fInputArrayComplex[iBin][1] = 0.;
         }
 
-        fftw_execute( fRealToComplexPlan );
-        fftw_execute( fC2CForwardPlan );
+        fftw_execute_dft_r2c( fRealToComplexPlan, fInputArrayReal, fTransformedInputArrayFromReal );
+        fftw_execute_dft( fC2CForwardPlan, fInputArrayComplex, fTransformedInputArray );
         
         fTransformedKernelXAsReal = new fftw_complex[block];
         fTransformedKernelXAsComplex = new fftw_complex[block];
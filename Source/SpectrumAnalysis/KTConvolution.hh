@@ -61,6 +61,7 @@ namespace Katydid
      - "normalize": bool -- Normalize the kernel. If false, the output will be scaled by the norm of the kernel
      - "transform-type": std::string -- "convolution" or "cross-correlation"
      - "transform-flag": std:string -- Transform flag for FFTW
+     - "n-threads": unsigned int -- Number of threads used by each FFT (default: the FFTW_NTHREADS build setting); the block FFTs are large, so they can benefit from threading
 
      Slots:
      - "ps": void (Nymph::KTDataPtr) -- Convolves a power spectrum; Requires KTPowerSpectrumData; Adds KTConvolvedPowerSpectrumData
@@ -90,6 +91,7 @@ namespace Katydid
             MEMBERVARIABLE(bool, NormalizeKernel);
             MEMBERVARIABLE(std::string, TransformType);
             MEMBERVARIABLE_NOSET(std::string, TransformFlag);
+            MEMBERVARIABLE(unsigned, NThreads);
 
             MEMBERVARIABLE_NOSET(double, RegularSize);
             MEMBERVARIABLE_NOSET(double, ShortSize);
@@ -136,6 +138,7 @@ namespace Katydid
             fftw_plan fGeneralReversePlan;
             fftw_plan fGeneralForwardPlanShort;
             fftw_plan fGeneralReversePlanShort;
+            bool fGeneralIsReal;
 
             unsigned fTransformFlagUnsigned;
             int fKernelSize;
@@ -174,6 +177,9 @@ namespace Katydid
             void SetOutputArray( int position, int nBin, KTFrequencySpectrumFFTW& transformedFSFFTW, double norm );
             void SetOutputArray( int position, int nBin, KTFrequencySpectrumPolar& transformedFSPolar, double norm );
 
+            void ExecuteGeneralForward( fftw_plan plan );
+            void ExecuteGeneralReverse( fftw_plan plan );
+
             void SetupInternalMaps();
 
             bool FinishSetup();
@@ -292,7 +298,7 @@ namespace Katydid
 
             // FFT of input block
             KTDEBUG(convlog_hh, "Performing DFT");
-            fftw_execute( fGeneralForwardPlan );
+            ExecuteGeneralForward( fGeneralForwardPlan );
 
             // Bin multiplication in fourier space
             KTDEBUG(convlog_hh, "Multiplying arrays in fourier space");
@@ -305,7 +311,7 @@ namespace Katydid
 
             // Reverse FFT of output block
             KTDEBUG(convlog_hh, "Performing reverse DFT");
-            fftw_execute( fGeneralReversePlan );
+            ExecuteGeneralReverse( fGeneralReversePlan );
 
             // Loop over bins in the output block and fill the convolved spectrum
             for( int nBin = overlap; nBin < block; ++nBin )
@@ -344,7 +350,7 @@ namespace Katydid
         KTDEBUG(convlog_hh, "Initialized short array length = " << fShortSize);
 
         // FFT of input block
-        fftw_execute( fGeneralForwardPlanShort );
+        ExecuteGeneralForward( fGeneralForwardPlanShort );
 
         for( int nBin = 0; nBin < nBinLimitShort; ++nBin )
         {
@@ -353,7 +359,7 @@ namespace Katydid
         }
 
         // Reverse FFT of output block
-        fftw_execute( fGeneralReversePlanShort );
+        ExecuteGeneralReverse( fGeneralReversePlanShort );
 
         // Loop over bins in the output block and fill the convolved spectrum
         for( int nBin = overlap; nBin < fShortSize; ++nBin )
@@ -198,12 +198,7 @@ namespace Katydid
         {
             KTTimeSeriesReal* newTS = static_cast< KTTimeSeriesReal* >(data.GetTimeSeries(iComponent));
             KTTimeSeriesReal* avTS = static_cast< KTTimeSeriesReal* >(accData.GetTimeSeries(iComponent));
-            for (unsigned iBin = 0; iBin < arraySize; ++iBin)
-            {
-                //KTDEBUG(avlog, (*avTS)(iBin) << "  " << (*newTS)(iBin) << "  " << remainingFrac << "  " << fAveragingFrac);
-                (*avTS)(iBin) = (*avTS)(iBin) * remainingFrac + (*newTS)(iBin) * fAveragingFrac;
-                //KTDEBUG(avlog, (*avTS)(iBin));
-            }
+            avTS->Assign(*avTS * remainingFrac + *newTS * fAveragingFrac);
         }
 
         return true;
@@ -512,13 +507,8 @@ namespace Katydid
             KTPowerSpectrum* avSpect = accData.GetSpectrum(iComponent);
             KTFrequencySpectrumVariance* varSpect = devData.GetSpectrum(iComponent);
             avSpect->SetMode(newSpect->GetMode());
-            double avCache = 0.;
-            for (unsigned iBin = 0; iBin < arraySize; ++iBin)
-            {
-                avCache = (*avSpect)(iBin);
-                (*avSpect)(iBin) = avCache * remainingFrac + (*newSpect)(iBin) * fAveragingFrac;
-                (*varSpect)(iBin) = (*varSpect)(iBin) * remainingFrac + (*newSpect)(iBin) * (*newSpect)(iBin) * fAveragingFrac;
-            }
+            avSpect->Assign(*avSpect * remainingFrac + *newSpect * fAveragingFrac);
+            varSpect->Assign(*varSpect * remainingFrac + *newSpect * *newSpect * fAveragingFrac);
         }
 
         return true;
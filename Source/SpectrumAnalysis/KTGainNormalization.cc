@@ -347,15 +347,12 @@ namespace Katydid
             {
                 (*newSpectrum)(iBin) = (*powerSpectrum)(iBin);
             }
-
-            // Then scale the bins within the scaling range
-#pragma omp for private(iBin)
-            for (iBin=fMinBin; iBin < fMaxBin+1; ++iBin)
-            {
-                (*newSpectrum)(iBin) = normalizedMean + ((*powerSpectrum)(iBin) - (*splineImp)(iBin - fMinBin)) * sqrt(normalizedVariance / (*varSplineImp)(iBin - fMinBin));
-            }
         }
 
+        // Then scale the bins within the scaling range, in one pass
+        KTArrayRef< double > inRange(powerSpectrum->GetData() + fMinBin, nBins);
+        KTArrayEvaluate(newSpectrum->GetData() + fMinBin, normalizedMean + (inRange - *splineImp) * KTArraySqrt(normalizedVariance / *varSplineImp));
+
         return newSpectrum;
     }
 
@@ -16,6 +16,8 @@
 
 #include "param.hh"
 
+#include <algorithm>
+
 
 namespace Katydid
 {
@@ -99,6 +101,22 @@ namespace Katydid
         return CoreAddData(header, static_cast< KTPowerSpectrumDataCore& >(data), accDataStruct, accData);
     }
 
+    void KTSpectrogramStriper::PerformSwaps(KTMultiPSDataCore& stripeData, unsigned component)
+    {
+        const KTMultiPS& spectra = *stripeData.GetSpectra(component);
+
+        // calculate min/max times
+        double minTime = spectra.GetBinLowEdge(fSwaps[0].first);
+        double maxTime = minTime + fStripeSize * spectra.GetBinWidth();
+
+        // the swaps move each spectrum back by the same number of bins
+        stripeData.RotateSpectra(fSwaps[0].first, component);
+
+        // apply new min and max times
+        stripeData.SetTimeRange(minTime, maxTime, component);
+        return;
+    }
+
     bool KTSpectrogramStriper::OutputStripes()
     {
         KTINFO(sslog, "Outputting all histograms");
@@ -127,11 +145,26 @@ namespace Katydid
         }
     }
 
-    void KTSpectrogramStriper::CopySpectrum(const KTPowerSpectrum* source, KTPowerSpectrum* dest, unsigned arraySize)
+    void KTSpectrogramStriper::ZeroSpectra(KTMultiPSDataCore& stripeData, unsigned component, unsigned firstSpect)
+    {
+        KTMultiPSBlock* spectrogram = stripeData.GetSpectrogram(component);
+        if (spectrogram == NULL || firstSpect >= spectrogram->size(1)) return;
+        std::fill(spectrogram->begin() + firstSpect * spectrogram->GetStride(), spectrogram->end(), 0.);
+        return;
+    }
+
+    void KTSpectrogramStriper::SetTimeRange(KTMultiPSDataCore& stripeData, unsigned component, double startTime, double endTime)
+    {
+        stripeData.SetTimeRange(startTime, endTime, component);
+        return;
+    }
+
+    void KTSpectrogramStriper::CopySpectrum(const KTPowerSpectrum* source, KTMultiPSDataCore& stripeData, unsigned component, unsigned iSpect, unsigned arraySize)
     {
+        KTMultiPSBlock::row_view dest = stripeData.GetSpectrogram(component)->GetRow(iSpect);
         for (unsigned iBin = 0; iBin < arraySize; ++iBin)
         {
-            (*dest)(iBin) = (*source)(iBin);
+            dest[iBin] = (*source)(iBin);
         }
     }
 
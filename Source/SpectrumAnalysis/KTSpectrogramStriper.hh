@@ -29,6 +29,7 @@ namespace Katydid
 {
     class KTFrequencySpectrumFFTW;
     class KTFrequencySpectrumPolar;
+    class KTMultiPSDataCore;
     class KTPowerSpectrum;
 
     KTLOGGER(sslog_h, "KTSpectrogramStriper");
@@ -119,8 +120,10 @@ namespace Katydid
             const std::vector< std::pair< unsigned, unsigned > >& Swaps() const;
 
         private:
-            template< class XDataType >
-            void PerformSwaps(XDataType& data);
+            template< class XMultiSpectrumDataCore >
+            void PerformSwaps(XMultiSpectrumDataCore& stripeData, unsigned component);
+            /// Power spectra are stored in one contiguous block, so the values are rotated instead of the pointers
+            void PerformSwaps(KTMultiPSDataCore& stripeData, unsigned component);
 
             template< class XDataType >
             TypedStripeAccumulator< XDataType >& GetOrCreateAccumulator();
@@ -128,6 +131,19 @@ namespace Katydid
             template< class XSpectrumDataCore, class XMultiSpectrumDataCore >
             bool CoreAddData(const KTSliceHeader& header, const XSpectrumDataCore& data, StripeAccumulator& stripeDataStruct, XMultiSpectrumDataCore& stripeData);
 
+            /// Sets the values of the spectra from time bin firstSpect onwards to 0
+            template< class XMultiSpectrumDataCore >
+            void ZeroSpectra(XMultiSpectrumDataCore& stripeData, unsigned component, unsigned firstSpect);
+            template< class XMultiSpectrumDataCore >
+            void SetTimeRange(XMultiSpectrumDataCore& stripeData, unsigned component, double startTime, double endTime);
+            template< class XSpectrum, class XMultiSpectrumDataCore >
+            void CopySpectrum(const XSpectrum* source, XMultiSpectrumDataCore& stripeData, unsigned component, unsigned iSpect, unsigned arraySize);
+
+            // The power spectra of KTMultiPSData can't be changed directly; their values are set through the rows of the block
+            void ZeroSpectra(KTMultiPSDataCore& stripeData, unsigned component, unsigned firstSpect);
+            void SetTimeRange(KTMultiPSDataCore& stripeData, unsigned component, double startTime, double endTime);
+            void CopySpectrum(const KTPowerSpectrum* source, KTMultiPSDataCore& stripeData, unsigned component, unsigned iSpect, unsigned arraySize);
+
             // FS FFTW functions
             const KTFrequencySpectrumFFTW* GetSpectrum(const KTFrequencySpectrumDataFFTWCore& data, const unsigned iComponent) const;
             void CopySpectrum(const KTFrequencySpectrumFFTW* source, KTFrequencySpectrumFFTW* dest, unsigned arraySize);
@@ -138,7 +154,6 @@ namespace Katydid
 
             // PS functions
             const KTPowerSpectrum* GetSpectrum(const KTPowerSpectrumDataCore& data, const unsigned iComponent) const;
-            void CopySpectrum(const KTPowerSpectrum* source, KTPowerSpectrum* dest, unsigned arraySize);
 
             AccumulatorMap fDataMap;
             mutable StripeAccumulator* fLastAccumulatorPtr;
@@ -168,15 +183,17 @@ namespace Katydid
     };
 
 
-    template< class XSpectraType >
-    void KTSpectrogramStriper::PerformSwaps(XSpectraType& spectra)
+    template< class XMultiSpectrumDataCore >
+    void KTSpectrogramStriper::PerformSwaps(XMultiSpectrumDataCore& stripeData, unsigned component)
     {
+        typename XMultiSpectrumDataCore::multi_spectrum_type& spectra = *stripeData.GetSpectra(component);
+
         // calculate min/max times
         double minTime = spectra.GetBinLowEdge(fSwaps[0].first);
         double maxTime = minTime + fStripeSize * spectra.GetBinWidth();
 
         // send element 0 to a holding buffer
-        typename XSpectraType::value_type bufferSpectrum = spectra(0);
+        typename XMultiSpectrumDataCore::multi_spectrum_type::value_type bufferSpectrum = spectra(0);
         // do mapped swaps
         unsigned nSwaps = fSwaps.size();
         for (unsigned iSwap = 0; iSwap < nSwaps; ++iSwap)
@@ -236,14 +253,10 @@ namespace Katydid
 
             for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
             {
-                typename XMultiSpectrumDataCore::multi_spectrum_type* spectra = stripeData.GetSpectra(iComponent);
                 // reset the values all to 0
-                for (unsigned iSpect = 0; iSpect < spectra->size(); ++iSpect)
-                {
-                    spectra->operator()(iSpect)->operator*=(0.);
-                }
+                ZeroSpectra(stripeData, iComponent, 0);
                 // set the time axis
-                spectra->SetRange(header.GetTimeInRun(), header.GetTimeInRun() + fStripeSize * header.GetSliceLength());
+                SetTimeRange(stripeData, iComponent, header.GetTimeInRun(), header.GetTimeInRun() + fStripeSize * header.GetSliceLength());
             }
 
             stripeDataStruct.fSliceHeader.CopySliceHeaderOnly(header);
@@ -256,13 +269,9 @@ namespace Katydid
             KTDEBUG(sslog_h, "Performing swap for overlap region");
             for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
             {
-                typename XMultiSpectrumDataCore::multi_spectrum_type* spectra = stripeData.GetSpectra(iComponent);
-                PerformSwaps(*spectra);
+                PerformSwaps(stripeData, iComponent);
                 // zero out all spectra after the overlap
-                for (unsigned iSpect = fStripeOverlap; iSpect < spectra->size(); ++iSpect)
-                {
-                    spectra->operator()(iSpect)->operator*=(0.);
-                }
+                ZeroSpectra(stripeData, iComponent, fStripeOverlap);
             }
         }
 
@@ -281,7 +290,7 @@ namespace Katydid
 
         for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
         {
-            CopySpectrum(GetSpectrum(data, iComponent), (*stripeData.GetSpectra(iComponent))(stripeDataStruct.fNextBin), arraySize);
+            CopySpectrum(GetSpectrum(data, iComponent), stripeData, iComponent, stripeDataStruct.fNextBin, arraySize);
         }
 
         stripeDataStruct.fNextBin += 1;
@@ -297,6 +306,31 @@ namespace Katydid
         return true;
     }
 
+    template< class XMultiSpectrumDataCore >
+    void KTSpectrogramStriper::ZeroSpectra(XMultiSpectrumDataCore& stripeData, unsigned component, unsigned firstSpect)
+    {
+        typename XMultiSpectrumDataCore::multi_spectrum_type* spectra = stripeData.GetSpectra(component);
+        for (unsigned iSpect = firstSpect; iSpect < spectra->size(); ++iSpect)
+        {
+            spectra->operator()(iSpect)->operator*=(0.);
+        }
+        return;
+    }
+
+    template< class XMultiSpectrumDataCore >
+    void KTSpectrogramStriper::SetTimeRange(XMultiSpectrumDataCore& stripeData, unsigned component, double startTime, double endTime)
+    {
+        stripeData.GetSpectra(component)->SetRange(startTime, endTime);
+        return;
+    }
+
+    template< class XSpectrum, class XMultiSpectrumDataCore >
+    void KTSpectrogramStriper::CopySpectrum(const XSpectrum* source, XMultiSpectrumDataCore& stripeData, unsigned component, unsigned iSpect, unsigned arraySize)
+    {
+        CopySpectrum(source, (*stripeData.GetSpectra(component))(iSpect), arraySize);
+        return;
+    }
+
 
     inline const std::vector< std::pair< unsigned, unsigned > >& KTSpectrogramStriper::Swaps() const
     {
@@ -49,6 +49,7 @@ namespace Katydid
      - "min-voltage": double -- Set the minimum voltage for the digitizer
      - "voltage-range": double -- Set the full-scale voltage range for the digitizer
      - "n-bits-emulated": unsigned -- Set the number of bits to emulate
+     - "precision": string -- "double" (default) or "float"; single precision produces KTTimeSeriesRealF or KTTimeSeriesFFTWF, for use with a single-precision forward FFT; "float" is only available if Katydid was built with single-precision FFTW
 
      Slots:
      - "header": void (KTEggHeader*) -- Sets up the DACs with the header information and then updates the contents if the bit depths are being changed; Emits signal "header"
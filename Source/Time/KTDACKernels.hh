@@ -0,0 +1,204 @@
+/**
+ @file KTDACKernels.hh
+ @brief Contains KTDACKernel
+ @details Typed conversion loops from digitized levels to voltages
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTDACKERNELS_HH_
+#define KTDACKERNELS_HH_
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace Katydid
+{
+
+    /*!
+     @class KTDACKernel
+     @author agent
+
+     @brief Converts a block of digitized samples of type XRawType to voltages
+
+     @details
+     The input is the raw storage of a time series, interpreted as XRawType; the output is written directly into a contiguous array
+     of doubles or, for the single-precision processing path, floats.
+     Interleaved IQ data are converted the same way, with the output being the interleaved real and imaginary parts
+     of the complex time series (i.e. 2 * nSamples values).
+
+     Two forms are provided:
+     - ConvertLinear(): voltage = gain * level + offset; used when the voltage table is affine (the usual case).
+       For uint8_t, int8_t, uint16_t and int16_t, an AVX2 version is used when Katydid is compiled for a target that supports it
+       (4 samples per instruction for double output, 8 for float output); that is off by default, and is turned on with the CMake option
+       Katydid_ENABLE_AVX2 (or with compiler flags such as -mavx2 or -march=native in CMAKE_CXX_FLAGS).
+       Otherwise the loop is simple enough for the compiler to vectorize.
+     - ConvertLookup(): voltage = voltages[level]; used when the table is not affine (e.g. when the bit depth is reduced).
+       For signed types, voltages should point to the entry for level 0.
+    */
+    template< typename XRawType >
+    struct KTDACKernel
+    {
+        template< typename XOutputType >
+        static void ConvertLinear(const XRawType* in, XOutputType* out, unsigned n, double gain, double offset);
+        template< typename XOutputType >
+        static void ConvertLookup(const XRawType* in, XOutputType* out, unsigned n, const double* voltages);
+    };
+
+
+    // Vectorized heads of the linear conversion; each returns the number of samples converted.
+    // The generic version does nothing, and the scalar loop does all of the work.
+
+    template< typename XRawType, typename XOutputType >
+    inline unsigned KTDACConvertLinearSIMD(const XRawType*, XOutputType*, unsigned, double, double)
+    {
+        return 0;
+    }
+
+#if defined(__AVX2__)
+    inline __m128i KTDACLoadAsInt32x4(const uint8_t* in)
+    {
+        int32_t packed;
+        memcpy(&packed, in, sizeof(packed));
+        return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+    }
+
+    inline __m128i KTDACLoadAsInt32x4(const int8_t* in)
+    {
+        int32_t packed;
+        memcpy(&packed, in, sizeof(packed));
+        return _mm_cvtepi8_epi32(_mm_cvtsi32_si128(packed));
+    }
+
+    inline __m128i KTDACLoadAsInt32x4(const uint16_t* in)
+    {
+        return _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast< const __m128i* >(in)));
+    }
+
+    inline __m128i KTDACLoadAsInt32x4(const int16_t* in)
+    {
+        return _mm_cvtepi16_epi32(_mm_loadl_epi64(reinterpret_cast< const __m128i* >(in)));
+    }
+
+    inline __m256i KTDACLoadAsInt32x8(const uint8_t* in)
+    {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast< const __m128i* >(in)));
+    }
+
+    inline __m256i KTDACLoadAsInt32x8(const int8_t* in)
+    {
+        return _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast< const __m128i* >(in)));
+    }
+
+    inline __m256i KTDACLoadAsInt32x8(const uint16_t* in)
+    {
+        return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast< const __m128i* >(in)));
+    }
+
+    inline __m256i KTDACLoadAsInt32x8(const int16_t* in)
+    {
+        return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast< const __m128i* >(in)));
+    }
+
+    template< typename XRawType >
+    inline unsigned KTDACConvertLinearAVX2(const XRawType* in, double* out, unsigned n, double gain, double offset)
+    {
+        const __m256d gainVec = _mm256_set1_pd(gain);
+        const __m256d offsetVec = _mm256_set1_pd(offset);
+        unsigned i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m256d levels = _mm256_cvtepi32_pd(KTDACLoadAsInt32x4(in + i));
+            _mm256_storeu_pd(out + i, _mm256_add_pd(_mm256_mul_pd(levels, gainVec), offsetVec));
+        }
+        return i;
+    }
+
+    template< typename XRawType >
+    inline unsigned KTDACConvertLinearAVX2(const XRawType* in, float* out, unsigned n, double gain, double offset)
+    {
+        const __m256 gainVec = _mm256_set1_ps(float(gain));
+        const __m256 offsetVec = _mm256_set1_ps(float(offset));
+        unsigned i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            __m256 levels = _mm256_cvtepi32_ps(KTDACLoadAsInt32x8(in + i));
+            _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(levels, gainVec), offsetVec));
+        }
+        return i;
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const uint8_t* in, double* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const int8_t* in, double* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const uint16_t* in, double* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const int16_t* in, double* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const uint8_t* in, float* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const int8_t* in, float* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const uint16_t* in, float* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+
+    inline unsigned KTDACConvertLinearSIMD(const int16_t* in, float* out, unsigned n, double gain, double offset)
+    {
+        return KTDACConvertLinearAVX2(in, out, n, gain, offset);
+    }
+#endif
+
+
+    template< typename XRawType >
+    template< typename XOutputType >
+    void KTDACKernel< XRawType >::ConvertLinear(const XRawType* in, XOutputType* out, unsigned n, double gain, double offset)
+    {
+        unsigned i = KTDACConvertLinearSIMD(in, out, n, gain, offset);
+        const XOutputType gainOut = gain;
+        const XOutputType offsetOut = offset;
+        for (; i < n; ++i)
+        {
+            out[i] = XOutputType(in[i]) * gainOut + offsetOut;
+        }
+        return;
+    }
+
+    template< typename XRawType >
+    template< typename XOutputType >
+    void KTDACKernel< XRawType >::ConvertLookup(const XRawType* in, XOutputType* out, unsigned n, const double* voltages)
+    {
+        for (unsigned i = 0; i < n; ++i)
+        {
+            out[i] = voltages[in[i]];
+        }
+        return;
+    }
+
+} /* namespace Katydid */
+
+#endif /* KTDACKERNELS_HH_ */
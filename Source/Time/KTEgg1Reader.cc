@@ -9,6 +9,7 @@
 
 #include "KTEggHeader.hh"
 #include "KTLogger.hh"
+#include "KTMemoryMappedFile.hh"
 #include "KTSliceHeader.hh"
 #include "KTRawTimeSeriesData.hh"
 #include "KTRawTimeSeries.hh"
@@ -16,11 +17,8 @@
 #include "rapidxml.hpp"
 //#include "rapidxml_print.hpp"
 
-#include <cstring>
 #include <vector>
 
-using std::ifstream;
-using std::fstream;
 using std::string;
 using std::stringstream;
 using std::vector;
@@ -30,14 +28,15 @@ namespace Katydid
 {
     KTLOGGER(eggreadlog, "KTEgg1Reader");
 
-    const ifstream::pos_type KTEgg1Reader::sPreludeSize = 9;
+    const unsigned KTEgg1Reader::sPreludeSize = 9;
 
     KT_REGISTER_EGGREADER(KTEgg1Reader, "egg1");
 
     KTEgg1Reader::KTEgg1Reader() :
             KTEggReader(),
             fFileName(),
-            fEggStream(),
+            fEggFile(),
+            fReadPos(0),
             fPrelude(),
             fHeaderSize(0),
             fHeader(),
@@ -60,59 +59,49 @@ namespace Katydid
     Nymph::KTDataPtr KTEgg1Reader::BreakEgg(const path_vec& filenames)
     {
         // First, read all of the information from the file and put it in the right places
-        if (fEggStream.is_open()) fEggStream.close();
+        CloseEgg();
 
-        // open the file stream
+        // map the file
         if (filenames.size() > 1)
         {
             KTWARN(eggreadlog, "Egg1 reader is only setup to handle a single file; multiple files have been specified and all but the first one will be skipped");
         }
-        KTINFO(eggreadlog, "Opening egg file <" << filenames[0] << ">")
-        fEggStream.open(filenames[0].c_str(), ifstream::in|ifstream::binary);
-
-        if (! fEggStream.is_open())
+        KTINFO(eggreadlog, "Opening egg file <" << filenames[0] << ">");
+        std::shared_ptr< KTMemoryMappedFile > eggFile = std::make_shared< KTMemoryMappedFile >();
+        if (! eggFile->Open(filenames[0].native()))
         {
-            KTERROR(eggreadlog, "Egg filestream did not open (file: " << filenames[0] << ")");
+            KTERROR(eggreadlog, "Egg file did not open (file: " << filenames[0] << ")");
             return Nymph::KTDataPtr();
         }
 
         // read the prelude (which states how long the header is in hex)
-        // add one to the size of the array to allow it to terminate in a null character
-        //int readBufferSize = (int)sPreludeSize + 1;
-        char* readBuffer = new char [(int)sPreludeSize];
-        int readSize = (int)sPreludeSize - 1;
-        fEggStream.read(readBuffer, readSize);
-        if (! fEggStream.good())
+        std::size_t readSize = sPreludeSize - 1;
+        if (eggFile->GetSize() < readSize)
         {
-            KTERROR(eggreadlog, "Egg filestream is bad after reading the prelude");
-            delete [] readBuffer;
+            KTERROR(eggreadlog, "Egg file is too short to contain the prelude");
             return Nymph::KTDataPtr();
         }
-        string newPrelude(readBuffer, sPreludeSize);
-        fPrelude = newPrelude;
+        fPrelude = string(eggFile->GetData(), readSize);
 
         // convert the prelude to the header size
         stringstream conversion;
-        conversion << readBuffer;
+        conversion << fPrelude;
         conversion >> std::hex >> fHeaderSize;
         //KTDEBUG(eggreadlog, "header size: " << fHeaderSize);
 
         // read the header
-        delete [] readBuffer;
-        readBuffer = new char [fHeaderSize+1];
-        fEggStream.read(readBuffer, fHeaderSize);
-        if (! fEggStream.good())
+        if (eggFile->GetSize() < readSize + fHeaderSize)
         {
-            KTERROR(eggreadlog, "Egg filestream is bad after reading the header");
-            delete [] readBuffer;
+            KTERROR(eggreadlog, "Egg file is too short to contain the header");
             return Nymph::KTDataPtr();
         }
-        readBuffer[fHeaderSize] = '\0';
-        string newHeader(readBuffer);
-        fHeader = newHeader;
-        KTDEBUG(eggreadlog, "Header: " << newHeader);
+        // the header is null-terminated by the writer if it's shorter than the stated size
+        fHeader = string(eggFile->GetData() + readSize, fHeaderSize);
+        fHeader = fHeader.c_str();
+        KTDEBUG(eggreadlog, "Header: " << fHeader);
 
-        delete [] readBuffer;
+        fEggFile = eggFile;
+        fReadPos = readSize + fHeaderSize;
 
         // All data has been read from the file at this point
 
@@ -124,11 +113,12 @@ namespace Katydid
 
         // Parse the XML header
         rapidxml::xml_document<char> headerDOM;
-        char* headerCopy = new char [fHeader.size()+1];
-        strcpy(headerCopy, fHeader.c_str());
+        // rapidxml parses in place, so it needs a modifiable copy
+        vector< char > headerCopy(fHeader.begin(), fHeader.end());
+        headerCopy.push_back('\0');
         try
         {
-            headerDOM.parse<0>(headerCopy);
+            headerDOM.parse<0>(headerCopy.data());
         }
         catch (rapidxml::parse_error& e)
         {
@@ -177,6 +167,11 @@ namespace Katydid
         fHeaderInfo.fRecordSize = ConvertFromArray< int >(attr->value());
 
         fHeaderInfo.fSliceSize = fHeaderInfo.fFrameIDSize + fHeaderInfo.fTimeStampSize + fHeaderInfo.fRecordSize;
+        if (fHeaderInfo.fRecordSize <= 0 || fHeaderInfo.fFrameIDSize < 0 || fHeaderInfo.fTimeStampSize < 0)
+        {
+            KTERROR(eggreadlog, "Invalid data format in the header");
+            return Nymph::KTDataPtr();
+        }
 
         rapidxml::xml_node<char>* nodeDigitizer = nodeHeader->first_node("digitizer");
         if (nodeDigitizer == NULL)
@@ -207,8 +202,6 @@ namespace Katydid
         }
         fHeaderInfo.fRunLength = ConvertFromArray< double >(attr->value()) * fHeaderInfo.fSecondsPerRunLengthUnit; // in seconds
 
-        delete [] headerCopy;
-
         KTDEBUG(eggreadlog, "Parsed header:\n"
              << "\tFrame ID Size: " << fHeaderInfo.fFrameIDSize << '\n'
              << "\tTime Stamp Size: " << fHeaderInfo.fTimeStampSize << '\n'
@@ -256,72 +249,46 @@ namespace Katydid
 
     Nymph::KTDataPtr KTEgg1Reader::HatchNextSlice()
     {
-        if (! fEggStream.good()) return Nymph::KTDataPtr();
+        if (! fEggFile) return Nymph::KTDataPtr();
+
+        std::size_t remaining = fEggFile->GetSize() - fReadPos;
+        if (remaining < std::size_t(fHeaderInfo.fSliceSize))
+        {
+            if (remaining > 0)
+            {
+                KTWARN(eggreadlog, "The last record in the file is incomplete\n"
+                        << "\tExpected: " << fHeaderInfo.fSliceSize << '\n'
+                        << "\tAvailable: " << remaining);
+            }
+            return Nymph::KTDataPtr();
+        }
 
         Nymph::KTDataPtr newData(new Nymph::KTData());
 
         KTSliceHeader& sliceHeader = newData->Of< KTSliceHeader >().SetNComponents(1);
 
-        unsigned char* readBuffer;
+        const char* readPtr = fEggFile->GetData() + fReadPos;
 
         // read the time stamp
-        readBuffer = new unsigned char [fHeaderInfo.fTimeStampSize];
-        fEggStream.read((char*)(&readBuffer[0]), fHeaderInfo.fTimeStampSize);
-        if (fEggStream.gcount() != fHeaderInfo.fTimeStampSize)
-        {
-            KTWARN(eggreadlog, "Size of the data read for the time stamp did not match the size expected\n"
-                    << "\tExpected: " << fHeaderInfo.fTimeStampSize << '\n'
-                    << "\tRead: " << fEggStream.gcount());
-            delete [] readBuffer;
-        }
-        else
-        {
-            //vector< unsigned > newTimeStamp(readBuffer, readBuffer + fHeaderInfo.fTimeStampSize/sizeof(unsigned char));
-            unsigned long int newTimeStamp = ConvertFromArray< unsigned long >(readBuffer);
-            delete [] readBuffer;
-            sliceHeader.SetTimeStamp(newTimeStamp);
-            //std::cout << "Time stamp (" << newTimeStamp.size() << " chars): ";
-            //for (int i=0; i<newTimeStamp.size(); i++)
-            //    std::cout << newTimeStamp[i];
-            //std::cout << std::endl;
-        }
-        if (! fEggStream.good())
-        {
-            KTERROR(eggreadlog, "Reached end of file after reading time stamp size");
-            return Nymph::KTDataPtr();
-        }
-
-        // read the frame size
-        readBuffer = new unsigned char [fHeaderInfo.fFrameIDSize];
-        fEggStream.read((char*)(&readBuffer[0]), fHeaderInfo.fFrameIDSize);
-        if (fEggStream.gcount() != fHeaderInfo.fFrameIDSize)
+        string timeStampField(readPtr, fHeaderInfo.fTimeStampSize);
+        unsigned long int newTimeStamp = ConvertFromArray< unsigned long >(timeStampField.c_str());
+        sliceHeader.SetTimeStamp(newTimeStamp);
+        readPtr += fHeaderInfo.fTimeStampSize;
+
+        // read the frame ID
+        string frameIDField(readPtr, fHeaderInfo.fFrameIDSize);
+        unsigned newFrameID = ConvertFromArray< unsigned >(frameIDField.c_str());
+        sliceHeader.SetAcquisitionID(newFrameID);
+        if (newFrameID == fLastFrameID && fRecordsRead > 0)
         {
-            KTWARN(eggreadlog, "The size of the data read for the frame ID did not match the expected size\n"
-                    << "\tExpected: " << fHeaderInfo.fFrameIDSize << '\n'
-                    << "\tRead: " << fEggStream.gcount());
-            delete [] readBuffer;
+            sliceHeader.SetIsNewAcquisition(false);
         }
         else
         {
-            //vector< unsigned > newFrameID(readBuffer, readBuffer + fHeaderInfo.fFrameIDSize()/sizeof(unsigned char));
-            unsigned newFrameID = ConvertFromArray< unsigned >(readBuffer);
-            delete [] readBuffer;
-            sliceHeader.SetAcquisitionID(newFrameID);
-            if (newFrameID == fLastFrameID && fRecordsRead > 0)
-            {
-                sliceHeader.SetIsNewAcquisition(false);
-            }
-            else
-            {
-                sliceHeader.SetIsNewAcquisition(true);
-                fLastFrameID = newFrameID;
-            }
-        }
-        if (! fEggStream.good())
-        {
-            KTERROR(eggreadlog, "Reached end of file after reading frame size");
-            return Nymph::KTDataPtr();
+            sliceHeader.SetIsNewAcquisition(true);
+            fLastFrameID = newFrameID;
         }
+        readPtr += fHeaderInfo.fFrameIDSize;
 
         // Other information
         sliceHeader.SetSampleRate(double(fHeaderInfo.fSampleRate));
@@ -339,41 +306,23 @@ namespace Katydid
         sliceHeader.SetRecordSize(fHeaderInfo.fRecordSize);
         sliceHeader.SetRawDataFormatType(fHeaderInfo.fDataFormat, 0);
 
-        // read the record
-        readBuffer = new unsigned char [fHeaderInfo.fRecordSize];
-        fEggStream.read((char*)(&readBuffer[0]), fHeaderInfo.fRecordSize);
-        if (fEggStream.gcount() != fHeaderInfo.fRecordSize)
-        {
-            KTWARN(eggreadlog, "Size of the data read for the record did not match the amount expected"
-                    << "\tExpected: :" << fHeaderInfo.fRecordSize << '\n'
-                    << "\tRead: " << fEggStream.gcount());
-            delete [] readBuffer;
-            return Nymph::KTDataPtr();
-        }
-        else
-        {
-            //vector< DataType >* newRecord = new vector< DataType >(readBuffer, readBuffer + fHeaderInfo.fRecordSize/sizeof(unsigned char));
-            KTRawTimeSeries* newRecord = new KTRawTimeSeries(1, sDigitizedUS, fHeaderInfo.fRecordSize, 0., double(fHeaderInfo.fRecordSize) * sliceHeader.GetBinWidth());
-            for (int iBin=0; iBin<fHeaderInfo.fRecordSize; iBin++)
-            {
-                newRecord->SetAt(readBuffer[iBin], iBin);
-            }
-            delete [] readBuffer;
-            KTRawTimeSeriesData& tsData = newData->Of< KTRawTimeSeriesData >().SetNComponents(1);
-            tsData.SetTimeSeries(newRecord);
-            fRecordsRead++;
-        }
-        if (! fEggStream.good())
-        {
-            KTERROR(eggreadlog, "Egg stream state is not good after reading in this slice.");
-        }
+        // the record is used in place; the time series keeps the mapped file alive
+        KTRawTimeSeries* newRecord = new KTRawTimeSeries(fEggFile, reinterpret_cast< const uint8_t* >(readPtr), 1, sDigitizedUS,
+                fHeaderInfo.fRecordSize, 0., double(fHeaderInfo.fRecordSize) * sliceHeader.GetBinWidth());
+        KTRawTimeSeriesData& tsData = newData->Of< KTRawTimeSeriesData >().SetNComponents(1);
+        tsData.SetTimeSeries(newRecord);
+
+        fReadPos += fHeaderInfo.fSliceSize;
+        fRecordsRead++;
 
         return newData;
     }
 
     bool KTEgg1Reader::CloseEgg()
     {
-        if (fEggStream.is_open()) fEggStream.close();
+        // slices that still refer to the file keep it mapped
+        fEggFile.reset();
+        fReadPos = 0;
         return true;
     }
 
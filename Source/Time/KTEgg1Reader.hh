@@ -12,13 +12,24 @@
 
 #include "KTConstants.hh"
 
-#include <fstream>
+#include <memory>
 #include <sstream>
 
 namespace Katydid
 {
-    
+    class KTMemoryMappedFile;
 
+    /*!
+     @class KTEgg1Reader
+     @author N. S. Oblath
+
+     @brief Reads 2011-format egg files
+
+     @details
+     The file is memory mapped: the prelude and header are parsed in place, and the raw time series of each slice
+     points directly into the mapped record rather than holding a copy of it.  The map stays alive for as long as any
+     slice refers to it, even after CloseEgg() is called.
+    */
     class KTEgg1Reader : public KTEggReader
     {
         private:
@@ -73,7 +84,8 @@ namespace Katydid
             XReturnType ConvertFromArray(XArrayType* value);
 
             std::string fFileName;
-            std::ifstream fEggStream;
+            std::shared_ptr< KTMemoryMappedFile > fEggFile;
+            std::size_t fReadPos;
             std::string fPrelude;
             unsigned fHeaderSize;
             std::string fHeader;
@@ -84,7 +96,7 @@ namespace Katydid
 
             unsigned fLastFrameID;
 
-            static const std::ifstream::pos_type sPreludeSize;  // the prelude size is currently restricted to eight bytes
+            static const unsigned sPreludeSize;  // the prelude size is currently restricted to eight bytes
 
     };
 
@@ -92,7 +104,7 @@ namespace Katydid
     XReturnType KTEgg1Reader::ConvertFromArray(XArrayType* value)
     {
         std::stringstream converter;
-        XReturnType converted;
+        XReturnType converted = XReturnType();
         converter << value;
         converter >> converted;
         return converted;
@@ -45,11 +45,13 @@ namespace Katydid
             fSliceSize(1024),
             fStride(0),
             fStartTime(0.),
+            fUseIndex(false),
             fMonarch(NULL),
             fHeaderPtr(new Nymph::KTData()),
             fHeader(fHeaderPtr->Of< KTEggHeader >()),
             fReadState(),
             fNumberOfChannels(),
+            fIndex(),
             fGetTimeInRun(&KTEgg2Reader::GetTimeInRunFirstCall),
             fT0Offset(0),
             fSampleRateUnitsInHz(1.e6),
@@ -85,6 +87,7 @@ namespace Katydid
         SetSliceSize(eggProc.GetSliceSize());
         SetStride(eggProc.GetStride());
         SetStartTime(eggProc.GetStartTime());
+        SetUseIndex(eggProc.GetUseIndex());
         return true;
     }
 
@@ -147,7 +150,36 @@ namespace Katydid
         fReadState.fAbsoluteRecordOffset = 0;
 
         // skip forward in the run if fStartTime is non-zero
-        if (fStartTime > 0.)
+        if (fStartTime > 0. && fUseIndex)
+        {
+            if (! LoadIndex(filenames[0]))
+            {
+                CloseEgg();
+                return Nymph::KTDataPtr();
+            }
+            // the start time is relative to the first record in the file
+            uint64_t recordLength = uint64_t(double(fRecordSize) * fBinWidth / SEC_PER_NSEC); // ns
+            uint64_t startTimeStamp = fIndex.GetEntry(0).fTimeStamp + uint64_t(fStartTime / SEC_PER_NSEC);
+            const KTEggIndex::Entry* entry = fIndex.FindTime(startTimeStamp, recordLength);
+            if (entry == NULL)
+            {
+                KTERROR(eggreadlog, "The requested start time is beyond the end of the file");
+                CloseEgg();
+                return Nymph::KTDataPtr();
+            }
+            fReadState.fAbsoluteRecordOffset = entry->fRecordOffset;
+            if (startTimeStamp > entry->fTimeStamp && recordLength > 0)
+            {
+                uint64_t timeInAcq = startTimeStamp - entry->fTimeStamp;
+                uint64_t recordInAcq = timeInAcq / recordLength;
+                fReadState.fAbsoluteRecordOffset += recordInAcq;
+                fReadState.fReadPtrOffset = (unsigned)(double(timeInAcq - recordInAcq * recordLength) * SEC_PER_NSEC / fBinWidth);
+                if (fReadState.fReadPtrOffset >= fRecordSize) fReadState.fReadPtrOffset = fRecordSize - 1;
+            }
+            fReadState.fSliceStartPtrOffset = fReadState.fReadPtrOffset;
+            KTINFO(eggreadlog, "Starting in acquisition " << entry->fAcquisitionId << ", at record " << fReadState.fAbsoluteRecordOffset << " and sample " << fReadState.fReadPtrOffset);
+        }
+        else if (fStartTime > 0.)
         {
             double recordLength = fRecordSize * fBinWidth; // seconds
             unsigned recordSkips = (unsigned)(fStartTime / recordLength);
@@ -415,6 +447,60 @@ namespace Katydid
     }
 
 
+    bool KTEgg2Reader::LoadIndex(const scarab::path& filename)
+    {
+        // egg2 files have a single stream
+        fIndex.Clear();
+        uint64_t recordNBytes = uint64_t(fHeader.GetNChannels()) * fRecordSize * fHeader.GetChannelHeader(0)->GetDataTypeSize();
+        if (! fIndex.ReadSidecar(filename, 0, 0, recordNBytes))
+        {
+            KTINFO(eggreadlog, "Indexing egg file <" << filename << ">");
+            if (! IndexFile(filename, 0, fIndex))
+            {
+                KTERROR(eggreadlog, "Unable to index egg file <" << filename << ">");
+                return false;
+            }
+            fIndex.WriteSidecar(filename, 0, 0);
+        }
+
+        if (fIndex.GetNEntries() == 0)
+        {
+            KTERROR(eggreadlog, "The index is empty; there are no records in the file");
+            return false;
+        }
+        KTDEBUG(eggreadlog, "Index loaded; there are " << fIndex.GetNEntries() << " acquisitions in the file");
+        return true;
+    }
+
+    bool KTEgg2Reader::IndexFile(const scarab::path& filename, unsigned file, KTEggIndex& index)
+    {
+        const Monarch2* monarch = NULL;
+        try
+        {
+            monarch = Monarch2::OpenForReading(filename.native());
+            monarch->ReadHeader();
+            monarch->SetInterface(monarch2::sInterfaceSeparate);
+
+            uint64_t recordOffset = 0;
+            while (monarch->ReadRecord())
+            {
+                const M2RecordBytes* record = monarch->GetRecordSeparateOne();
+                index.AddRecord(file, record->fAcquisitionId, record->fRecordId, record->fTime, recordOffset);
+                ++recordOffset;
+            }
+            monarch->Close();
+        }
+        catch (M2Exception& e)
+        {
+            KTERROR(eggreadlog, "Error while indexing <" << filename << ">: " << e.what());
+            delete monarch;
+            return false;
+        }
+        delete monarch;
+        return true;
+    }
+
+
     void KTEgg2Reader::CopyHeaderInformation(const M2Header* monarchHeader)
     {
         fHeader.SetFilename(monarchHeader->GetFilename());
@@ -9,6 +9,7 @@
 #ifndef KTEGG2READER_HH_
 #define KTEGG2READER_HH_
 
+#include "KTEggIndex.hh"
 #include "KTEggReader.hh"
 
 #include "M2Record.hh"
@@ -73,10 +74,14 @@ namespace Katydid
             double GetStartTime() const;
             void SetStartTime(double time);
 
+            bool GetUseIndex() const;
+            void SetUseIndex(bool flag);
+
         protected:
             unsigned fSliceSize;
             unsigned fStride;
             double fStartTime;
+            bool fUseIndex;
 
         public:
             bool Configure(const KTEggProcessor& eggProc);
@@ -90,6 +95,13 @@ namespace Katydid
 
             static unsigned GetMaxChannels();
 
+            /// Fills the index for the file, using the sidecar file if possible
+            bool LoadIndex(const scarab::path& filename);
+            const KTEggIndex& GetIndex() const;
+
+            /// Reads all of the records in a file, and adds them to the index
+            static bool IndexFile(const scarab::path& filename, unsigned file, KTEggIndex& index);
+
         private:
             /// Copy header information from the MonarchHeader object
             void CopyHeaderInformation(const monarch2::M2Header* monarchHeader);
@@ -104,6 +116,8 @@ namespace Katydid
 
             AcquisitionModeMap fNumberOfChannels;
 
+            KTEggIndex fIndex;
+
         public:
             double GetSampleRateUnitsInHz() const;
 
@@ -176,6 +190,22 @@ namespace Katydid
         return;
     }
 
+    inline bool KTEgg2Reader::GetUseIndex() const
+    {
+        return fUseIndex;
+    }
+
+    inline void KTEgg2Reader::SetUseIndex(bool flag)
+    {
+        fUseIndex = flag;
+        return;
+    }
+
+    inline const KTEggIndex& KTEgg2Reader::GetIndex() const
+    {
+        return fIndex;
+    }
+
     inline double KTEgg2Reader::GetSampleRateUnitsInHz() const
     {
         return fSampleRateUnitsInHz;
@@ -9,10 +9,12 @@
 
 #include "KTEggHeader.hh"
 #include "KTEggProcessor.hh"
+#include "KTEggReaderWorker.hh"
 #include "KTLogger.hh"
 #include "KTSliceHeader.hh"
 #include "KTRawTimeSeriesData.hh"
 #include "KTRawTimeSeries.hh"
+#include "KTStreamSliceHeaderData.hh"
 #include "KTTimeSeriesData.hh"
 #include "KTTimeSeriesFFTW.hh"
 
@@ -22,6 +24,8 @@
 
 #include "scarab_version.hh"
 
+#include <algorithm>
+
 using namespace monarch3;
 
 using std::map;
@@ -40,12 +44,32 @@ namespace Katydid
             fStride(0),
             fStartTime(0.),
             fStartRecord(0),
+            fReadAhead(0),
+            fBorrowRecords(false),
+            fStreamNumber(-1),
+            fReadAllStreams(false),
+            fUseIndex(false),
+            fFirstAcquisition(0),
+            fLastAcquisition(-1),
+            fNShards(0),
+            fShard(0),
             //fHatchNextSlicePtr(NULL),
+            fHaveStopRecord(false),
+            fStopRecordId(0),
+            fSelectedStream(0),
+            fIndex(),
+            fStreamReaders(),
+            fStreamWorkers(),
             fFilenames(),
             fCurrentFileIt(),
             fMonarch(nullptr),
             fM3Stream(nullptr),
             fM3StreamHeader(nullptr),
+            fRecordQueue(nullptr),
+            fNChannels(0),
+            fSampleSize(1),
+            fDataTypeSize(1),
+            fDataFormat(sInvalidFormat),
             fHeaderPtr(new Nymph::KTData()),
             fHeader(fHeaderPtr->Of< KTEggHeader >()),
             fMasterSliceHeader(),
@@ -57,7 +81,9 @@ namespace Katydid
             fRecordSize(0),
             fBinWidth(0.),
             fSliceNumber(0),
-            fRecordsProcessed(0)
+            fFirstSliceNumber(0),
+            fRecordsProcessed(0),
+            fStreamsIntegratedTime(0.)
     {
         fReadState.fStatus = MonarchReadState::kInvalid;
         fReadState.fStartOfLastSliceRecord = 0;
@@ -68,8 +94,11 @@ namespace Katydid
 
     KTEgg3Reader::~KTEgg3Reader()
     {
+        ClearStreamReaders();
+        delete fRecordQueue;
         if (fMonarch != NULL)
         {
+            std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
             delete fMonarch;
         }
     }
@@ -80,6 +109,14 @@ namespace Katydid
         SetStride(eggProc.GetStride());
         SetStartTime(eggProc.GetStartTime());
         SetStartRecord(eggProc.GetStartRecord());
+        SetReadAhead(eggProc.GetReadAhead());
+        SetBorrowRecords(eggProc.GetBorrowRecords());
+        SetReadAllStreams(eggProc.GetReadAllStreams());
+        SetUseIndex(eggProc.GetUseIndex());
+        SetFirstAcquisition(eggProc.GetFirstAcquisition());
+        SetLastAcquisition(eggProc.GetLastAcquisition());
+        SetNShards(eggProc.GetNShards());
+        SetShard(eggProc.GetShard());
         return true;
     }
 
@@ -87,10 +124,19 @@ namespace Katydid
     {
         if (fStride == 0) fStride = fSliceSize;
 
+        ClearStreamReaders();
+        if (fReadAllStreams)
+        {
+            return BreakEggAllStreams(filenames);
+        }
+
         if (fMonarch != NULL)
         {
+            std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
             delete fMonarch;
         }
+        delete fRecordQueue;
+        fRecordQueue = nullptr;
 
         // copy the vector of filenames
         fFilenames = filenames;
@@ -98,6 +144,8 @@ namespace Katydid
 
         // open the file
         KTINFO(eggreadlog, "Opening egg file <" << fFilenames[0] << ">");
+        // Monarch access is serialized in case other readers are running on other threads
+        std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
         try
         {
             fMonarch = Monarch3::OpenForReading(fFilenames[0].native());
@@ -144,11 +192,13 @@ namespace Katydid
             fGetTimeInRun = &KTEgg3Reader::GetTimeInRunFromMonarch;
         }
 
-        // Temporary assumption: using channel 0 + any other channels in the same stream
-        unsigned streamNum = fMonarch->GetHeader()->GetChannelStreams()[0];
-        // set the stream pointer to stream 0
-        fM3Stream = fMonarch->GetStream(streamNum);
-        fM3StreamHeader = &(fMonarch->GetHeader()->GetStreamHeaders()[streamNum]);
+        unsigned streamNum = 0;
+        if (! SelectStream(streamNum))
+        {
+            delete fMonarch;
+            fMonarch = NULL;
+            return Nymph::KTDataPtr();
+        }
 
         CopyHeader(fMonarch->GetHeader());
 
@@ -186,6 +236,12 @@ namespace Katydid
         fRecordSize = fHeader.GetChannelHeader(0)->GetRecordSize();
         fBinWidth = 1. / fHeader.GetAcquisitionRate();
 
+        fNChannels = fM3Stream->GetNChannels();
+        fSampleSize = fM3Stream->GetSampleSize();
+        fDataTypeSize = fM3Stream->GetDataTypeSize();
+        fDataFormat = ConvertMonarch3DataFormat(fM3StreamHeader->GetDataFormat());
+        m3Lock.unlock();
+
         // by default, start the read state at the beginning of the run
         fReadState.fStatus = MonarchReadState::kAtStartOfRun;
         fReadState.fStartOfLastSliceRecord = 0;
@@ -193,8 +249,29 @@ namespace Katydid
         fReadState.fStartOfSliceAcquisitionId = 0;
         fReadState.fCurrentRecord = 0;
 
+        unsigned startFile = 0;
+        fHaveStopRecord = false;
+        fFirstSliceNumber = 0;
+        if (fNShards > 1 || fFirstAcquisition > 0 || fLastAcquisition >= 0)
+        {
+            // read a subset of the acquisitions
+            if (! LoadIndex() || ! SelectAcquisitions(startFile))
+            {
+                CloseEgg();
+                return Nymph::KTDataPtr();
+            }
+        }
+        else if (fUseIndex && (fStartRecord != 0 || fStartTime > 0.))
+        {
+            // skip forward in the run using the index
+            if (! LoadIndex() || ! SeekWithIndex(startFile))
+            {
+                CloseEgg();
+                return Nymph::KTDataPtr();
+            }
+        }
         // skip forward in the run if fStartTime is non-zero
-        if (fStartRecord == 0 && fStartTime > 0.)
+        else if (fStartRecord == 0 && fStartTime > 0.)
         {
             double recordLength = fRecordSize * fBinWidth; // seconds
             unsigned recordSkips = (unsigned)(fStartTime / recordLength);
@@ -207,7 +284,20 @@ namespace Katydid
             // fReadState.fStartOfLastSliceReadPtr stays 0
         }
 
-        fSliceNumber = 0;
+        if (startFile != 0)
+        {
+            // the start is in a later file; LoadNextFile() resets the read state, so it's saved here and restored
+            MonarchReadState startState = fReadState;
+            fCurrentFileIt = fFilenames.begin() + (startFile - 1);
+            if (! LoadNextFile())
+            {
+                KTERROR(eggreadlog, "Unable to open the file in which to start");
+                return Nymph::KTDataPtr();
+            }
+            fReadState = startState;
+        }
+
+        fSliceNumber = fFirstSliceNumber;
 
         // set a few values in the master slice header that don't change with each slice
         fMasterSliceHeader.SetSampleRate(fHeader.GetAcquisitionRate());
@@ -217,13 +307,42 @@ namespace Katydid
         fMasterSliceHeader.SetNonOverlapFrac((double)fStride / (double)fSliceSize);
         fMasterSliceHeader.SetRecordSize(fHeader.GetChannelHeader(0)->GetRecordSize());
 
+        if (fBorrowRecords && fReadAhead == 0)
+        {
+            // slices borrow the reference-counted records from the read-ahead buffer
+            KTINFO(eggreadlog, "Borrowing records requires reading ahead; using a read-ahead depth of " << sDefaultBorrowRecordsReadAhead << " records");
+            fReadAhead = sDefaultBorrowRecordsReadAhead;
+        }
+
+        if (fReadAhead > 0)
+        {
+            // the read-ahead thread opens the files itself, so this copy of the first file is no longer needed
+            CloseEgg();
+
+            KTINFO(eggreadlog, "Reading ahead by up to " << fReadAhead << " records");
+            // enough history is kept to return to the start of the previous slice
+            fRecordQueue = new KTEgg3RecordQueue(fReadAhead, fSliceSize / fRecordSize + 2);
+            if (! fRecordQueue->Start(path_vec(fCurrentFileIt, fFilenames.cend()), streamNum, fReadState.fStartOfLastSliceRecord))
+            {
+                KTERROR(eggreadlog, "Unable to start reading ahead");
+                delete fRecordQueue;
+                fRecordQueue = nullptr;
+                return Nymph::KTDataPtr();
+            }
+        }
+
         return fHeaderPtr;
     }
 
 
     inline Nymph::KTDataPtr KTEgg3Reader::HatchNextSlice()
     {
-        if (fMonarch == NULL)
+        if (! fStreamReaders.empty())
+        {
+            return HatchNextSliceAllStreams();
+        }
+
+        if (fMonarch == NULL && fRecordQueue == nullptr)
         {
             KTERROR(eggreadlog, "Monarch file has not been opened");
             return Nymph::KTDataPtr();
@@ -235,10 +354,10 @@ namespace Katydid
         }
 
         // Get the number of channels, record size and the number of bytes per sample from the stream
-        unsigned nChannels = fM3Stream->GetNChannels();
-        unsigned recordSize = fM3Stream->GetChannelRecordSize();
-        unsigned sampleSize = fM3Stream->GetSampleSize();
-        unsigned nBytesInSample = fM3Stream->GetDataTypeSize() * sampleSize;
+        unsigned nChannels = fNChannels;
+        unsigned recordSize = fRecordSize;
+        unsigned sampleSize = fSampleSize;
+        unsigned nBytesInSample = fDataTypeSize * sampleSize;
 
         // the read position in the current record (initialize to 0 for now; will be set correctly below)
         unsigned readPos = 0;
@@ -266,7 +385,18 @@ namespace Katydid
 
                 // if we're at the beginning of the run, load the first record
                 // second argument specifies that monarch should not go to the first record if it's a new acquisition
-                if (! fM3Stream->ReadRecord(startingRecordShift, false))
+                // (when reading ahead, the starting shift was already applied by the read-ahead thread)
+                bool haveFirstRecord = false;
+                if (fRecordQueue != nullptr)
+                {
+                    haveFirstRecord = fRecordQueue->ReadRecord();
+                }
+                else
+                {
+                    std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+                    haveFirstRecord = fM3Stream->ReadRecord(startingRecordShift, false);
+                }
+                if (! haveFirstRecord)
                 {
                     KTERROR(eggreadlog, "There's nothing in the file or the requested start is beyond the end of the (first) file");
                     return Nymph::KTDataPtr();
@@ -274,12 +404,12 @@ namespace Katydid
                 ++fRecordsProcessed;
 
                 // set the time offset for the run based on the first channel
-                fT0Offset = fM3Stream->GetAcqFirstRecordTime();
+                fT0Offset = fRecordQueue != nullptr ? fRecordQueue->GetCurrentRecord().fAcqFirstRecordTime : fM3Stream->GetAcqFirstRecordTime();
                 KTDEBUG(eggreadlog, "Time offset of the first slice: " << fT0Offset << " ns");
 
                 // set fStartOFLastSliceRecord properly, considering that the first record in the file might not be record 0
                 // this has to be done after the first record is read, because Monarch only knows what the first record number is after accessing the records
-                fReadState.fStartOfLastSliceRecord += fM3Stream->GetFirstRecordInFile();
+                fReadState.fStartOfLastSliceRecord += fRecordQueue != nullptr ? fRecordQueue->GetCurrentRecord().fFirstRecordInFile : fM3Stream->GetFirstRecordInFile();
                 KTDEBUG(eggreadlog, "File starts with record " << fReadState.fStartOfLastSliceRecord);
 
                 // the current record is the one we just loaded
@@ -288,11 +418,11 @@ namespace Katydid
                 // at this point, fReadState.fStartOfLastSliceRecord and fReadState.fStartOfLastSliceReadPtr are where they need to be
                 // for the slice that will follow this one.
                 // but we need to set fReadState.fStartOfSliceAcquisitionId
-                fReadState.fStartOfSliceAcquisitionId = fM3Stream->GetAcquisitionId();
+                fReadState.fStartOfSliceAcquisitionId = GetCurrentAcquisitionId();
 
                 fAcqTimeInRun = GetTimeInRun();
 
-                fSliceNumber = 0;
+                fSliceNumber = fFirstSliceNumber;
             }
             else
             {
@@ -319,29 +449,19 @@ namespace Katydid
                 if( recordShift != 0 )
                 {
                     bool inNewFile = false; // use this in addition to checking for an acquisition ID change below since the ID won't change if the entire file just finished has one acquisition
-                    if (! fM3Stream->ReadRecord(recordShift - 1))  // 1 is subtracted since ReadRecord(0) goes to the next record
+                    if (! MoveToRecord(recordShift - 1, inNewFile))  // 1 is subtracted since ReadRecord(0) goes to the next record
                     {
-                        // we've reached the end of the file
-                        if (! LoadNextFile())
-                        {
-                            KTINFO(eggreadlog, "End of egg file reached after reading new records");
-                            return Nymph::KTDataPtr();
-                        }
-                        if (! fM3Stream->ReadRecord())
-                        {
-                            KTERROR(eggreadlog, "There's nothing in the file or the requested start is beyond the end of the file");
-                            return Nymph::KTDataPtr();
-                        }
-                        inNewFile = true;
+                        KTINFO(eggreadlog, "End of egg file reached after reading new records");
+                        return Nymph::KTDataPtr();
                     }
                     ++fRecordsProcessed;
 
                     // set the current record according to what's now loaded
-                    fReadState.fCurrentRecord = fM3Stream->GetAcqFirstRecordId() + fM3Stream->GetRecordCountInAcq();
+                    fReadState.fCurrentRecord = GetCurrentRecordInRun();
                     // check if we're in a new acquisition
-                    if (fReadState.fStartOfSliceAcquisitionId != fM3Stream->GetAcquisitionId() || inNewFile)
+                    if (fReadState.fStartOfSliceAcquisitionId != GetCurrentAcquisitionId() || inNewFile)
                     {
-                        KTDEBUG(eggreadlog, "Starting slice in a new acquisition: " << fM3Stream->GetAcquisitionId() << "; is a new file? " << inNewFile << "; Starting at record << " << fReadState.fCurrentRecord);
+                        KTDEBUG(eggreadlog, "Starting slice in a new acquisition: " << GetCurrentAcquisitionId() << "; is a new file? " << inNewFile << "; Starting at record << " << fReadState.fCurrentRecord);
                         isNewAcquisition = true;
                         // then we need to start reading at the start of this record
                         readPos = 0;
@@ -356,7 +476,7 @@ namespace Katydid
                 fReadState.fStartOfLastSliceRecord = fReadState.fCurrentRecord;
                 fReadState.fStartOfLastSliceReadPtr = readPos;
                 // also set fStartOfSliceAcquisitionId
-                fReadState.fStartOfSliceAcquisitionId = fM3Stream->GetAcquisitionId();
+                fReadState.fStartOfSliceAcquisitionId = GetCurrentAcquisitionId();
 
                 ++fSliceNumber;
             }
@@ -376,20 +496,32 @@ namespace Katydid
             sliceHeader.SetStartRecordNumber(fReadState.fCurrentRecord);
             sliceHeader.SetStartSampleNumber(readPos);
 
+            // if records are borrowed, a slice that lies entirely within the current record points into the (reference-counted) record buffer
+            bool borrowRecord = fBorrowRecords && fRecordQueue != nullptr && readPos + fSliceSize <= recordSize;
+
             // create the raw time series objects that will contain the new copies of slices
             // and set some channel-specific slice header info
             vector< KTRawTimeSeries* > newSlices(nChannels);
             for (unsigned iChan = 0; iChan < nChannels; ++iChan)
             {
                 // nBins = fSliceSize * sampleSize to allow for real and complex samples
-                newSlices[iChan] = new KTRawTimeSeries(fM3Stream->GetDataTypeSize(),
-                        ConvertMonarch3DataFormat(fM3StreamHeader->GetDataFormat()),
-                        fSliceSize * sampleSize, 0., double(fSliceSize) * sliceHeader.GetBinWidth());
+                if (borrowRecord)
+                {
+                    newSlices[iChan] = new KTRawTimeSeries(fRecordQueue->GetCurrentRecordPtr(),
+                            GetCurrentRecordData( iChan ) + readPos * nBytesInSample,
+                            fDataTypeSize, fDataFormat,
+                            fSliceSize * sampleSize, 0., double(fSliceSize) * sliceHeader.GetBinWidth());
+                }
+                else
+                {
+                    newSlices[iChan] = new KTRawTimeSeries(fDataTypeSize, fDataFormat,
+                            fSliceSize * sampleSize, 0., double(fSliceSize) * sliceHeader.GetBinWidth());
+                }
                 newSlices[iChan]->SetSampleSize(sampleSize);
 
-                sliceHeader.SetAcquisitionID(fM3Stream->GetAcquisitionId(), iChan);
-                sliceHeader.SetRecordID(fM3Stream->GetChannelRecord( iChan )->GetRecordId(), iChan);
-                sliceHeader.SetTimeStamp(fM3Stream->GetChannelRecord( iChan )->GetTime(), iChan);
+                sliceHeader.SetAcquisitionID(GetCurrentAcquisitionId(), iChan);
+                sliceHeader.SetRecordID(GetCurrentRecordId( iChan ), iChan);
+                sliceHeader.SetTimeStamp(GetCurrentTimeStamp( iChan ), iChan);
                 sliceHeader.SetRawDataFormatType(fHeader.GetChannelHeader( iChan )->GetDataFormat(), iChan);
             }
 
@@ -407,6 +539,13 @@ namespace Katydid
 
             fReadState.fStatus = MonarchReadState::kContinueReading;
 
+            if (borrowRecord)
+            {
+                // nothing needs to be copied
+                samplesRemainingToCopy = 0;
+                lastSampleCopied = readPos + fSliceSize - 1;
+            }
+
             //****************************************
             // loop until all samples have been copied
             //****************************************
@@ -436,8 +575,8 @@ namespace Katydid
                 KTDEBUG(eggreadlog, "Copying data to slice; " << bytesToCopy << " bytes in " << samplesToCopyFromThisRecord << " samples");
                 for( unsigned iChan = 0; iChan < nChannels; ++iChan )
                 {
-                    memcpy( newSlices[iChan]->GetStorage() + writePosBytes,
-                            fM3Stream->GetChannelRecord( iChan )->GetData() + readPosBytes,
+                    memcpy( newSlices[iChan]->GetWritableStorage() + writePosBytes,
+                            GetCurrentRecordData( iChan ) + readPosBytes,
                             bytesToCopy );
                 }
 
@@ -465,27 +604,18 @@ namespace Katydid
                 {
                     bool inNewFile = false; // use this in addition to checking for an acquisition ID change below since the ID won't change if the entire file just finished has one acquisition
                     // move to the next record
-                    if (! fM3Stream->ReadRecord())
+                    if (! MoveToRecord(0, inNewFile))
                     {
-                        if (! LoadNextFile())
-                        {
-                            KTINFO(eggreadlog, "End of file reached in the middle of reading out a slice");
-                            return Nymph::KTDataPtr();
-                        }
-                        if (! fM3Stream->ReadRecord())
-                        {
-                            KTERROR(eggreadlog, "There's nothing in the file or the requested start is beyond the end of the file");
-                            return Nymph::KTDataPtr();
-                        }
-                        inNewFile = true;
+                        KTINFO(eggreadlog, "End of file reached in the middle of reading out a slice");
+                        return Nymph::KTDataPtr();
                     }
                     ++fRecordsProcessed;
-                    fReadState.fCurrentRecord = fM3Stream->GetAcqFirstRecordId() + fM3Stream->GetRecordCountInAcq();
+                    fReadState.fCurrentRecord = GetCurrentRecordInRun();
 
                     readPos = 0; // reset the read position, which is now at the beginning of the new record
 
                     // check if we've moved to a new acquisition
-                    if (fReadState.fStartOfSliceAcquisitionId != fM3Stream->GetAcquisitionId() || inNewFile)
+                    if (fReadState.fStartOfSliceAcquisitionId != GetCurrentAcquisitionId() || inNewFile)
                     {
                         KTDEBUG(eggreadlog, "New acquisition reached; starting slice again\n" <<
                                 "\tUnused samples: " << writePos + samplesToCopyFromThisRecord);
@@ -497,7 +627,7 @@ namespace Katydid
                         fReadState.fStartOfLastSliceRecord = fReadState.fCurrentRecord;
                         fReadState.fStartOfLastSliceReadPtr = readPos;
                         // also reset fStartOfSliceAcquisitionId
-                        fReadState.fStartOfSliceAcquisitionId = fM3Stream->GetAcquisitionId();
+                        fReadState.fStartOfSliceAcquisitionId = GetCurrentAcquisitionId();
 
                         // reset slice data
                         sliceHeader.SetIsNewAcquisition(true);
@@ -505,9 +635,9 @@ namespace Katydid
                         sliceHeader.SetStartSampleNumber(readPos);
                         for (unsigned iChan = 0; iChan < nChannels; ++iChan)
                         {
-                            sliceHeader.SetAcquisitionID(fM3Stream->GetAcquisitionId(), iChan);
-                            sliceHeader.SetRecordID(fM3Stream->GetChannelRecord( iChan )->GetRecordId(), iChan);
-                            sliceHeader.SetTimeStamp(fM3Stream->GetChannelRecord( iChan )->GetTime(), iChan);
+                            sliceHeader.SetAcquisitionID(GetCurrentAcquisitionId(), iChan);
+                            sliceHeader.SetRecordID(GetCurrentRecordId( iChan ), iChan);
+                            sliceHeader.SetTimeStamp(GetCurrentTimeStamp( iChan ), iChan);
                         }
                         sliceHeader.SetTimeInRun(GetTimeInRun());
                         fAcqTimeInRun = sliceHeader.GetTimeInRun();
@@ -534,6 +664,12 @@ namespace Katydid
                 tsData.SetTimeSeries(newSlices[iChannel], iChannel);
             }
 
+            if (fHaveStopRecord && sliceHeader.GetRecordID(0) >= fStopRecordId)
+            {
+                KTINFO(eggreadlog, "Reached the end of the requested acquisitions");
+                return Nymph::KTDataPtr();
+            }
+
             return newData;
         }
         catch (M3Exception& e)
@@ -543,6 +679,38 @@ namespace Katydid
         }
     }
 
+    bool KTEgg3Reader::MoveToRecord(int offset, bool& inNewFile)
+    {
+        inNewFile = false;
+
+        if (fRecordQueue != nullptr)
+        {
+            // file changes are handled by the read-ahead thread
+            if (! fRecordQueue->ReadRecord(offset)) return false;
+            inNewFile = fRecordQueue->GetInNewFile();
+            return true;
+        }
+
+        {
+            std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+            if (fM3Stream->ReadRecord(offset)) return true;
+        }
+
+        // we've reached the end of the file
+        if (! LoadNextFile())
+        {
+            return false;
+        }
+        std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+        if (! fM3Stream->ReadRecord())
+        {
+            KTERROR(eggreadlog, "There's nothing in the file or the requested start is beyond the end of the file");
+            return false;
+        }
+        inNewFile = true;
+        return true;
+    }
+
     bool KTEgg3Reader::LoadNextFile()
     {
         KTDEBUG(eggreadlog, "Attempting to load next file");
@@ -563,6 +731,7 @@ namespace Katydid
 
         // open the next file
         KTINFO(eggreadlog, "Opening next egg file <" << *fCurrentFileIt << ">");
+        std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
         try
         {
             fMonarch = Monarch3::OpenForReading(fCurrentFileIt->native());
@@ -587,11 +756,13 @@ namespace Katydid
             return false;
         }
 
-        // Temporary assumption: using channel 0 + any other channels in the same stream
-        unsigned streamNum = fMonarch->GetHeader()->GetChannelStreams()[0];
-        // set the stream pointer to stream 0
-        fM3Stream = fMonarch->GetStream(streamNum);
-        fM3StreamHeader = &(fMonarch->GetHeader()->GetStreamHeaders()[streamNum]);
+        unsigned streamNum = 0;
+        if (! SelectStream(streamNum))
+        {
+            delete fMonarch;
+            fMonarch = nullptr;
+            return false;
+        }
 
         // by default, start the read state at the beginning of the file
         fReadState.fStatus = MonarchReadState::kAtStartOfRun;
@@ -606,6 +777,21 @@ namespace Katydid
 
     bool KTEgg3Reader::CloseEgg()
     {
+        if (! fStreamReaders.empty())
+        {
+            ClearStreamReaders();
+            return true;
+        }
+        if (fRecordQueue != nullptr)
+        {
+            fRecordQueue->Stop();
+        }
+        if (fMonarch == NULL)
+        {
+            return true;
+        }
+
+        std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
         try
         {
             fMonarch->FinishReading();
@@ -620,6 +806,426 @@ namespace Katydid
     }
 
 
+    bool KTEgg3Reader::SelectStream(unsigned& streamNum)
+    {
+        const M3Header* monarchHeader = fMonarch->GetHeader();
+        if (fStreamNumber < 0)
+        {
+            // default: using channel 0 + any other channels in the same stream
+            streamNum = monarchHeader->GetChannelStreams()[0];
+        }
+        else
+        {
+            streamNum = unsigned(fStreamNumber);
+        }
+
+        if (streamNum >= monarchHeader->GetNStreams())
+        {
+            KTERROR(eggreadlog, "Stream " << streamNum << " was requested, but the file only has " << monarchHeader->GetNStreams() << " stream(s)");
+            return false;
+        }
+
+        KTDEBUG(eggreadlog, "Using stream " << streamNum);
+        fSelectedStream = streamNum;
+        fM3Stream = fMonarch->GetStream(streamNum);
+        fM3StreamHeader = &(monarchHeader->GetStreamHeaders()[streamNum]);
+        return true;
+    }
+
+
+    bool KTEgg3Reader::LoadIndex()
+    {
+        fIndex.Clear();
+        // a record takes up at least this much of the egg file (more if the samples are complex)
+        uint64_t recordNBytes = uint64_t(fNChannels) * fRecordSize * fDataTypeSize;
+        for (unsigned iFile = 0; iFile < fFilenames.size(); ++iFile)
+        {
+            if (fIndex.ReadSidecar(fFilenames[iFile], iFile, fSelectedStream, recordNBytes)) continue;
+
+            KTINFO(eggreadlog, "Indexing stream " << fSelectedStream << " of egg file <" << fFilenames[iFile] << ">");
+            if (! IndexFile(fFilenames[iFile], iFile, fSelectedStream, fIndex))
+            {
+                KTERROR(eggreadlog, "Unable to index egg file <" << fFilenames[iFile] << ">");
+                return false;
+            }
+            fIndex.WriteSidecar(fFilenames[iFile], iFile, fSelectedStream);
+        }
+
+        if (fIndex.GetNEntries() == 0)
+        {
+            KTERROR(eggreadlog, "The index is empty; there are no records in the run");
+            return false;
+        }
+        KTDEBUG(eggreadlog, "Index loaded; there are " << fIndex.GetNEntries() << " acquisitions in the run");
+        return true;
+    }
+
+    bool KTEgg3Reader::IndexFile(const scarab::path& filename, unsigned file, unsigned streamNum, KTEggIndex& index)
+    {
+        std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+        const Monarch3* monarch = nullptr;
+        try
+        {
+            monarch = Monarch3::OpenForReading(filename.native());
+            monarch->ReadHeader();
+            if (streamNum >= monarch->GetHeader()->GetNStreams())
+            {
+                KTERROR(eggreadlog, "Stream " << streamNum << " does not exist in <" << filename << ">");
+                monarch->FinishReading();
+                delete monarch;
+                return false;
+            }
+
+            const M3Stream* stream = monarch->GetStream(streamNum);
+            uint64_t recordOffset = 0;
+            while (stream->ReadRecord())
+            {
+                const M3Record* record = stream->GetChannelRecord(0);
+                index.AddRecord(file, stream->GetAcquisitionId(), record->GetRecordId(), record->GetTime(), recordOffset);
+                ++recordOffset;
+            }
+            monarch->FinishReading();
+        }
+        catch (M3Exception& e)
+        {
+            KTERROR(eggreadlog, "Error while indexing <" << filename << ">: " << e.what());
+            delete monarch;
+            return false;
+        }
+        delete monarch;
+        return true;
+    }
+
+    bool KTEgg3Reader::SeekWithIndex(unsigned& startFile)
+    {
+        // start times are relative to the first record in the run
+        const KTEggIndex::Entry& firstEntry = fIndex.GetEntry(0);
+
+        const KTEggIndex::Entry* entry = nullptr;
+        uint64_t recordInAcq = 0;
+        unsigned readPos = 0;
+        if (fStartRecord != 0)
+        {
+            // as without the index, the start record is the number of records to skip, not a record ID;
+            // with the index, the records of all of the files are counted
+            entry = fIndex.FindRecordInRun(fStartRecord, recordInAcq);
+        }
+        else
+        {
+            uint64_t recordLength = uint64_t(double(fRecordSize) * fBinWidth / SEC_PER_NSEC); // ns
+            uint64_t startTimeStamp = firstEntry.fTimeStamp + uint64_t(fStartTime / SEC_PER_NSEC);
+            entry = fIndex.FindTime(startTimeStamp, recordLength);
+            if (entry != nullptr && startTimeStamp < entry->fTimeStamp)
+            {
+                KTINFO(eggreadlog, "The requested start is between acquisitions; starting at the beginning of the next acquisition");
+            }
+            else if (entry != nullptr && recordLength > 0)
+            {
+                uint64_t timeInAcq = startTimeStamp - entry->fTimeStamp;
+                recordInAcq = timeInAcq / recordLength;
+                readPos = unsigned(double(timeInAcq - recordInAcq * recordLength) * SEC_PER_NSEC / fBinWidth);
+                if (readPos >= fRecordSize) readPos = fRecordSize - 1;
+            }
+        }
+
+        if (entry == nullptr)
+        {
+            KTERROR(eggreadlog, "The requested start is beyond the end of the run");
+            return false;
+        }
+
+        startFile = entry->fFile;
+        fReadState.fStartOfLastSliceRecord = entry->fRecordOffset + recordInAcq;
+        fReadState.fStartOfLastSliceReadPtr = readPos;
+        KTINFO(eggreadlog, "Starting in file " << startFile << " (acquisition " << entry->fAcquisitionId << "), at record " <<
+                fReadState.fStartOfLastSliceRecord << " in the file and sample " << readPos);
+        return true;
+    }
+
+
+    bool KTEgg3Reader::SelectAcquisitions(unsigned& startFile)
+    {
+        unsigned firstEntry = fFirstAcquisition;
+        unsigned lastEntry = fLastAcquisition < 0 ? fIndex.GetNEntries() - 1 : unsigned(fLastAcquisition);
+        if (fNShards > 1)
+        {
+            if (fFirstAcquisition > 0 || fLastAcquisition >= 0)
+            {
+                KTWARN(eggreadlog, "Both an acquisition range and shards were specified; the acquisition range will be ignored");
+            }
+            if (! fIndex.GetShard(fNShards, fShard, firstEntry, lastEntry))
+            {
+                KTERROR(eggreadlog, "Shard " << fShard << " of " << fNShards << " is empty; there are " << fIndex.GetNEntries() << " acquisitions in the run");
+                return false;
+            }
+        }
+        if (fStartRecord != 0 || fStartTime > 0.)
+        {
+            KTWARN(eggreadlog, "The start time and start record are ignored when reading a subset of the acquisitions");
+        }
+
+        if (firstEntry >= fIndex.GetNEntries() || firstEntry > lastEntry)
+        {
+            KTERROR(eggreadlog, "Invalid acquisition range: " << firstEntry << " to " << lastEntry << "; there are " << fIndex.GetNEntries() << " acquisitions in the run");
+            return false;
+        }
+        if (lastEntry >= fIndex.GetNEntries()) lastEntry = fIndex.GetNEntries() - 1;
+
+        // the slices are the ones the whole run would have in these acquisitions, numbered as they would be in the whole run,
+        // so that the outputs of the shards can be merged
+        uint64_t startRecord = 0;
+        fFirstSliceNumber = fIndex.GetNSlicesBefore(firstEntry, fRecordSize, fStride, startRecord);
+        const KTEggIndex::Entry& entry = fIndex.GetEntry(firstEntry);
+        if (startRecord >= entry.fNRecords)
+        {
+            KTWARN(eggreadlog, "The stride is longer than acquisition " << entry.fAcquisitionId << ", so no slice of the whole run starts in it; reading will start at its first record");
+            startRecord = 0;
+        }
+        startFile = entry.fFile;
+        fReadState.fStartOfLastSliceRecord = entry.fRecordOffset + startRecord;
+        fReadState.fStartOfLastSliceReadPtr = 0;
+
+        fHaveStopRecord = lastEntry + 1 < fIndex.GetNEntries();
+        if (fHaveStopRecord) fStopRecordId = fIndex.GetEntry(lastEntry + 1).fFirstRecordId;
+
+        KTINFO(eggreadlog, "Reading acquisitions " << firstEntry << " to " << lastEntry << " (of " << fIndex.GetNEntries() << "), starting in file " << startFile <<
+                " with slice " << fFirstSliceNumber);
+        return true;
+    }
+
+
+    Nymph::KTDataPtr KTEgg3Reader::BreakEggAllStreams(const path_vec& filenames)
+    {
+        fFilenames = filenames;
+
+        // the number of streams is taken from the first file
+        unsigned nStreams = 0;
+        KTINFO(eggreadlog, "Opening egg file <" << fFilenames[0] << "> to find the streams");
+        {
+            std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+            const Monarch3* monarch = nullptr;
+            try
+            {
+                monarch = Monarch3::OpenForReading(fFilenames[0].native());
+                monarch->ReadHeader();
+                nStreams = monarch->GetHeader()->GetNStreams();
+                monarch->FinishReading();
+            }
+            catch (M3Exception& e)
+            {
+                KTERROR(eggreadlog, "Unable to break egg: " << e.what());
+                delete monarch;
+                return Nymph::KTDataPtr();
+            }
+            delete monarch;
+        }
+
+        if (nStreams == 0)
+        {
+            KTERROR(eggreadlog, "There are no streams in the file");
+            return Nymph::KTDataPtr();
+        }
+        KTINFO(eggreadlog, "Reading all " << nStreams << " streams");
+
+        // each stream gets its own reader; the first stream's header is the basis for the combined header
+        for (unsigned iStream = 0; iStream < nStreams; ++iStream)
+        {
+            KTEgg3Reader* streamReader = new KTEgg3Reader();
+            streamReader->SetSliceSize(fSliceSize);
+            streamReader->SetStride(fStride);
+            streamReader->SetStartTime(fStartTime);
+            streamReader->SetStartRecord(fStartRecord);
+            streamReader->SetReadAhead(fReadAhead);
+            streamReader->SetBorrowRecords(fBorrowRecords);
+            streamReader->SetStreamNumber(int(iStream));
+            streamReader->SetUseIndex(fUseIndex);
+            streamReader->SetFirstAcquisition(fFirstAcquisition);
+            streamReader->SetLastAcquisition(fLastAcquisition);
+            streamReader->SetNShards(fNShards);
+            streamReader->SetShard(fShard);
+            fStreamReaders.push_back(streamReader);
+
+            Nymph::KTDataPtr streamHeaderPtr = streamReader->BreakEgg(fFilenames);
+            if (! streamHeaderPtr)
+            {
+                KTERROR(eggreadlog, "Unable to break egg for stream " << iStream);
+                ClearStreamReaders();
+                return Nymph::KTDataPtr();
+            }
+
+            const KTEggHeader& streamHeader = streamHeaderPtr->Of< KTEggHeader >();
+            if (iStream == 0)
+            {
+                fHeader = streamHeader;
+                fRecordSize = streamReader->GetRecordSize();
+                fBinWidth = streamReader->GetBinWidth();
+                continue;
+            }
+
+            if (streamHeader.GetAcquisitionRate() != fHeader.GetAcquisitionRate())
+            {
+                KTWARN(eggreadlog, "Stream " << iStream << " has a different acquisition rate (" << streamHeader.GetAcquisitionRate() <<
+                        " Hz) than stream 0 (" << fHeader.GetAcquisitionRate() << " Hz); slices from the two streams will cover different times");
+            }
+
+            // the channels of this stream follow those of the previous streams
+            for (unsigned iChan = 0; iChan < streamHeader.GetNChannels(); ++iChan)
+            {
+                unsigned iChanInKatydid = fHeader.GetNChannels();
+                KTChannelHeader* newChanHeader = new KTChannelHeader(*streamHeader.GetChannelHeader(iChan));
+                newChanHeader->SetNumber(iChanInKatydid);
+                fHeader.SetChannelHeader(newChanHeader, iChanInKatydid);
+            }
+        }
+        fHeader.SetAcquisitionMode(fHeader.GetNChannels());
+
+        KTDEBUG(eggreadlog, "Combined header:\n" << fHeader);
+
+        for (vector< KTEgg3Reader* >::iterator readerIt = fStreamReaders.begin(); readerIt != fStreamReaders.end(); ++readerIt)
+        {
+            KTEggReaderWorker* worker = new KTEggReaderWorker(*readerIt);
+            worker->Start();
+            fStreamWorkers.push_back(worker);
+        }
+
+        // the slices are numbered by the first stream
+        fFirstSliceNumber = fStreamReaders[0]->fFirstSliceNumber;
+        fSliceNumber = fFirstSliceNumber;
+        fRecordsProcessed = 0;
+        fStreamsIntegratedTime = 0.;
+
+        return fHeaderPtr;
+    }
+
+
+    Nymph::KTDataPtr KTEgg3Reader::HatchNextSliceAllStreams()
+    {
+        // the slices from the different streams are combined in the data object from the first stream
+        Nymph::KTDataPtr newData;
+        KTSliceHeader* sliceHeader = nullptr;
+        KTRawTimeSeriesData* tsData = nullptr;
+        KTStreamSliceHeaderData* streamSliceHeaders = nullptr;
+
+        unsigned nStreams = fStreamWorkers.size();
+        vector< Nymph::KTDataPtr > streamSlices(nStreams);
+        for (unsigned iStream = 0; iStream < nStreams; ++iStream)
+        {
+            streamSlices[iStream] = fStreamWorkers[iStream]->Pop();
+            if (! streamSlices[iStream])
+            {
+                KTINFO(eggreadlog, "Stream " << iStream << " has no more slices");
+                return Nymph::KTDataPtr();
+            }
+        }
+
+        // the streams are combined in lockstep, so they have to be at the same acquisition, record, and sample;
+        // a stream that's behind (e.g. because it dropped records) skips ahead to the others
+        unsigned nSkipped = 0;
+        while (true)
+        {
+            SlicePosition latest = GetSlicePosition(streamSlices[0]->Of< KTSliceHeader >());
+            for (unsigned iStream = 1; iStream < nStreams; ++iStream)
+            {
+                latest = std::max(latest, GetSlicePosition(streamSlices[iStream]->Of< KTSliceHeader >()));
+            }
+
+            bool inStep = true;
+            for (unsigned iStream = 0; iStream < nStreams; ++iStream)
+            {
+                SlicePosition position = GetSlicePosition(streamSlices[iStream]->Of< KTSliceHeader >());
+                if (position == latest) continue;
+
+                inStep = false;
+                if (++nSkipped > sMaxSkippedStreamSlices)
+                {
+                    KTERROR(eggreadlog, "The streams are out of step by more than " << sMaxSkippedStreamSlices << " slices; stopping");
+                    return Nymph::KTDataPtr();
+                }
+                KTWARN(eggreadlog, "Stream " << iStream << " is behind the other streams (acquisition " << std::get<0>(position) << ", record " << std::get<1>(position) <<
+                        ", sample " << std::get<2>(position) << " vs. acquisition " << std::get<0>(latest) << ", record " << std::get<1>(latest) <<
+                        ", sample " << std::get<2>(latest) << "); skipping a slice");
+                streamSlices[iStream] = fStreamWorkers[iStream]->Pop();
+                if (! streamSlices[iStream])
+                {
+                    KTINFO(eggreadlog, "Stream " << iStream << " has no more slices");
+                    return Nymph::KTDataPtr();
+                }
+            }
+            if (inStep) break;
+        }
+
+        unsigned nRecordsProcessed = 0;
+        for (unsigned iStream = 0; iStream < nStreams; ++iStream)
+        {
+            Nymph::KTDataPtr streamData = streamSlices[iStream];
+            nRecordsProcessed += fStreamWorkers[iStream]->GetNRecordsProcessed();
+
+            KTSliceHeader& streamSliceHeader = streamData->Of< KTSliceHeader >();
+            KTRawTimeSeriesData& streamTSData = streamData->Of< KTRawTimeSeriesData >();
+            unsigned nComponents = streamTSData.GetNComponents();
+
+            if (iStream == 0)
+            {
+                newData = streamData;
+                sliceHeader = &streamSliceHeader;
+                tsData = &streamTSData;
+                streamSliceHeaders = &newData->Of< KTStreamSliceHeaderData >();
+                streamSliceHeaders->AddStream(streamSliceHeader, nComponents);
+                continue;
+            }
+
+            streamSliceHeaders->AddStream(streamSliceHeader, nComponents);
+
+            // a new acquisition in any stream is a new acquisition for the combined slice
+            if (streamSliceHeader.GetIsNewAcquisition()) sliceHeader->SetIsNewAcquisition(true);
+
+            unsigned firstComponent = tsData->GetNComponents();
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                unsigned newComponent = firstComponent + iComponent;
+                // ownership of the time series is transferred to the combined data object
+                tsData->SetTimeSeries(streamTSData.GetTimeSeries(iComponent), newComponent);
+                streamTSData.SetTimeSeries(NULL, iComponent);
+
+                sliceHeader->SetAcquisitionID(streamSliceHeader.GetAcquisitionID(iComponent), newComponent);
+                sliceHeader->SetRecordID(streamSliceHeader.GetRecordID(iComponent), newComponent);
+                sliceHeader->SetTimeStamp(streamSliceHeader.GetTimeStamp(iComponent), newComponent);
+                sliceHeader->SetRawDataFormatType(streamSliceHeader.GetRawDataFormatType(iComponent), newComponent);
+            }
+        }
+
+        fSliceNumber = sliceHeader->GetSliceNumber();
+        fRecordsProcessed = nRecordsProcessed;
+        fStreamsIntegratedTime = fStreamWorkers[0]->GetIntegratedTime();
+
+        return newData;
+    }
+
+
+    KTEgg3Reader::SlicePosition KTEgg3Reader::GetSlicePosition(const KTSliceHeader& sliceHeader)
+    {
+        return SlicePosition(sliceHeader.GetAcquisitionID(0), sliceHeader.GetRecordID(0), sliceHeader.GetStartSampleNumber());
+    }
+
+
+    void KTEgg3Reader::ClearStreamReaders()
+    {
+        // the workers have to be stopped before their readers are closed
+        while (! fStreamWorkers.empty())
+        {
+            delete fStreamWorkers.back();
+            fStreamWorkers.pop_back();
+        }
+        while (! fStreamReaders.empty())
+        {
+            fStreamReaders.back()->CloseEgg();
+            delete fStreamReaders.back();
+            fStreamReaders.pop_back();
+        }
+        return;
+    }
+
+
     void KTEgg3Reader::CopyHeader(const M3Header* monarchHeader)
     {
         fHeader.SetFilename(monarchHeader->GetFilename());
@@ -9,6 +9,8 @@
 #ifndef KTEGG3READER_HH_
 #define KTEGG3READER_HH_
 
+#include "KTEgg3RecordQueue.hh"
+#include "KTEggIndex.hh"
 #include "KTEggReader.hh"
 #include "KTSliceHeader.hh"
 
@@ -17,6 +19,7 @@
 
 #include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #ifndef SEC_PER_NSEC
@@ -32,10 +35,35 @@ namespace Katydid
 {
     
     class KTEggHeader;
+    class KTEggReaderWorker;
 
     // NOTE: the first version of this KTEgg3Reader operates in much the same way as KTEgg2Reader, and does not take advantage of
-    // the flexibility of the full egg3 file format.  In particular, it only uses the channels in stream0 (though it uses as
-    // many channels as exist in that stream).
+    // the flexibility of the full egg3 file format.  By default it only uses the stream containing channel 0 (though it uses as
+    // many channels as exist in that stream).  A different stream can be chosen with SetStreamNumber().
+    //
+    // If all streams are read (SetReadAllStreams(true)), a separate reader is created for each stream, and each one hatches its
+    // slices on its own thread (see KTEggReaderWorker).  The slices from the different streams are combined: the components
+    // of the time series are ordered by stream, the egg header contains the channels of all streams, and the per-stream
+    // slice headers are attached as KTStreamSliceHeaderData.  The slices are combined only if they start at the same acquisition ID,
+    // record ID, and sample; a stream that falls behind skips slices to catch up (with a warning), and reading stops if the streams
+    // can't be brought back into step.  Access to Monarch itself is serialized (see Monarch3Mutex()),
+    // so the concurrency is in the record handling and slice assembly.
+    //
+    // If the index is used (SetUseIndex(true)), a non-zero start time or start record is found with a KTEggIndex, which accounts for
+    // gaps between acquisitions and can start in any file of the run.  The index is read from its sidecar files, or built
+    // (and cached) if they don't exist yet.  Without the index, the start is calculated assuming continuous acquisition in the first file.
+    // Either way, the start record is the number of records to skip (not a record ID); with the index it can be beyond the first file.
+    //
+    // A run can be split into independent pieces at acquisition boundaries: either a range of acquisitions (SetFirstAcquisition()
+    // and SetLastAcquisition()) or one of N shards (SetNShards() and SetShard()) is read, and the start time/record are ignored.
+    // Acquisitions are numbered by their position in the index, starting from 0; an acquisition that continues into the next file
+    // is counted once per file.  Shards have roughly equal numbers of records.  The index is always used in this case.
+    //
+    // If the read-ahead depth is non-zero, records are read and decoded on a background thread (see KTEgg3RecordQueue),
+    // and up to that many records are kept waiting in memory, including across file boundaries.
+    // Each record is copied once, from Monarch's buffer into the read-ahead buffer, since Monarch reuses its buffer for the next record.
+    // If records are borrowed (which uses the read-ahead buffers), slices that lie entirely within one record share that copy
+    // instead of copying it again; only slices that straddle records are copied.
     class KTEgg3Reader : public KTEggReader
     {
         protected:
@@ -80,11 +108,50 @@ namespace Katydid
             unsigned GetStartRecord() const;
             void SetStartRecord(unsigned rec);
 
+            unsigned GetReadAhead() const;
+            void SetReadAhead(unsigned nRecords);
+
+            bool GetBorrowRecords() const;
+            void SetBorrowRecords(bool flag);
+
+            /// Stream to read; a negative value means the stream that contains channel 0
+            int GetStreamNumber() const;
+            void SetStreamNumber(int stream);
+
+            bool GetReadAllStreams() const;
+            void SetReadAllStreams(bool flag);
+
+            bool GetUseIndex() const;
+            void SetUseIndex(bool flag);
+
+            unsigned GetFirstAcquisition() const;
+            void SetFirstAcquisition(unsigned acq);
+
+            /// Last acquisition to read (inclusive); a negative value means the end of the run
+            int GetLastAcquisition() const;
+            void SetLastAcquisition(int acq);
+
+            /// Number of shards into which the run is divided; 0 or 1 means the run is not divided
+            unsigned GetNShards() const;
+            void SetNShards(unsigned nShards);
+
+            unsigned GetShard() const;
+            void SetShard(unsigned shard);
+
         protected:
             unsigned fSliceSize;
             unsigned fStride;
             double fStartTime;
             unsigned fStartRecord;
+            unsigned fReadAhead;
+            bool fBorrowRecords;
+            int fStreamNumber;
+            bool fReadAllStreams;
+            bool fUseIndex;
+            unsigned fFirstAcquisition;
+            int fLastAcquisition;
+            unsigned fNShards;
+            unsigned fShard;
 
         public:
             bool Configure(const KTEggProcessor& eggProc);
@@ -98,12 +165,62 @@ namespace Katydid
 
             static unsigned GetMaxChannels();
 
+            /// Read-ahead depth used when borrowing records if no read-ahead depth was set
+            static const unsigned sDefaultBorrowRecordsReadAhead = 4;
+
+            /// Fills the index for the egg that's been broken, using the sidecar files where possible; must be called after BreakEgg()
+            bool LoadIndex();
+            const KTEggIndex& GetIndex() const;
+
+            /// Reads all of the records of one stream in a file, and adds them to the index
+            static bool IndexFile(const scarab::path& filename, unsigned file, unsigned streamNum, KTEggIndex& index);
+
         private:
             /// Copy header information from the M3Header object
             void CopyHeader(const monarch3::M3Header* monarchHeader);
 
             bool LoadNextFile();
 
+            /// Selects the stream to use in the currently-open file; returns false if it doesn't exist
+            bool SelectStream(unsigned& streamNum);
+
+            /// Uses the index to find the file, record, and sample at which to start
+            bool SeekWithIndex(unsigned& startFile);
+            /// Uses the index to find the start and end of the requested acquisitions or shard
+            bool SelectAcquisitions(unsigned& startFile);
+
+            // slices starting at or after this record are not read (used when reading a subset of the acquisitions)
+            bool fHaveStopRecord;
+            uint64_t fStopRecordId;
+
+            unsigned fSelectedStream;
+            KTEggIndex fIndex;
+
+            Nymph::KTDataPtr BreakEggAllStreams(const path_vec& filenames);
+            Nymph::KTDataPtr HatchNextSliceAllStreams();
+            void ClearStreamReaders();
+
+            // acquisition ID, record ID, and sample in the record at which a slice starts
+            typedef std::tuple< uint64_t, uint64_t, unsigned > SlicePosition;
+            static SlicePosition GetSlicePosition(const KTSliceHeader& sliceHeader);
+            /// Number of slices that may be skipped to bring the streams back into step before reading stops
+            static const unsigned sMaxSkippedStreamSlices = 100;
+
+            // used when reading all streams
+            std::vector< KTEgg3Reader* > fStreamReaders;
+            std::vector< KTEggReaderWorker* > fStreamWorkers;
+
+            /// Moves to the record (offset + 1) after the current one, continuing into the next file if necessary
+            /// Returns false if there are no more records
+            bool MoveToRecord(int offset, bool& inNewFile);
+
+            // Accessors for the currently-loaded record; these use either the Monarch stream or the read-ahead queue
+            monarch3::AcquisitionIdType GetCurrentAcquisitionId() const;
+            unsigned GetCurrentRecordInRun() const;
+            monarch3::RecordIdType GetCurrentRecordId(unsigned iChan) const;
+            monarch3::TimeType GetCurrentTimeStamp(unsigned iChan) const;
+            const monarch3::byte_type* GetCurrentRecordData(unsigned iChan) const;
+
             //Nymph::KTDataPtr (KTEgg3Reader::*fHatchNextSlicePtr)();
             //Nymph::KTDataPtr HatchNextSliceRealUnsigned();
             //Nymph::KTDataPtr HatchNextSliceRealSigned();
@@ -116,6 +233,14 @@ namespace Katydid
             const monarch3::M3Stream* fM3Stream;
             const monarch3::M3StreamHeader* fM3StreamHeader;
 
+            KTEgg3RecordQueue* fRecordQueue;
+
+            // stream properties, cached so that they're available when reading ahead
+            unsigned fNChannels;
+            unsigned fSampleSize;
+            unsigned fDataTypeSize;
+            uint32_t fDataFormat;
+
             Nymph::KTDataPtr fHeaderPtr;
             KTEggHeader& fHeader;
             KTSliceHeader fMasterSliceHeader;
@@ -160,8 +285,10 @@ namespace Katydid
             double fBinWidth;
 
             uint64_t fSliceNumber;
+            uint64_t fFirstSliceNumber; /// Number of the first slice; non-zero when reading a subset of the acquisitions
 
             uint64_t fRecordsProcessed;
+            double fStreamsIntegratedTime;
     };
 
 
@@ -213,6 +340,110 @@ namespace Katydid
         return;
     }
 
+    inline unsigned KTEgg3Reader::GetReadAhead() const
+    {
+        return fReadAhead;
+    }
+
+    inline void KTEgg3Reader::SetReadAhead(unsigned nRecords)
+    {
+        fReadAhead = nRecords;
+        return;
+    }
+
+    inline bool KTEgg3Reader::GetBorrowRecords() const
+    {
+        return fBorrowRecords;
+    }
+
+    inline void KTEgg3Reader::SetBorrowRecords(bool flag)
+    {
+        fBorrowRecords = flag;
+        return;
+    }
+
+    inline int KTEgg3Reader::GetStreamNumber() const
+    {
+        return fStreamNumber;
+    }
+
+    inline void KTEgg3Reader::SetStreamNumber(int stream)
+    {
+        fStreamNumber = stream;
+        return;
+    }
+
+    inline bool KTEgg3Reader::GetReadAllStreams() const
+    {
+        return fReadAllStreams;
+    }
+
+    inline void KTEgg3Reader::SetReadAllStreams(bool flag)
+    {
+        fReadAllStreams = flag;
+        return;
+    }
+
+    inline bool KTEgg3Reader::GetUseIndex() const
+    {
+        return fUseIndex;
+    }
+
+    inline void KTEgg3Reader::SetUseIndex(bool flag)
+    {
+        fUseIndex = flag;
+        return;
+    }
+
+    inline unsigned KTEgg3Reader::GetFirstAcquisition() const
+    {
+        return fFirstAcquisition;
+    }
+
+    inline void KTEgg3Reader::SetFirstAcquisition(unsigned acq)
+    {
+        fFirstAcquisition = acq;
+        return;
+    }
+
+    inline int KTEgg3Reader::GetLastAcquisition() const
+    {
+        return fLastAcquisition;
+    }
+
+    inline void KTEgg3Reader::SetLastAcquisition(int acq)
+    {
+        fLastAcquisition = acq;
+        return;
+    }
+
+    inline unsigned KTEgg3Reader::GetNShards() const
+    {
+        return fNShards;
+    }
+
+    inline void KTEgg3Reader::SetNShards(unsigned nShards)
+    {
+        fNShards = nShards;
+        return;
+    }
+
+    inline unsigned KTEgg3Reader::GetShard() const
+    {
+        return fShard;
+    }
+
+    inline void KTEgg3Reader::SetShard(unsigned shard)
+    {
+        fShard = shard;
+        return;
+    }
+
+    inline const KTEggIndex& KTEgg3Reader::GetIndex() const
+    {
+        return fIndex;
+    }
+
     inline double KTEgg3Reader::GetSampleRateUnitsInHz() const
     {
         return fSampleRateUnitsInHz;
@@ -234,7 +465,7 @@ namespace Katydid
 
     inline double KTEgg3Reader::GetTimeInRunFromMonarch() const
     {
-        return double(fM3Stream->GetChannelRecord(0)->GetTime()) * SEC_PER_NSEC + fBinWidth * double(fReadState.fStartOfLastSliceReadPtr);
+        return double(GetCurrentTimeStamp(0)) * SEC_PER_NSEC + fBinWidth * double(fReadState.fStartOfLastSliceReadPtr);
     }
 
     inline double KTEgg3Reader::GetTimeInRunManually() const
@@ -244,12 +475,14 @@ namespace Katydid
 
     inline double KTEgg3Reader::GetIntegratedTime() const
     {
+        // when reading all streams, the integrated time is that of the first stream
+        if (! fStreamReaders.empty()) return fStreamsIntegratedTime;
         return (double)fRecordsProcessed * (double)fRecordSize * fBinWidth;
     }
 
     inline unsigned KTEgg3Reader::GetNSlicesProcessed() const
     {
-        return (unsigned)fSliceNumber + 1;
+        return (unsigned)(fSliceNumber - fFirstSliceNumber) + 1;
     }
 
     inline unsigned KTEgg3Reader::GetNRecordsProcessed() const
@@ -267,6 +500,36 @@ namespace Katydid
         return fAcqTimeInRun;
     }
 
+    inline monarch3::AcquisitionIdType KTEgg3Reader::GetCurrentAcquisitionId() const
+    {
+        if (fRecordQueue != nullptr) return fRecordQueue->GetCurrentRecord().fAcquisitionId;
+        return fM3Stream->GetAcquisitionId();
+    }
+
+    inline unsigned KTEgg3Reader::GetCurrentRecordInRun() const
+    {
+        if (fRecordQueue != nullptr) return fRecordQueue->GetCurrentRecord().fRecordInRun;
+        return fM3Stream->GetAcqFirstRecordId() + fM3Stream->GetRecordCountInAcq();
+    }
+
+    inline monarch3::RecordIdType KTEgg3Reader::GetCurrentRecordId(unsigned iChan) const
+    {
+        if (fRecordQueue != nullptr) return fRecordQueue->GetCurrentRecord().fRecordIds[iChan];
+        return fM3Stream->GetChannelRecord(iChan)->GetRecordId();
+    }
+
+    inline monarch3::TimeType KTEgg3Reader::GetCurrentTimeStamp(unsigned iChan) const
+    {
+        if (fRecordQueue != nullptr) return fRecordQueue->GetCurrentRecord().fTimeStamps[iChan];
+        return fM3Stream->GetChannelRecord(iChan)->GetTime();
+    }
+
+    inline const monarch3::byte_type* KTEgg3Reader::GetCurrentRecordData(unsigned iChan) const
+    {
+        if (fRecordQueue != nullptr) return fRecordQueue->GetCurrentRecord().GetChannelData(iChan);
+        return fM3Stream->GetChannelRecord(iChan)->GetData();
+    }
+
 
 
 } /* namespace Katydid */
@@ -0,0 +1,290 @@
+/*
+ * KTEgg3RecordQueue.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTEgg3RecordQueue.hh"
+
+#include "KTLogger.hh"
+
+#include "M3Exception.hh"
+#include "M3Monarch.hh"
+
+#include <cstring>
+
+using namespace monarch3;
+
+namespace Katydid
+{
+    KTLOGGER(rqlog, "KTEgg3RecordQueue");
+
+    std::mutex& Monarch3Mutex()
+    {
+        static std::mutex sMonarch3Mutex;
+        return sMonarch3Mutex;
+    }
+
+    KTEgg3RecordQueue::KTEgg3RecordQueue(unsigned capacity, unsigned historySize) :
+            fCapacity(capacity > 0 ? capacity : 1),
+            fHistorySize(historySize > 0 ? historySize : 1),
+            fBuffer(),
+            fWorkerDone(true),
+            fStopRequested(false),
+            fMutex(),
+            fNotEmpty(),
+            fNotFull(),
+            fThread(),
+            fHistory(),
+            fCurrentPos(0),
+            fInNewFile(false)
+    {
+    }
+
+    KTEgg3RecordQueue::~KTEgg3RecordQueue()
+    {
+        Stop();
+    }
+
+    bool KTEgg3RecordQueue::Start(const KTEggReader::path_vec& filenames, unsigned streamNum, int startingRecordShift)
+    {
+        Stop();
+
+        if (filenames.empty())
+        {
+            KTERROR(rqlog, "No files were given to the record queue");
+            return false;
+        }
+
+        fStopRequested = false;
+        fWorkerDone = false;
+
+        KTDEBUG(rqlog, "Starting read-ahead of stream " << streamNum << " with up to " << fCapacity << " records");
+        fThread = std::thread(&KTEgg3RecordQueue::ReadFiles, this, filenames, streamNum, startingRecordShift);
+        return true;
+    }
+
+    void KTEgg3RecordQueue::Stop()
+    {
+        if (fThread.joinable())
+        {
+            {
+                std::unique_lock< std::mutex > lock(fMutex);
+                fStopRequested = true;
+            }
+            fNotFull.notify_all();
+            fThread.join();
+        }
+        fBuffer.clear();
+        fHistory.clear();
+        fCurrentPos = 0;
+        fInNewFile = false;
+        fWorkerDone = true;
+        return;
+    }
+
+    bool KTEgg3RecordQueue::ReadRecord(int offset)
+    {
+        fInNewFile = false;
+
+        if (fHistory.empty())
+        {
+            // the offset for the first record was applied by the worker when the first file was opened
+            KTEgg3RecordPtr record = Pop();
+            if (! record) return false;
+            fHistory.push_back(record);
+            fCurrentPos = 0;
+            return true;
+        }
+
+        int target = int(fCurrentPos) + 1 + offset;
+        if (target < 0)
+        {
+            KTERROR(rqlog, "Cannot move back by " << -offset - 1 << " records; only " << fCurrentPos << " earlier records are available");
+            return false;
+        }
+
+        // moving back (or staying put) only requires the history
+        if (unsigned(target) <= fCurrentPos)
+        {
+            fCurrentPos = unsigned(target);
+            return true;
+        }
+
+        // step forward one record at a time, so that acquisition and file boundaries are respected
+        AcquisitionIdType startAcqId = fHistory[fCurrentPos]->fAcquisitionId;
+        unsigned pos = fCurrentPos;
+        while (pos < unsigned(target))
+        {
+            if (pos + 1 == fHistory.size())
+            {
+                KTEgg3RecordPtr record = Pop();
+                if (! record) return false;
+                fHistory.push_back(record);
+            }
+            ++pos;
+            const KTEgg3Record& record = *fHistory[pos];
+            if (record.fIsFirstInFile)
+            {
+                fInNewFile = true;
+                break;
+            }
+            if (record.fAcquisitionId != startAcqId) break;
+        }
+        fCurrentPos = pos;
+
+        if (fInNewFile)
+        {
+            // records from the previous file are never revisited
+            fHistory.erase(fHistory.begin(), fHistory.begin() + fCurrentPos);
+            fCurrentPos = 0;
+        }
+        TrimHistory();
+
+        return true;
+    }
+
+    void KTEgg3RecordQueue::ReadFiles(KTEggReader::path_vec filenames, unsigned streamNum, int startingRecordShift)
+    {
+        bool isFirstFile = true;
+        for (KTEggReader::path_vec::const_iterator fileIt = filenames.begin(); fileIt != filenames.end(); ++fileIt)
+        {
+            const Monarch3* monarch = nullptr;
+            KTDEBUG(rqlog, "Opening egg file <" << *fileIt << "> for read-ahead");
+            {
+                // the cleanup after a failed open also has to hold the Monarch lock
+                std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+                try
+                {
+                    monarch = Monarch3::OpenForReading(fileIt->native());
+                    monarch->ReadHeader();
+                }
+                catch (M3Exception& e)
+                {
+                    KTERROR(rqlog, "Unable to open egg file <" << *fileIt << ">: " << e.what());
+                    delete monarch;
+                    monarch = nullptr;
+                }
+            }
+            if (monarch == nullptr) break;
+
+            bool keepReading = true;
+            try
+            {
+                std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+                const M3Stream* stream = monarch->GetStream(streamNum);
+                unsigned nChannels = stream->GetNChannels();
+                unsigned nBytesPerChannel = stream->GetChannelRecordSize() * stream->GetSampleSize() * stream->GetDataTypeSize();
+
+                // the starting shift only applies to the first file; Monarch should not go to the start of a new acquisition for it
+                bool haveRecord = isFirstFile ? stream->ReadRecord(startingRecordShift, false) : stream->ReadRecord();
+                if (isFirstFile && ! haveRecord)
+                {
+                    KTERROR(rqlog, "There's nothing in the file or the requested start is beyond the end of the (first) file");
+                    keepReading = false;
+                }
+                bool isFirstInFile = true;
+                while (haveRecord)
+                {
+                    KTEgg3RecordPtr record = std::make_shared< KTEgg3Record >();
+                    record->fData.resize(nChannels * nBytesPerChannel);
+                    record->fNBytesPerChannel = nBytesPerChannel;
+                    record->fRecordIds.resize(nChannels);
+                    record->fTimeStamps.resize(nChannels);
+                    for (unsigned iChan = 0; iChan < nChannels; ++iChan)
+                    {
+                        const M3Record* chanRecord = stream->GetChannelRecord(iChan);
+                        // Monarch reuses its record buffer, so this is the one copy of each record that can't be avoided
+                        memcpy(record->fData.data() + iChan * nBytesPerChannel, chanRecord->GetData(), nBytesPerChannel);
+                        record->fRecordIds[iChan] = chanRecord->GetRecordId();
+                        record->fTimeStamps[iChan] = chanRecord->GetTime();
+                    }
+                    record->fAcquisitionId = stream->GetAcquisitionId();
+                    record->fRecordInRun = stream->GetAcqFirstRecordId() + stream->GetRecordCountInAcq();
+                    record->fAcqFirstRecordTime = stream->GetAcqFirstRecordTime();
+                    record->fFirstRecordInFile = stream->GetFirstRecordInFile();
+                    record->fIsFirstInFile = isFirstInFile && ! isFirstFile;
+
+                    // don't hold the Monarch lock while waiting for room in the buffer
+                    m3Lock.unlock();
+                    if (! Push(record))
+                    {
+                        keepReading = false;
+                        break;
+                    }
+                    isFirstInFile = false;
+
+                    m3Lock.lock();
+                    haveRecord = stream->ReadRecord();
+                }
+            }
+            catch (M3Exception& e)
+            {
+                KTERROR(rqlog, "Error while reading ahead in egg file <" << *fileIt << ">: " << e.what());
+                keepReading = false;
+            }
+
+            try
+            {
+                std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+                monarch->FinishReading();
+            }
+            catch (M3Exception& e)
+            {
+                KTERROR(rqlog, "Something went wrong while closing the file: " << e.what());
+            }
+            {
+                std::unique_lock< std::mutex > m3Lock(Monarch3Mutex());
+                delete monarch;
+            }
+
+            isFirstFile = false;
+            if (! keepReading) break;
+        }
+
+        KTDEBUG(rqlog, "Read-ahead of stream " << streamNum << " is finished");
+        {
+            std::unique_lock< std::mutex > lock(fMutex);
+            fWorkerDone = true;
+        }
+        fNotEmpty.notify_all();
+        return;
+    }
+
+    KTEgg3RecordPtr KTEgg3RecordQueue::Pop()
+    {
+        std::unique_lock< std::mutex > lock(fMutex);
+        fNotEmpty.wait(lock, [this]{ return ! fBuffer.empty() || fWorkerDone; });
+        if (fBuffer.empty()) return KTEgg3RecordPtr();
+
+        KTEgg3RecordPtr record = fBuffer.front();
+        fBuffer.pop_front();
+        lock.unlock();
+        fNotFull.notify_one();
+        return record;
+    }
+
+    bool KTEgg3RecordQueue::Push(KTEgg3RecordPtr record)
+    {
+        std::unique_lock< std::mutex > lock(fMutex);
+        fNotFull.wait(lock, [this]{ return fBuffer.size() < fCapacity || fStopRequested; });
+        if (fStopRequested) return false;
+
+        fBuffer.push_back(record);
+        lock.unlock();
+        fNotEmpty.notify_one();
+        return true;
+    }
+
+    void KTEgg3RecordQueue::TrimHistory()
+    {
+        while (fCurrentPos + 1 > fHistorySize)
+        {
+            fHistory.pop_front();
+            --fCurrentPos;
+        }
+        return;
+    }
+
+} /* namespace Katydid */
@@ -0,0 +1,166 @@
+/**
+ @file KTEgg3RecordQueue.hh
+ @brief Contains KTEgg3RecordQueue
+ @details Reads Monarch3 records ahead of the slice-assembly thread
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTEGG3RECORDQUEUE_HH_
+#define KTEGG3RECORDQUEUE_HH_
+
+#include "KTEggReader.hh"
+
+#include "M3Types.hh"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Katydid
+{
+    /// Serializes access to Monarch3 (and therefore HDF5, which is not guaranteed to be thread-safe) across all readers in the process
+    std::mutex& Monarch3Mutex();
+
+    /*!
+     @class KTEgg3Record
+     @author agent
+
+     @brief Decoded copy of a single Monarch3 record (all channels of one stream)
+
+     @details
+     The data for the channels are stored back-to-back in fData; each channel occupies fNBytesPerChannel bytes.
+     fRecordInRun is equivalent to M3Stream::GetAcqFirstRecordId() + M3Stream::GetRecordCountInAcq().
+    */
+    struct KTEgg3Record
+    {
+        std::vector< monarch3::byte_type > fData;
+        unsigned fNBytesPerChannel;
+        std::vector< monarch3::RecordIdType > fRecordIds;
+        std::vector< monarch3::TimeType > fTimeStamps;
+        monarch3::AcquisitionIdType fAcquisitionId;
+        unsigned fRecordInRun;
+        monarch3::TimeType fAcqFirstRecordTime;
+        monarch3::RecordIdType fFirstRecordInFile;
+        bool fIsFirstInFile;
+
+        const monarch3::byte_type* GetChannelData(unsigned iChan) const;
+    };
+
+    typedef std::shared_ptr< KTEgg3Record > KTEgg3RecordPtr;
+
+    inline const monarch3::byte_type* KTEgg3Record::GetChannelData(unsigned iChan) const
+    {
+        return fData.data() + iChan * fNBytesPerChannel;
+    }
+
+
+    /*!
+     @class KTEgg3RecordQueue
+     @author agent
+
+     @brief Reads the records of one Monarch3 stream on a background thread
+
+     @details
+     A worker thread opens each file in the list in turn, reads the records of the requested stream, and places decoded copies
+     in a bounded buffer (the read-ahead depth).  The worker blocks when the buffer is full, so at most fCapacity records
+     are waiting to be used at any time.  File boundaries are handled by the worker; the first record of each new file is flagged.
+
+     The consumer side mimics M3Stream::ReadRecord(): ReadRecord(offset) moves to the record that is (offset + 1) records
+     after the current one.  A short history of already-used records is kept so that negative offsets (needed when slices overlap)
+     can be satisfied without going back to the file.  As with Monarch, a forward move that crosses into a new acquisition or
+     a new file stops at the first record of the new acquisition/file.
+
+     The records handed out are reference counted, so they remain valid for as long as anybody holds a KTEgg3RecordPtr to them.
+
+     Only one thread should use the consumer interface (ReadRecord(), GetCurrentRecord(), etc.).
+    */
+    class KTEgg3RecordQueue
+    {
+        public:
+            KTEgg3RecordQueue(unsigned capacity, unsigned historySize = 2);
+            virtual ~KTEgg3RecordQueue();
+
+            /// Starts the reading thread; startingRecordShift is applied to the first read of the first file
+            bool Start(const KTEggReader::path_vec& filenames, unsigned streamNum, int startingRecordShift);
+            /// Stops the reading thread and discards any records still in the buffer
+            void Stop();
+
+            /// Moves to the record (offset + 1) after the current one; returns false if no more records are available
+            bool ReadRecord(int offset = 0);
+
+            /// Returns true if the last call to ReadRecord() moved into a new file
+            bool GetInNewFile() const;
+
+            const KTEgg3Record& GetCurrentRecord() const;
+            KTEgg3RecordPtr GetCurrentRecordPtr() const;
+
+            unsigned GetCapacity() const;
+            unsigned GetHistorySize() const;
+            void SetHistorySize(unsigned size);
+
+        private:
+            void ReadFiles(KTEggReader::path_vec filenames, unsigned streamNum, int startingRecordShift);
+
+            /// Blocks until a record is available; returns an empty pointer when the worker is done and the buffer is empty
+            KTEgg3RecordPtr Pop();
+            /// Blocks until there's room in the buffer; returns false if the queue is being stopped
+            bool Push(KTEgg3RecordPtr record);
+            void TrimHistory();
+
+            unsigned fCapacity;
+            unsigned fHistorySize;
+
+            // shared between threads; protected by fMutex
+            std::deque< KTEgg3RecordPtr > fBuffer;
+            bool fWorkerDone;
+            bool fStopRequested;
+            std::mutex fMutex;
+            std::condition_variable fNotEmpty;
+            std::condition_variable fNotFull;
+
+            std::thread fThread;
+
+            // consumer-side state
+            std::deque< KTEgg3RecordPtr > fHistory;
+            unsigned fCurrentPos;
+            bool fInNewFile;
+    };
+
+    inline bool KTEgg3RecordQueue::GetInNewFile() const
+    {
+        return fInNewFile;
+    }
+
+    inline const KTEgg3Record& KTEgg3RecordQueue::GetCurrentRecord() const
+    {
+        return *fHistory[fCurrentPos];
+    }
+
+    inline KTEgg3RecordPtr KTEgg3RecordQueue::GetCurrentRecordPtr() const
+    {
+        return fHistory[fCurrentPos];
+    }
+
+    inline unsigned KTEgg3RecordQueue::GetCapacity() const
+    {
+        return fCapacity;
+    }
+
+    inline unsigned KTEgg3RecordQueue::GetHistorySize() const
+    {
+        return fHistorySize;
+    }
+
+    inline void KTEgg3RecordQueue::SetHistorySize(unsigned size)
+    {
+        fHistorySize = size > 0 ? size : 1;
+        return;
+    }
+
+} /* namespace Katydid */
+
+#endif /* KTEGG3RECORDQUEUE_HH_ */
@@ -0,0 +1,280 @@
+/*
+ * KTEggIndex.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTEggIndex.hh"
+
+#include "KTLogger.hh"
+
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+
+namespace Katydid
+{
+    KTLOGGER(eggidxlog, "KTEggIndex");
+
+    const std::string KTEggIndex::sSidecarExtension(".kdx");
+
+    KTEggIndex::KTEggIndex() :
+            fEntries()
+    {
+    }
+
+    KTEggIndex::~KTEggIndex()
+    {
+    }
+
+    void KTEggIndex::Clear()
+    {
+        fEntries.clear();
+        return;
+    }
+
+    void KTEggIndex::AddEntry(const Entry& entry)
+    {
+        fEntries.push_back(entry);
+        return;
+    }
+
+    void KTEggIndex::AddRecord(unsigned file, uint64_t acqId, uint64_t recordId, uint64_t timeStamp, uint64_t recordOffset)
+    {
+        if (! fEntries.empty())
+        {
+            Entry& last = fEntries.back();
+            if (last.fFile == file && last.fAcquisitionId == acqId && last.fRecordOffset + last.fNRecords == recordOffset)
+            {
+                ++last.fNRecords;
+                return;
+            }
+        }
+        Entry newEntry;
+        newEntry.fFile = file;
+        newEntry.fAcquisitionId = acqId;
+        newEntry.fFirstRecordId = recordId;
+        newEntry.fTimeStamp = timeStamp;
+        newEntry.fRecordOffset = recordOffset;
+        newEntry.fNRecords = 1;
+        fEntries.push_back(newEntry);
+        return;
+    }
+
+    const KTEggIndex::Entry* KTEggIndex::FindTime(uint64_t timeStamp, uint64_t recordLength) const
+    {
+        // first entry that starts after timeStamp
+        std::vector< Entry >::const_iterator next = std::upper_bound(fEntries.begin(), fEntries.end(), timeStamp,
+                [](uint64_t time, const Entry& entry){ return time < entry.fTimeStamp; });
+        if (next != fEntries.begin())
+        {
+            std::vector< Entry >::const_iterator containing = next - 1;
+            if (timeStamp < containing->fTimeStamp + containing->fNRecords * recordLength) return &(*containing);
+        }
+        if (next == fEntries.end()) return NULL;
+        return &(*next);
+    }
+
+    const KTEggIndex::Entry* KTEggIndex::FindRecordInRun(uint64_t recordInRun, uint64_t& recordInEntry) const
+    {
+        for (std::vector< Entry >::const_iterator entryIt = fEntries.begin(); entryIt != fEntries.end(); ++entryIt)
+        {
+            if (recordInRun < entryIt->fNRecords)
+            {
+                recordInEntry = recordInRun;
+                return &(*entryIt);
+            }
+            recordInRun -= entryIt->fNRecords;
+        }
+        return NULL;
+    }
+
+    uint64_t KTEggIndex::GetNSlicesBefore(unsigned firstEntry, unsigned recordSize, unsigned stride, uint64_t& startRecord) const
+    {
+        startRecord = 0;
+        if (recordSize == 0 || stride == 0) return 0;
+
+        uint64_t nSlices = 0;
+        // startRecord is the record of each entry in which its first slice starts; a stride longer than a record can skip
+        // the first records of an entry, or whole entries
+        for (unsigned iEntry = 0; iEntry < firstEntry && iEntry < fEntries.size(); ++iEntry)
+        {
+            uint64_t nRecords = fEntries[iEntry].fNRecords;
+            if (startRecord >= nRecords)
+            {
+                startRecord -= nRecords;
+                continue;
+            }
+            uint64_t nEntrySlices = ((nRecords - startRecord) * recordSize + stride - 1) / stride;
+            nSlices += nEntrySlices;
+            startRecord = startRecord + nEntrySlices * stride / recordSize - nRecords;
+        }
+        return nSlices;
+    }
+
+    bool KTEggIndex::GetShard(unsigned nShards, unsigned shard, unsigned& firstEntry, unsigned& lastEntry) const
+    {
+        if (nShards == 0 || shard >= nShards || fEntries.empty()) return false;
+
+        uint64_t nRecords = 0;
+        for (std::vector< Entry >::const_iterator entryIt = fEntries.begin(); entryIt != fEntries.end(); ++entryIt)
+        {
+            nRecords += entryIt->fNRecords;
+        }
+
+        // an entry belongs to the shard in which its first record falls
+        uint64_t shardStart = nRecords * shard / nShards;
+        uint64_t shardEnd = nRecords * (shard + 1) / nShards;
+        bool haveFirst = false;
+        uint64_t recordsBefore = 0;
+        for (unsigned iEntry = 0; iEntry < fEntries.size(); ++iEntry)
+        {
+            if (recordsBefore >= shardEnd) break;
+            if (recordsBefore >= shardStart)
+            {
+                if (! haveFirst) firstEntry = iEntry;
+                haveFirst = true;
+                lastEntry = iEntry;
+            }
+            recordsBefore += fEntries[iEntry].fNRecords;
+        }
+        return haveFirst;
+    }
+
+    bool KTEggIndex::ReadSidecar(const scarab::path& eggFilename, unsigned file, unsigned stream, uint64_t recordNBytes)
+    {
+        scarab::path sidecarFilename = GetSidecarFilename(eggFilename, stream);
+        std::ifstream sidecar(sidecarFilename.native());
+        if (! sidecar.is_open())
+        {
+            KTDEBUG(eggidxlog, "No index found for <" << eggFilename << ">");
+            return false;
+        }
+
+        std::string tag;
+        unsigned version = 0, sidecarStream = 0;
+        uint64_t fileSize = 0;
+        int64_t writeTime = 0;
+        uint64_t nEntries = 0;
+        sidecar >> tag >> version >> fileSize >> writeTime >> sidecarStream >> nEntries;
+        if (! sidecar || tag != "katydid-egg-index" || version != sSidecarVersion)
+        {
+            KTWARN(eggidxlog, "Index <" << sidecarFilename << "> is not readable; it will be ignored");
+            return false;
+        }
+
+        uint64_t sidecarSize = 0;
+        try
+        {
+            if (fileSize != boost::filesystem::file_size(eggFilename) || writeTime != int64_t(boost::filesystem::last_write_time(eggFilename)))
+            {
+                KTINFO(eggidxlog, "Index <" << sidecarFilename << "> is out of date; it will be ignored");
+                return false;
+            }
+            sidecarSize = boost::filesystem::file_size(sidecarFilename);
+        }
+        catch (boost::filesystem::filesystem_error& e)
+        {
+            KTERROR(eggidxlog, "Unable to check egg file <" << eggFilename << ">: " << e.what());
+            return false;
+        }
+        if (sidecarStream != stream)
+        {
+            KTINFO(eggidxlog, "Index <" << sidecarFilename << "> is for stream " << sidecarStream << ", not " << stream << "; it will be ignored");
+            return false;
+        }
+
+        // the number of entries is checked before anything is allocated for them: each entry takes at least
+        // sMinEntryNBytes in the sidecar, and has at least one record, which can't be smaller than recordNBytes in the egg file
+        uint64_t maxRecords = fileSize / std::max< uint64_t >(recordNBytes, 1);
+        uint64_t headerNBytes = uint64_t(sidecar.tellg());
+        uint64_t maxEntries = std::min(maxRecords, (sidecarSize - std::min(headerNBytes, sidecarSize)) / sMinEntryNBytes);
+        if (nEntries > maxEntries)
+        {
+            KTWARN(eggidxlog, "Index <" << sidecarFilename << "> claims " << nEntries << " entries, but there can be no more than " << maxEntries << "; it will be ignored");
+            return false;
+        }
+
+        std::vector< Entry > newEntries(nEntries);
+        uint64_t nRecords = 0;
+        for (std::vector< Entry >::iterator entryIt = newEntries.begin(); entryIt != newEntries.end(); ++entryIt)
+        {
+            entryIt->fFile = file;
+            sidecar >> entryIt->fAcquisitionId >> entryIt->fFirstRecordId >> entryIt->fTimeStamp >> entryIt->fRecordOffset >> entryIt->fNRecords;
+            if (! sidecar) break;
+            // the entries of a file cover its records in order, without gaps
+            if (entryIt->fNRecords == 0 || entryIt->fRecordOffset != nRecords || entryIt->fNRecords > maxRecords - nRecords)
+            {
+                KTWARN(eggidxlog, "Index <" << sidecarFilename << "> has an invalid entry, or more records than the egg file can hold; it will be ignored");
+                return false;
+            }
+            nRecords += entryIt->fNRecords;
+        }
+        if (! sidecar)
+        {
+            KTWARN(eggidxlog, "Index <" << sidecarFilename << "> is incomplete; it will be ignored");
+            return false;
+        }
+
+        fEntries.insert(fEntries.end(), newEntries.begin(), newEntries.end());
+        KTDEBUG(eggidxlog, "Read " << nEntries << " index entries from <" << sidecarFilename << ">");
+        return true;
+    }
+
+    bool KTEggIndex::WriteSidecar(const scarab::path& eggFilename, unsigned file, unsigned stream) const
+    {
+        scarab::path sidecarFilename = GetSidecarFilename(eggFilename, stream);
+
+        uint64_t fileSize = 0;
+        int64_t writeTime = 0;
+        try
+        {
+            fileSize = boost::filesystem::file_size(eggFilename);
+            writeTime = int64_t(boost::filesystem::last_write_time(eggFilename));
+        }
+        catch (boost::filesystem::filesystem_error& e)
+        {
+            KTERROR(eggidxlog, "Unable to check egg file <" << eggFilename << ">: " << e.what());
+            return false;
+        }
+
+        uint64_t nEntries = 0;
+        for (std::vector< Entry >::const_iterator entryIt = fEntries.begin(); entryIt != fEntries.end(); ++entryIt)
+        {
+            if (entryIt->fFile == file) ++nEntries;
+        }
+
+        std::ofstream sidecar(sidecarFilename.native());
+        if (! sidecar.is_open())
+        {
+            // e.g. the data directory is read-only; the index will just have to be rebuilt next time
+            KTWARN(eggidxlog, "Unable to write index <" << sidecarFilename << ">");
+            return false;
+        }
+
+        sidecar << "katydid-egg-index " << sSidecarVersion << ' ' << fileSize << ' ' << writeTime << ' ' << stream << ' ' << nEntries << '\n';
+        for (std::vector< Entry >::const_iterator entryIt = fEntries.begin(); entryIt != fEntries.end(); ++entryIt)
+        {
+            if (entryIt->fFile != file) continue;
+            sidecar << entryIt->fAcquisitionId << ' ' << entryIt->fFirstRecordId << ' ' << entryIt->fTimeStamp << ' ' << entryIt->fRecordOffset << ' ' << entryIt->fNRecords << '\n';
+        }
+        if (! sidecar)
+        {
+            KTWARN(eggidxlog, "Something went wrong while writing index <" << sidecarFilename << ">");
+            return false;
+        }
+
+        KTINFO(eggidxlog, "Wrote " << nEntries << " index entries to <" << sidecarFilename << ">");
+        return true;
+    }
+
+    scarab::path KTEggIndex::GetSidecarFilename(const scarab::path& eggFilename, unsigned stream)
+    {
+        scarab::path sidecarFilename(eggFilename);
+        sidecarFilename += "." + std::to_string(stream) + sSidecarExtension;
+        return sidecarFilename;
+    }
+
+} /* namespace Katydid */
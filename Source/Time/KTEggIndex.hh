@@ -0,0 +1,114 @@
+/**
+ @file KTEggIndex.hh
+ @brief Contains KTEggIndex
+ @details Time/record index of the acquisitions in a run, cached on disk next to each egg file
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTEGGINDEX_HH_
+#define KTEGGINDEX_HH_
+
+#include "path.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Katydid
+{
+
+    /*!
+     @class KTEggIndex
+     @author agent
+
+     @brief Index of the acquisitions in a run, used to seek to a time or record without reading the earlier records
+
+     @details
+     There is one entry per acquisition.  Records within an acquisition are contiguous, so the record containing
+     a particular time or record ID is found by a binary search over the entries followed by a bit of arithmetic.
+
+     The entries for each egg file and stream are cached in a sidecar file next to the egg file (e.g. run.egg.0.kdx for stream 0).
+     The sidecar records the size and modification time of the egg file; if they don't match, the sidecar is considered stale and is not used.
+
+     Entries must be added in run order (i.e. in order of increasing time stamp and record ID).
+
+     The record offset of an entry is the position of the acquisition's first record in the file, counting records
+     from the start of the file (the indexed stream only).  This is the offset used by Monarch to move to a record,
+     and it is independent of how the records are laid out on disk.
+    */
+    class KTEggIndex
+    {
+        public:
+            struct Entry
+            {
+                unsigned fFile; /// position of the file in the run's list of files
+                uint64_t fAcquisitionId;
+                uint64_t fFirstRecordId;
+                uint64_t fTimeStamp; /// time stamp of the first record, in ns
+                uint64_t fRecordOffset; /// position of the first record in the file, in records
+                uint64_t fNRecords;
+            };
+
+        public:
+            KTEggIndex();
+            virtual ~KTEggIndex();
+
+            void Clear();
+
+            void AddEntry(const Entry& entry);
+            /// Adds a record to the index; a new entry is started if the record is from a different acquisition or file than the last one
+            void AddRecord(unsigned file, uint64_t acqId, uint64_t recordId, uint64_t timeStamp, uint64_t recordOffset);
+
+            unsigned GetNEntries() const;
+            const Entry& GetEntry(unsigned iEntry) const;
+
+            /// Returns the entry containing timeStamp (in ns); if timeStamp falls between acquisitions, the next one is returned.
+            /// Returns NULL if timeStamp is after the end of the run.
+            const Entry* FindTime(uint64_t timeStamp, uint64_t recordLength) const;
+            /// Returns the entry containing the record at position recordInRun in the run, counting the records of all of the files from 0,
+            /// and gives the position of the record in the entry.  Returns NULL if the run has no more than recordInRun records.
+            const Entry* FindRecordInRun(uint64_t recordInRun, uint64_t& recordInEntry) const;
+
+            /// Steps through the entries before firstEntry the way the reader does when the run is read from the beginning:
+            /// a slice starts every stride samples, and a slice that would start in a later acquisition starts at the beginning of the record it falls in.
+            /// Returns the number of slices that start before firstEntry; startRecord is set to the record of firstEntry in which the next slice starts
+            /// (it can be beyond the end of firstEntry if the stride is longer than the acquisition).
+            uint64_t GetNSlicesBefore(unsigned firstEntry, unsigned recordSize, unsigned stride, uint64_t& startRecord) const;
+
+            /// Divides the entries into nShards contiguous groups with roughly equal numbers of records,
+            /// and gives the first and last (inclusive) entries in the requested shard.
+            /// Returns false if the shard is empty (e.g. there are more shards than entries).
+            bool GetShard(unsigned nShards, unsigned shard, unsigned& firstEntry, unsigned& lastEntry) const;
+
+            /// Reads the sidecar for an egg file, and adds its entries with the given file number
+            /// recordNBytes is the smallest size a record of the stream can have in the egg file; it limits the number of records the sidecar can describe
+            /// Returns false if there's no sidecar, or if it's stale or invalid
+            bool ReadSidecar(const scarab::path& eggFilename, unsigned file, unsigned stream, uint64_t recordNBytes);
+            /// Writes the entries for the given file number to the egg file's sidecar
+            bool WriteSidecar(const scarab::path& eggFilename, unsigned file, unsigned stream) const;
+
+            static scarab::path GetSidecarFilename(const scarab::path& eggFilename, unsigned stream);
+
+            static const std::string sSidecarExtension;
+            static const unsigned sSidecarVersion = 1;
+            /// Size of the shortest possible entry in a sidecar file ("0 0 0 0 1\n")
+            static const unsigned sMinEntryNBytes = 10;
+
+        private:
+            std::vector< Entry > fEntries;
+    };
+
+    inline unsigned KTEggIndex::GetNEntries() const
+    {
+        return unsigned(fEntries.size());
+    }
+
+    inline const KTEggIndex::Entry& KTEggIndex::GetEntry(unsigned iEntry) const
+    {
+        return fEntries[iEntry];
+    }
+
+} /* namespace Katydid */
+
+#endif /* KTEGGINDEX_HH_ */
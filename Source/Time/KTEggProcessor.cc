@@ -13,11 +13,14 @@
 #include "KTData.hh"
 #include "KTEggHeader.hh"
 #include "KTEggReader.hh"
+#include "KTEggReaderWorker.hh"
 #include "KTProcSummary.hh"
 #include "KTRawTimeSeriesData.hh"
 #include "KTTimeSeriesData.hh"
 #include "KTSliceHeader.hh"
 
+#include <deque>
+
 using std::string;
 
 
@@ -41,6 +44,15 @@ namespace Katydid
             fStride(1024),
             fStartTime(0.),
             fStartRecord(0),
+            fReadAhead(0),
+            fBorrowRecords(false),
+            fReadAllStreams(false),
+            fUseIndex(false),
+            fFirstAcquisition(0),
+            fLastAcquisition(-1),
+            fNShards(0),
+            fShard(0),
+            fNFilesReadAhead(0),
             fDAC(new KTDAC()),
             fNormalizeVoltages(true),
             fHeaderSignal("header", this),
@@ -104,6 +116,27 @@ namespace Katydid
             // specify the time in the run to start
             fStartTime = node->get_value< double >("start-time", fStartTime);
             fStartRecord = node->get_value< unsigned >("start-record", fStartRecord);
+            // number of records to read ahead of the processing (0 to disable)
+            fReadAhead = node->get_value< unsigned >("read-ahead", fReadAhead);
+            // whether slices within one record should share the record's memory
+            fBorrowRecords = node->get_value< bool >("borrow-records", fBorrowRecords);
+            // whether to read every stream in the file, rather than just the one containing channel 0
+            fReadAllStreams = node->get_value< bool >("read-all-streams", fReadAllStreams);
+            // whether to use the (cached) index of acquisitions to find the starting point
+            fUseIndex = node->get_value< bool >("use-index", fUseIndex);
+            // process only part of the run, divided at acquisition boundaries
+            fFirstAcquisition = node->get_value< unsigned >("first-acquisition", fFirstAcquisition);
+            fLastAcquisition = node->get_value< int >("last-acquisition", fLastAcquisition);
+            fNShards = node->get_value< unsigned >("n-shards", fNShards);
+            fShard = node->get_value< unsigned >("shard", fShard);
+            if (fNShards > 1 && fShard >= fNShards)
+            {
+                KTERROR(egglog, "Shard " << fShard << " was requested, but there are only " << fNShards << " shards");
+                return false;
+            }
+
+            // number of files to read at the same time
+            fNFilesReadAhead = node->get_value< unsigned >("n-files-read-ahead", fNFilesReadAhead);
 
             if (fSliceSize == 0)
             {
@@ -137,6 +170,11 @@ namespace Katydid
 
     bool KTEggProcessor::ProcessEgg()
     {
+        if (fNFilesReadAhead > 1 && fFilenames.size() > 1)
+        {
+            return ProcessFilesWithReadAhead();
+        }
+
         // Create egg reader and transfer information
         KTEggReader* reader = scarab::factory< KTEggReader >::get_instance()->create(fEggReaderType);
         if (reader == NULL)
@@ -223,21 +261,7 @@ namespace Katydid
                 nextSliceIsValid = false;
             }
 
-            if (data->Has< KTRawTimeSeriesData >())
-            {
-                KTDEBUG(egglog, "Raw time series data is present.");
-                fRawDataSignal(data);
-                NormalizeData(data);
-            }
-            if (data->Has< KTTimeSeriesData >())
-            {
-                KTDEBUG(egglog, "Normalized time series data is present.");
-                fDataSignal(data);
-            }
-            else
-            {
-                KTWARN(egglog, "No time-series data present in slice");
-            }
+            EmitSlice(data);
 
             ++iSlice;
             ++iProgress;
@@ -273,30 +297,200 @@ namespace Katydid
 
             if (iSlice == fNSlices - 1) data->Of< Nymph::KTData >().SetLastData(true);
 
-            if (data->Has< KTRawTimeSeriesData >())
+            EmitSlice(data);
+
+            ++iSlice;
+            ++iProgress;
+
+            if (iProgress == fProgressReportInterval)
+            {
+                iProgress = 0;
+                KTPROG(egglog, iSlice << " slices processed (" << double(iSlice) / double(fNSlices) * 100. << " %)");
+            }
+        }
+        return;
+    }
+
+    bool KTEggProcessor::ProcessFilesWithReadAhead()
+    {
+        // only the reading is concurrent; the slices of each file are emitted on this thread, after those of the files before it
+        KTINFO(egglog, "Processing " << fFilenames.size() << " files, reading ahead up to " << fNFilesReadAhead << " at a time");
+
+        std::deque< ReadAheadFile > openFiles;
+        KTEggReader::path_vec::const_iterator nextFileIt = fFilenames.begin();
+
+        unsigned iSlice = 0, iProgress = 0, nRecords = 0;
+        double integratedTime = 0.;
+        // the most recent slice is held back until we know whether it's the last one
+        Nymph::KTDataPtr data;
+        bool done = false;
+        while (! done)
+        {
+            // keep the window of files being read full
+            while (openFiles.size() < fNFilesReadAhead && nextFileIt != fFilenames.end())
             {
-                KTDEBUG(egglog, "Raw time series data is present.");
-                fRawDataSignal(data);
-                NormalizeData(data);
+                ReadAheadFile file;
+                if (! OpenReadAheadFile(*nextFileIt, file))
+                {
+                    KTERROR(egglog, "Egg <" << *nextFileIt << "> did not break");
+                    while (! openFiles.empty())
+                    {
+                        CloseReadAheadFile(openFiles.front());
+                        openFiles.pop_front();
+                    }
+                    return false;
+                }
+                openFiles.push_back(file);
+                ++nextFileIt;
             }
-            if (data->Has< KTTimeSeriesData >())
+            if (openFiles.empty()) break;
+
+            ReadAheadFile& file = openFiles.front();
+            KTPROG(egglog, "Processing slices from <" << file.fFilename << ">");
+
+            Nymph::KTDataPtr nextData = file.fWorker->Pop();
+            if (! nextData)
             {
-                KTDEBUG(egglog, "Normalized time series data is present.");
-                fDataSignal(data);
+                KTWARN(egglog, "No slices were hatched from <" << file.fFilename << ">");
             }
             else
             {
-                KTWARN(egglog, "No time-series data present in slice");
-            }
+                // all of the previous file's slices are emitted before this file's header
+                if (data) EmitSlice(data);
+                data.reset();
 
-            ++iSlice;
-            ++iProgress;
+                // pass the digitizer parameters from this file's header to the DAC
+                if (! fDAC->InitializeWithHeader(file.fHeader->Of< KTEggHeader >()))
+                {
+                    KTERROR(egglog, "Unable to initialize the DAC for <" << file.fFilename << ">");
+                    while (! openFiles.empty())
+                    {
+                        CloseReadAheadFile(openFiles.front());
+                        openFiles.pop_front();
+                    }
+                    return false;
+                }
+                fHeaderSignal(file.fHeader);
+            }
 
-            if (iProgress == fProgressReportInterval)
+            while (nextData)
             {
-                iProgress = 0;
-                KTPROG(egglog, iSlice << " slices processed (" << double(iSlice) / double(fNSlices) * 100. << " %)");
+                if (fNSlices != 0 && iSlice >= fNSlices)
+                {
+                    KTPROG(egglog, iSlice << "/" << fNSlices << " slices hatched; slice processing is complete");
+                    done = true;
+                    break;
+                }
+
+                // there's another slice, so the held-back one is not the last
+                if (data) EmitSlice(data);
+                data = nextData;
+                ++iSlice;
+                ++iProgress;
+
+                if (iProgress == fProgressReportInterval)
+                {
+                    iProgress = 0;
+                    KTPROG(egglog, iSlice << " slices processed");
+                }
+
+                nextData = file.fWorker->Pop();
             }
+
+            nRecords += file.fWorker->GetNRecordsProcessed();
+            integratedTime += file.fWorker->GetIntegratedTime();
+            CloseReadAheadFile(file);
+            openFiles.pop_front();
+        }
+
+        while (! openFiles.empty())
+        {
+            CloseReadAheadFile(openFiles.front());
+            openFiles.pop_front();
+        }
+
+        if (data)
+        {
+            data->Of< Nymph::KTData >().SetLastData(true);
+            EmitSlice(data);
+        }
+
+        fEggDoneSignal();
+
+        KTProcSummary* summary = new KTProcSummary();
+        summary->SetNSlicesProcessed(iSlice);
+        summary->SetNRecordsProcessed(nRecords);
+        summary->SetIntegratedTime(integratedTime);
+        KTDEBUG(egglog, "Summary of processing:\n" <<
+                "\tSlices processed: " << summary->GetNSlicesProcessed() << '\n' <<
+                "\tRecords processed: " << summary->GetNRecordsProcessed() << '\n' <<
+                "\tIntegrated time: " << summary->GetIntegratedTime() << " s");
+        if(fNSlices != 0 && summary->GetNSlicesProcessed() != fNSlices)
+        {
+            KTWARN(egglog, "Could not process the requested number of slices because there was not enough data in the file(s):\n" <<
+                    "\tSlices requested: " << fNSlices << '\n' <<
+                    "\tSlices processed: " << summary->GetNSlicesProcessed());
+        }
+        fSummarySignal(summary);
+        delete summary;
+
+        return true;
+    }
+
+    bool KTEggProcessor::OpenReadAheadFile(const scarab::path& filename, ReadAheadFile& file)
+    {
+        file.fFilename = filename;
+        file.fWorker = NULL;
+        file.fReader = scarab::factory< KTEggReader >::get_instance()->create(fEggReaderType);
+        if (file.fReader == NULL)
+        {
+            KTERROR(egglog, "Invalid egg reader type: " << fEggReaderType);
+            return false;
+        }
+        file.fReader->Configure(*this);
+
+        KTEggReader::path_vec oneFile(1, filename);
+        file.fHeader = file.fReader->BreakEgg(oneFile);
+        if (! file.fHeader)
+        {
+            delete file.fReader;
+            file.fReader = NULL;
+            return false;
+        }
+
+        file.fWorker = new KTEggReaderWorker(file.fReader, sReadAheadFileDepth);
+        file.fWorker->Start();
+        KTDEBUG(egglog, "Started reading <" << filename << ">");
+        return true;
+    }
+
+    void KTEggProcessor::CloseReadAheadFile(ReadAheadFile& file)
+    {
+        // the worker has to be stopped before its reader is deleted
+        delete file.fWorker;
+        file.fWorker = NULL;
+        delete file.fReader;
+        file.fReader = NULL;
+        file.fHeader.reset();
+        return;
+    }
+
+    void KTEggProcessor::EmitSlice(Nymph::KTDataPtr& data)
+    {
+        if (data->Has< KTRawTimeSeriesData >())
+        {
+            KTDEBUG(egglog, "Raw time series data is present.");
+            fRawDataSignal(data);
+            NormalizeData(data);
+        }
+        if (data->Has< KTTimeSeriesData >())
+        {
+            KTDEBUG(egglog, "Normalized time series data is present.");
+            fDataSignal(data);
+        }
+        else
+        {
+            KTWARN(egglog, "No time-series data present in slice");
         }
         return;
     }
@@ -21,6 +21,7 @@ namespace Katydid
 {
     
     class KTDAC;
+    class KTEggReaderWorker;
     class KTProcSummary;
     class KTTimeSeriesData;
 
@@ -55,6 +56,17 @@ namespace Katydid
          between slices)
      - "start-time": double -- Specify how far into the file to start (in seconds); if "start-record" is non-zero, this will be ignored
      - "start-record": unsigned -- Specify which record to start on; if "start-time" is present and this is non-zero, start-time will be ignored
+     - "read-ahead": unsigned -- Number of records to read ahead on a background thread (egg3 reader only); 0 (default) disables reading ahead
+     - "borrow-records": bool -- If true, slices that lie within a single record share the read-ahead buffer's copy of that record instead of copying it again (egg3 reader only; implies reading ahead); default is false
+     - "read-all-streams": bool -- If true, all streams in the file are read, each on its own thread; the channels of all streams are included in each slice (egg3 reader only); default is false
+     - "use-index": bool -- If true, "start-time" and "start-record" are found with an index of the acquisitions in the run, which is cached next to each egg file and built the first time it's needed (egg2 and egg3 readers); default is false
+     - "first-acquisition": unsigned -- First acquisition to read, counting from 0 (egg3 reader only; uses the index); default is 0
+     - "last-acquisition": int -- Last acquisition to read, inclusive; -1 reads to the end of the run (egg3 reader only; uses the index); default is -1
+     - "n-shards": unsigned -- Divides the run into this many pieces at acquisition boundaries, to be processed separately (egg3 reader only; uses the index); 0 or 1 means the run is not divided; default is 0
+     - "shard": unsigned -- Which of the shards to process, counting from 0; its slices are numbered as they are in the whole run; use MergeShards to combine the outputs of the shards; default is 0
+     - "n-files-read-ahead": unsigned -- If greater than 1 and multiple files are given, up to this many files are read ahead at the same time, each with its own reader and thread;
+        only the reading is concurrent: the slices are processed one at a time, in file order, by the one processor chain.  Each file is treated as a separate run
+        (the "header" signal is emitted for each file, and times in the run start again in each file); default is 0 (files are read in sequence as one run)
      - "normalize-voltages": bool -- Flag to toggle the normalization of ADC
         values from the egg file (default: true)
      - "dac": object -- configure the DAC
@@ -99,6 +111,15 @@ namespace Katydid
             MEMBERVARIABLE(unsigned, Stride);
             MEMBERVARIABLE(double, StartTime); // will only be used if fStartRecord is 0
             MEMBERVARIABLE(unsigned, StartRecord);
+            MEMBERVARIABLE(unsigned, ReadAhead);
+            MEMBERVARIABLE(bool, BorrowRecords);
+            MEMBERVARIABLE(bool, ReadAllStreams);
+            MEMBERVARIABLE(bool, UseIndex);
+            MEMBERVARIABLE(unsigned, FirstAcquisition);
+            MEMBERVARIABLE(int, LastAcquisition);
+            MEMBERVARIABLE(unsigned, NShards);
+            MEMBERVARIABLE(unsigned, Shard);
+            MEMBERVARIABLE(unsigned, NFilesReadAhead);
 
             MEMBERVARIABLE(bool, NormalizeVoltages);
 
@@ -117,6 +138,23 @@ namespace Katydid
             void UnlimitedLoop(KTEggReader* reader);
             void LimitedLoop(KTEggReader* reader);
 
+            void EmitSlice(Nymph::KTDataPtr& data);
+
+            struct ReadAheadFile
+            {
+                scarab::path fFilename;
+                KTEggReader* fReader;
+                KTEggReaderWorker* fWorker;
+                Nymph::KTDataPtr fHeader;
+            };
+
+            bool ProcessFilesWithReadAhead();
+            bool OpenReadAheadFile(const scarab::path& filename, ReadAheadFile& file);
+            void CloseReadAheadFile(ReadAheadFile& file);
+
+            /// Number of slices hatched ahead for each file when files are read ahead
+            static const unsigned sReadAheadFileDepth = 16;
+
 
             //***************
             // Signals
@@ -0,0 +1,111 @@
+/*
+ * KTEggReaderWorker.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTEggReaderWorker.hh"
+
+#include "KTEggReader.hh"
+#include "KTLogger.hh"
+
+namespace Katydid
+{
+    KTLOGGER(eggworklog, "KTEggReaderWorker");
+
+    KTEggReaderWorker::KTEggReaderWorker(KTEggReader* reader, unsigned depth) :
+            fReader(reader),
+            fDepth(depth > 0 ? depth : 1),
+            fNSlicesProcessed(0),
+            fNRecordsProcessed(0),
+            fIntegratedTime(0.),
+            fSlices(),
+            fReaderDone(true),
+            fStopRequested(false),
+            fMutex(),
+            fNotEmpty(),
+            fNotFull(),
+            fThread()
+    {
+    }
+
+    KTEggReaderWorker::~KTEggReaderWorker()
+    {
+        Stop();
+    }
+
+    void KTEggReaderWorker::Start()
+    {
+        Stop();
+        fStopRequested = false;
+        fReaderDone = false;
+        fThread = std::thread(&KTEggReaderWorker::HatchSlices, this);
+        return;
+    }
+
+    void KTEggReaderWorker::Stop()
+    {
+        if (fThread.joinable())
+        {
+            {
+                std::unique_lock< std::mutex > lock(fMutex);
+                fStopRequested = true;
+            }
+            fNotFull.notify_all();
+            fThread.join();
+        }
+        fSlices.clear();
+        fReaderDone = true;
+        fNSlicesProcessed = 0;
+        fNRecordsProcessed = 0;
+        fIntegratedTime = 0.;
+        return;
+    }
+
+    Nymph::KTDataPtr KTEggReaderWorker::Pop()
+    {
+        std::unique_lock< std::mutex > lock(fMutex);
+        fNotEmpty.wait(lock, [this]{ return ! fSlices.empty() || fReaderDone; });
+        if (fSlices.empty()) return Nymph::KTDataPtr();
+
+        HatchedSlice slice = fSlices.front();
+        fSlices.pop_front();
+        lock.unlock();
+        fNotFull.notify_one();
+
+        fNSlicesProcessed = slice.fNSlicesProcessed;
+        fNRecordsProcessed = slice.fNRecordsProcessed;
+        fIntegratedTime = slice.fIntegratedTime;
+        return slice.fData;
+    }
+
+    void KTEggReaderWorker::HatchSlices()
+    {
+        while (true)
+        {
+            HatchedSlice slice;
+            slice.fData = fReader->HatchNextSlice();
+            if (! slice.fData) break;
+            slice.fNSlicesProcessed = fReader->GetNSlicesProcessed();
+            slice.fNRecordsProcessed = fReader->GetNRecordsProcessed();
+            slice.fIntegratedTime = fReader->GetIntegratedTime();
+
+            std::unique_lock< std::mutex > lock(fMutex);
+            fNotFull.wait(lock, [this]{ return fSlices.size() < fDepth || fStopRequested; });
+            if (fStopRequested) break;
+            fSlices.push_back(slice);
+            lock.unlock();
+            fNotEmpty.notify_one();
+        }
+
+        KTDEBUG(eggworklog, "Slice hatching is finished");
+        {
+            std::unique_lock< std::mutex > lock(fMutex);
+            fReaderDone = true;
+        }
+        fNotEmpty.notify_all();
+        return;
+    }
+
+} /* namespace Katydid */
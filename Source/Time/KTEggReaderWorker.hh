@@ -0,0 +1,113 @@
+/**
+ @file KTEggReaderWorker.hh
+ @brief Contains KTEggReaderWorker
+ @details Hatches slices from an egg reader on a background thread
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTEGGREADERWORKER_HH_
+#define KTEGGREADERWORKER_HH_
+
+#include "KTData.hh"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Katydid
+{
+
+    class KTEggReader;
+
+    /*!
+     @class KTEggReaderWorker
+     @author agent
+
+     @brief Hatches slices from an egg reader on a background thread
+
+     @details
+     The worker repeatedly calls HatchNextSlice() on its reader and keeps up to fDepth slices waiting.
+     Slices are handed out in the order they were hatched; Pop() returns an empty pointer once the reader has no more slices.
+     The reader's counters are recorded with each slice, so GetNRecordsProcessed(), etc., refer to the last slice popped,
+     regardless of how far ahead the worker is.
+
+     The reader must have been configured and its egg broken before Start() is called.
+     While the worker is running, the reader must not be used from any other thread.
+     The worker does not own the reader.
+    */
+    class KTEggReaderWorker
+    {
+        public:
+            KTEggReaderWorker(KTEggReader* reader, unsigned depth = 2);
+            virtual ~KTEggReaderWorker();
+
+            void Start();
+            /// Stops hatching and discards any slices still waiting
+            void Stop();
+
+            /// Blocks until the next slice is available; returns an empty pointer when the reader is done
+            Nymph::KTDataPtr Pop();
+
+            KTEggReader* GetReader() const;
+
+            /// Number of slices processed by the reader as of the last slice popped
+            unsigned GetNSlicesProcessed() const;
+            /// Number of records processed by the reader as of the last slice popped
+            unsigned GetNRecordsProcessed() const;
+            /// Integrated time of the reader as of the last slice popped
+            double GetIntegratedTime() const;
+
+        private:
+            void HatchSlices();
+
+            struct HatchedSlice
+            {
+                Nymph::KTDataPtr fData;
+                unsigned fNSlicesProcessed;
+                unsigned fNRecordsProcessed;
+                double fIntegratedTime;
+            };
+
+            KTEggReader* fReader;
+            unsigned fDepth;
+
+            // consumer-side copies of the reader's counters
+            unsigned fNSlicesProcessed;
+            unsigned fNRecordsProcessed;
+            double fIntegratedTime;
+
+            std::deque< HatchedSlice > fSlices;
+            bool fReaderDone;
+            bool fStopRequested;
+            std::mutex fMutex;
+            std::condition_variable fNotEmpty;
+            std::condition_variable fNotFull;
+
+            std::thread fThread;
+    };
+
+    inline KTEggReader* KTEggReaderWorker::GetReader() const
+    {
+        return fReader;
+    }
+
+    inline unsigned KTEggReaderWorker::GetNSlicesProcessed() const
+    {
+        return fNSlicesProcessed;
+    }
+
+    inline unsigned KTEggReaderWorker::GetNRecordsProcessed() const
+    {
+        return fNRecordsProcessed;
+    }
+
+    inline double KTEggReaderWorker::GetIntegratedTime() const
+    {
+        return fIntegratedTime;
+    }
+
+} /* namespace Katydid */
+
+#endif /* KTEGGREADERWORKER_HH_ */
@@ -14,6 +14,8 @@
 
 #include "digital.hh"
 
+#include <cmath>
+
 using std::string;
 
 namespace Katydid
@@ -26,14 +28,18 @@ namespace Katydid
             fVoltageOffset(0.),
             fVoltageRange(0.),
             fDACGain(-1.),
-            fBitAlignment(sBitsAlignedLeft),
             fDigitizedDataFormat(sInvalidFormat),
             fTimeSeriesType(kUnknownTimeSeries),
             fBitDepthMode(kNoChange),
             fEmulatedNBits(fNBits),
+            fBitAlignment(sBitsAlignedLeft),
+            fSinglePrecision(false),
             fShouldRunInitialize(true),
             fVoltages(),
             fIntLevelOffset(0),
+            fLinearVoltages(false),
+            fLinearGain(0.),
+            fLinearOffset(0.),
             fConvertTSFunc(NULL),
             fOversamplingBins(1),
             fOversamplingScaleFactor(1.)
@@ -46,14 +52,18 @@ namespace Katydid
             fVoltageOffset(orig.fVoltageOffset),
             fVoltageRange(orig.fVoltageRange),
             fDACGain(orig.fDACGain),
-            fBitAlignment(orig.fBitAlignment),
             fDigitizedDataFormat(orig.fDigitizedDataFormat),
             fTimeSeriesType(orig.fTimeSeriesType),
             fBitDepthMode(orig.fBitDepthMode),
             fEmulatedNBits(orig.fEmulatedNBits),
+            fBitAlignment(orig.fBitAlignment),
+            fSinglePrecision(orig.fSinglePrecision),
             fShouldRunInitialize(orig.fShouldRunInitialize),
             fVoltages(orig.fVoltages),
             fIntLevelOffset(orig.fIntLevelOffset),
+            fLinearVoltages(orig.fLinearVoltages),
+            fLinearGain(orig.fLinearGain),
+            fLinearOffset(orig.fLinearOffset),
             fConvertTSFunc(orig.fConvertTSFunc),
             fOversamplingBins(orig.fOversamplingBins),
             fOversamplingScaleFactor(orig.fOversamplingScaleFactor)
@@ -102,6 +112,23 @@ namespace Katydid
             SetEmulatedNBits(node->get_value< unsigned >("n-bits-emulated", fEmulatedNBits));
         }
 
+        string precisionString = node->get_value("precision", fSinglePrecision ? "float" : "double");
+        if (precisionString == "double") SetSinglePrecision(false);
+#ifdef FFTWF_FOUND
+        else if (precisionString == "float") SetSinglePrecision(true);
+#else
+        else if (precisionString == "float")
+        {
+            KTERROR(egglog_scdac, "Single precision is not available; Katydid was built without single-precision FFTW");
+            return false;
+        }
+#endif
+        else
+        {
+            KTERROR(egglog_scdac, "Illegal string for precision: <" << precisionString << ">");
+            return false;
+        }
+
         return true;
     }
 
@@ -112,6 +139,7 @@ namespace Katydid
 
         SetTimeSeriesType(master.GetTimeSeriesType());
         SetEmulatedNBits(master.GetEmulatedNBits());
+        SetSinglePrecision(master.GetSinglePrecision());
 
         return true;
     }
@@ -174,6 +202,12 @@ namespace Katydid
             return false;
         }
 
+        if (fSinglePrecision && fBitDepthMode == kIncreasing)
+        {
+            KTERROR(egglog_scdac, "Increasing the bit depth is only available in double precision");
+            return false;
+        }
+
         if (! fVoltages.empty())
         {
             fVoltages.clear();
@@ -290,7 +324,41 @@ namespace Katydid
             }
         }
 
+        // check whether the voltages can be calculated directly from the levels, rather than looked up
+        fLinearVoltages = false;
+        if (fVoltages.size() > 1)
+        {
+            fLinearOffset = fVoltages[fIntLevelOffset];
+            fLinearGain = fIntLevelOffset + 1 < int64_t(fVoltages.size()) ?
+                    fVoltages[fIntLevelOffset + 1] - fLinearOffset : fLinearOffset - fVoltages[fIntLevelOffset - 1];
+            // allow for rounding in the voltage calculation
+            double tolerance = 1.e-9 * std::fabs(fLinearGain);
+            fLinearVoltages = fLinearGain != 0.;
+            for (int64_t iLevel = 0; iLevel < int64_t(fVoltages.size()) && fLinearVoltages; ++iLevel)
+            {
+                fLinearVoltages = std::fabs(fVoltages[iLevel] - (double(iLevel - fIntLevelOffset) * fLinearGain + fLinearOffset)) <= tolerance;
+            }
+        }
+        KTDEBUG(egglog_scdac, "Voltages are " << (fLinearVoltages ? "" : "not ") << "linear in the digitized level");
+
         // setting the convert function
+#ifdef FFTWF_FOUND
+        if (fSinglePrecision)
+        {
+            // bit-depth increases (oversampling) were rejected above
+            if (fTimeSeriesType == kFFTWTimeSeries)
+            {
+                KTDEBUG(egglog_scdac, "Convert function set to " << (fDigitizedDataFormat == sDigitizedS ? "signed" : "unsigned") << " int --> single-precision FFTW");
+                fConvertTSFunc = fDigitizedDataFormat == sDigitizedS ? &KTSingleChannelDAC::ConvertSignedToFFTWF : &KTSingleChannelDAC::ConvertUnsignedToFFTWF;
+            }
+            else //(fTimeSeriesType == kRealTimeSeries)
+            {
+                KTDEBUG(egglog_scdac, "Convert function set to " << (fDigitizedDataFormat == sDigitizedS ? "signed" : "unsigned") << " int --> single-precision real");
+                fConvertTSFunc = fDigitizedDataFormat == sDigitizedS ? &KTSingleChannelDAC::ConvertSignedToRealF : &KTSingleChannelDAC::ConvertUnsignedToRealF;
+            }
+        }
+        else
+#endif
         if (fTimeSeriesType == kFFTWTimeSeries)
         {
             if (fBitDepthMode != kIncreasing)
@@ -351,6 +419,117 @@ namespace Katydid
         }
 
         fShouldRunInitialize = false;
+
+        // use the conversion specialized for the data type, where there is one
+        if (fBitDepthMode != kIncreasing) SetTypedConvertFunction();
+
+        return true;
+    }
+
+    bool KTSingleChannelDAC::SetTypedConvertFunction()
+    {
+        bool toFFTW = fTimeSeriesType == kFFTWTimeSeries;
+        if (fDigitizedDataFormat == sDigitizedUS && fDataTypeSize == 1)
+        {
+#ifdef FFTWF_FOUND
+            if (fSinglePrecision) fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTWF< uint8_t > : &KTSingleChannelDAC::ConvertTypedToRealF< uint8_t >;
+            else
+#endif
+            fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTW< uint8_t > : &KTSingleChannelDAC::ConvertTypedToReal< uint8_t >;
+        }
+        else if (fDigitizedDataFormat == sDigitizedS && fDataTypeSize == 1)
+        {
+#ifdef FFTWF_FOUND
+            if (fSinglePrecision) fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTWF< int8_t > : &KTSingleChannelDAC::ConvertTypedToRealF< int8_t >;
+            else
+#endif
+            fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTW< int8_t > : &KTSingleChannelDAC::ConvertTypedToReal< int8_t >;
+        }
+        else if (fDigitizedDataFormat == sDigitizedUS && fDataTypeSize == 2)
+        {
+#ifdef FFTWF_FOUND
+            if (fSinglePrecision) fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTWF< uint16_t > : &KTSingleChannelDAC::ConvertTypedToRealF< uint16_t >;
+            else
+#endif
+            fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTW< uint16_t > : &KTSingleChannelDAC::ConvertTypedToReal< uint16_t >;
+        }
+        else if (fDigitizedDataFormat == sDigitizedS && fDataTypeSize == 2)
+        {
+#ifdef FFTWF_FOUND
+            if (fSinglePrecision) fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTWF< int16_t > : &KTSingleChannelDAC::ConvertTypedToRealF< int16_t >;
+            else
+#endif
+            fConvertTSFunc = toFFTW ? &KTSingleChannelDAC::ConvertTypedToFFTW< int16_t > : &KTSingleChannelDAC::ConvertTypedToReal< int16_t >;
+        }
+        else
+        {
+            return false;
+        }
+        KTDEBUG(egglog_scdac, "Convert function replaced by the version for " << fDataTypeSize << "-byte " <<
+                (fDigitizedDataFormat == sDigitizedS ? "signed" : "unsigned") << " data (" << (fLinearVoltages ? "linear" : "lookup") <<
+                (fSinglePrecision ? ", single precision" : "") << ")");
+        return true;
+    }
+
+    bool KTSingleChannelDAC::ConvertToArray(KTRawTimeSeries* ts, double* out)
+    {
+        if (fShouldRunInitialize)
+        {
+            if (! Initialize())
+            {
+                KTERROR(egglog_scdac, "Failed to initialize single-channel DAC");
+                return false;
+            }
+        }
+
+        if (fBitDepthMode == kIncreasing)
+        {
+            KTERROR(egglog_scdac, "Cannot convert into an array while increasing the bit depth");
+            return false;
+        }
+
+        unsigned nBins = ts->size();
+        if (ts->GetDataTypeSize() == fDataTypeSize)
+        {
+            const uint8_t* storage = ts->GetStorage();
+            if (fDigitizedDataFormat == sDigitizedUS && fDataTypeSize == 1)
+            {
+                ConvertSamples(reinterpret_cast< const uint8_t* >(storage), out, nBins);
+                return true;
+            }
+            if (fDigitizedDataFormat == sDigitizedS && fDataTypeSize == 1)
+            {
+                ConvertSamples(reinterpret_cast< const int8_t* >(storage), out, nBins);
+                return true;
+            }
+            if (fDigitizedDataFormat == sDigitizedUS && fDataTypeSize == 2)
+            {
+                ConvertSamples(reinterpret_cast< const uint16_t* >(storage), out, nBins);
+                return true;
+            }
+            if (fDigitizedDataFormat == sDigitizedS && fDataTypeSize == 2)
+            {
+                ConvertSamples(reinterpret_cast< const int16_t* >(storage), out, nBins);
+                return true;
+            }
+        }
+
+        // other data types go through the generic interface
+        if (fDigitizedDataFormat == sDigitizedS)
+        {
+            KTVarTypePhysicalArray< int64_t > signedTS(*ts, false);
+            for (unsigned bin = 0; bin < nBins; ++bin)
+            {
+                out[bin] = Convert(signedTS(bin));
+            }
+        }
+        else
+        {
+            for (unsigned bin = 0; bin < nBins; ++bin)
+            {
+                out[bin] = Convert((*ts)(bin));
+            }
+        }
         return true;
     }
 
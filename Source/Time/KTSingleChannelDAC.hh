@@ -12,6 +12,7 @@
 #include "param.hh"
 
 #include "KTConstants.hh"
+#include "KTDACKernels.hh"
 #include "KTLogger.hh"
 #include "KTMemberVariable.hh"
 #include "KTRawTimeSeries.hh"
@@ -67,6 +68,9 @@ namespace Katydid
 
             bool SetEmulatedNBits(unsigned nBits);
 
+            /// If true, the output time series are single precision (KTTimeSeriesRealF or KTTimeSeriesFFTWF); only available if Katydid was built with single-precision FFTW
+            void SetSinglePrecision(bool flag);
+
             MEMBERVARIABLE_NOSET(unsigned, DataTypeSize);
             MEMBERVARIABLE_NOSET(unsigned, NBits);
             MEMBERVARIABLE_NOSET(double, VoltageOffset);
@@ -77,6 +81,7 @@ namespace Katydid
             MEMBERVARIABLE_NOSET(BitDepthMode, BitDepthMode);
             MEMBERVARIABLE_NOSET(unsigned, EmulatedNBits);
             MEMBERVARIABLE_NOSET(unsigned, BitAlignment);
+            MEMBERVARIABLE_NOSET(bool, SinglePrecision);
 
         public:
             bool InitializeWithHeader(KTChannelHeader* header);
@@ -97,6 +102,30 @@ namespace Katydid
             KTTimeSeries* ConvertSignedToFFTWOversampled(KTRawTimeSeries* ts);
             KTTimeSeries* ConvertSignedToRealOversampled(KTRawTimeSeries* ts);
 
+#ifdef FFTWF_FOUND
+            KTTimeSeries* ConvertUnsignedToFFTWF(KTRawTimeSeries* ts);
+            KTTimeSeries* ConvertUnsignedToRealF(KTRawTimeSeries* ts);
+
+            KTTimeSeries* ConvertSignedToFFTWF(KTRawTimeSeries* ts);
+            KTTimeSeries* ConvertSignedToRealF(KTRawTimeSeries* ts);
+#endif
+
+            /// Conversion specialized for the raw data type (uint8_t, int8_t, uint16_t or int16_t); the output is written directly into the new time series
+            template< typename XRawType >
+            KTTimeSeries* ConvertTypedToFFTW(KTRawTimeSeries* ts);
+            template< typename XRawType >
+            KTTimeSeries* ConvertTypedToReal(KTRawTimeSeries* ts);
+#ifdef FFTWF_FOUND
+            template< typename XRawType >
+            KTTimeSeries* ConvertTypedToFFTWF(KTRawTimeSeries* ts);
+            template< typename XRawType >
+            KTTimeSeries* ConvertTypedToRealF(KTRawTimeSeries* ts);
+#endif
+
+            /// Converts all of the bins of a raw time series into an existing array (e.g. an FFT input buffer) of at least ts->size() doubles.
+            /// Complex data are written as interleaved real and imaginary parts.  Not available when increasing the bit depth.
+            bool ConvertToArray(KTRawTimeSeries* ts, double* out);
+
             double Convert(uint64_t level);
             double Convert(int64_t level);
 
@@ -111,11 +140,29 @@ namespace Katydid
             template< typename XInterfaceType >
             KTTimeSeries* DoConvertToRealOversampled(const KTVarTypePhysicalArray< XInterfaceType >& ts);
 
+#ifdef FFTWF_FOUND
+            template< typename XInterfaceType >
+            KTTimeSeries* DoConvertToFFTWF(const KTVarTypePhysicalArray< XInterfaceType >& ts);
+            template< typename XInterfaceType >
+            KTTimeSeries* DoConvertToRealF(const KTVarTypePhysicalArray< XInterfaceType >& ts);
+#endif
+
+            template< typename XRawType, typename XOutputType >
+            void ConvertSamples(const XRawType* in, XOutputType* out, unsigned nSamples) const;
+
+            /// Chooses the typed conversion function for the data type size and format, if there is one
+            bool SetTypedConvertFunction();
+
             bool fShouldRunInitialize;
 
             std::vector< double > fVoltages;
             int64_t fIntLevelOffset;
 
+            // if the voltages are an affine function of the level, voltage = fLinearGain * level + fLinearOffset
+            bool fLinearVoltages;
+            double fLinearGain;
+            double fLinearOffset;
+
             KTTimeSeries* (KTSingleChannelDAC::*fConvertTSFunc)(KTRawTimeSeries*);
 
             MEMBERVARIABLE_NOSET(unsigned, OversamplingBins);
@@ -180,6 +227,35 @@ namespace Katydid
         return DoConvertToRealOversampled(KTVarTypePhysicalArray< int64_t >(*ts, false));
     }
 
+#ifdef FFTWF_FOUND
+    inline KTTimeSeries* KTSingleChannelDAC::ConvertUnsignedToFFTWF(KTRawTimeSeries* ts)
+    {
+        return DoConvertToFFTWF(*ts);
+    }
+
+    inline KTTimeSeries* KTSingleChannelDAC::ConvertUnsignedToRealF(KTRawTimeSeries* ts)
+    {
+        return DoConvertToRealF(*ts);
+    }
+
+    inline KTTimeSeries* KTSingleChannelDAC::ConvertSignedToFFTWF(KTRawTimeSeries* ts)
+    {
+        return DoConvertToFFTWF(KTVarTypePhysicalArray< int64_t >(*ts, false));
+    }
+
+    inline KTTimeSeries* KTSingleChannelDAC::ConvertSignedToRealF(KTRawTimeSeries* ts)
+    {
+        return DoConvertToRealF(KTVarTypePhysicalArray< int64_t >(*ts, false));
+    }
+#endif
+
+    inline void KTSingleChannelDAC::SetSinglePrecision(bool flag)
+    {
+        fSinglePrecision = flag;
+        fShouldRunInitialize = true;
+        return;
+    }
+
     inline void KTSingleChannelDAC::SetTimeSeriesType(TimeSeriesType type)
     {
         fTimeSeriesType = type;
@@ -327,6 +403,150 @@ namespace Katydid
 
 
 
+#ifdef FFTWF_FOUND
+    template< typename XInterfaceType >
+    KTTimeSeries* KTSingleChannelDAC::DoConvertToFFTWF(const KTVarTypePhysicalArray< XInterfaceType >& ts)
+    {
+        KTDEBUG(egglog_scdac, "Converting raw-ts to single-precision ts-fftw");
+
+        if (fShouldRunInitialize)
+        {
+            if (! Initialize())
+            {
+                KTERROR(egglog_scdac, "Failed to initialize single-channel DAC");
+                return NULL;
+            }
+        }
+
+        // ts.size() is divided by 2 because we have complex samples, and the raw time series sees each sample as 2 bins
+        unsigned nBins = ts.size() / 2;
+        KTTimeSeriesFFTWF* newTS = new KTTimeSeriesFFTWF(nBins, ts.GetRangeMin(), ts.GetRangeMax());
+        for (unsigned bin = 0; bin < nBins; ++bin)
+        {
+            (*newTS)(bin)[0] = Convert(ts(2 * bin));
+            (*newTS)(bin)[1] = Convert(ts(2 * bin + 1));
+        }
+        return newTS;
+    }
+
+    template< typename XInterfaceType >
+    KTTimeSeries* KTSingleChannelDAC::DoConvertToRealF(const KTVarTypePhysicalArray< XInterfaceType >& ts)
+    {
+        KTDEBUG(egglog_scdac, "Converting raw-ts to single-precision ts-real");
+
+        if (fShouldRunInitialize)
+        {
+            if (! Initialize())
+            {
+                KTERROR(egglog_scdac, "Failed to initialize single-channel DAC");
+                return NULL;
+            }
+        }
+
+        unsigned nBins = ts.size();
+        KTTimeSeriesRealF* newTS = new KTTimeSeriesRealF(nBins, ts.GetRangeMin(), ts.GetRangeMax());
+        for (unsigned bin = 0; bin < nBins; ++bin)
+        {
+            (*newTS)(bin) = Convert((ts)(bin));
+        }
+        return newTS;
+    }
+#endif
+
+
+
+    template< typename XRawType >
+    KTTimeSeries* KTSingleChannelDAC::ConvertTypedToFFTW(KTRawTimeSeries* ts)
+    {
+        if (fShouldRunInitialize || ts->GetDataTypeSize() != sizeof(XRawType))
+        {
+            // the parameters have changed since this function was chosen, or the data don't match them
+            if (KTVTPATypeInfo< XRawType >::IsSigned()) return ConvertSignedToFFTW(ts);
+            return ConvertUnsignedToFFTW(ts);
+        }
+
+        KTDEBUG(egglog_scdac, "Converting raw-ts to ts-fftw (" << sizeof(XRawType) << "-byte " << (KTVTPATypeInfo< XRawType >::IsSigned() ? "signed" : "unsigned") << " data)");
+
+        // ts.size() is divided by 2 because we have complex samples, and the raw time series sees each sample as 2 bins
+        unsigned nBins = ts->size() / 2;
+        KTTimeSeriesFFTW* newTS = new KTTimeSeriesFFTW(nBins, ts->GetRangeMin(), ts->GetRangeMax());
+        // fftw_complex is two doubles, so the interleaved IQ samples map directly onto the output array
+        ConvertSamples(reinterpret_cast< const XRawType* >(ts->GetStorage()), reinterpret_cast< double* >(newTS->GetData()), 2 * nBins);
+        return newTS;
+    }
+
+    template< typename XRawType >
+    KTTimeSeries* KTSingleChannelDAC::ConvertTypedToReal(KTRawTimeSeries* ts)
+    {
+        if (fShouldRunInitialize || ts->GetDataTypeSize() != sizeof(XRawType))
+        {
+            // the parameters have changed since this function was chosen, or the data don't match them
+            if (KTVTPATypeInfo< XRawType >::IsSigned()) return ConvertSignedToReal(ts);
+            return ConvertUnsignedToReal(ts);
+        }
+
+        KTDEBUG(egglog_scdac, "Converting raw-ts to ts-real (" << sizeof(XRawType) << "-byte " << (KTVTPATypeInfo< XRawType >::IsSigned() ? "signed" : "unsigned") << " data)");
+
+        unsigned nBins = ts->size();
+        KTTimeSeriesReal* newTS = new KTTimeSeriesReal(nBins, ts->GetRangeMin(), ts->GetRangeMax());
+        ConvertSamples(reinterpret_cast< const XRawType* >(ts->GetStorage()), newTS->GetData(), nBins);
+        return newTS;
+    }
+
+#ifdef FFTWF_FOUND
+    template< typename XRawType >
+    KTTimeSeries* KTSingleChannelDAC::ConvertTypedToFFTWF(KTRawTimeSeries* ts)
+    {
+        if (fShouldRunInitialize || ts->GetDataTypeSize() != sizeof(XRawType))
+        {
+            // the parameters have changed since this function was chosen, or the data don't match them
+            if (KTVTPATypeInfo< XRawType >::IsSigned()) return ConvertSignedToFFTWF(ts);
+            return ConvertUnsignedToFFTWF(ts);
+        }
+
+        KTDEBUG(egglog_scdac, "Converting raw-ts to single-precision ts-fftw (" << sizeof(XRawType) << "-byte " << (KTVTPATypeInfo< XRawType >::IsSigned() ? "signed" : "unsigned") << " data)");
+
+        unsigned nBins = ts->size() / 2;
+        KTTimeSeriesFFTWF* newTS = new KTTimeSeriesFFTWF(nBins, ts->GetRangeMin(), ts->GetRangeMax());
+        // fftwf_complex is two floats, so the interleaved IQ samples map directly onto the output array
+        ConvertSamples(reinterpret_cast< const XRawType* >(ts->GetStorage()), reinterpret_cast< float* >(newTS->GetData()), 2 * nBins);
+        return newTS;
+    }
+
+    template< typename XRawType >
+    KTTimeSeries* KTSingleChannelDAC::ConvertTypedToRealF(KTRawTimeSeries* ts)
+    {
+        if (fShouldRunInitialize || ts->GetDataTypeSize() != sizeof(XRawType))
+        {
+            // the parameters have changed since this function was chosen, or the data don't match them
+            if (KTVTPATypeInfo< XRawType >::IsSigned()) return ConvertSignedToRealF(ts);
+            return ConvertUnsignedToRealF(ts);
+        }
+
+        KTDEBUG(egglog_scdac, "Converting raw-ts to single-precision ts-real (" << sizeof(XRawType) << "-byte " << (KTVTPATypeInfo< XRawType >::IsSigned() ? "signed" : "unsigned") << " data)");
+
+        unsigned nBins = ts->size();
+        KTTimeSeriesRealF* newTS = new KTTimeSeriesRealF(nBins, ts->GetRangeMin(), ts->GetRangeMax());
+        ConvertSamples(reinterpret_cast< const XRawType* >(ts->GetStorage()), newTS->GetData(), nBins);
+        return newTS;
+    }
+#endif
+
+    template< typename XRawType, typename XOutputType >
+    inline void KTSingleChannelDAC::ConvertSamples(const XRawType* in, XOutputType* out, unsigned nSamples) const
+    {
+        if (fLinearVoltages)
+        {
+            KTDACKernel< XRawType >::ConvertLinear(in, out, nSamples, fLinearGain, fLinearOffset);
+        }
+        else
+        {
+            // for signed data, level 0 is at fIntLevelOffset
+            KTDACKernel< XRawType >::ConvertLookup(in, out, nSamples, fVoltages.data() + fIntLevelOffset);
+        }
+        return;
+    }
+
     inline double KTSingleChannelDAC::Convert(uint64_t level)
     {
         return fVoltages[level];
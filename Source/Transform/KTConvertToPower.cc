@@ -17,8 +17,6 @@
 #include "KTPowerSpectrum.hh"
 #include "KTPowerSpectrumData.hh"
 
-using boost::shared_ptr;
-
 namespace Katydid
 {
     KTLOGGER(pslog, "katydid.fft");
@@ -32,6 +30,10 @@ namespace Katydid
             fFSPToPSDSlot("fs-polar-to-psd", this, &KTConvertToPower::ToPowerSpectralDensity, &fPowerSpectralDensitySignal),
             fFSFToPSSlot("fs-fftw-to-ps", this, &KTConvertToPower::ToPowerSpectrum, &fPowerSpectrumSignal),
             fFSFToPSDSlot("fs-fftw-to-psd", this, &KTConvertToPower::ToPowerSpectralDensity, &fPowerSpectralDensitySignal),
+#ifdef FFTWF_FOUND
+            fFSFFToPSSlot("fs-fftwf-to-ps", this, &KTConvertToPower::ToPowerSpectrum, &fPowerSpectrumSignal),
+            fFSFFToPSDSlot("fs-fftwf-to-psd", this, &KTConvertToPower::ToPowerSpectralDensity, &fPowerSpectralDensitySignal),
+#endif
             fAggFSFToPSSlot("aggfs-fftw-to-ps", this, &KTConvertToPower::ToPowerSpectrum, &fPowerSpectrumSignal),
             fAggFSFToPSDSlot("aggfs-fftw-to-psd", this, &KTConvertToPower::ToPowerSpectralDensity, &fPowerSpectralDensitySignal),
             fPSDToPSSlot("psd-to-ps", this, &KTConvertToPower::ToPowerSpectrum, &fPowerSpectrumSignal),
@@ -106,6 +108,34 @@ namespace Katydid
         return true;
     }
     
+#ifdef FFTWF_FOUND
+    bool KTConvertToPower::ToPowerSpectrum(KTFrequencySpectrumDataFFTWF& data)
+    {
+        unsigned nComponents = data.GetNComponents();
+        KTPowerSpectrumData& psData = data.Of< KTPowerSpectrumData >().SetNComponents(nComponents);
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTPowerSpectrum* spectrum = data.GetSpectrum(iComponent)->CreatePowerSpectrum();
+            spectrum->ConvertToPowerSpectrum();
+            psData.SetSpectrum(spectrum, iComponent);
+        }
+        return true;
+    }
+
+    bool KTConvertToPower::ToPowerSpectralDensity(KTFrequencySpectrumDataFFTWF& data)
+    {
+        unsigned nComponents = data.GetNComponents();
+        KTPowerSpectrumData& psData = data.Of< KTPowerSpectrumData >().SetNComponents(nComponents);
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTPowerSpectrum* spectrum = data.GetSpectrum(iComponent)->CreatePowerSpectrum();
+            spectrum->ConvertToPowerSpectralDensity();
+            psData.SetSpectrum(spectrum, iComponent);
+        }
+        return true;
+    }
+#endif
+
     bool KTConvertToPower::ToPowerSpectrum(KTAggregatedFrequencySpectrumDataFFTW& data)
     {
         unsigned nComponents = data.GetNComponents();
@@ -18,6 +18,7 @@ namespace Katydid
 {
     
     class KTFrequencySpectrumDataFFTW;
+    class KTFrequencySpectrumDataFFTWF;
     class KTFrequencySpectrumDataPolar;
     class KTPowerSpectrumData;
     class KTAggregatedFrequencySpectrumDataFFTW;
@@ -40,6 +41,8 @@ namespace Katydid
      - "fs-polar-to-psd": void (Nymph::KTDataPtr) -- Converts a polar FS to a PSD; Requires KTFrequencySpectrumDataPolar; Adds KTPowerSpectrumData; Emits signal "psd"
      - "fs-fftw-to-ps": void (Nymph::KTDataPtr) -- Converts an FFTW FS to a PS; Requires KTFrequencySpectrumDataFFTW; Adds KTPowerSpectrumData; Emits signal "ps"
      - "fs-fftw-to-psd": void (Nymph::KTDataPtr) -- Converts an FFTW FS to a PSD; Requires KTFrequencySpectrumDataFFTW; Adds KTPowerSpectrumData; Emits signal "psd"
+     - "fs-fftwf-to-ps": void (Nymph::KTDataPtr) -- Converts a single-precision FFTW FS to a PS; Requires KTFrequencySpectrumDataFFTWF; Adds KTPowerSpectrumData; Emits signal "ps"; Only available if Katydid was built with single-precision FFTW
+     - "fs-fftwf-to-psd": void (Nymph::KTDataPtr) -- Converts a single-precision FFTW FS to a PSD; Requires KTFrequencySpectrumDataFFTWF; Adds KTPowerSpectrumData; Emits signal "psd"; Only available if Katydid was built with single-precision FFTW
      - "aggfs-fftw-to-ps": void (Nymph::KTDataPtr) -- Converts an aggregated FFTW FS to a PS; Requires KTAggregatedFrequencySpectrumDataFFTW; Adds KTPowerSpectrumData; Emits signal "ps"
      - "aggfs-fftw-to-psd": void (Nymph::KTDataPtr) -- Converts an FFTW FS to a PSD; Requires KTAggregatedFrequencySpectrumDataFFTW; Adds KTPowerSpectrumData; Emits signal "psd"
      - "psd-to-ps": void (Nymph::KTDataPtr) -- Converts a PSD to a PS (in place); Requires KTPowerSpectrumData; Does not add additional data; Emits signal "ps"
@@ -67,6 +70,11 @@ namespace Katydid
 
             bool ToPowerSpectrum(KTFrequencySpectrumDataFFTW& data);
             bool ToPowerSpectralDensity(KTFrequencySpectrumDataFFTW& data);
+
+#ifdef FFTWF_FOUND
+            bool ToPowerSpectrum(KTFrequencySpectrumDataFFTWF& data);
+            bool ToPowerSpectralDensity(KTFrequencySpectrumDataFFTWF& data);
+#endif
         
             bool ToPowerSpectrum(KTAggregatedFrequencySpectrumDataFFTW& data);
             bool ToPowerSpectralDensity(KTAggregatedFrequencySpectrumDataFFTW& data);
@@ -93,6 +101,10 @@ namespace Katydid
             Nymph::KTSlotDataOneType< KTFrequencySpectrumDataPolar > fFSPToPSDSlot;
             Nymph::KTSlotDataOneType< KTFrequencySpectrumDataFFTW > fFSFToPSSlot;
             Nymph::KTSlotDataOneType< KTFrequencySpectrumDataFFTW > fFSFToPSDSlot;
+#ifdef FFTWF_FOUND
+            Nymph::KTSlotDataOneType< KTFrequencySpectrumDataFFTWF > fFSFFToPSSlot;
+            Nymph::KTSlotDataOneType< KTFrequencySpectrumDataFFTWF > fFSFFToPSDSlot;
+#endif
             Nymph::KTSlotDataOneType< KTAggregatedFrequencySpectrumDataFFTW > fAggFSFToPSSlot;
             Nymph::KTSlotDataOneType< KTAggregatedFrequencySpectrumDataFFTW > fAggFSFToPSDSlot;
             Nymph::KTSlotDataOneType< KTPowerSpectrumData > fPSDToPSSlot;
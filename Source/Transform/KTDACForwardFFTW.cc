@@ -0,0 +1,246 @@
+/*
+ * KTDACForwardFFTW.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTDACForwardFFTW.hh"
+
+#include "KTEggHeader.hh"
+#include "KTFrequencySpectrumDataFFTW.hh"
+#include "KTFrequencySpectrumFFTW.hh"
+#include "KTLogger.hh"
+#include "KTRawTimeSeriesData.hh"
+#include "KTSliceHeader.hh"
+#include "KTWindowFunction.hh"
+
+#include "factory.hh"
+
+using std::string;
+
+namespace Katydid
+{
+    KTLOGGER(dacfftlog, "KTDACForwardFFTW");
+
+    KT_REGISTER_PROCESSOR(KTDACForwardFFTW, "dac-forward-fftw");
+
+    KTDACForwardFFTW::KTDACForwardFFTW(const std::string& name) :
+            KTProcessor(name),
+            fDAC(),
+            fForwardFFT(),
+            fWindowFunction(NULL),
+            fWeights(),
+            fRInputArray(NULL),
+            fCInputArray(NULL),
+            fFFTSignal("fft", this),
+            fHeaderSlot("header", this, &KTDACForwardFFTW::InitializeWithHeader),
+            fRawTSSlot("raw-ts", this, &KTDACForwardFFTW::TransformRawData, &fFFTSignal)
+    {
+        SelectWindowFunction("rectangular");
+    }
+
+    KTDACForwardFFTW::~KTDACForwardFFTW()
+    {
+        FreeArrays();
+        delete fWindowFunction;
+    }
+
+    bool KTDACForwardFFTW::Configure(const scarab::param_node* node)
+    {
+        if (node == NULL) return true;
+
+        if (node->has("dac") && ! fDAC.Configure(node->node_at("dac")))
+        {
+            return false;
+        }
+
+        if (! SelectWindowFunction(node->get_value("window-function-type", "rectangular")))
+        {
+            return false;
+        }
+        if (node->has("window-function") && ! fWindowFunction->Configure(node->node_at("window-function")))
+        {
+            return false;
+        }
+
+        if (! fForwardFFT.Configure(node->node_at("forward-fftw")))
+        {
+            return false;
+        }
+        if (fForwardFFT.GetSinglePrecision())
+        {
+            KTERROR(dacfftlog, "The combined DAC and FFT is only available in double precision");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool KTDACForwardFFTW::SelectWindowFunction(const string& windowType)
+    {
+        KTWindowFunction* tempWF = scarab::factory< KTWindowFunction >::get_instance()->create(windowType);
+        if (tempWF == NULL)
+        {
+            KTERROR(dacfftlog, "Invalid window function type given: <" << windowType << ">.");
+            return false;
+        }
+        delete fWindowFunction;
+        fWindowFunction = tempWF;
+        return true;
+    }
+
+    bool KTDACForwardFFTW::InitializeWithHeader(KTEggHeader& header)
+    {
+        // the FFT input arrays and TransformArray() are double precision only
+        if (fForwardFFT.GetSinglePrecision())
+        {
+            KTERROR(dacfftlog, "The combined DAC and FFT is only available in double precision");
+            return false;
+        }
+
+        // the DAC may update the header (e.g. the bit depth), so it goes first
+        if (! fDAC.InitializeWithHeader(header))
+        {
+            KTERROR(dacfftlog, "Unable to initialize the DAC");
+            return false;
+        }
+        for (unsigned iChannel = 0; iChannel < fDAC.GetNChannels(); ++iChannel)
+        {
+            if (fDAC.GetChannelDAC(iChannel).GetBitDepthMode() == KTSingleChannelDAC::kIncreasing)
+            {
+                KTERROR(dacfftlog, "Increasing the bit depth is not supported by the combined DAC and FFT");
+                return false;
+            }
+        }
+
+        if (! fForwardFFT.InitializeWithHeader(header))
+        {
+            KTERROR(dacfftlog, "Unable to initialize the forward FFT");
+            return false;
+        }
+
+        unsigned timeSize = fForwardFFT.GetTimeSize();
+        fWindowFunction->SetBinWidth(1. / header.GetAcquisitionRate());
+        fWindowFunction->SetSize(timeSize);
+        fWindowFunction->RebuildWindowFunction();
+        fWeights.resize(timeSize);
+        for (unsigned iBin = 0; iBin < timeSize; ++iBin)
+        {
+            fWeights[iBin] = fWindowFunction->GetWeight(iBin);
+        }
+
+        if (! AllocateArrays())
+        {
+            KTERROR(dacfftlog, "Unable to allocate the FFT input arrays");
+            return false;
+        }
+
+        KTDEBUG(dacfftlog, "DAC, window function and FFT initialized with header; time size: " << timeSize);
+        return true;
+    }
+
+    bool KTDACForwardFFTW::TransformRawData(KTSliceHeader& header, KTRawTimeSeriesData& rawData)
+    {
+        if (! fForwardFFT.GetIsInitialized() || (fRInputArray == NULL && fCInputArray == NULL))
+        {
+            KTERROR(dacfftlog, "The DAC and FFT must be initialized (with the egg header) before data can be transformed");
+            return false;
+        }
+
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+        unsigned timeSize = fForwardFFT.GetTimeSize();
+        // the raw time series sees each complex sample as 2 bins
+        unsigned nRawBins = state == KTForwardFFTW::kC2C ? 2 * timeSize : timeSize;
+        double timeBinWidth = header.GetBinWidth();
+
+        unsigned nComponents = rawData.GetNComponents();
+
+        KTFrequencySpectrumDataFFTW& newData = rawData.Of< KTFrequencySpectrumDataFFTW >().SetNComponents(nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTRawTimeSeries* rawTS = rawData.GetTimeSeries(iComponent);
+            if (rawTS->size() != nRawBins)
+            {
+                KTERROR(dacfftlog, "Component <" << iComponent << "> has " << rawTS->size() << " bins; " << nRawBins << " were expected");
+                return false;
+            }
+
+            KTSingleChannelDAC& dac = fDAC.GetChannelDAC(iComponent);
+            KTFrequencySpectrumFFTW* nextResult = NULL;
+            if (state == KTForwardFFTW::kR2C)
+            {
+                if (! dac.ConvertToArray(rawTS, fRInputArray)) return false;
+                for (unsigned iBin = 0; iBin < timeSize; ++iBin)
+                {
+                    fRInputArray[iBin] *= fWeights[iBin];
+                }
+                nextResult = fForwardFFT.TransformArray(fRInputArray, timeBinWidth);
+            }
+            else if (state == KTForwardFFTW::kC2C)
+            {
+                // fftw_complex is two doubles, so the interleaved IQ samples map directly onto the input array
+                if (! dac.ConvertToArray(rawTS, reinterpret_cast< double* >(fCInputArray))) return false;
+                for (unsigned iBin = 0; iBin < timeSize; ++iBin)
+                {
+                    fCInputArray[iBin][0] *= fWeights[iBin];
+                    fCInputArray[iBin][1] *= fWeights[iBin];
+                }
+                nextResult = fForwardFFT.TransformArray(fCInputArray, timeBinWidth);
+            }
+            else // state == KTForwardFFTW::kRasC2C
+            {
+                if (! dac.ConvertToArray(rawTS, fRInputArray)) return false;
+                for (unsigned iBin = 0; iBin < timeSize; ++iBin)
+                {
+                    fCInputArray[iBin][0] = fRInputArray[iBin] * fWeights[iBin];
+                    fCInputArray[iBin][1] = 0.;
+                }
+                nextResult = fForwardFFT.TransformArray(fCInputArray, timeBinWidth);
+            }
+
+            KTDEBUG(dacfftlog, "FFT computed; size: " << nextResult->size() << "; range: " << nextResult->GetRangeMin() << " - " << nextResult->GetRangeMax());
+            newData.SetSpectrum(nextResult, iComponent);
+        }
+
+        KTINFO(dacfftlog, "DAC and FFT complete; " << nComponents << " channel(s) transformed");
+
+        return true;
+    }
+
+    bool KTDACForwardFFTW::AllocateArrays()
+    {
+        FreeArrays();
+
+        unsigned timeSize = fForwardFFT.GetTimeSize();
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+        if (state == KTForwardFFTW::kR2C || state == KTForwardFFTW::kRasC2C)
+        {
+            fRInputArray = (double*) fftw_malloc(sizeof(double) * timeSize);
+            if (fRInputArray == NULL) return false;
+        }
+        if (state == KTForwardFFTW::kC2C || state == KTForwardFFTW::kRasC2C)
+        {
+            fCInputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * timeSize);
+            if (fCInputArray == NULL) return false;
+        }
+        return true;
+    }
+
+    void KTDACForwardFFTW::FreeArrays()
+    {
+        if (fRInputArray != NULL)
+        {
+            fftw_free(fRInputArray);
+            fRInputArray = NULL;
+        }
+        if (fCInputArray != NULL)
+        {
+            fftw_free(fCInputArray);
+            fCInputArray = NULL;
+        }
+        return;
+    }
+
+} /* namespace Katydid */
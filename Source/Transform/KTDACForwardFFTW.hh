@@ -0,0 +1,129 @@
+/**
+ @file KTDACForwardFFTW.hh
+ @brief Contains KTDACForwardFFTW
+ @details Digitizer conversion, windowing, and forward FFT in a single step
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTDACFORWARDFFTW_HH_
+#define KTDACFORWARDFFTW_HH_
+
+#include "KTProcessor.hh"
+
+#include "KTDAC.hh"
+#include "KTForwardFFTW.hh"
+#include "KTSlot.hh"
+
+#include <fftw3.h>
+
+#include <string>
+#include <vector>
+
+
+namespace Katydid
+{
+
+    class KTEggHeader;
+    class KTRawTimeSeriesData;
+    class KTSliceHeader;
+    class KTWindowFunction;
+
+    /*!
+     @class KTDACForwardFFTW
+     @author agent
+
+     @brief Converts raw time series to voltages, applies a window function, and performs a forward FFT, without intermediate time series.
+
+     @details
+     This is equivalent to the chain dac:ts --> windower:ts-[real/fftw] --> forward-fftw:ts-[real/fftw], but the voltages are written
+     directly into the FFT input buffer and windowed there, so each slice is only read once before the transform and no
+     KTTimeSeriesData is created.
+
+     The transform state is determined as by KTForwardFFTW (from the egg header, unless "transform-state" is given in the "forward-fftw" node).
+     Increasing the bit depth in the DAC is not supported, since that changes the number of samples.
+     The FFT is always done in double precision; "precision": "float" in the "forward-fftw" node is rejected.
+
+     Configuration name: "dac-forward-fftw"
+
+     Available configuration values:
+     - "dac": nested config -- See KTDAC
+     - "window-function-type": string -- sets the type of window function to be used (default: rectangular)
+     - "window-function": nested config -- See the window function being used
+     - "forward-fftw": nested config -- See KTForwardFFTW
+
+     Slots:
+     - "header": void (Nymph::KTDataPtr) -- Initializes the DAC, window function and FFT from an Egg header; Requires KTEggHeader
+     - "raw-ts": void (Nymph::KTDataPtr) -- Converts, windows and transforms a slice; Requires KTSliceHeader and KTRawTimeSeriesData; Adds KTFrequencySpectrumDataFFTW; Emits signal "fft"
+
+     Signals:
+     - "fft": void (Nymph::KTDataPtr) -- Emitted upon performance of a forward transform; Guarantees KTFrequencySpectrumDataFFTW.
+    */
+
+    class KTDACForwardFFTW : public Nymph::KTProcessor
+    {
+        public:
+            KTDACForwardFFTW(const std::string& name = "dac-forward-fftw");
+            virtual ~KTDACForwardFFTW();
+
+            bool Configure(const scarab::param_node* node);
+
+            KTDAC* GetDAC();
+            KTForwardFFTW* GetForwardFFT();
+            KTWindowFunction* GetWindowFunction() const;
+
+            bool SelectWindowFunction(const std::string& windowType);
+
+        private:
+            KTDAC fDAC;
+            KTForwardFFTW fForwardFFT;
+            KTWindowFunction* fWindowFunction;
+
+        public:
+            bool InitializeWithHeader(KTEggHeader& header);
+
+            bool TransformRawData(KTSliceHeader& header, KTRawTimeSeriesData& rawData);
+
+        private:
+            bool AllocateArrays();
+            void FreeArrays();
+
+            std::vector< double > fWeights;
+
+            double*       fRInputArray;
+            fftw_complex* fCInputArray;
+
+            //***************
+            // Signals
+            //***************
+
+        private:
+            Nymph::KTSignalData fFFTSignal;
+
+            //***************
+            // Slots
+            //***************
+
+        private:
+            Nymph::KTSlotDataOneType< KTEggHeader > fHeaderSlot;
+            Nymph::KTSlotDataTwoTypes< KTSliceHeader, KTRawTimeSeriesData > fRawTSSlot;
+
+    };
+
+    inline KTDAC* KTDACForwardFFTW::GetDAC()
+    {
+        return &fDAC;
+    }
+
+    inline KTForwardFFTW* KTDACForwardFFTW::GetForwardFFT()
+    {
+        return &fForwardFFT;
+    }
+
+    inline KTWindowFunction* KTDACForwardFFTW::GetWindowFunction() const
+    {
+        return fWindowFunction;
+    }
+
+} /* namespace Katydid */
+#endif /* KTDACFORWARDFFTW_HH_ */
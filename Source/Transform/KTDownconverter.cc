@@ -0,0 +1,327 @@
+/*
+ * KTDownconverter.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTDownconverter.hh"
+
+#include "KTLogger.hh"
+#include "KTSliceHeader.hh"
+#include "KTTimeSeriesData.hh"
+#include "KTTimeSeriesFFTW.hh"
+#include "KTTimeSeriesReal.hh"
+#include "KTWindowFunction.hh"
+
+#include "factory.hh"
+
+#include <algorithm>
+#include <cmath>
+
+using std::string;
+
+namespace Katydid
+{
+    KTLOGGER(ddclog, "KTDownconverter");
+
+    KT_REGISTER_PROCESSOR(KTDownconverter, "downconverter");
+
+    KTDownconverter::KTDownconverter(const std::string& name) :
+            KTProcessor(name),
+            fMinFrequency(0.),
+            fMaxFrequency(0.),
+            fDecimation(0),
+            fOversampling(1.5),
+            fTapsPerPhase(32),
+            fWindowFunction(NULL),
+            fSampleRate(0.),
+            fSliceSize(0),
+            fInputOffset(0.),
+            fInputIsComplex(false),
+            fMixFrequency(0.),
+            fActiveDecimation(0),
+            fCoefficients(),
+            fHistories(),
+            fMixed(),
+            fNextTimeInRun(-1.),
+            fTSSignal("ts", this)
+    {
+        RegisterSlot("ts", this, &KTDownconverter::SlotFunctionTS);
+
+        SelectWindowFunction("blackman-harris");
+    }
+
+    KTDownconverter::~KTDownconverter()
+    {
+        delete fWindowFunction;
+    }
+
+    bool KTDownconverter::Configure(const scarab::param_node* node)
+    {
+        if (node == NULL) return false;
+
+        SetMinFrequency(node->get_value("min-frequency", fMinFrequency));
+        SetMaxFrequency(node->get_value("max-frequency", fMaxFrequency));
+        if (fMinFrequency >= fMaxFrequency)
+        {
+            KTERROR(ddclog, "A band has to be given, with min-frequency (" << fMinFrequency << ") < max-frequency (" << fMaxFrequency << ")");
+            return false;
+        }
+
+        SetDecimation(node->get_value< unsigned >("decimation", fDecimation));
+        SetOversampling(node->get_value("oversampling", fOversampling));
+        SetTapsPerPhase(node->get_value< unsigned >("taps-per-phase", fTapsPerPhase));
+        if (fOversampling <= 0. || fTapsPerPhase == 0)
+        {
+            KTERROR(ddclog, "The oversampling and the number of taps per phase must be positive");
+            return false;
+        }
+
+        if (! SelectWindowFunction(node->get_value("window-function-type", "blackman-harris")))
+        {
+            return false;
+        }
+        if (node->has("window-function") && ! fWindowFunction->Configure(node->node_at("window-function")))
+        {
+            return false;
+        }
+
+        // the filter is made again with the next slice
+        fSampleRate = 0.;
+        return true;
+    }
+
+    bool KTDownconverter::SelectWindowFunction(const string& windowType)
+    {
+        KTWindowFunction* tempWF = scarab::factory< KTWindowFunction >::get_instance()->create(windowType);
+        if (tempWF == NULL)
+        {
+            KTERROR(ddclog, "Invalid window function type given: <" << windowType << ">.");
+            return false;
+        }
+        delete fWindowFunction;
+        fWindowFunction = tempWF;
+        fSampleRate = 0.;
+        return true;
+    }
+
+    void KTDownconverter::Reset()
+    {
+        for (std::vector< std::vector< std::complex< double > > >::iterator histIt = fHistories.begin(); histIt != fHistories.end(); ++histIt)
+        {
+            std::fill(histIt->begin(), histIt->end(), std::complex< double >(0., 0.));
+        }
+        fNextTimeInRun = -1.;
+        return;
+    }
+
+    bool KTDownconverter::BuildFilter(double sampleRate, unsigned sliceSize, double inputOffset, bool isComplex)
+    {
+        if (sampleRate == fSampleRate && sliceSize == fSliceSize && inputOffset == fInputOffset && isComplex == fInputIsComplex)
+        {
+            return true;
+        }
+
+        // real time series only have the positive frequencies
+        double inputMin = isComplex ? inputOffset - 0.5 * sampleRate : inputOffset;
+        double inputMax = inputOffset + 0.5 * sampleRate;
+        if (fMinFrequency < inputMin || fMaxFrequency > inputMax)
+        {
+            KTERROR(ddclog, "The band (" << fMinFrequency << " - " << fMaxFrequency << " Hz) is not within the input bandwidth (" << inputMin << " - " << inputMax << " Hz)");
+            return false;
+        }
+
+        double bandwidth = fMaxFrequency - fMinFrequency;
+        unsigned decimation = fDecimation;
+        if (decimation == 0)
+        {
+            decimation = std::max(unsigned(sampleRate / (fOversampling * bandwidth)), 1u);
+            while (sliceSize % decimation != 0) --decimation;
+        }
+        else if (sliceSize % decimation != 0)
+        {
+            KTERROR(ddclog, "The decimation (" << decimation << ") has to divide the slice size (" << sliceSize << ")");
+            return false;
+        }
+        if (sampleRate / double(decimation) < bandwidth)
+        {
+            KTWARN(ddclog, "The output sample rate (" << sampleRate / double(decimation) << " Hz) is less than the bandwidth (" << bandwidth << " Hz); the edges of the band will alias");
+        }
+
+        // windowed sinc, with the cutoff at half of the output sample rate
+        unsigned nTaps = decimation * fTapsPerPhase;
+        fWindowFunction->SetBinWidth(1. / sampleRate);
+        fWindowFunction->SetSize(nTaps);
+        fWindowFunction->RebuildWindowFunction();
+
+        double cutoff = 0.5 / double(decimation); // in cycles per input sample
+        double center = 0.5 * double(nTaps - 1);
+        double sum = 0.;
+        fCoefficients.resize(nTaps);
+        for (unsigned iTap = 0; iTap < nTaps; ++iTap)
+        {
+            double x = 2. * M_PI * cutoff * (double(iTap) - center);
+            fCoefficients[iTap] = (x == 0. ? 1. : sin(x) / x) * fWindowFunction->GetWeight(iTap);
+            sum += fCoefficients[iTap];
+        }
+        // unit gain at DC; real inputs also get the factor of 2 that makes the analytic signal
+        double norm = (isComplex ? 1. : 2.) / sum;
+        for (unsigned iTap = 0; iTap < nTaps; ++iTap)
+        {
+            fCoefficients[iTap] *= norm;
+        }
+
+        fMixFrequency = 0.5 * (fMinFrequency + fMaxFrequency) - inputOffset;
+        fActiveDecimation = decimation;
+        fSampleRate = sampleRate;
+        fSliceSize = sliceSize;
+        fInputOffset = inputOffset;
+        fInputIsComplex = isComplex;
+
+        for (std::vector< std::vector< std::complex< double > > >::iterator histIt = fHistories.begin(); histIt != fHistories.end(); ++histIt)
+        {
+            histIt->assign(nTaps - 1, std::complex< double >(0., 0.));
+        }
+        fNextTimeInRun = -1.;
+
+        KTINFO(ddclog, "Downconverter filter made; mixing frequency: " << fMixFrequency << " Hz; decimation: " << decimation << "; taps: " << nTaps
+                << "; output sample rate: " << sampleRate / double(decimation) << " Hz");
+        return true;
+    }
+
+    Nymph::KTDataPtr KTDownconverter::Downconvert(const KTSliceHeader& header, const KTTimeSeriesData& tsData)
+    {
+        unsigned nComponents = tsData.GetNComponents();
+        unsigned sliceSize = tsData.GetTimeSeries(0)->GetNTimeBins();
+        bool isComplex = dynamic_cast< const KTTimeSeriesFFTW* >(tsData.GetTimeSeries(0)) != NULL;
+        double binWidth = header.GetBinWidth();
+        double sampleRate = 1. / binWidth;
+
+        if (! BuildFilter(sampleRate, sliceSize, header.GetFrequencyOffset(), isComplex))
+        {
+            return Nymph::KTDataPtr();
+        }
+        unsigned nHistory = fCoefficients.size() - 1;
+        if (fHistories.size() != nComponents)
+        {
+            fHistories.assign(nComponents, std::vector< std::complex< double > >(nHistory));
+            fNextTimeInRun = -1.;
+        }
+
+        // the filter continues from the previous slice only if the samples are contiguous
+        if (header.GetIsNewAcquisition() || fabs(header.GetTimeInRun() - fNextTimeInRun) > 0.5 * binWidth)
+        {
+            KTDEBUG(ddclog, "Starting a new stream at " << header.GetTimeInRun() << " s");
+            Reset();
+        }
+        fNextTimeInRun = header.GetTimeInRun() + double(sliceSize) * binWidth;
+
+        unsigned decimation = fActiveDecimation;
+        unsigned nOutput = sliceSize / decimation;
+        double outputBinWidth = binWidth * double(decimation);
+        // the filter delays the signal by half of its length
+        double delay = 0.5 * double(nHistory) * binWidth;
+
+        Nymph::KTDataPtr newData(new Nymph::KTData());
+
+        KTSliceHeader& newHeader = newData->Of< KTSliceHeader >();
+        newHeader.CopySliceHeaderOnly(header);
+        newHeader.SetSliceSize(nOutput);
+        newHeader.SetRawSliceSize(nOutput);
+        newHeader.SetSampleRate(1. / outputBinWidth);
+        newHeader.CalculateBinWidthAndSliceLength();
+        newHeader.SetFrequencyOffset(0.5 * (fMinFrequency + fMaxFrequency));
+        newHeader.SetTimeInRun(header.GetTimeInRun() - delay);
+        newHeader.SetTimeInAcq(header.GetTimeInAcq() - delay);
+
+        KTTimeSeriesData& newTSData = newData->Of< KTTimeSeriesData >().SetNComponents(nComponents);
+
+        // the local oscillator phase follows the time in the run, so it is continuous across slices
+        double cycles = fMixFrequency * header.GetTimeInRun();
+        std::complex< double > firstLO = std::polar(1., -2. * M_PI * (cycles - floor(cycles)));
+        std::complex< double > stepLO = std::polar(1., -2. * M_PI * fMixFrequency / sampleRate);
+
+        fMixed.resize(nHistory + sliceSize);
+        unsigned lastTap = nHistory;
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            std::vector< std::complex< double > >& history = fHistories[iComponent];
+            std::copy(history.begin(), history.end(), fMixed.begin());
+
+            std::complex< double > lo = firstLO;
+            if (isComplex)
+            {
+                const KTTimeSeriesFFTW* ts = dynamic_cast< const KTTimeSeriesFFTW* >(tsData.GetTimeSeries(iComponent));
+                if (ts == NULL || ts->size() != sliceSize)
+                {
+                    KTERROR(ddclog, "Component <" << iComponent << "> is not a complex time series of " << sliceSize << " bins");
+                    return Nymph::KTDataPtr();
+                }
+                for (unsigned iBin = 0; iBin < sliceSize; ++iBin)
+                {
+                    fMixed[nHistory + iBin] = std::complex< double >((*ts)(iBin)[0], (*ts)(iBin)[1]) * lo;
+                    lo *= stepLO;
+                }
+            }
+            else
+            {
+                const KTTimeSeriesReal* ts = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(iComponent));
+                if (ts == NULL || ts->size() != sliceSize)
+                {
+                    KTERROR(ddclog, "Component <" << iComponent << "> is not a real time series of " << sliceSize << " bins");
+                    return Nymph::KTDataPtr();
+                }
+                for (unsigned iBin = 0; iBin < sliceSize; ++iBin)
+                {
+                    fMixed[nHistory + iBin] = (*ts)(iBin) * lo;
+                    lo *= stepLO;
+                }
+            }
+            std::copy(fMixed.end() - nHistory, fMixed.end(), history.begin());
+
+            // only the samples that are kept are filtered
+            KTTimeSeriesFFTW* newTS = new KTTimeSeriesFFTW(nOutput, 0., double(nOutput) * outputBinWidth);
+            for (unsigned iOutput = 0; iOutput < nOutput; ++iOutput)
+            {
+                const std::complex< double >* input = &fMixed[iOutput * decimation];
+                std::complex< double > sum(0., 0.);
+                for (unsigned iTap = 0; iTap <= lastTap; ++iTap)
+                {
+                    sum += input[iTap] * fCoefficients[lastTap - iTap];
+                }
+                (*newTS)(iOutput)[0] = sum.real();
+                (*newTS)(iOutput)[1] = sum.imag();
+            }
+            newTSData.SetTimeSeries(newTS, iComponent);
+        }
+
+        KTDEBUG(ddclog, "Slice downconverted; " << nComponents << " component(s) of " << sliceSize << " --> " << nOutput << " samples");
+        return newData;
+    }
+
+    void KTDownconverter::SlotFunctionTS(Nymph::KTDataPtr data)
+    {
+        if (! data->Has< KTSliceHeader >())
+        {
+            KTERROR(ddclog, "Data not found with type < KTSliceHeader >!");
+            return;
+        }
+        if (! data->Has< KTTimeSeriesData >())
+        {
+            KTERROR(ddclog, "Data not found with type < KTTimeSeriesData >!");
+            return;
+        }
+
+        Nymph::KTDataPtr newData = Downconvert(data->Of< KTSliceHeader >(), data->Of< KTTimeSeriesData >());
+        if (! newData)
+        {
+            KTERROR(ddclog, "Something went wrong while downconverting the time series");
+            return;
+        }
+
+        fTSSignal(newData);
+        return;
+    }
+
+} /* namespace Katydid */
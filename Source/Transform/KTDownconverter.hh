@@ -0,0 +1,162 @@
+/**
+ @file KTDownconverter.hh
+ @brief Contains KTDownconverter
+ @details Digital downconversion of a time series to a frequency band: mixing, low-pass filtering and decimation
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTDOWNCONVERTER_HH_
+#define KTDOWNCONVERTER_HH_
+
+#include "KTProcessor.hh"
+
+#include "KTData.hh"
+#include "KTMemberVariable.hh"
+#include "KTSlot.hh"
+
+#include <complex>
+#include <string>
+#include <vector>
+
+
+namespace Katydid
+{
+
+    class KTSliceHeader;
+    class KTTimeSeriesData;
+    class KTWindowFunction;
+
+    /*!
+     @class KTDownconverter
+     @author agent
+
+     @brief Shifts a frequency band of a time series to DC, and decimates it to a sample rate that just covers the band.
+
+     @details
+     Each time series is mixed with a local oscillator at the center of the band ("min-frequency" to "max-frequency"), low-pass filtered,
+     and decimated.  The low-pass filter is a windowed-sinc FIR filter with "taps-per-phase" * decimation taps and a cutoff at half
+     of the output sample rate.  It is applied in polyphase form: only the samples that are kept are calculated, so the filter costs
+     "taps-per-phase" multiplications per input sample.  The output is a complex (KTTimeSeriesFFTW) time series with slice size / decimation
+     samples, which can then be transformed at a fraction of the cost of the full-rate slice.
+
+     Real input time series are scaled by 2, so that the output is the downconverted analytic signal (the amplitude of a tone is
+     not changed); complex (e.g. IQ) time series are not scaled.  The band must fit within the input bandwidth.
+
+     If "decimation" is not given, the largest factor that divides the slice size and keeps the output sample rate
+     at least "oversampling" times the bandwidth of the band is used.
+
+     The frequencies are absolute: the frequency offset of the input slice header (non-zero if the data was already downconverted)
+     is taken into account, and the output slice header's frequency offset is the center of the band.  To get spectra with the
+     correct frequency axis, transform the output with the forward FFT's "ts-downconverted" slot, configured with "transform-state": "c2c"
+     (and "transform-complex-as-iq" false).  Otherwise a forward FFT initialized from the Egg header of real data is in the r2c state,
+     and rejects the complex output.
+
+     The filter history is kept from one slice to the next, so contiguous slices (stride == slice size) are filtered as one stream.
+     At the start of each acquisition, and for slices that do not follow on from the previous one, the filter starts from zeros.
+
+     NOTE: This creates a completely new data object, with a new slice header; its slice size and raw slice size are both the decimated size.
+
+     Configuration name: "downconverter"
+
+     Available configuration values:
+     - "min-frequency": double -- lower edge of the band, in Hz (required)
+     - "max-frequency": double -- upper edge of the band, in Hz (required)
+     - "decimation": unsigned int -- decimation factor; 0 to choose it from the bandwidth (default: 0)
+     - "oversampling": double -- minimum ratio of the output sample rate to the bandwidth when the decimation is chosen automatically (default: 1.5)
+     - "taps-per-phase": unsigned int -- number of filter taps per polyphase branch (default: 32)
+     - "window-function-type": string -- window function used to make the low-pass filter (default: blackman-harris)
+     - "window-function": nested config -- See the window function being used
+
+     Slots:
+     - "ts": void (Nymph::KTDataPtr) -- Downconverts a real or complex time series; Requires KTSliceHeader and KTTimeSeriesData; Emits signal "ts" with a new data object
+
+     Signals:
+     - "ts": void (Nymph::KTDataPtr) -- Emitted for each downconverted slice; Guarantees KTSliceHeader and KTTimeSeriesData (KTTimeSeriesFFTW).
+    */
+
+    class KTDownconverter : public Nymph::KTProcessor
+    {
+        public:
+            KTDownconverter(const std::string& name = "downconverter");
+            virtual ~KTDownconverter();
+
+            bool Configure(const scarab::param_node* node);
+
+            MEMBERVARIABLE(double, MinFrequency);
+            MEMBERVARIABLE(double, MaxFrequency);
+            MEMBERVARIABLE(unsigned, Decimation);
+            MEMBERVARIABLE(double, Oversampling);
+            MEMBERVARIABLE(unsigned, TapsPerPhase);
+
+            KTWindowFunction* GetWindowFunction() const;
+
+            bool SelectWindowFunction(const std::string& windowType);
+
+        private:
+            KTWindowFunction* fWindowFunction;
+
+        public:
+            /// Creates a new data object with the downconverted time series
+            Nymph::KTDataPtr Downconvert(const KTSliceHeader& header, const KTTimeSeriesData& tsData);
+
+            /// Decimation factor used for the current filter (0 if the filter has not been made yet)
+            unsigned GetActiveDecimation() const;
+            const std::vector< double >& GetFilterCoefficients() const;
+
+            /// Empties the filter history; the next slice starts a new stream
+            void Reset();
+
+        private:
+            /// Makes the mixing frequency, decimation and filter, if the input sample rate, slice size or frequency offset has changed
+            bool BuildFilter(double sampleRate, unsigned sliceSize, double inputOffset, bool isComplex);
+
+            double fSampleRate;
+            unsigned fSliceSize;
+            double fInputOffset;
+            bool fInputIsComplex;
+
+            double fMixFrequency;
+            unsigned fActiveDecimation;
+            std::vector< double > fCoefficients;
+
+            /// Per-component history of the last (filter length - 1) mixed samples
+            std::vector< std::vector< std::complex< double > > > fHistories;
+            /// Filter history followed by the mixed samples of the current slice
+            std::vector< std::complex< double > > fMixed;
+            /// Time in the run at which the next slice has to start to continue the stream
+            double fNextTimeInRun;
+
+            //***************
+            // Signals
+            //***************
+
+        private:
+            Nymph::KTSignalData fTSSignal;
+
+            //***************
+            // Slots
+            //***************
+
+        private:
+            void SlotFunctionTS(Nymph::KTDataPtr data);
+
+    };
+
+    inline KTWindowFunction* KTDownconverter::GetWindowFunction() const
+    {
+        return fWindowFunction;
+    }
+
+    inline unsigned KTDownconverter::GetActiveDecimation() const
+    {
+        return fActiveDecimation;
+    }
+
+    inline const std::vector< double >& KTDownconverter::GetFilterCoefficients() const
+    {
+        return fCoefficients;
+    }
+
+} /* namespace Katydid */
+#endif /* KTDOWNCONVERTER_HH_ */
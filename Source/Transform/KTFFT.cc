@@ -10,6 +10,8 @@
 #include "KTLogger.hh"
 
 #ifdef FFTW_FOUND
+#include "KTFFTWPlanCache.hh"
+
 #include <fftw3.h>
 #endif
 
@@ -26,38 +28,29 @@ namespace Katydid
     }
 
     KTFFTW::KTFFTW() :
-            KTFFT()
+            KTFFT(),
+#ifdef FFTW_FOUND
+            fNThreads(KTFFTWPlanCache::GetDefaultNThreads())
+#else
+            fNThreads(1)
+#endif
     {
         sInstanceCount++;
     }
 
     KTFFTW::~KTFFTW()
     {
-#ifdef FFTW_NTHREADS
+#ifdef FFTW_FOUND
+        // plans that are still in use elsewhere must not outlive FFTW's cleanup, so the cache only cleans up if it has no plans
         if (sInstanceCount == 1)
         {
-            fftw_cleanup_threads();
+            KTFFTWPlanCache::get_instance()->CleanupThreads();
         }
 #endif
         sInstanceCount--;
     }
 
-    void KTFFTW::InitializeMultithreaded()
-    {
-#ifdef FFTW_NTHREADS
-        if (! sMultithreadedIsInitialized)
-        {
-            fftw_init_threads();
-            fftw_plan_with_nthreads(FFTW_NTHREADS);
-            KTDEBUG(fftlog, "Configuring FFTW to use up to " << FFTW_NTHREADS << " threads.");
-            sMultithreadedIsInitialized = true;
-        }
-#endif
-        return;
-    }
-
 
     unsigned KTFFTW::sInstanceCount = 0;
-    bool KTFFTW::sMultithreadedIsInitialized = false;
 
 } /* namespace Katydid */
@@ -63,12 +63,22 @@ namespace Katydid
             KTFFTW();
             virtual ~KTFFTW();
 
-            void InitializeMultithreaded();
+            /// Number of threads used by each of this FFT's plans
+            unsigned GetNThreads() const;
 
+        protected:
+            /// Validated number of threads; set by the derived classes' SetNThreads()
+            unsigned fNThreads;
+
+        public:
             static unsigned sInstanceCount;
-            static bool sMultithreadedIsInitialized;
     };
 
+    inline unsigned KTFFTW::GetNThreads() const
+    {
+        return fNThreads;
+    }
+
 
 
 } /* namespace Katydid */
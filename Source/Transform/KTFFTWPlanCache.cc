@@ -0,0 +1,316 @@
+/*
+ * KTFFTWPlanCache.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTFFTWPlanCache.hh"
+
+#include "KTLogger.hh"
+
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Katydid
+{
+    KTLOGGER(plancachelog, "KTFFTWPlanCache");
+
+    KTFFTWPlanCache::KTFFTWPlanCache() :
+            fPlans(),
+#ifdef FFTWF_FOUND
+            fPlansF(),
+#endif
+            fThreadsInitialized(false),
+            fMutex()
+    {
+    }
+
+    KTFFTWPlanCache::~KTFFTWPlanCache()
+    {
+        std::unique_lock< std::mutex > lock(fMutex);
+        // Plans that are still held at this point may outlive FFTW's own cleanup, so they're not destroyed here
+        unsigned nPlans = fPlans.size();
+#ifdef FFTWF_FOUND
+        nPlans += fPlansF.size();
+#endif
+        if (nPlans != 0)
+        {
+            KTDEBUG(plancachelog, nPlans << " FFTW plan(s) were not released");
+        }
+    }
+
+    fftw_plan KTFFTWPlanCache::AcquirePlan(Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany, unsigned nThreads)
+    {
+        return DoAcquirePlan< double >(fPlans, kind, direction, size, flags, howMany, nThreads);
+    }
+
+    void KTFFTWPlanCache::ReleasePlan(fftw_plan plan)
+    {
+        DoReleasePlan< double >(fPlans, plan);
+        return;
+    }
+
+#ifdef FFTWF_FOUND
+    fftwf_plan KTFFTWPlanCache::AcquirePlanF(Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany, unsigned nThreads)
+    {
+        return DoAcquirePlan< float >(fPlansF, kind, direction, size, flags, howMany, nThreads);
+    }
+
+    void KTFFTWPlanCache::ReleasePlanF(fftwf_plan plan)
+    {
+        DoReleasePlan< float >(fPlansF, plan);
+        return;
+    }
+#endif
+
+    template< typename XFloatType >
+    typename KTFFTWTraits< XFloatType >::plan_type KTFFTWPlanCache::DoAcquirePlan(std::map< PlanKey, PlanEntry< typename KTFFTWTraits< XFloatType >::plan_type > >& plans, Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany, unsigned nThreads)
+    {
+        typedef typename KTFFTWTraits< XFloatType >::plan_type plan_type;
+        typedef std::map< PlanKey, PlanEntry< plan_type > > map_type;
+
+        bool singlePrecision = sizeof(XFloatType) == sizeof(float);
+        const char* precisionLabel = singlePrecision ? "single-precision " : "";
+
+        if (kind != kC2C) direction = kind == kR2C ? FFTW_FORWARD : FFTW_BACKWARD;
+        nThreads = GetValidNThreads(nThreads);
+        PlanKey key(singlePrecision, kind, direction, size, howMany, flags, nThreads);
+
+        std::unique_lock< std::mutex > lock(fMutex);
+        typename map_type::iterator planIt = plans.find(key);
+        if (planIt != plans.end())
+        {
+            ++planIt->second.fNUsers;
+            KTDEBUG(plancachelog, "Reusing " << precisionLabel << "FFTW plan; kind: " << kind << "; size: " << size << "; # of transforms: " << howMany << "; # of users: " << planIt->second.fNUsers);
+            return planIt->second.fPlan;
+        }
+
+        SetPlanNThreads(nThreads);
+        plan_type plan = MakePlan< XFloatType >(kind, direction, size, flags, howMany);
+        if (plan == NULL)
+        {
+            KTERROR(plancachelog, "Unable to create " << precisionLabel << "FFTW plan; kind: " << kind << "; size: " << size << "; # of transforms: " << howMany);
+            return NULL;
+        }
+        PlanEntry< plan_type > entry = {plan, 1};
+        plans.insert(typename map_type::value_type(key, entry));
+        KTDEBUG(plancachelog, "Created " << precisionLabel << "FFTW plan; kind: " << kind << "; size: " << size << "; # of transforms: " << howMany << "; # of threads: " << nThreads);
+        return plan;
+    }
+
+    template< typename XFloatType >
+    void KTFFTWPlanCache::DoReleasePlan(std::map< PlanKey, PlanEntry< typename KTFFTWTraits< XFloatType >::plan_type > >& plans, typename KTFFTWTraits< XFloatType >::plan_type plan)
+    {
+        typedef std::map< PlanKey, PlanEntry< typename KTFFTWTraits< XFloatType >::plan_type > > map_type;
+
+        if (plan == NULL) return;
+
+        std::unique_lock< std::mutex > lock(fMutex);
+        for (typename map_type::iterator planIt = plans.begin(); planIt != plans.end(); ++planIt)
+        {
+            if (planIt->second.fPlan != plan) continue;
+            if (--planIt->second.fNUsers == 0)
+            {
+                KTFFTWTraits< XFloatType >::DestroyPlan(plan);
+                plans.erase(planIt);
+                KTDEBUG(plancachelog, "Destroyed FFTW plan");
+            }
+            return;
+        }
+        KTWARN(plancachelog, "Attempt to release an FFTW plan that did not come from the plan cache");
+        return;
+    }
+
+    bool KTFFTWPlanCache::ImportWisdom(const std::string& filename, bool singlePrecision)
+    {
+#ifndef FFTWF_FOUND
+        if (singlePrecision)
+        {
+            KTERROR(plancachelog, "Single-precision wisdom is not available; Katydid was built without single-precision FFTW");
+            return false;
+        }
+#endif
+        std::unique_lock< std::mutex > lock(fMutex);
+#ifdef FFTWF_FOUND
+        if (singlePrecision) return KTFFTWTraits< float >::ImportWisdomFromFilename(filename.c_str()) != 0;
+#endif
+        return KTFFTWTraits< double >::ImportWisdomFromFilename(filename.c_str()) != 0;
+    }
+
+    bool KTFFTWPlanCache::ExportWisdom(const std::string& filename, bool singlePrecision)
+    {
+#ifndef FFTWF_FOUND
+        if (singlePrecision)
+        {
+            KTERROR(plancachelog, "Single-precision wisdom is not available; Katydid was built without single-precision FFTW");
+            return false;
+        }
+#endif
+        if (GetWisdomIsLocked(filename))
+        {
+            KTDEBUG(plancachelog, "Wisdom file <" << filename << "> is locked; it will not be updated");
+            return true;
+        }
+
+        // Other jobs may be reading the file, so it's replaced in one step
+        std::string tempFilename(filename + ".tmp" + std::to_string(getpid()));
+        std::unique_lock< std::mutex > lock(fMutex);
+#ifdef FFTWF_FOUND
+        int result = singlePrecision ? KTFFTWTraits< float >::ExportWisdomToFilename(tempFilename.c_str()) : KTFFTWTraits< double >::ExportWisdomToFilename(tempFilename.c_str());
+#else
+        int result = KTFFTWTraits< double >::ExportWisdomToFilename(tempFilename.c_str());
+#endif
+        if (result == 0)
+        {
+            std::remove(tempFilename.c_str());
+            return false;
+        }
+        if (std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+        {
+            std::remove(tempFilename.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void KTFFTWPlanCache::ForgetWisdom(bool singlePrecision)
+    {
+        std::unique_lock< std::mutex > lock(fMutex);
+#ifdef FFTWF_FOUND
+        if (singlePrecision) KTFFTWTraits< float >::ForgetWisdom();
+        else KTFFTWTraits< double >::ForgetWisdom();
+#else
+        // there's no single-precision wisdom to forget
+        if (! singlePrecision) KTFFTWTraits< double >::ForgetWisdom();
+#endif
+        return;
+    }
+
+    std::string KTFFTWPlanCache::GetDefaultWisdomFilename()
+    {
+        const char* envFilename = std::getenv("KATYDID_FFTW_WISDOM");
+        if (envFilename != NULL && envFilename[0] != '\0') return std::string(envFilename);
+        // the FFT processors used to default to wisdom_complexfft.fftw3 each; the shared file has a new name
+        return std::string("katydid_wisdom.fftw3");
+    }
+
+    bool KTFFTWPlanCache::GetWisdomIsLocked(const std::string& filename)
+    {
+        // the permission bits are checked directly, since access() ignores them for root
+        struct stat fileStat;
+        if (stat(filename.c_str(), &fileStat) != 0) return false;
+        return (fileStat.st_mode & (S_IWUSR | S_IWGRP | S_IWOTH)) == 0;
+    }
+
+    unsigned KTFFTWPlanCache::GetNPlans() const
+    {
+        std::unique_lock< std::mutex > lock(fMutex);
+#ifdef FFTWF_FOUND
+        return fPlans.size() + fPlansF.size();
+#else
+        return fPlans.size();
+#endif
+    }
+
+    void KTFFTWPlanCache::CleanupThreads()
+    {
+#ifdef FFTW_NTHREADS
+        std::unique_lock< std::mutex > lock(fMutex);
+#ifdef FFTWF_FOUND
+        bool noPlans = fPlans.empty() && fPlansF.empty();
+#else
+        bool noPlans = fPlans.empty();
+#endif
+        if (fThreadsInitialized && noPlans)
+        {
+            KTFFTWTraits< double >::CleanupThreads();
+#ifdef FFTWF_FOUND
+            KTFFTWTraits< float >::CleanupThreads();
+#endif
+            fThreadsInitialized = false;
+            KTDEBUG(plancachelog, "FFTW threads cleaned up");
+        }
+#endif
+        return;
+    }
+
+    unsigned KTFFTWPlanCache::GetDefaultNThreads()
+    {
+#ifdef FFTW_NTHREADS
+        return GetValidNThreads(FFTW_NTHREADS);
+#else
+        return 1;
+#endif
+    }
+
+    unsigned KTFFTWPlanCache::GetValidNThreads(unsigned nThreads)
+    {
+#ifdef FFTW_NTHREADS
+        return nThreads == 0 ? 1 : nThreads;
+#else
+        return 1;
+#endif
+    }
+
+    void KTFFTWPlanCache::SetPlanNThreads(unsigned nThreads)
+    {
+#ifdef FFTW_NTHREADS
+        if (! fThreadsInitialized)
+        {
+            KTFFTWTraits< double >::InitThreads();
+#ifdef FFTWF_FOUND
+            KTFFTWTraits< float >::InitThreads();
+#endif
+            fThreadsInitialized = true;
+            KTDEBUG(plancachelog, "FFTW threads initialized");
+        }
+        KTFFTWTraits< double >::PlanWithNThreads(nThreads);
+#ifdef FFTWF_FOUND
+        KTFFTWTraits< float >::PlanWithNThreads(nThreads);
+#endif
+#endif
+        return;
+    }
+
+    template< typename XFloatType >
+    typename KTFFTWTraits< XFloatType >::plan_type KTFFTWPlanCache::MakePlan(Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany) const
+    {
+        typedef KTFFTWTraits< XFloatType > traits;
+        typedef typename traits::real_type real_type;
+        typedef typename traits::complex_type complex_type;
+
+        // Planning may overwrite the arrays, so they're only used here
+        int n = size;
+        unsigned halfSize = size / 2 + 1;
+        typename traits::plan_type plan = NULL;
+        if (kind == kR2C)
+        {
+            real_type* in = (real_type*) traits::Malloc(sizeof(real_type) * size * howMany);
+            complex_type* out = (complex_type*) traits::Malloc(sizeof(complex_type) * halfSize * howMany);
+            plan = traits::PlanManyDFTR2C(1, &n, howMany, in, NULL, 1, size, out, NULL, 1, halfSize, flags);
+            traits::Free(in);
+            traits::Free(out);
+        }
+        else if (kind == kC2R)
+        {
+            complex_type* in = (complex_type*) traits::Malloc(sizeof(complex_type) * halfSize * howMany);
+            real_type* out = (real_type*) traits::Malloc(sizeof(real_type) * size * howMany);
+            plan = traits::PlanManyDFTC2R(1, &n, howMany, in, NULL, 1, halfSize, out, NULL, 1, size, flags);
+            traits::Free(in);
+            traits::Free(out);
+        }
+        else // kind == kC2C
+        {
+            complex_type* in = (complex_type*) traits::Malloc(sizeof(complex_type) * size * howMany);
+            complex_type* out = (complex_type*) traits::Malloc(sizeof(complex_type) * size * howMany);
+            plan = traits::PlanManyDFT(1, &n, howMany, in, NULL, 1, size, out, NULL, 1, size, direction, flags);
+            traits::Free(in);
+            traits::Free(out);
+        }
+        return plan;
+    }
+
+} /* namespace Katydid */
@@ -0,0 +1,153 @@
+/**
+ @file KTFFTWPlanCache.hh
+ @brief Contains KTFFTWPlanCache
+ @details Process-wide registry of FFTW plans
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTFFTWPLANCACHE_HH_
+#define KTFFTWPLANCACHE_HH_
+
+#include "KTFFTWTraits.hh"
+
+#include "singleton.hh"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace Katydid
+{
+
+    /*!
+     @class KTFFTWPlanCache
+     @author agent
+
+     @brief Shares FFTW plans among all of the FFT users in a process.
+
+     @details
+     Processors that perform FFTs get their plans from this cache with AcquirePlan() (or AcquirePlanF() for single precision,
+     which is only available if Katydid was built with single-precision FFTW, i.e. FFTWF_FOUND is defined),
+     and give them back with ReleasePlan() (ReleasePlanF()) when they no longer need them.  Plans are keyed by precision,
+     kind (R2C, C2R or C2C), direction, size, number of transforms, and FFTW flags; each distinct plan is made only once,
+     and is destroyed when the last user releases it.  This means that a configuration with several FFT processors of the same
+     size (or several processing chains) only pays for MEASURE/PATIENT planning once.
+
+     Plans are made on arrays owned by the cache, so they must be executed with the new-array execute functions
+     (fftw_execute_dft(), fftw_execute_dft_r2c(), fftw_execute_dft_c2r(), etc.) on arrays allocated with fftw_malloc (or fftwf_malloc),
+     unless FFTW_UNALIGNED is included in the flags.  The alignment requirement is therefore part of the key through the flags.
+     Plans for more than one transform (howMany > 1) expect the transforms to be contiguous in memory, with unit stride;
+     a complex half-spectrum (R2C output or C2R input) has size/2 + 1 elements per transform.
+
+     A plan given out by the cache must not be destroyed by its user, since other users may share it.
+
+     Each plan is made for a given number of threads (set with fftw_plan_with_nthreads() just before planning), which is part of its key,
+     so different FFT users can use threaded or single-threaded plans as suits them.  Multithreaded plans are only available if
+     Katydid was built with the FFTW threads libraries (i.e. FFTW_NTHREADS is defined); otherwise all plans are single-threaded.
+     The FFTW threads are initialized when the first plan is made, and cleaned up by CleanupThreads().
+
+     FFTW's planner and wisdom functions are not thread-safe, so all planning and wisdom import/export should go through the cache,
+     which serializes them.  The execute functions can be used concurrently.
+
+     Wisdom files are written atomically (to a temporary file that then replaces the wisdom file), so jobs running at the same
+     time never read a partially-written file.  A wisdom file without write permission is "locked": it is read, but ExportWisdom()
+     leaves it unchanged.  The TuneFFTWWisdom executable writes locked wisdom files with the best plans for a given set of transforms.
+     The default wisdom file, used by the FFT processors unless "wisdom-filename" is given, is named by the environment variable
+     KATYDID_FFTW_WISDOM, or is katydid_wisdom.fftw3 (in the working directory) if that is not set.  This replaces the processors'
+     earlier default, wisdom_complexfft.fftw3; wisdom in a file of that name is not read unless "wisdom-filename" or KATYDID_FFTW_WISDOM names it.
+    */
+    class KTFFTWPlanCache : public scarab::singleton< KTFFTWPlanCache >
+    {
+        public:
+            enum Kind
+            {
+                kR2C,
+                kC2R,
+                kC2C
+            };
+
+        protected:
+            friend class scarab::singleton< KTFFTWPlanCache >;
+            friend class scarab::destroyer< KTFFTWPlanCache >;
+            KTFFTWPlanCache();
+            virtual ~KTFFTWPlanCache();
+
+        public:
+            /// Returns a plan for howMany transforms of the given size, using nThreads threads; direction is only used for C2C (FFTW_FORWARD or FFTW_BACKWARD). Returns NULL if FFTW can't make the plan.
+            fftw_plan AcquirePlan(Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany = 1, unsigned nThreads = 1);
+            /// Releases a plan acquired with AcquirePlan(); NULL is ignored
+            void ReleasePlan(fftw_plan plan);
+
+#ifdef FFTWF_FOUND
+            /// Single-precision version of AcquirePlan()
+            fftwf_plan AcquirePlanF(Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany = 1, unsigned nThreads = 1);
+            /// Releases a plan acquired with AcquirePlanF(); NULL is ignored
+            void ReleasePlanF(fftwf_plan plan);
+#endif
+
+            /// Thread-safe version of fftw(f)_import_wisdom_from_filename(); single precision fails if Katydid was built without single-precision FFTW
+            bool ImportWisdom(const std::string& filename, bool singlePrecision = false);
+            /// Thread-safe, atomic version of fftw(f)_export_wisdom_to_filename(); a locked file is left unchanged (and true is returned)
+            bool ExportWisdom(const std::string& filename, bool singlePrecision = false);
+            /// Thread-safe version of fftw(f)_forget_wisdom()
+            void ForgetWisdom(bool singlePrecision = false);
+
+            /// Wisdom file used when none is specified: $KATYDID_FFTW_WISDOM, or katydid_wisdom.fftw3
+            static std::string GetDefaultWisdomFilename();
+            /// Returns true if the file exists and has no write permission
+            static bool GetWisdomIsLocked(const std::string& filename);
+
+            /// Number of distinct plans currently held (both precisions)
+            unsigned GetNPlans() const;
+
+            /// Cleans up the FFTW threads, if they were initialized and no plans are held
+            void CleanupThreads();
+
+            /// Number of threads used for plans by default: the FFTW_NTHREADS build setting, or 1
+            static unsigned GetDefaultNThreads();
+            /// Number of threads that will actually be used for a plan that requests nThreads (at least 1; always 1 without the FFTW threads libraries)
+            static unsigned GetValidNThreads(unsigned nThreads);
+
+        private:
+            // precision (true for float), kind, direction, size, howMany, flags, number of threads
+            typedef std::tuple< bool, Kind, int, unsigned, unsigned, unsigned, unsigned > PlanKey;
+
+            template< typename XPlanType >
+            struct PlanEntry
+            {
+                XPlanType fPlan;
+                unsigned fNUsers;
+            };
+
+            typedef std::map< PlanKey, PlanEntry< fftw_plan > > PlanMap;
+#ifdef FFTWF_FOUND
+            typedef std::map< PlanKey, PlanEntry< fftwf_plan > > PlanMapF;
+#endif
+
+            /// Common implementation of AcquirePlan() and AcquirePlanF()
+            template< typename XFloatType >
+            typename KTFFTWTraits< XFloatType >::plan_type DoAcquirePlan(std::map< PlanKey, PlanEntry< typename KTFFTWTraits< XFloatType >::plan_type > >& plans, Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany, unsigned nThreads);
+            /// Common implementation of ReleasePlan() and ReleasePlanF()
+            template< typename XFloatType >
+            void DoReleasePlan(std::map< PlanKey, PlanEntry< typename KTFFTWTraits< XFloatType >::plan_type > >& plans, typename KTFFTWTraits< XFloatType >::plan_type plan);
+
+            template< typename XFloatType >
+            typename KTFFTWTraits< XFloatType >::plan_type MakePlan(Kind kind, int direction, unsigned size, unsigned flags, unsigned howMany) const;
+
+            /// Initializes the FFTW threads if necessary, and sets the number of threads for the next plan; must be called with the mutex locked
+            void SetPlanNThreads(unsigned nThreads);
+
+            PlanMap fPlans;
+#ifdef FFTWF_FOUND
+            PlanMapF fPlansF;
+#endif
+
+            bool fThreadsInitialized;
+
+            mutable std::mutex fMutex;
+    };
+
+} /* namespace Katydid */
+#endif /* KTFFTWPLANCACHE_HH_ */
@@ -0,0 +1,73 @@
+/*
+ * KTFFTWScratch.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTFFTWScratch.hh"
+
+#include <cstddef>
+
+namespace Katydid
+{
+    namespace
+    {
+        /// XFloatType selects the FFTW allocation functions (see KTFFTWTraits)
+        template< typename XArrayType, typename XFloatType >
+        class ScratchArray
+        {
+            public:
+                ScratchArray() :
+                    fArray(NULL),
+                    fSize(0)
+                {}
+                ~ScratchArray()
+                {
+                    if (fArray != NULL) KTFFTWTraits< XFloatType >::Free(fArray);
+                }
+
+                XArrayType* Get(unsigned size)
+                {
+                    if (size > fSize)
+                    {
+                        if (fArray != NULL) KTFFTWTraits< XFloatType >::Free(fArray);
+                        fArray = (XArrayType*) KTFFTWTraits< XFloatType >::Malloc(sizeof(XArrayType) * size);
+                        fSize = fArray == NULL ? 0 : size;
+                    }
+                    return fArray;
+                }
+
+            private:
+                XArrayType* fArray;
+                unsigned fSize;
+        };
+    }
+
+    double* KTFFTWScratch::GetReal(unsigned size)
+    {
+        static thread_local ScratchArray< double, double > sArray;
+        return sArray.Get(size);
+    }
+
+    fftw_complex* KTFFTWScratch::GetComplex(unsigned size)
+    {
+        static thread_local ScratchArray< fftw_complex, double > sArray;
+        return sArray.Get(size);
+    }
+
+#ifdef FFTWF_FOUND
+    float* KTFFTWScratch::GetRealF(unsigned size)
+    {
+        static thread_local ScratchArray< float, float > sArray;
+        return sArray.Get(size);
+    }
+
+    fftwf_complex* KTFFTWScratch::GetComplexF(unsigned size)
+    {
+        static thread_local ScratchArray< fftwf_complex, float > sArray;
+        return sArray.Get(size);
+    }
+#endif
+
+} /* namespace Katydid */
@@ -0,0 +1,48 @@
+/**
+ @file KTFFTWScratch.hh
+ @brief Contains KTFFTWScratch
+ @details Per-thread aligned scratch arrays for FFTW's new-array execute functions
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTFFTWSCRATCH_HH_
+#define KTFFTWSCRATCH_HH_
+
+#include "KTFFTWTraits.hh"
+
+namespace Katydid
+{
+
+    /*!
+     @class KTFFTWScratch
+     @author agent
+
+     @brief Provides scratch arrays, allocated with fftw_malloc, that belong to the calling thread.
+
+     @details
+     FFTW plans can be executed on arrays other than the ones they were made with (fftw_execute_dft, etc.),
+     and those calls may be made concurrently from different threads, as long as the arrays have the same alignment as the originals.
+     The FFT classes use these arrays, rather than member arrays, wherever data must be staged before or after a transform,
+     so that a single plan can be used by several threads at once.
+
+     Each thread has one array of each type; it is grown as needed and freed when the thread exits.
+     The contents are only valid until the next call for the same type from the same thread.
+    */
+    class KTFFTWScratch
+    {
+        public:
+            /// Returns an array of at least size doubles
+            static double* GetReal(unsigned size);
+            /// Returns an array of at least size fftw_complex values
+            static fftw_complex* GetComplex(unsigned size);
+#ifdef FFTWF_FOUND
+            /// Returns an array of at least size floats
+            static float* GetRealF(unsigned size);
+            /// Returns an array of at least size fftwf_complex values
+            static fftwf_complex* GetComplexF(unsigned size);
+#endif
+    };
+
+} /* namespace Katydid */
+#endif /* KTFFTWSCRATCH_HH_ */
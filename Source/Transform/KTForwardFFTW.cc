@@ -10,8 +10,12 @@
 #include "KTAnalyticAssociateData.hh"
 #include "KTCacheDirectory.hh"
 #include "KTEggHeader.hh"
+#include "KTFFTWPlanCache.hh"
+#include "KTFFTWScratch.hh"
 #include "KTFrequencySpectrumDataFFTW.hh"
 #include "KTLogger.hh"
+#include "KTPowerSpectrumData.hh"
+#include "KTSliceHeader.hh"
 #include "KTTimeSeriesData.hh"
 #include "KTTimeSeriesFFTW.hh"
 #include "KTTimeSeriesReal.hh"
@@ -33,32 +37,52 @@ namespace Katydid
             KTFFTW(),
             KTProcessor(name),
             fUseWisdom(true),
-            fWisdomFilename("wisdom_complexfft.fftw3"),
+            fWisdomFilename(KTFFTWPlanCache::GetDefaultWisdomFilename()),
             fComplexAsIQ(false),
             fTimeSize(0),
             fFrequencySize(0),
             fTransformFlag("ESTIMATE"),
+            fSinglePrecision(false),
+            fBatchComponents(false),
+            fFoldNegativeFrequencies(false),
             fTransformFlagMap(),
             fState(kNone),
             fIsInitialized(false),
-            fForwardPlan(),
-            fRInputArray(NULL),
-            fCInputArray(NULL),
-            fOutputArray(NULL),
+            fForwardPlan(NULL),
+            fBatchPlan(NULL),
+            fBatchSize(0),
+            fBatchRInputArray(NULL),
+            fBatchCInputArray(NULL),
+            fBatchOutputArray(NULL),
+#ifdef FFTWF_FOUND
+            fForwardPlanF(NULL),
+#endif
             fFFTSignal("fft", this),
+            fPSSignal("ps", this),
+            fPSDSignal("psd", this),
             fHeaderSlot("header", this, &KTForwardFFTW::InitializeWithHeader),
             fTSRealSlot("ts-real", this, &KTForwardFFTW::TransformRealData, &fFFTSignal),
             fTSComplexSlot("ts-fftw", this, &KTForwardFFTW::TransformComplexData, &fFFTSignal),
+            fTSDownconvertedSlot("ts-downconverted", this, &KTForwardFFTW::TransformDownconvertedData, &fFFTSignal),
             fAASlot("aa", this, &KTForwardFFTW::TransformComplexData, &fFFTSignal),
-            fTSRealAsComplexSlot("ts-real-as-complex", this, &KTForwardFFTW::TransformRealDataAsComplex, &fFFTSignal)
+            fTSRealAsComplexSlot("ts-real-as-complex", this, &KTForwardFFTW::TransformRealDataAsComplex, &fFFTSignal),
+            fTSRealToPSSlot("ts-real-to-ps", this, &KTForwardFFTW::TransformRealDataToPS, &fPSSignal),
+            fTSRealToPSDSlot("ts-real-to-psd", this, &KTForwardFFTW::TransformRealDataToPSD, &fPSDSignal),
+            fTSComplexToPSSlot("ts-fftw-to-ps", this, &KTForwardFFTW::TransformComplexDataToPS, &fPSSignal),
+            fTSComplexToPSDSlot("ts-fftw-to-psd", this, &KTForwardFFTW::TransformComplexDataToPSD, &fPSDSignal),
+            fTSRealAsComplexToPSSlot("ts-real-as-complex-to-ps", this, &KTForwardFFTW::TransformRealDataAsComplexToPS, &fPSSignal),
+            fTSRealAsComplexToPSDSlot("ts-real-as-complex-to-psd", this, &KTForwardFFTW::TransformRealDataAsComplexToPSD, &fPSDSignal)
     {
         SetupInternalMaps();
     }
 
     KTForwardFFTW::~KTForwardFFTW()
     {
-        FreeArrays();
-        if (fForwardPlan != NULL) fftw_destroy_plan(fForwardPlan);
+        ClearBatch();
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fForwardPlan);
+#ifdef FFTWF_FOUND
+        KTFFTWPlanCache::get_instance()->ReleasePlanF(fForwardPlanF);
+#endif
     }
 
     bool KTForwardFFTW::Configure(const scarab::param_node* node)
@@ -67,11 +91,39 @@ namespace Katydid
         if (node != NULL)
         {
             SetTransformFlag(node->get_value("transform-flag", fTransformFlag));
+            SetNThreads(node->get_value< unsigned >("n-threads", fNThreads));
 
             SetUseWisdom(node->get_value<bool>("use-wisdom", fUseWisdom));
             SetWisdomFilename(node->get_value("wisdom-filename", fWisdomFilename));
 
             SetComplexAsIQ(node->get_value("transform-complex-as-iq", fComplexAsIQ));
+            SetFoldNegativeFrequencies(node->get_value("fold-negative-frequencies", fFoldNegativeFrequencies));
+
+            if (node->has("precision"))
+            {
+                string precision(node->get_value("precision"));
+                if (precision == "double") SetSinglePrecision(false);
+#ifdef FFTWF_FOUND
+                else if (precision == "float") SetSinglePrecision(true);
+#else
+                else if (precision == "float")
+                {
+                    KTERROR(fftwlog, "Single precision is not available; Katydid was built without single-precision FFTW");
+                    return false;
+                }
+#endif
+                else
+                {
+                    KTERROR(fftwlog, "Invalid precision requested: <" << precision << ">; options are \"double\" and \"float\"");
+                    return false;
+                }
+            }
+
+            SetBatchComponents(node->get_value<bool>("batch-components", fBatchComponents));
+            if (fBatchComponents && fSinglePrecision)
+            {
+                KTWARN(fftwlog, "Batched transforms are only available in double precision; components will be transformed individually");
+            }
 
             if( node->has("transform-state") )
             {
@@ -143,63 +195,83 @@ namespace Katydid
         TransformFlagMap::const_iterator iter = fTransformFlagMap.find(fTransformFlag);
         unsigned transformFlag = iter->second;
 
-        // allocate the input and output arrays if they're not there already
-        if (! AllocateArrays(intendedState))
-        {
-            KTERROR(fftwlog, "Unable to allocate arrays");
-            return false;
-        }
+        // any batched plan was made for the previous size/state
+        ClearBatch();
+
+        KTFFTWPlanCache* planCache = KTFFTWPlanCache::get_instance();
 
+        string wisdomFilename(GetPrecisionWisdomFilename());
         if (fUseWisdom)
         {
-            KTDEBUG(fftwlog, "Reading wisdom from file <" << fWisdomFilename << ">");
-            if (fftw_import_wisdom_from_filename(fWisdomFilename.c_str()) == 0)
+            KTDEBUG(fftwlog, "Reading wisdom from file <" << wisdomFilename << ">");
+            if (! planCache->ImportWisdom(wisdomFilename, fSinglePrecision))
             {
-                KTWARN(fftwlog, "Unable to read FFTW wisdom from file <" << fWisdomFilename << ">");
+                KTWARN(fftwlog, "Unable to read FFTW wisdom from file <" << wisdomFilename << ">");
             }
         }
 
-        InitializeMultithreaded();
-
-        if (intendedState == kR2C)
+        // The new plan is acquired before the old one is released, so that an unchanged plan is not remade
+#ifdef FFTWF_FOUND
+        if (fSinglePrecision)
         {
-            KTDEBUG(fftwlog, "Creating R2C plan: " << fTimeSize << " time bins; forward FFT");
-            // No FFTW_PRESERVE_INPUT, since the input array contents are replaced for each FFT
-            fForwardPlan = fftw_plan_dft_r2c_1d(fTimeSize, fRInputArray, fOutputArray, transformFlag);
-            // deleting arrays to save space
-            // input array is required; output array is not needed
-            KTDEBUG(fftwlog, "Freeing output array");
-            fftw_free(fOutputArray);
-            fOutputArray = NULL;
-        }
-        else if (intendedState == kC2C)
-        {
-            KTDEBUG(fftwlog, "Creating C2C plan: " << fTimeSize << " time bins; forward FFT");
-            // Add FFTW_PRESERVE_INPUT so that the input array content is not destroyed during the FFT
-            fForwardPlan = fftw_plan_dft_1d(fTimeSize, fCInputArray, fOutputArray, FFTW_FORWARD, transformFlag | FFTW_PRESERVE_INPUT);
-            // deleting arrays to save space
-            FreeArrays();
+            fftwf_plan newPlan = NULL;
+            if (intendedState == kR2C)
+            {
+                KTDEBUG(fftwlog, "Getting single-precision R2C plan: " << fTimeSize << " time bins; forward FFT");
+                newPlan = planCache->AcquirePlanF(KTFFTWPlanCache::kR2C, FFTW_FORWARD, fTimeSize, transformFlag, 1, fNThreads);
+            }
+            else if (intendedState == kC2C)
+            {
+                KTDEBUG(fftwlog, "Getting single-precision C2C plan: " << fTimeSize << " time bins; forward FFT");
+                newPlan = planCache->AcquirePlanF(KTFFTWPlanCache::kC2C, FFTW_FORWARD, fTimeSize, transformFlag | FFTW_PRESERVE_INPUT, 1, fNThreads);
+            }
+            else // intendedState == kRasC2C
+            {
+                KTDEBUG(fftwlog, "Getting single-precision RasC2C plan: " << fTimeSize << " time bins; forward FFT");
+                newPlan = planCache->AcquirePlanF(KTFFTWPlanCache::kC2C, FFTW_FORWARD, fTimeSize, transformFlag, 1, fNThreads);
+            }
+            planCache->ReleasePlanF(fForwardPlanF);
+            fForwardPlanF = newPlan;
         }
-        else // intendedState == kRasC2C
+        else
+#endif
         {
-            KTDEBUG(fftwlog, "Creating RasC2C plan: " << fTimeSize << " time bins; forward FFT");
-            // No FFTW_PRESERVE_INPUT, since the input array contents are replaced for each FFT
-            fForwardPlan = fftw_plan_dft_1d(fTimeSize, fCInputArray, fOutputArray, FFTW_FORWARD, transformFlag);
-            // deleting arrays to save space
-            // input array not required for C2C, but is for kRasC2C; output array not needed in either case
-            KTDEBUG(fftwlog, "Freeing output array");
-            fftw_free(fOutputArray);
-            fOutputArray = NULL;
+            fftw_plan newPlan = NULL;
+            if (intendedState == kR2C)
+            {
+                KTDEBUG(fftwlog, "Getting R2C plan: " << fTimeSize << " time bins; forward FFT");
+                // No FFTW_PRESERVE_INPUT, since the input is staged in a scratch array for each FFT
+                newPlan = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, fTimeSize, transformFlag, 1, fNThreads);
+            }
+            else if (intendedState == kC2C)
+            {
+                KTDEBUG(fftwlog, "Getting C2C plan: " << fTimeSize << " time bins; forward FFT");
+                // Add FFTW_PRESERVE_INPUT so that the input array content is not destroyed during the FFT
+                newPlan = planCache->AcquirePlan(KTFFTWPlanCache::kC2C, FFTW_FORWARD, fTimeSize, transformFlag | FFTW_PRESERVE_INPUT, 1, fNThreads);
+            }
+            else // intendedState == kRasC2C
+            {
+                KTDEBUG(fftwlog, "Getting RasC2C plan: " << fTimeSize << " time bins; forward FFT");
+                // No FFTW_PRESERVE_INPUT, since the input is staged in a scratch array for each FFT
+                newPlan = planCache->AcquirePlan(KTFFTWPlanCache::kC2C, FFTW_FORWARD, fTimeSize, transformFlag, 1, fNThreads);
+            }
+            planCache->ReleasePlan(fForwardPlan);
+            fForwardPlan = newPlan;
         }
 
-        if (fForwardPlan != NULL)
+#ifdef FFTWF_FOUND
+        bool havePlan = fSinglePrecision ? fForwardPlanF != NULL : fForwardPlan != NULL;
+#else
+        bool havePlan = fForwardPlan != NULL;
+#endif
+        if (havePlan)
         {
             fIsInitialized = true;
             if (fUseWisdom)
             {
-                if (fftw_export_wisdom_to_filename(fWisdomFilename.c_str()) == 0)
+                if (! planCache->ExportWisdom(wisdomFilename, fSinglePrecision))
                 {
-                    KTWARN(fftwlog, "Unable to write FFTW wisdom to file <" << fWisdomFilename << ">");
+                    KTWARN(fftwlog, "Unable to write FFTW wisdom to file <" << wisdomFilename << ">");
                 }
             }
             KTDEBUG(fftwlog, "FFTW plan created; Initialization complete.");
@@ -260,10 +332,31 @@ namespace Katydid
         double timeBinWidth = tsData.GetTimeSeries(0)->GetTimeBinWidth();
         UpdateBinningCache(timeBinWidth);
 
+#ifdef FFTWF_FOUND
+        if (fSinglePrecision) return TransformRealDataF(tsData);
+#endif
+
         unsigned nComponents = tsData.GetNComponents();
 
         KTFrequencySpectrumDataFFTW& newData = tsData.Of< KTFrequencySpectrumDataFFTW >().SetNComponents(nComponents);
 
+        if (fBatchComponents && nComponents > 1)
+        {
+            vector< const KTTimeSeriesReal* > inputs(nComponents);
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                inputs[iComponent] = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(iComponent));
+            }
+            vector< KTFrequencySpectrumFFTW* > results;
+            if (! BatchTransform(inputs, results)) return false;
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                newData.SetSpectrum(results[iComponent], iComponent);
+            }
+            KTINFO(fftwlog, "FFT complete; " << nComponents << " channel(s) transformed in one batch");
+            return true;
+        }
+
         for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
         {
             const KTTimeSeriesReal* nextInput = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(iComponent));
@@ -312,10 +405,31 @@ namespace Katydid
 
         UpdateBinningCache(tsData.GetTimeSeries(0)->GetTimeBinWidth());
 
+#ifdef FFTWF_FOUND
+        if (fSinglePrecision) return TransformRealDataAsComplexF(tsData);
+#endif
+
         unsigned nComponents = tsData.GetNComponents();
 
         KTFrequencySpectrumDataFFTW& newData = tsData.Of< KTFrequencySpectrumDataFFTW >().SetNComponents(nComponents);
 
+        if (fBatchComponents && nComponents > 1)
+        {
+            vector< const KTTimeSeriesReal* > inputs(nComponents);
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                inputs[iComponent] = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(iComponent));
+            }
+            vector< KTFrequencySpectrumFFTW* > results;
+            if (! BatchTransformAsComplex(inputs, results)) return false;
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                newData.SetSpectrum(results[iComponent], iComponent);
+            }
+            KTINFO(fftwlog, "FFT complete; " << nComponents << " channel(s) transformed in one batch");
+            return true;
+        }
+
         for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
         {
             const KTTimeSeriesReal* nextInput = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(iComponent));
@@ -364,10 +478,31 @@ namespace Katydid
 
         UpdateBinningCache(tsData.GetTimeSeries(0)->GetTimeBinWidth());
 
+#ifdef FFTWF_FOUND
+        if (fSinglePrecision) return TransformComplexDataF(tsData);
+#endif
+
         unsigned nComponents = tsData.GetNComponents();
 
         KTFrequencySpectrumDataFFTW& newData = tsData.Of< KTFrequencySpectrumDataFFTW >().SetNComponents(nComponents);
 
+        if (fBatchComponents && nComponents > 1)
+        {
+            vector< const KTTimeSeriesFFTW* > inputs(nComponents);
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                inputs[iComponent] = dynamic_cast< const KTTimeSeriesFFTW* >(tsData.GetTimeSeries(iComponent));
+            }
+            vector< KTFrequencySpectrumFFTW* > results;
+            if (! BatchTransform(inputs, results)) return false;
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                newData.SetSpectrum(results[iComponent], iComponent);
+            }
+            KTINFO(fftwlog, "FFT complete; " << nComponents << " channel(s) transformed in one batch");
+            return true;
+        }
+
         for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
         {
             const KTTimeSeriesFFTW* nextInput = dynamic_cast< const KTTimeSeriesFFTW* >(tsData.GetTimeSeries(iComponent));
@@ -393,8 +528,36 @@ namespace Katydid
         return true;
     }
 
+    bool KTForwardFFTW::TransformDownconvertedData(KTSliceHeader& header, KTTimeSeriesData& tsData)
+    {
+        if (! TransformComplexData(tsData)) return false;
+
+        // the spectra are calculated around DC; shift the axes back to the frequencies of the band
+        double offset = header.GetFrequencyOffset();
+        unsigned nComponents = tsData.GetNComponents();
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTAxisProperties< 1 >* axis = NULL;
+#ifdef FFTWF_FOUND
+            if (fSinglePrecision) axis = tsData.Of< KTFrequencySpectrumDataFFTWF >().GetSpectrumFFTW(iComponent);
+            else
+#endif
+            axis = tsData.Of< KTFrequencySpectrumDataFFTW >().GetSpectrumFFTW(iComponent);
+            axis->SetRange(axis->GetRangeMin() + offset, axis->GetRangeMax() + offset);
+        }
+        KTDEBUG(fftwlog, "Frequency axes offset by " << offset << " Hz");
+
+        return true;
+    }
+
     bool KTForwardFFTW::TransformComplexData(KTAnalyticAssociateData& tsData)
     {
+        if (fSinglePrecision)
+        {
+            KTERROR(fftwlog, "Analytic associate data can only be transformed in double precision");
+            return false;
+        }
+
         if (fState != kC2C)
         {
             KTERROR(fftwlog, "Cannot do transform of complex data in state <" << fState << ">");
@@ -445,6 +608,83 @@ namespace Katydid
         return true;
     }
 
+#ifdef FFTWF_FOUND
+    bool KTForwardFFTW::TransformRealDataF(KTTimeSeriesData& tsData)
+    {
+        unsigned nComponents = tsData.GetNComponents();
+
+        KTFrequencySpectrumDataFFTWF& newData = tsData.Of< KTFrequencySpectrumDataFFTWF >().SetNComponents(nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            const KTTimeSeriesRealF* nextInput = dynamic_cast< const KTTimeSeriesRealF* >(tsData.GetTimeSeries(iComponent));
+            if (nextInput == NULL)
+            {
+                KTERROR(fftwlog, "Incorrect time series type: time series did not cast to KTTimeSeriesRealF.");
+                return false;
+            }
+
+            KTFrequencySpectrumFFTWF* nextResult = FastTransform(nextInput);
+            KTDEBUG(fftwlog, "Single-precision FFT computed; size: " << nextResult->size() << "; range: " << nextResult->GetRangeMin() << " -> " << nextResult->GetRangeMax());
+            newData.SetSpectrum(nextResult, iComponent);
+        }
+
+        KTINFO(fftwlog, "FFT complete; " << nComponents << " channel(s) transformed in single precision");
+
+        return true;
+    }
+
+    bool KTForwardFFTW::TransformRealDataAsComplexF(KTTimeSeriesData& tsData)
+    {
+        unsigned nComponents = tsData.GetNComponents();
+
+        KTFrequencySpectrumDataFFTWF& newData = tsData.Of< KTFrequencySpectrumDataFFTWF >().SetNComponents(nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            const KTTimeSeriesRealF* nextInput = dynamic_cast< const KTTimeSeriesRealF* >(tsData.GetTimeSeries(iComponent));
+            if (nextInput == NULL)
+            {
+                KTERROR(fftwlog, "Incorrect time series type: time series did not cast to KTTimeSeriesRealF.");
+                return false;
+            }
+
+            KTFrequencySpectrumFFTWF* nextResult = FastTransformAsComplex(nextInput);
+            KTDEBUG(fftwlog, "Single-precision FFT computed; size: " << nextResult->size() << "; range: " << nextResult->GetRangeMin() << " - " << nextResult->GetRangeMax());
+            newData.SetSpectrum(nextResult, iComponent);
+        }
+
+        KTINFO(fftwlog, "FFT complete; " << nComponents << " channel(s) transformed in single precision");
+
+        return true;
+    }
+
+    bool KTForwardFFTW::TransformComplexDataF(KTTimeSeriesData& tsData)
+    {
+        unsigned nComponents = tsData.GetNComponents();
+
+        KTFrequencySpectrumDataFFTWF& newData = tsData.Of< KTFrequencySpectrumDataFFTWF >().SetNComponents(nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            const KTTimeSeriesFFTWF* nextInput = dynamic_cast< const KTTimeSeriesFFTWF* >(tsData.GetTimeSeries(iComponent));
+            if (nextInput == NULL)
+            {
+                KTERROR(fftwlog, "Incorrect time series type: time series did not cast to KTTimeSeriesFFTWF.");
+                return false;
+            }
+
+            KTFrequencySpectrumFFTWF* nextResult = FastTransform(nextInput);
+            KTDEBUG(fftwlog, "Single-precision FFT computed; size: " << nextResult->size() << "; range: " << nextResult->GetRangeMin() << " - " << nextResult->GetRangeMax());
+            newData.SetSpectrum(nextResult, iComponent);
+        }
+
+        KTINFO(fftwlog, "FFT complete; " << nComponents << " channel(s) transformed in single precision");
+
+        return true;
+    }
+#endif
+
     KTFrequencySpectrumFFTW* KTForwardFFTW::Transform(const KTTimeSeriesReal* ts) const
     {
         if (ts->size() != fTimeSize)
@@ -461,7 +701,9 @@ namespace Katydid
 
     KTFrequencySpectrumFFTW* KTForwardFFTW::FastTransform(const KTTimeSeriesReal* ts) const
     {
-        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, fFreqMinCache, fFreqMaxCache, false);
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, freqMin, freqMax, false);
 
         DoTransform(ts, newFS);
 
@@ -472,8 +714,9 @@ namespace Katydid
 
     void KTForwardFFTW::DoTransform(const KTTimeSeriesReal* tsIn, KTFrequencySpectrumFFTW* fsOut) const
     {
-        std::copy(tsIn->begin(), tsIn->end(), fRInputArray);
-        fftw_execute_dft_r2c(fForwardPlan, fRInputArray, fsOut->GetData());
+        double* input = KTFFTWScratch::GetReal(fTimeSize);
+        std::copy(tsIn->begin(), tsIn->end(), input);
+        fftw_execute_dft_r2c(fForwardPlan, input, fsOut->GetData());
         (*fsOut) *= sqrt(2. / (double)fTimeSize);
         return;
     }
@@ -494,7 +737,9 @@ namespace Katydid
 
     KTFrequencySpectrumFFTW* KTForwardFFTW::FastTransformAsComplex(const KTTimeSeriesReal* ts) const
     {
-        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, fFreqMinCache, fFreqMaxCache, true);
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, freqMin, freqMax, true);
 
         DoTransformAsComplex(ts, newFS);
 
@@ -505,12 +750,13 @@ namespace Katydid
 
     void KTForwardFFTW::DoTransformAsComplex(const KTTimeSeriesReal* tsIn, KTFrequencySpectrumFFTW* fsOut) const
     {
+        fftw_complex* input = KTFFTWScratch::GetComplex(fTimeSize);
         for (unsigned iBin = 0; iBin < fTimeSize; ++iBin)
         {
-            fCInputArray[iBin][0] = tsIn->GetData()[iBin];
-            fCInputArray[iBin][1] = 0;
+            input[iBin][0] = tsIn->GetData()[iBin];
+            input[iBin][1] = 0;
         }
-        fftw_execute_dft(fForwardPlan, fCInputArray, fsOut->GetData());
+        fftw_execute_dft(fForwardPlan, input, fsOut->GetData());
         (*fsOut) *= sqrt(1. / (double)fTimeSize);
         return;
     }
@@ -531,7 +777,9 @@ namespace Katydid
 
     KTFrequencySpectrumFFTW* KTForwardFFTW::FastTransform(const KTTimeSeriesFFTW* ts) const
     {
-        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, fFreqMinCache, fFreqMaxCache, true);
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, freqMin, freqMax, true);
 
         DoTransform(ts, newFS);
 
@@ -547,6 +795,526 @@ namespace Katydid
         return;
     }
 
+    KTFrequencySpectrumFFTW* KTForwardFFTW::TransformArray(double* arrayIn, double timeBinWidth) const
+    {
+        UpdateBinningCache(timeBinWidth);
+
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, freqMin, freqMax, false);
+        // the array must have the same alignment as the one used to make the plan, which fftw_malloc guarantees
+        fftw_execute_dft_r2c(fForwardPlan, arrayIn, newFS->GetData());
+        (*newFS) *= sqrt(2. / (double)fTimeSize);
+        newFS->SetNTimeBins(fTimeSize);
+        return newFS;
+    }
+
+    KTFrequencySpectrumFFTW* KTForwardFFTW::TransformArray(fftw_complex* arrayIn, double timeBinWidth) const
+    {
+        UpdateBinningCache(timeBinWidth);
+
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, freqMin, freqMax, true);
+        fftw_execute_dft(fForwardPlan, arrayIn, newFS->GetData());
+        (*newFS) *= sqrt(1. / (double)fTimeSize);
+        newFS->SetNTimeBins(fTimeSize);
+        return newFS;
+    }
+
+    void KTForwardFFTW::DoTransformArray(double* arrayIn, KTFrequencySpectrumFFTW* fsOut) const
+    {
+        fftw_execute_dft_r2c(fForwardPlan, arrayIn, fsOut->GetData());
+        (*fsOut) *= sqrt(2. / (double)fTimeSize);
+        fsOut->SetNTimeBins(fTimeSize);
+        return;
+    }
+
+    void KTForwardFFTW::DoTransformArray(fftw_complex* arrayIn, KTFrequencySpectrumFFTW* fsOut) const
+    {
+        fftw_execute_dft(fForwardPlan, arrayIn, fsOut->GetData());
+        (*fsOut) *= sqrt(1. / (double)fTimeSize);
+        fsOut->SetNTimeBins(fTimeSize);
+        return;
+    }
+
+    bool KTForwardFFTW::TransformRealDataToPS(KTTimeSeriesData& tsData)
+    {
+        return TransformToPower(tsData, kR2C, KTPowerSpectrum::kPower);
+    }
+
+    bool KTForwardFFTW::TransformRealDataToPSD(KTTimeSeriesData& tsData)
+    {
+        return TransformToPower(tsData, kR2C, KTPowerSpectrum::kPSD);
+    }
+
+    bool KTForwardFFTW::TransformRealDataAsComplexToPS(KTTimeSeriesData& tsData)
+    {
+        return TransformToPower(tsData, kRasC2C, KTPowerSpectrum::kPower);
+    }
+
+    bool KTForwardFFTW::TransformRealDataAsComplexToPSD(KTTimeSeriesData& tsData)
+    {
+        return TransformToPower(tsData, kRasC2C, KTPowerSpectrum::kPSD);
+    }
+
+    bool KTForwardFFTW::TransformComplexDataToPS(KTTimeSeriesData& tsData)
+    {
+        return TransformToPower(tsData, kC2C, KTPowerSpectrum::kPower);
+    }
+
+    bool KTForwardFFTW::TransformComplexDataToPSD(KTTimeSeriesData& tsData)
+    {
+        return TransformToPower(tsData, kC2C, KTPowerSpectrum::kPSD);
+    }
+
+    bool KTForwardFFTW::TransformToPower(KTTimeSeriesData& tsData, KTForwardFFTW::State intendedState, KTPowerSpectrum::Mode mode)
+    {
+        if (fState != intendedState)
+        {
+            KTERROR(fftwlog, "Cannot do a transform to power for state <" << intendedState << "> in state <" << fState << ">");
+            return false;
+        }
+        if (fSinglePrecision)
+        {
+            KTERROR(fftwlog, "Transforms straight to power are only available in double precision");
+            return false;
+        }
+
+        if (tsData.GetTimeSeries(0)->GetNTimeBins() != GetTimeSize())
+        {
+            InitializeFFT(intendedState, tsData.GetTimeSeries(0)->GetNTimeBins());
+        }
+
+        if (! fIsInitialized)
+        {
+            KTERROR(fftwlog, "FFT must be initialized before the transform is performed\n"
+                    << "\tPlease initialize the FFT first, then perform the transform.");
+            return false;
+        }
+
+        UpdateBinningCache(tsData.GetTimeSeries(0)->GetTimeBinWidth());
+
+        unsigned nComponents = tsData.GetNComponents();
+
+        KTPowerSpectrumData& newData = tsData.Of< KTPowerSpectrumData >().SetNComponents(nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTPowerSpectrum* nextResult = FastTransformToPower(tsData.GetTimeSeries(iComponent), mode);
+            if (nextResult == NULL)
+            {
+                KTERROR(fftwlog, "Channel <" << iComponent << "> did not transform correctly.");
+                return false;
+            }
+            KTDEBUG(fftwlog, "FFT to power computed; size: " << nextResult->size() << "; range: " << nextResult->GetRangeMin() << " - " << nextResult->GetRangeMax());
+            newData.SetSpectrum(nextResult, iComponent);
+        }
+
+        KTINFO(fftwlog, "FFT to " << (mode == KTPowerSpectrum::kPower ? "power spectrum" : "PSD") << " complete; " << nComponents << " channel(s) transformed");
+
+        return true;
+    }
+
+    KTPowerSpectrum* KTForwardFFTW::FastTransformToPower(const KTTimeSeries* ts, KTPowerSpectrum::Mode mode) const
+    {
+        // the spectrum only lives in the scratch array; for rasc2c the input is staged in the same array,
+        // at an offset that keeps the output as aligned as the input
+        unsigned outputOffset = fState == kRasC2C ? (fTimeSize + 3) & ~3u : 0;
+        fftw_complex* output = KTFFTWScratch::GetComplex(outputOffset + fFrequencySize) + outputOffset;
+        if (fState == kR2C)
+        {
+            const KTTimeSeriesReal* tsReal = dynamic_cast< const KTTimeSeriesReal* >(ts);
+            if (tsReal == NULL)
+            {
+                KTERROR(fftwlog, "Incorrect time series type: time series did not cast to KTTimeSeriesReal.");
+                return NULL;
+            }
+            double* input = KTFFTWScratch::GetReal(fTimeSize);
+            std::copy(tsReal->begin(), tsReal->end(), input);
+            fftw_execute_dft_r2c(fForwardPlan, input, output);
+        }
+        else if (fState == kRasC2C)
+        {
+            const KTTimeSeriesReal* tsReal = dynamic_cast< const KTTimeSeriesReal* >(ts);
+            if (tsReal == NULL)
+            {
+                KTERROR(fftwlog, "Incorrect time series type: time series did not cast to KTTimeSeriesReal.");
+                return NULL;
+            }
+            fftw_complex* input = output - outputOffset;
+            for (unsigned iBin = 0; iBin < fTimeSize; ++iBin)
+            {
+                input[iBin][0] = tsReal->GetData()[iBin];
+                input[iBin][1] = 0.;
+            }
+            fftw_execute_dft(fForwardPlan, input, output);
+        }
+        else // fState == kC2C
+        {
+            const KTTimeSeriesFFTW* tsComplex = dynamic_cast< const KTTimeSeriesFFTW* >(ts);
+            if (tsComplex == NULL)
+            {
+                KTERROR(fftwlog, "Incorrect time series type: time series did not cast to KTTimeSeriesFFTW.");
+                return NULL;
+            }
+            fftw_execute_dft(fForwardPlan, tsComplex->GetData(), output);
+        }
+
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        double freqBinWidth = (freqMax - freqMin) / double(fFrequencySize);
+
+        // same normalization as the forward transform followed by KTFrequencySpectrumFFTW::CreatePowerSpectrum()
+        double scaling = (fState == kR2C ? 2. : 1.) / (double(fTimeSize) * double(fTimeSize) * KTPowerSpectrum::GetResistance());
+        if (mode == KTPowerSpectrum::kPSD) scaling /= freqBinWidth;
+
+        KTPowerSpectrum* newPS = NULL;
+        if (fState == kR2C)
+        {
+            newPS = new KTPowerSpectrum(fFrequencySize, freqMin, freqMax);
+            double* ps = newPS->GetData();
+            for (unsigned iBin = 0; iBin < fFrequencySize; ++iBin)
+            {
+                ps[iBin] = (output[iBin][0] * output[iBin][0] + output[iBin][1] * output[iBin][1]) * scaling;
+            }
+        }
+        else
+        {
+            // FFTW order: DC and the positive frequencies, followed by the negative frequencies
+            unsigned nNegative = fFrequencySize / 2;
+            unsigned nPositive = fFrequencySize - nNegative;
+            if (fFoldNegativeFrequencies && ! (fState == kC2C && fComplexAsIQ))
+            {
+                newPS = new KTPowerSpectrum(nNegative + 1, -0.5 * freqBinWidth, (double(nNegative) + 0.5) * freqBinWidth);
+                double* ps = newPS->GetData();
+                std::fill(ps, ps + nNegative + 1, 0.);
+                for (unsigned iBin = 0; iBin < nPositive; ++iBin)
+                {
+                    ps[iBin] = (output[iBin][0] * output[iBin][0] + output[iBin][1] * output[iBin][1]) * scaling;
+                }
+                for (unsigned iBin = nPositive; iBin < fFrequencySize; ++iBin)
+                {
+                    ps[fFrequencySize - iBin] += (output[iBin][0] * output[iBin][0] + output[iBin][1] * output[iBin][1]) * scaling;
+                }
+            }
+            else
+            {
+                // same bins as the frequency spectrum, in increasing frequency
+                newPS = new KTPowerSpectrum(fFrequencySize, freqMin, freqMax);
+                double* ps = newPS->GetData();
+                for (unsigned iBin = 0; iBin < nPositive; ++iBin)
+                {
+                    ps[iBin + nNegative] = (output[iBin][0] * output[iBin][0] + output[iBin][1] * output[iBin][1]) * scaling;
+                }
+                for (unsigned iBin = nPositive; iBin < fFrequencySize; ++iBin)
+                {
+                    ps[iBin - nPositive] = (output[iBin][0] * output[iBin][0] + output[iBin][1] * output[iBin][1]) * scaling;
+                }
+            }
+        }
+
+        if (mode == KTPowerSpectrum::kPSD)
+        {
+            // the scaling already includes the bin width
+            newPS->OverrideMode(KTPowerSpectrum::kPSD);
+            newPS->SetDataLabel("Power Spectral Density (W/Hz)");
+        }
+        return newPS;
+    }
+
+    bool KTForwardFFTW::BatchTransform(const vector< const KTTimeSeriesReal* >& tsIn, vector< KTFrequencySpectrumFFTW* >& fsOut)
+    {
+        if (fState != kR2C)
+        {
+            KTERROR(fftwlog, "Cannot do batched transform of real data in state <" << fState << ">");
+            return false;
+        }
+        if (tsIn.empty()) return true;
+        if (! InitializeBatch(tsIn.size())) return false;
+
+        for (unsigned iTS = 0; iTS < tsIn.size(); ++iTS)
+        {
+            if (tsIn[iTS] == NULL || tsIn[iTS]->size() != fTimeSize)
+            {
+                KTERROR(fftwlog, "Time series <" << iTS << "> is missing, is not real, or does not have " << fTimeSize << " bins");
+                return false;
+            }
+            std::copy(tsIn[iTS]->begin(), tsIn[iTS]->end(), fBatchRInputArray + iTS * fTimeSize);
+        }
+
+        UpdateBinningCache(tsIn[0]->GetTimeBinWidth());
+        ExecuteBatch(tsIn.size(), false, sqrt(2. / (double)fTimeSize), fsOut);
+        return true;
+    }
+
+    bool KTForwardFFTW::BatchTransformAsComplex(const vector< const KTTimeSeriesReal* >& tsIn, vector< KTFrequencySpectrumFFTW* >& fsOut)
+    {
+        if (fState != kRasC2C)
+        {
+            KTERROR(fftwlog, "Cannot do batched transform of real-as-complex data in state <" << fState << ">");
+            return false;
+        }
+        if (tsIn.empty()) return true;
+        if (! InitializeBatch(tsIn.size())) return false;
+
+        for (unsigned iTS = 0; iTS < tsIn.size(); ++iTS)
+        {
+            if (tsIn[iTS] == NULL || tsIn[iTS]->size() != fTimeSize)
+            {
+                KTERROR(fftwlog, "Time series <" << iTS << "> is missing, is not real, or does not have " << fTimeSize << " bins");
+                return false;
+            }
+            fftw_complex* input = fBatchCInputArray + iTS * fTimeSize;
+            for (unsigned iBin = 0; iBin < fTimeSize; ++iBin)
+            {
+                input[iBin][0] = tsIn[iTS]->GetData()[iBin];
+                input[iBin][1] = 0.;
+            }
+        }
+
+        UpdateBinningCache(tsIn[0]->GetTimeBinWidth());
+        ExecuteBatch(tsIn.size(), true, sqrt(1. / (double)fTimeSize), fsOut);
+        return true;
+    }
+
+    bool KTForwardFFTW::BatchTransform(const vector< const KTTimeSeriesFFTW* >& tsIn, vector< KTFrequencySpectrumFFTW* >& fsOut)
+    {
+        if (fState != kC2C)
+        {
+            KTERROR(fftwlog, "Cannot do batched transform of complex data in state <" << fState << ">");
+            return false;
+        }
+        if (tsIn.empty()) return true;
+        if (! InitializeBatch(tsIn.size())) return false;
+
+        for (unsigned iTS = 0; iTS < tsIn.size(); ++iTS)
+        {
+            if (tsIn[iTS] == NULL || tsIn[iTS]->size() != fTimeSize)
+            {
+                KTERROR(fftwlog, "Time series <" << iTS << "> is missing, is not complex, or does not have " << fTimeSize << " bins");
+                return false;
+            }
+            std::copy(&(tsIn[iTS]->GetData()[0][0]), &(tsIn[iTS]->GetData()[0][0]) + 2 * fTimeSize, &(fBatchCInputArray[iTS * fTimeSize][0]));
+        }
+
+        UpdateBinningCache(tsIn[0]->GetTimeBinWidth());
+        ExecuteBatch(tsIn.size(), true, sqrt(1. / (double)fTimeSize), fsOut);
+        return true;
+    }
+
+    bool KTForwardFFTW::InitializeBatch(unsigned nTransforms)
+    {
+        if (fSinglePrecision)
+        {
+            KTERROR(fftwlog, "Batched transforms are only available in double precision");
+            return false;
+        }
+        if (! fIsInitialized)
+        {
+            KTERROR(fftwlog, "FFT must be initialized before a batched transform is performed");
+            return false;
+        }
+        if (fBatchPlan != NULL && fBatchSize == nTransforms) return true;
+
+        ClearBatch();
+
+        KTFFTWPlanCache* planCache = KTFFTWPlanCache::get_instance();
+        unsigned transformFlag = fTransformFlagMap.find(fTransformFlag)->second;
+
+        KTDEBUG(fftwlog, "Allocating batch output array for " << nTransforms << " transforms");
+        fBatchOutputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fFrequencySize * nTransforms);
+        if (fState == kR2C)
+        {
+            KTDEBUG(fftwlog, "Getting batched R2C plan: " << nTransforms << " x " << fTimeSize << " time bins; forward FFT");
+            fBatchRInputArray = (double*) fftw_malloc(sizeof(double) * fTimeSize * nTransforms);
+            fBatchPlan = planCache->AcquirePlan(KTFFTWPlanCache::kR2C, FFTW_FORWARD, fTimeSize, transformFlag, nTransforms, fNThreads);
+        }
+        else // fState == kC2C || fState == kRasC2C
+        {
+            KTDEBUG(fftwlog, "Getting batched C2C plan: " << nTransforms << " x " << fTimeSize << " time bins; forward FFT");
+            fBatchCInputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fTimeSize * nTransforms);
+            fBatchPlan = planCache->AcquirePlan(KTFFTWPlanCache::kC2C, FFTW_FORWARD, fTimeSize, transformFlag, nTransforms, fNThreads);
+        }
+
+        if (fBatchPlan == NULL)
+        {
+            KTERROR(fftwlog, "Unable to create the batched forward FFT plan");
+            ClearBatch();
+            return false;
+        }
+        fBatchSize = nTransforms;
+
+        if (fUseWisdom)
+        {
+            if (! planCache->ExportWisdom(fWisdomFilename))
+            {
+                KTWARN(fftwlog, "Unable to write FFTW wisdom to file <" << fWisdomFilename << ">");
+            }
+        }
+        return true;
+    }
+
+    void KTForwardFFTW::ExecuteBatch(unsigned nTransforms, bool arrayOrderIsFlipped, double norm, vector< KTFrequencySpectrumFFTW* >& fsOut)
+    {
+        if (fState == kR2C) fftw_execute_dft_r2c(fBatchPlan, fBatchRInputArray, fBatchOutputArray);
+        else fftw_execute_dft(fBatchPlan, fBatchCInputArray, fBatchOutputArray);
+
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+
+        // normalization is applied while copying out of the batch array
+        for (unsigned iTransform = 0; iTransform < nTransforms; ++iTransform)
+        {
+            KTFrequencySpectrumFFTW* newFS = new KTFrequencySpectrumFFTW(fFrequencySize, freqMin, freqMax, arrayOrderIsFlipped);
+            const fftw_complex* result = fBatchOutputArray + iTransform * fFrequencySize;
+            fftw_complex* output = newFS->GetData();
+            for (unsigned iBin = 0; iBin < fFrequencySize; ++iBin)
+            {
+                output[iBin][0] = result[iBin][0] * norm;
+                output[iBin][1] = result[iBin][1] * norm;
+            }
+            newFS->SetNTimeBins(fTimeSize);
+            fsOut.push_back(newFS);
+        }
+        return;
+    }
+
+    void KTForwardFFTW::ClearBatch()
+    {
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fBatchPlan);
+        fBatchPlan = NULL;
+        fBatchSize = 0;
+        if (fBatchRInputArray != NULL)
+        {
+            fftw_free(fBatchRInputArray);
+            fBatchRInputArray = NULL;
+        }
+        if (fBatchCInputArray != NULL)
+        {
+            fftw_free(fBatchCInputArray);
+            fBatchCInputArray = NULL;
+        }
+        if (fBatchOutputArray != NULL)
+        {
+            fftw_free(fBatchOutputArray);
+            fBatchOutputArray = NULL;
+        }
+        return;
+    }
+
+#ifdef FFTWF_FOUND
+    KTFrequencySpectrumFFTWF* KTForwardFFTW::Transform(const KTTimeSeriesRealF* ts) const
+    {
+        if (ts->size() != fTimeSize)
+        {
+            KTWARN(fftwlog, "Number of bins in the data provided does not match the number of bins set for this transform\n"
+                    << "   Bin expected: " << fTimeSize << ";   Bins in data: " << ts->size());
+            return NULL;
+        }
+
+        UpdateBinningCache(ts->GetTimeBinWidth());
+
+        return FastTransform(ts);
+    }
+
+    KTFrequencySpectrumFFTWF* KTForwardFFTW::FastTransform(const KTTimeSeriesRealF* ts) const
+    {
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTWF* newFS = new KTFrequencySpectrumFFTWF(fFrequencySize, freqMin, freqMax, false);
+
+        DoTransform(ts, newFS);
+
+        newFS->SetNTimeBins(fTimeSize);
+
+        return newFS;
+    }
+
+    void KTForwardFFTW::DoTransform(const KTTimeSeriesRealF* tsIn, KTFrequencySpectrumFFTWF* fsOut) const
+    {
+        float* input = KTFFTWScratch::GetRealF(fTimeSize);
+        std::copy(tsIn->begin(), tsIn->end(), input);
+        fftwf_execute_dft_r2c(fForwardPlanF, input, fsOut->GetData());
+        (*fsOut) *= sqrt(2. / (double)fTimeSize);
+        return;
+    }
+
+    KTFrequencySpectrumFFTWF* KTForwardFFTW::TransformAsComplex(const KTTimeSeriesRealF* ts) const
+    {
+        if (ts->size() != fTimeSize)
+        {
+            KTWARN(fftwlog, "Number of bins in the data provided does not match the number of bins set for this transform\n"
+                    << "   Bin expected: " << fTimeSize << ";   Bins in data: " << ts->size());
+            return NULL;
+        }
+
+        UpdateBinningCache(ts->GetTimeBinWidth());
+
+        return FastTransformAsComplex(ts);
+    }
+
+    KTFrequencySpectrumFFTWF* KTForwardFFTW::FastTransformAsComplex(const KTTimeSeriesRealF* ts) const
+    {
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTWF* newFS = new KTFrequencySpectrumFFTWF(fFrequencySize, freqMin, freqMax, true);
+
+        DoTransformAsComplex(ts, newFS);
+
+        newFS->SetNTimeBins(fTimeSize);
+
+        return newFS;
+    }
+
+    void KTForwardFFTW::DoTransformAsComplex(const KTTimeSeriesRealF* tsIn, KTFrequencySpectrumFFTWF* fsOut) const
+    {
+        fftwf_complex* input = KTFFTWScratch::GetComplexF(fTimeSize);
+        for (unsigned iBin = 0; iBin < fTimeSize; ++iBin)
+        {
+            input[iBin][0] = tsIn->GetData()[iBin];
+            input[iBin][1] = 0;
+        }
+        fftwf_execute_dft(fForwardPlanF, input, fsOut->GetData());
+        (*fsOut) *= sqrt(1. / (double)fTimeSize);
+        return;
+    }
+
+    KTFrequencySpectrumFFTWF* KTForwardFFTW::Transform(const KTTimeSeriesFFTWF* ts) const
+    {
+        if (ts->size() != fTimeSize)
+        {
+            KTWARN(fftwlog, "Number of bins in the data provided does not match the number of bins set for this transform\n"
+                    << "   Bin expected: " << fTimeSize << ";   Bins in data: " << ts->size());
+            return NULL;
+        }
+
+        UpdateBinningCache(ts->GetTimeBinWidth());
+
+        return FastTransform(ts);
+    }
+
+    KTFrequencySpectrumFFTWF* KTForwardFFTW::FastTransform(const KTTimeSeriesFFTWF* ts) const
+    {
+        double freqMin, freqMax;
+        GetBinningCache(freqMin, freqMax);
+        KTFrequencySpectrumFFTWF* newFS = new KTFrequencySpectrumFFTWF(fFrequencySize, freqMin, freqMax, true);
+
+        DoTransform(ts, newFS);
+
+        newFS->SetNTimeBins(fTimeSize);
+
+        return newFS;
+    }
+
+    void KTForwardFFTW::DoTransform(const KTTimeSeriesFFTWF* tsIn, KTFrequencySpectrumFFTWF* fsOut) const
+    {
+        fftwf_execute_dft(fForwardPlanF, tsIn->GetData(), fsOut->GetData());
+        (*fsOut) *= sqrt(1. / (double)fTimeSize);
+        return;
+    }
+#endif
+
     void KTForwardFFTW::SetTimeSize(unsigned nBins)
     {
         SetTimeSizeForState(nBins, fState);
@@ -571,7 +1339,7 @@ namespace Katydid
         KTDEBUG(fftwlog, "Time size set to " << fTimeSize << "; frequency size set to " << fFrequencySize);
 
         // clear things for good measure
-        FreeArrays();
+        ClearBatch();
 
         fIsInitialized = false;
         return;
@@ -585,80 +1353,70 @@ namespace Katydid
             return;
         }
 
-        // delete the plan
-        if (fForwardPlan != NULL) fftw_destroy_plan(fForwardPlan);
+        // release the plans
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fForwardPlan);
+        fForwardPlan = NULL;
+#ifdef FFTWF_FOUND
+        KTFFTWPlanCache::get_instance()->ReleasePlanF(fForwardPlanF);
+        fForwardPlanF = NULL;
+#endif
+        ClearBatch();
 
         fTransformFlag = flag;
         fIsInitialized = false;
         return;
     }
 
-    void KTForwardFFTW::SetupInternalMaps()
+    void KTForwardFFTW::SetNThreads(unsigned nThreads)
     {
-        // transform flag map
-        fTransformFlagMap.clear();
-        fTransformFlagMap["ESTIMATE"] = FFTW_ESTIMATE;
-        fTransformFlagMap["MEASURE"] = FFTW_MEASURE;
-        fTransformFlagMap["PATIENT"] = FFTW_PATIENT;
-        fTransformFlagMap["EXHAUSTIVE"] = FFTW_EXHAUSTIVE;
+        unsigned validNThreads = KTFFTWPlanCache::GetValidNThreads(nThreads);
+        if (validNThreads != nThreads)
+        {
+            KTWARN(fftwlog, nThreads << " threads were requested; FFTs will use " << validNThreads);
+        }
+        if (validNThreads == fNThreads) return;
+
+        // release the plans
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fForwardPlan);
+        fForwardPlan = NULL;
+#ifdef FFTWF_FOUND
+        KTFFTWPlanCache::get_instance()->ReleasePlanF(fForwardPlanF);
+        fForwardPlanF = NULL;
+#endif
+        ClearBatch();
+
+        fNThreads = validNThreads;
+        fIsInitialized = false;
+        KTDEBUG(fftwlog, "Number of threads set to " << fNThreads);
         return;
     }
 
-    bool KTForwardFFTW::AllocateArrays(State intendedState)
+    void KTForwardFFTW::SetSinglePrecision(bool flag)
     {
-        FreeArrays();
-        if (intendedState == kNone) intendedState = fState;
-        if (intendedState == kNone)
+        if (flag == fSinglePrecision) return;
+#ifndef FFTWF_FOUND
+        if (flag)
         {
-            KTERROR(fftwlog, "Cannot allocate arrays for state <" << intendedState << ">");
-            return false;
-        }
-
-        if (intendedState == kR2C)
-        {
-            if (fRInputArray == NULL)
-            {
-                KTDEBUG(fftwlog, "Allocating real input array");
-                fRInputArray = (double*) fftw_malloc(sizeof(double) * fTimeSize);
-            }
-        }
-        else //  intendedState == kC2C or kRasC2C
-        {
-            if (fCInputArray == NULL)
-            {
-                KTDEBUG(fftwlog, "Allocating complex input array");
-                fCInputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fTimeSize);
-            }
-        }
-        if (fOutputArray == NULL)
-        {
-            KTDEBUG(fftwlog, "Allocating output array");
-            fOutputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fFrequencySize);
+            KTERROR(fftwlog, "Single precision is not available; Katydid was built without single-precision FFTW");
+            return;
         }
+#endif
 
-        return true;
+        ClearBatch();
+        fSinglePrecision = flag;
+        fIsInitialized = false;
+        KTDEBUG(fftwlog, "Precision set to " << (fSinglePrecision ? "float" : "double"));
+        return;
     }
 
-    void KTForwardFFTW::FreeArrays()
+    void KTForwardFFTW::SetupInternalMaps()
     {
-        if (fRInputArray != NULL)
-        {
-            KTDEBUG(fftwlog, "Freeing real input array");
-            fftw_free(fRInputArray);
-            fRInputArray = NULL;
-        }
-        if (fCInputArray != NULL)
-        {
-            KTDEBUG(fftwlog, "Freeing complex input array");
-            fftw_free(fCInputArray);
-            fCInputArray = NULL;
-        }
-        if (fOutputArray != NULL)
-        {
-            KTDEBUG(fftwlog, "Freeing output array");
-            fftw_free(fOutputArray);
-            fOutputArray = NULL;
-        }
+        // transform flag map
+        fTransformFlagMap.clear();
+        fTransformFlagMap["ESTIMATE"] = FFTW_ESTIMATE;
+        fTransformFlagMap["MEASURE"] = FFTW_MEASURE;
+        fTransformFlagMap["PATIENT"] = FFTW_PATIENT;
+        fTransformFlagMap["EXHAUSTIVE"] = FFTW_EXHAUSTIVE;
         return;
     }
 
@@ -10,14 +10,15 @@
 #define KTFORWARDFFTW_HH_
 
 #include "KTFFT.hh"
+#include "KTFFTWTraits.hh"
 #include "KTProcessor.hh"
 
 #include "KTMemberVariable.hh"
+#include "KTPowerSpectrum.hh"
 #include "KTSlot.hh"
 
-#include <fftw3.h>
-
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -28,8 +29,17 @@ namespace Katydid
     class KTAnalyticAssociateData;
     class KTEggHeader;
     class KTFrequencySpectrumFFTW;
+#ifdef FFTWF_FOUND
+    class KTFrequencySpectrumFFTWF;
+#endif
+    class KTSliceHeader;
+    class KTTimeSeries;
     class KTTimeSeriesFFTW;
     class KTTimeSeriesReal;
+#ifdef FFTWF_FOUND
+    class KTTimeSeriesFFTWF;
+    class KTTimeSeriesRealF;
+#endif
 
     /*!
      @class KTForwardFFTW
@@ -57,15 +67,48 @@ namespace Katydid
      - Use the type recorded in the Egg header.  The choice will be based on whether the time-domain-data is real, complex (not IQ), or IQ.
      - Specify the "transform-state" in the processor configuration.  You can then also specify whether to "transform-complex-as-iq".
 
-     The FFT is implemented using FFTW.
+     The FFT is implemented using FFTW.  Plans are obtained from KTFFTWPlanCache, so FFT processors of the same size and settings share them.
+
+     Once the FFT is initialized, Transform(), FastTransform(), DoTransform() and TransformArray() (and the "AsComplex" variants)
+     are reentrant: any staging of the data is done in per-thread scratch arrays (see KTFFTWScratch), and the plan is executed with
+     FFTW's new-array execute functions, so one instance can be used to transform slices in several threads at once.
+     Concurrent callers should all use the same time bin width.  Initialization, changing the settings, the batched transforms,
+     and the slot functions (which may re-initialize the FFT) are not thread-safe.
+
+     Each FFT can also be split over several threads by FFTW with "n-threads".  This helps large transforms; for typical slice sizes
+     (a few thousand bins) single-threaded FFTs with the slices processed in parallel are usually faster.
+
+     The transform can be done in double (default) or single precision.  In single precision the input time series must be
+     KTTimeSeriesRealF or KTTimeSeriesFFTWF (e.g. from a DAC configured with "precision": "float"), the plans are made with fftwf,
+     and the output is a KTFrequencySpectrumFFTWF.  Wisdom for single-precision plans is kept in a separate file,
+     named by adding ".float" to the wisdom filename.  Single precision is only available if Katydid was built with single-precision
+     FFTW (libfftw3f); otherwise "precision": "float" is rejected.
+
+     In double precision, several time series of the same size can be transformed together with a single FFTW call using
+     BatchTransform() and BatchTransformAsComplex(); this can be used for all of the components of a slice, or for
+     a number of consecutive slices.  The batched plan is made with fftw_plan_many_dft(_r2c) the first time a given number of
+     transforms is requested, and is reused until the size, state or transform flag changes.  The data are copied into and out of
+     one contiguous block, so batching helps most when the per-call overhead is significant (i.e. multi-channel data and/or small slices).
+     With "batch-components" enabled, the data slots transform all of the components of each slice in one batch.
+
+     When only the power is needed, the "-to-ps" and "-to-psd" slots compute |X|^2 (or the PSD) directly from the FFTW output,
+     which is kept in a per-thread scratch array, so no KTFrequencySpectrumFFTW is made.  The result is the same as from
+     the corresponding fs-fftw-to-ps(d) slot of KTConvertToPower, except for the layout of complex transforms: for c2c and rasc2c
+     the power spectrum has the same bins as the frequency spectrum, or, with "fold-negative-frequencies", the power at each
+     negative frequency is added to that at the corresponding positive frequency and the spectrum runs from DC to the Nyquist frequency.
+     These slots are only available in double precision.
 
      Configuration name: "forward-fftw"
 
      Available configuration values:
      - "transform_flag": string -- flag that determines how much planning is done prior to any transforms (see below)
      - "use-wisdom": bool -- whether or not to use FFTW wisdom to improve FFT performance
-     - "wisdom-filename": string -- filename for loading/saving FFTW wisdom
+     - "n-threads": unsigned int -- number of threads used by each FFT (default: the FFTW_NTHREADS build setting); more than 1 requires the FFTW threads libraries
+     - "wisdom-filename": string -- filename for loading/saving FFTW wisdom (default: KTFFTWPlanCache::GetDefaultWisdomFilename(), i.e. $KATYDID_FFTW_WISDOM or katydid_wisdom.fftw3 in the working directory; the default used to be wisdom_complexfft.fftw3, which is no longer read); a locked (read-only) file, e.g. from TuneFFTWWisdom, is read but not updated
+     - "precision": string -- "double" (default) or "float"; the precision of the transform and of the input/output data ("float" requires single-precision FFTW)
+     - "batch-components": bool -- if true, all of the components of a slice are transformed with a single batched FFT (double precision only; default: false)
      - "transform-state": string -- "r2c", "c2c", or "rasc2c"; specify the transform state, regardless of the time domain type listed in the egg header; this is useful when a new time domain data type (e.g. aa) has been added to the data object and is being transformed.
+     - "fold-negative-frequencies": bool -- for c2c and rasc2c transforms straight to power, add the negative-frequency bins to the positive-frequency bins (default: false; ignored for IQ data)
      - "transform-complex-as-iq": bool -- specify whether to treat complex data as IQ: the negative frequency bins are assumed to be a continuous extension of the positive frequency bins, and the whole spectrum is shifted so that it starts at DC; this is only used if the transform state has also been specified.
 
      Transform flags control how FFTW performs the FFT.
@@ -80,13 +123,22 @@ namespace Katydid
 
      Slots:
      - "header": void (Nymph::KTDataPtr) -- Initialize the FFT from an Egg header; Requires KTEggHeader
-     - "ts-real": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series; Requires KTTimeSeriesData; Adds KTFrequencySpectrumFFTW; Emits signal "fft"
-     - "ts-fftw": void (Nymph::KTDataPtr) -- Perform a forward FFT on a complex time series; Requires KTTimeSeriesData; Adds KTFrequencySpectrumFFTW; Emits signal "fft"
-     - "aa": void (Nymph::KTDataPtr) -- Perform a forward FFT on an analytic associate data; Requires KTAnalyticAssociateData; Adds KTFrequencySpectrumFFTW; Emits signal "fft"
-     - "ts-real-as-complex": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series; Requires KTTimeSeriesData; Adds KTFrequencySpectrumFFTW; Emits signal "fft"
+     - "ts-real": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series; Requires KTTimeSeriesData; Adds KTFrequencySpectrumFFTW (KTFrequencySpectrumFFTWF in single precision); Emits signal "fft"
+     - "ts-fftw": void (Nymph::KTDataPtr) -- Perform a forward FFT on a complex time series; Requires KTTimeSeriesData; Adds KTFrequencySpectrumFFTW (KTFrequencySpectrumFFTWF in single precision); Emits signal "fft"
+     - "ts-real-to-ps": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series and keep only the power spectrum; Requires KTTimeSeriesData; Adds KTPowerSpectrumData; Emits signal "ps"
+     - "ts-real-to-psd": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series and keep only the PSD; Requires KTTimeSeriesData; Adds KTPowerSpectrumData; Emits signal "psd"
+     - "ts-fftw-to-ps": void (Nymph::KTDataPtr) -- Perform a forward FFT on a complex time series and keep only the power spectrum; Requires KTTimeSeriesData; Adds KTPowerSpectrumData; Emits signal "ps"
+     - "ts-fftw-to-psd": void (Nymph::KTDataPtr) -- Perform a forward FFT on a complex time series and keep only the PSD; Requires KTTimeSeriesData; Adds KTPowerSpectrumData; Emits signal "psd"
+     - "ts-real-as-complex-to-ps": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series as complex and keep only the power spectrum; Requires KTTimeSeriesData; Adds KTPowerSpectrumData; Emits signal "ps"
+     - "ts-real-as-complex-to-psd": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series as complex and keep only the PSD; Requires KTTimeSeriesData; Adds KTPowerSpectrumData; Emits signal "psd"
+     - "ts-downconverted": void (Nymph::KTDataPtr) -- Perform a forward FFT on a complex time series, with the frequency axis offset by the slice header's frequency offset (e.g. from KTDownconverter); the FFT must be in the c2c state, so set "transform-state" to "c2c" (with "transform-complex-as-iq" false): initialized from the Egg header of real data it would be in the r2c state and the data would be rejected; Requires KTSliceHeader and KTTimeSeriesData; Adds KTFrequencySpectrumFFTW (KTFrequencySpectrumFFTWF in single precision); Emits signal "fft"
+     - "aa": void (Nymph::KTDataPtr) -- Perform a forward FFT on an analytic associate data; Requires KTAnalyticAssociateData; Adds KTFrequencySpectrumFFTW; Emits signal "fft"; double precision only
+     - "ts-real-as-complex": void (Nymph::KTDataPtr) -- Perform a forward FFT on a real time series; Requires KTTimeSeriesData; Adds KTFrequencySpectrumFFTW (KTFrequencySpectrumFFTWF in single precision); Emits signal "fft"
 
      Signals:
-     - "fft": void (Nymph::KTDataPtr) -- Emitted upon performance of a forward transform; Guarantees KTFrequencySpectrumDataFFTW.
+     - "fft": void (Nymph::KTDataPtr) -- Emitted upon performance of a forward transform; Guarantees KTFrequencySpectrumDataFFTW (KTFrequencySpectrumDataFFTWF in single precision).
+     - "ps": void (Nymph::KTDataPtr) -- Emitted upon performance of a forward transform straight to a power spectrum; Guarantees KTPowerSpectrumData.
+     - "psd": void (Nymph::KTDataPtr) -- Emitted upon performance of a forward transform straight to a power spectral density; Guarantees KTPowerSpectrumData.
     */
 
     class KTForwardFFTW : public KTFFTW, public Nymph::KTProcessor
@@ -119,11 +171,21 @@ namespace Katydid
 
             MEMBERVARIABLEREF_NOSET(std::string, TransformFlag);
 
+            MEMBERVARIABLE_NOSET(bool, SinglePrecision);
+
+            MEMBERVARIABLE(bool, BatchComponents);
+
+            MEMBERVARIABLE(bool, FoldNegativeFrequencies);
+
         public:
             /// Set the number of time bins; FFT must be initialized after calling this.
             void SetTimeSize(unsigned nBins);
             /// Change the transform flag; FFT must be initialized after calling this.
             void SetTransformFlag(const std::string& flag);
+            /// Set the number of threads used by the FFT plans; FFT must be initialized after calling this.
+            void SetNThreads(unsigned nThreads);
+            /// Switch between double and single precision; FFT must be initialized after calling this.
+            void SetSinglePrecision(bool flag);
 
         private:
             /// note: does not change the state
@@ -173,6 +235,8 @@ namespace Katydid
             bool TransformComplexData(KTTimeSeriesData& tsData);
             /// Forward FFT - Complex Analytic Associate Data
             bool TransformComplexData(KTAnalyticAssociateData& aaData);
+            /// Forward FFT - Complex Time Data that has been shifted in frequency; the spectra are offset by the slice header's frequency offset
+            bool TransformDownconvertedData(KTSliceHeader& header, KTTimeSeriesData& tsData);
             /// Forward FFT - Complex Time Series
             KTFrequencySpectrumFFTW* Transform(const KTTimeSeriesFFTW* ts) const;
             /// Forward FFT - Complex Time Series - No size or bin width checks
@@ -180,24 +244,103 @@ namespace Katydid
             /// Forward FFT - Complex Time Series - Output must exist - No size or bin width checks
             void DoTransform(const KTTimeSeriesFFTW* tsIn, KTFrequencySpectrumFFTW* fsOut) const;
 
+            /// Forward FFT - Real input array of GetTimeSize() values, allocated with fftw_malloc; the contents may be destroyed; requires the R2C state
+            KTFrequencySpectrumFFTW* TransformArray(double* arrayIn, double timeBinWidth) const;
+            /// Forward FFT - Complex input array of GetTimeSize() values, allocated with fftw_malloc; requires the C2C or RasC2C state
+            KTFrequencySpectrumFFTW* TransformArray(fftw_complex* arrayIn, double timeBinWidth) const;
+            /// Forward FFT - Real input array, as for TransformArray() - Output must exist - No size or bin width checks
+            void DoTransformArray(double* arrayIn, KTFrequencySpectrumFFTW* fsOut) const;
+            /// Forward FFT - Complex input array, as for TransformArray() - Output must exist - No size or bin width checks
+            void DoTransformArray(fftw_complex* arrayIn, KTFrequencySpectrumFFTW* fsOut) const;
+
+            /// Forward FFT straight to a power spectrum - Real Time Data; the complex spectrum is not kept
+            bool TransformRealDataToPS(KTTimeSeriesData& tsData);
+            /// Forward FFT straight to a power spectral density - Real Time Data; the complex spectrum is not kept
+            bool TransformRealDataToPSD(KTTimeSeriesData& tsData);
+            /// Forward FFT straight to a power spectrum - Real Time Data as Complex; the complex spectrum is not kept
+            bool TransformRealDataAsComplexToPS(KTTimeSeriesData& tsData);
+            /// Forward FFT straight to a power spectral density - Real Time Data as Complex; the complex spectrum is not kept
+            bool TransformRealDataAsComplexToPSD(KTTimeSeriesData& tsData);
+            /// Forward FFT straight to a power spectrum - Complex Time Data; the complex spectrum is not kept
+            bool TransformComplexDataToPS(KTTimeSeriesData& tsData);
+            /// Forward FFT straight to a power spectral density - Complex Time Data; the complex spectrum is not kept
+            bool TransformComplexDataToPSD(KTTimeSeriesData& tsData);
+            /// Forward FFT of a time series of the type for the current state, straight to a power spectrum or PSD - No size or bin width checks
+            KTPowerSpectrum* FastTransformToPower(const KTTimeSeries* ts, KTPowerSpectrum::Mode mode) const;
+
+            /// Batched forward FFT - Real Time Series; all inputs must have GetTimeSize() bins; the outputs are created and added to fsOut
+            bool BatchTransform(const std::vector< const KTTimeSeriesReal* >& tsIn, std::vector< KTFrequencySpectrumFFTW* >& fsOut);
+            /// Batched forward FFT - Real-as-Complex Time Series; all inputs must have GetTimeSize() bins; the outputs are created and added to fsOut
+            bool BatchTransformAsComplex(const std::vector< const KTTimeSeriesReal* >& tsIn, std::vector< KTFrequencySpectrumFFTW* >& fsOut);
+            /// Batched forward FFT - Complex Time Series; all inputs must have GetTimeSize() bins; the outputs are created and added to fsOut
+            bool BatchTransform(const std::vector< const KTTimeSeriesFFTW* >& tsIn, std::vector< KTFrequencySpectrumFFTW* >& fsOut);
+
+#ifdef FFTWF_FOUND
+            /// Forward FFT - Single-precision Real Time Series
+            KTFrequencySpectrumFFTWF* Transform(const KTTimeSeriesRealF* ts) const;
+            /// Forward FFT - Single-precision Real Time Series - No size or bin width checks
+            KTFrequencySpectrumFFTWF* FastTransform(const KTTimeSeriesRealF* ts) const;
+            /// Forward FFT - Single-precision Real Time Series - Output must exist - No size or bin width checks
+            void DoTransform(const KTTimeSeriesRealF* tsIn, KTFrequencySpectrumFFTWF* fsOut) const;
+
+            /// Forward FFT - Single-precision Real-as-Complex Time Series
+            KTFrequencySpectrumFFTWF* TransformAsComplex(const KTTimeSeriesRealF* ts) const;
+            /// Forward FFT - Single-precision Real-as-Complex Time Series - No size or bin width checks
+            KTFrequencySpectrumFFTWF* FastTransformAsComplex(const KTTimeSeriesRealF* ts) const;
+            /// Forward FFT - Single-precision Real-as-Complex Time Series - Output must exist - No size or bin width checks
+            void DoTransformAsComplex(const KTTimeSeriesRealF* tsIn, KTFrequencySpectrumFFTWF* fsOut) const;
+
+            /// Forward FFT - Single-precision Complex Time Series
+            KTFrequencySpectrumFFTWF* Transform(const KTTimeSeriesFFTWF* ts) const;
+            /// Forward FFT - Single-precision Complex Time Series - No size or bin width checks
+            KTFrequencySpectrumFFTWF* FastTransform(const KTTimeSeriesFFTWF* ts) const;
+            /// Forward FFT - Single-precision Complex Time Series - Output must exist - No size or bin width checks
+            void DoTransform(const KTTimeSeriesFFTWF* tsIn, KTFrequencySpectrumFFTWF* fsOut) const;
+#endif
+
         private:
+#ifdef FFTWF_FOUND
+            /// Single-precision versions of the time-series transforms; called by TransformRealData(), etc.
+            bool TransformRealDataF(KTTimeSeriesData& tsData);
+            bool TransformRealDataAsComplexF(KTTimeSeriesData& tsData);
+            bool TransformComplexDataF(KTTimeSeriesData& tsData);
+#endif
+
+            /// Common implementation of the transforms straight to power
+            bool TransformToPower(KTTimeSeriesData& tsData, KTForwardFFTW::State intendedState, KTPowerSpectrum::Mode mode);
+
+            /// Creates the batched plan and arrays for nTransforms transforms in the current state, if they don't already exist
+            bool InitializeBatch(unsigned nTransforms);
+            void ClearBatch();
+            /// Transforms the contents of the batch input array and copies the normalized results into new spectra
+            void ExecuteBatch(unsigned nTransforms, bool arrayOrderIsFlipped, double norm, std::vector< KTFrequencySpectrumFFTW* >& fsOut);
+
+            /// Wisdom for single-precision plans is kept separately from double-precision wisdom
+            std::string GetPrecisionWisdomFilename() const;
+
             // binning cache
             void UpdateBinningCache(double timeBinWidth) const;
+            void GetBinningCache(double& freqMin, double& freqMax) const;
+            mutable std::mutex fBinningCacheMutex;
             mutable double fTimeBinWidthCache;
             mutable double fFreqMinCache;
             mutable double fFreqMaxCache;
 
-            /// Allocate memory in the i/o arrays for an intended state if provided, or (default) the current state
-            /// note: does not change the state
-            bool AllocateArrays(State intendedState = kNone);
-            void FreeArrays();
             void SetupInternalMaps(); // do not make this virtual (called from the constructor)
 
+            // plans are shared through KTFFTWPlanCache
             fftw_plan fForwardPlan;
 
-            double*       fRInputArray;
-            fftw_complex* fCInputArray;
-            fftw_complex* fOutputArray;
+            fftw_plan fBatchPlan;
+            unsigned fBatchSize;
+
+            double*       fBatchRInputArray;
+            fftw_complex* fBatchCInputArray;
+            fftw_complex* fBatchOutputArray;
+
+#ifdef FFTWF_FOUND
+            fftwf_plan fForwardPlanF;
+#endif
 
             //***************
             // Signals
@@ -205,6 +348,8 @@ namespace Katydid
 
         private:
             Nymph::KTSignalData fFFTSignal;
+            Nymph::KTSignalData fPSSignal;
+            Nymph::KTSignalData fPSDSignal;
 
             //***************
             // Slots
@@ -214,8 +359,15 @@ namespace Katydid
             Nymph::KTSlotDataOneType< KTEggHeader > fHeaderSlot;
             Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSRealSlot;
             Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSComplexSlot;
+            Nymph::KTSlotDataTwoTypes< KTSliceHeader, KTTimeSeriesData > fTSDownconvertedSlot;
             Nymph::KTSlotDataOneType< KTAnalyticAssociateData > fAASlot;
             Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSRealAsComplexSlot;
+            Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSRealToPSSlot;
+            Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSRealToPSDSlot;
+            Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSComplexToPSSlot;
+            Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSComplexToPSDSlot;
+            Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSRealAsComplexToPSSlot;
+            Nymph::KTSlotDataOneType< KTTimeSeriesData > fTSRealAsComplexToPSDSlot;
 
     };
 
@@ -252,8 +404,17 @@ namespace Katydid
         }
     }
 
+    inline std::string KTForwardFFTW::GetPrecisionWisdomFilename() const
+    {
+#ifdef FFTWF_FOUND
+        if (fSinglePrecision) return fWisdomFilename + KTFFTWTraits< float >::WisdomSuffix();
+#endif
+        return fWisdomFilename + KTFFTWTraits< double >::WisdomSuffix();
+    }
+
     inline void KTForwardFFTW::UpdateBinningCache(double timeBinWidth) const
     {
+        std::unique_lock< std::mutex > lock(fBinningCacheMutex);
         if (timeBinWidth == fTimeBinWidthCache) return;
         fTimeBinWidthCache = timeBinWidth;
         fFreqMinCache = GetMinFrequency(timeBinWidth);
@@ -261,6 +422,14 @@ namespace Katydid
         return;
     }
 
+    inline void KTForwardFFTW::GetBinningCache(double& freqMin, double& freqMax) const
+    {
+        std::unique_lock< std::mutex > lock(fBinningCacheMutex);
+        freqMin = fFreqMinCache;
+        freqMax = fFreqMaxCache;
+        return;
+    }
+
 } /* namespace Katydid */
 
 #endif /* KTFORWARDFFTW_HH_ */
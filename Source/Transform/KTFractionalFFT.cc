@@ -9,6 +9,7 @@
 
 #include "KTLogger.hh"
 
+#include "KTFFTWPlanCache.hh"
 #include "KTSliceHeader.hh"
 #include "KTTimeSeriesData.hh"
 #include "KTTimeSeriesFFTW.hh"
@@ -32,6 +33,7 @@ namespace Katydid
             fSlope(0.),
             fInitialized(false),
             fTransformFlag("ESTIMATE"),
+            fNThreads(KTFFTWPlanCache::GetDefaultNThreads()),
             fForwardFFT(),
             fReverseFFT(),
             fProcTrackSlot("track", this, &KTFractionalFFT::AssignSlopeParams),
@@ -53,6 +55,7 @@ namespace Katydid
         SetAlpha(node->get_value< double >("alpha", fAlpha));
         SetSlope(node->get_value< double >("slope", fSlope));
         SetTransformFlag(node->get_value("transform-flag", fTransformFlag));
+        SetNThreads(node->get_value< unsigned >("n-threads", fNThreads));
 
         return true;
     }
@@ -67,8 +70,10 @@ namespace Katydid
         fForwardFFT.SetComplexAsIQ( true );
         fForwardFFT.SetTimeSize( s );
         fForwardFFT.SetTransformFlag( fTransformFlag );
+        fForwardFFT.SetNThreads( fNThreads );
         fReverseFFT.SetTimeSize( s );
         fReverseFFT.SetTransformFlag( fTransformFlag );
+        fReverseFFT.SetNThreads( fNThreads );
 
         if (! fForwardFFT.InitializeForComplexTDD())
         {
@@ -53,6 +53,7 @@ namespace Katydid
      - "alpha": double -- rotation angle for fractional FFT, in radians
      - "slope": double -- track slope for chirp transform, in Hz/s
      - "transform-flag": string -- flag that determines how much planning is done prior to any transforms (see KTForwardFFTW.hh)
+     - "n-threads": unsigned int -- number of threads used by each FFT (default: the FFTW_NTHREADS build setting)
 
      Slots:
      - "track": void (Nymph::KTDataPtr) -- Sets the value of slope and alpha from a track; Requires KTProcessedTrackData; Adds nothing
@@ -77,6 +78,7 @@ namespace Katydid
             MEMBERVARIABLE(double, Slope)
             MEMBERVARIABLE(bool, Initialized);
             MEMBERVARIABLE(std::string, TransformFlag);
+            MEMBERVARIABLE(unsigned, NThreads);
 
         private:
 
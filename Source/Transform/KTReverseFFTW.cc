@@ -10,6 +10,8 @@
 #include "KTAnalyticAssociateData.hh"
 #include "KTCacheDirectory.hh"
 #include "KTEggHeader.hh"
+#include "KTFFTWPlanCache.hh"
+#include "KTFFTWScratch.hh"
 #include "KTFrequencySpectrumDataFFTW.hh"
 #include "KTLogger.hh"
 #include "KTTimeSeriesData.hh"
@@ -33,7 +35,7 @@ namespace Katydid
             KTFFTW(),
             KTProcessor(name),
             fUseWisdom(true),
-            fWisdomFilename("wisdom_complexfft.fftw3"),
+            fWisdomFilename(KTFFTWPlanCache::GetDefaultWisdomFilename()),
             fRequestedState(kNone),
             fTimeSize(0),
             fFrequencySize(0),
@@ -41,10 +43,7 @@ namespace Katydid
             fTransformFlagMap(),
             fState(kNone),
             fIsInitialized(false),
-            fReversePlan(),
-            fInputArray(NULL),
-            fROutputArray(NULL),
-            fCOutputArray(NULL),
+            fReversePlan(NULL),
             fFFTSignal("fft", this),
             fHeaderSlot("header", this, &KTReverseFFTW::InitializeWithHeader),
             fFSFFTWToRealSlot("fs-fftw-to-real", this, &KTReverseFFTW::TransformDataToReal, &fFFTSignal),
@@ -55,8 +54,7 @@ namespace Katydid
 
     KTReverseFFTW::~KTReverseFFTW()
     {
-        FreeArrays();
-        if (fReversePlan != NULL) fftw_destroy_plan(fReversePlan);
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fReversePlan);
     }
 
     bool KTReverseFFTW::Configure(const scarab::param_node* node)
@@ -65,6 +63,7 @@ namespace Katydid
         if (node != NULL)
         {
             SetTransformFlag(node->get_value("transform-flag", fTransformFlag));
+            SetNThreads(node->get_value< unsigned >("n-threads", fNThreads));
 
             SetUseWisdom(node->get_value<bool>("use-wisdom", fUseWisdom));
             SetWisdomFilename(node->get_value("wisdom-filename", fWisdomFilename));
@@ -142,49 +141,40 @@ namespace Katydid
         TransformFlagMap::const_iterator iter = fTransformFlagMap.find(fTransformFlag);
         unsigned transformFlag = iter->second;
 
-        // allocate the input and output arrays if they're not there already
-        if (! AllocateArrays(intendedState))
-        {
-            KTERROR(fftwlog, "Unable to allocate arrays");
-            return false;
-        }
+        KTFFTWPlanCache* planCache = KTFFTWPlanCache::get_instance();
 
         if (fUseWisdom)
         {
             KTDEBUG(fftwlog, "Reading wisdom from file <" << fWisdomFilename << ">");
-            if (fftw_import_wisdom_from_filename(fWisdomFilename.c_str()) == 0)
+            if (! planCache->ImportWisdom(fWisdomFilename))
             {
                 KTWARN(fftwlog, "Unable to read FFTW wisdom from file <" << fWisdomFilename << ">");
             }
         }
 
-        InitializeMultithreaded();
-
+        // The new plan is acquired before the old one is released, so that an unchanged plan is not remade
+        fftw_plan newPlan = NULL;
         if (intendedState == kC2R)
         {
-            KTDEBUG(fftwlog, "Creating C2R plan: " << fTimeSize << " time bins; reverse FFT");
+            KTDEBUG(fftwlog, "Getting C2R plan: " << fTimeSize << " time bins; reverse FFT");
             // Add FFTW_PRESERVE_INPUT so that the input array content is not destroyed during the FFT
-            fReversePlan = fftw_plan_dft_c2r_1d(fTimeSize, fInputArray, fROutputArray, transformFlag | FFTW_PRESERVE_INPUT);
-            // deleting arrays to save space
-            // output array (fROutputArray) is required; input array is not needed
-            fftw_free(fInputArray);
-            fInputArray = NULL;
+            newPlan = planCache->AcquirePlan(KTFFTWPlanCache::kC2R, FFTW_BACKWARD, fTimeSize, transformFlag | FFTW_PRESERVE_INPUT, 1, fNThreads);
         }
         else // intendedState == kC2C || kRasC2C
         {
-            KTDEBUG(fftwlog, "Creating C2C plan: " << fTimeSize << " time bins; forward FFT");
+            KTDEBUG(fftwlog, "Getting C2C plan: " << fTimeSize << " time bins; reverse FFT");
             // Add FFTW_PRESERVE_INPUT so that the input array content is not destroyed during the FFT
-            fReversePlan = fftw_plan_dft_1d(fTimeSize, fInputArray, fCOutputArray, FFTW_BACKWARD, transformFlag | FFTW_PRESERVE_INPUT);
-            // deleting arrays to save space; neither input nor output are needed
-            FreeArrays();
+            newPlan = planCache->AcquirePlan(KTFFTWPlanCache::kC2C, FFTW_BACKWARD, fTimeSize, transformFlag | FFTW_PRESERVE_INPUT, 1, fNThreads);
         }
+        planCache->ReleasePlan(fReversePlan);
+        fReversePlan = newPlan;
 
         if (fReversePlan != NULL)
         {
             fIsInitialized = true;
             if (fUseWisdom)
             {
-                if (fftw_export_wisdom_to_filename(fWisdomFilename.c_str()) == 0)
+                if (! planCache->ExportWisdom(fWisdomFilename))
                 {
                     KTWARN(fftwlog, "Unable to write FFTW wisdom to file <" << fWisdomFilename << ">");
                 }
@@ -269,7 +259,9 @@ namespace Katydid
 
     KTTimeSeriesReal* KTReverseFFTW::FastTransformToReal(const KTFrequencySpectrumFFTW* fs) const
     {
-        KTTimeSeriesReal* newTS = new KTTimeSeriesReal(fTimeSize, fTimeMinCache, fTimeMaxCache);
+        double timeMin, timeMax;
+        GetBinningCache(timeMin, timeMax);
+        KTTimeSeriesReal* newTS = new KTTimeSeriesReal(fTimeSize, timeMin, timeMax);
 
         DoTransform(fs, newTS);
 
@@ -278,8 +270,10 @@ namespace Katydid
 
     void KTReverseFFTW::DoTransform(const KTFrequencySpectrumFFTW* fsIn, KTTimeSeriesReal* tsOut) const
     {
-        fftw_execute_dft_c2r(fReversePlan, fsIn->GetData(), fROutputArray);
-        std::copy(fROutputArray, fROutputArray+fTimeSize, tsOut->begin());
+        // the time series' storage isn't necessarily aligned for FFTW, so the output is staged in a scratch array
+        double* output = KTFFTWScratch::GetReal(fTimeSize);
+        fftw_execute_dft_c2r(fReversePlan, fsIn->GetData(), output);
+        std::copy(output, output+fTimeSize, tsOut->begin());
         (*tsOut) *= sqrt(1. / double(fTimeSize));
         return;
     }
@@ -351,7 +345,9 @@ namespace Katydid
 
     KTTimeSeriesFFTW* KTReverseFFTW::FastTransformToComplex(const KTFrequencySpectrumFFTW* fs) const
     {
-        KTTimeSeriesFFTW* newTS = new KTTimeSeriesFFTW(fTimeSize, fTimeMinCache, fTimeMaxCache);
+        double timeMin, timeMax;
+        GetBinningCache(timeMin, timeMax);
+        KTTimeSeriesFFTW* newTS = new KTTimeSeriesFFTW(fTimeSize, timeMin, timeMax);
 
         DoTransform(fs, newTS);
 
@@ -387,9 +383,6 @@ namespace Katydid
             KTDEBUG(fftwlog, "Time size set while in state <" << fState << ">; frequency size not changed");
         }
 
-        // clear things for good measure
-        FreeArrays();
-
         fIsInitialized = false;
         return;
     }
@@ -416,9 +409,6 @@ namespace Katydid
             KTDEBUG(fftwlog, "Frequency size set while in state <" << fState << ">; time size not changed");
         }
 
-        // clear things for good measure
-        FreeArrays();
-
         fIsInitialized = false;
         return;
     }
@@ -431,74 +421,42 @@ namespace Katydid
             return;
         }
 
-        // delete the plan
-        if (fReversePlan != NULL) fftw_destroy_plan(fReversePlan);
+        // release the plan
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fReversePlan);
+        fReversePlan = NULL;
 
         fTransformFlag = flag;
         fIsInitialized = false;
         return;
     }
 
-    void KTReverseFFTW::SetupInternalMaps()
+    void KTReverseFFTW::SetNThreads(unsigned nThreads)
     {
-        // transform flag map
-        fTransformFlagMap.clear();
-        fTransformFlagMap["ESTIMATE"] = FFTW_ESTIMATE;
-        fTransformFlagMap["MEASURE"] = FFTW_MEASURE;
-        fTransformFlagMap["PATIENT"] = FFTW_PATIENT;
-        fTransformFlagMap["EXHAUSTIVE"] = FFTW_EXHAUSTIVE;
-        return;
-    }
-
-    bool KTReverseFFTW::AllocateArrays(State intendedState)
-    {
-        FreeArrays();
-        if (intendedState == kNone) intendedState = fState;
-        if (intendedState == kNone)
+        unsigned validNThreads = KTFFTWPlanCache::GetValidNThreads(nThreads);
+        if (validNThreads != nThreads)
         {
-            KTERROR(fftwlog, "Cannot allocate arrays for state <" << intendedState << ">");
-            return false;
+            KTWARN(fftwlog, nThreads << " threads were requested; FFTs will use " << validNThreads);
         }
+        if (validNThreads == fNThreads) return;
 
-        if (fInputArray == NULL)
-        {
-            fInputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fFrequencySize);
-        }
-        if (intendedState == kC2R)
-        {
-            if (fROutputArray == NULL)
-            {
-                fROutputArray = (double*) fftw_malloc(sizeof(double) * fTimeSize);
-            }
-        }
-        else //  intendedState == kC2C
-        {
-            if (fCOutputArray == NULL)
-            {
-                fCOutputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fTimeSize);
-            }
-        }
+        // release the plan
+        KTFFTWPlanCache::get_instance()->ReleasePlan(fReversePlan);
+        fReversePlan = NULL;
 
-        return true;
+        fNThreads = validNThreads;
+        fIsInitialized = false;
+        KTDEBUG(fftwlog, "Number of threads set to " << fNThreads);
+        return;
     }
 
-    void KTReverseFFTW::FreeArrays()
+    void KTReverseFFTW::SetupInternalMaps()
     {
-        if (fROutputArray != NULL)
-        {
-            fftw_free(fROutputArray);
-            fROutputArray = NULL;
-        }
-        if (fCOutputArray != NULL)
-        {
-            fftw_free(fCOutputArray);
-            fCOutputArray = NULL;
-        }
-        if (fInputArray != NULL)
-        {
-            fftw_free(fInputArray);
-            fInputArray = NULL;
-        }
+        // transform flag map
+        fTransformFlagMap.clear();
+        fTransformFlagMap["ESTIMATE"] = FFTW_ESTIMATE;
+        fTransformFlagMap["MEASURE"] = FFTW_MEASURE;
+        fTransformFlagMap["PATIENT"] = FFTW_PATIENT;
+        fTransformFlagMap["EXHAUSTIVE"] = FFTW_EXHAUSTIVE;
         return;
     }
 
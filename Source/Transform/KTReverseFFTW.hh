@@ -18,6 +18,7 @@
 #include <fftw3.h>
 
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -41,14 +42,20 @@ namespace Katydid
      @details
      KTReverseFFTW performs a complex-to-real or complex-to-complex reverse FFT on a one-dimensional frequency spectrum.
 
-     The FFT is implemented using FFTW.
+     The FFT is implemented using FFTW.  Plans are obtained from KTFFTWPlanCache, so FFT processors of the same size and settings share them.
+
+     Once the FFT is initialized, TransformToReal(), TransformToComplex(), their "Fast" versions, and DoTransform() are reentrant:
+     the real output is staged in a per-thread scratch array (see KTFFTWScratch), and the plan is executed with FFTW's new-array
+     execute functions, so one instance can be used from several threads at once.  Concurrent callers should all use the same frequency bin width.
+     Initialization, changing the settings, and the slot functions (which may re-initialize the FFT) are not thread-safe.
 
      Configuration name: "reverse-fftw"
 
      Available configuration values:
      - "transform_flag": string -- flag that determines how much planning is done prior to any transforms (see below)
      - "use-wisdom": bool -- whether or not to use FFTW wisdom to improve FFT performance
-     - "wisdom-filename": string -- filename for loading/saving FFTW wisdom
+     - "n-threads": unsigned int -- number of threads used by each FFT (default: the FFTW_NTHREADS build setting); more than 1 requires the FFTW threads libraries
+     - "wisdom-filename": string -- filename for loading/saving FFTW wisdom (default: KTFFTWPlanCache::GetDefaultWisdomFilename(), i.e. $KATYDID_FFTW_WISDOM or katydid_wisdom.fftw3 in the working directory; the default used to be wisdom_complexfft.fftw3, which is no longer read); a locked (read-only) file, e.g. from TuneFFTWWisdom, is read but not updated
 
      Transform flags control how FFTW performs the FFT.
      Currently only the following "rigor" flags are available:
@@ -111,6 +118,8 @@ namespace Katydid
             void SetFrequencySize(unsigned nBins);
             /// Change the transform flag; FFT must be initialized after calling this.
             void SetTransformFlag(const std::string& flag);
+            /// Set the number of threads used by the FFT plans; FFT must be initialized after calling this.
+            void SetNThreads(unsigned nThreads);
 
         private:
             /// note: does not change the state
@@ -161,22 +170,17 @@ namespace Katydid
         private:
             // binning cache
             void UpdateBinningCache(double freqBinWidth) const;
+            void GetBinningCache(double& timeMin, double& timeMax) const;
+            mutable std::mutex fBinningCacheMutex;
             mutable double fFreqBinWidthCache;
             mutable double fTimeMinCache;
             mutable double fTimeMaxCache;
 
-            /// Allocate memory in the i/o arrays for an intended state if provided, or (default) the current state
-            /// note: does not change the state
-            bool AllocateArrays(State intendedState = kNone);
-            void FreeArrays();
             void SetupInternalMaps(); // do not make this virtual (called from the constructor)
 
+            // the plan is shared through KTFFTWPlanCache
             fftw_plan fReversePlan;
 
-            fftw_complex* fInputArray;
-            double*       fROutputArray;
-            fftw_complex* fCOutputArray;
-
             //***************
             // Signals
             //***************
@@ -209,6 +213,7 @@ namespace Katydid
 
     inline void KTReverseFFTW::UpdateBinningCache(double freqBinWidth) const
     {
+        std::unique_lock< std::mutex > lock(fBinningCacheMutex);
         if (freqBinWidth == fFreqBinWidthCache) return;
         fFreqBinWidthCache = freqBinWidth;
         fTimeMinCache = GetMinTime();
@@ -216,6 +221,14 @@ namespace Katydid
         return;
     }
 
+    inline void KTReverseFFTW::GetBinningCache(double& timeMin, double& timeMax) const
+    {
+        std::unique_lock< std::mutex > lock(fBinningCacheMutex);
+        timeMin = fTimeMinCache;
+        timeMax = fTimeMaxCache;
+        return;
+    }
+
 } /* namespace Katydid */
 
 #endif /* KTREVERSEFFTW_HH_ */
@@ -0,0 +1,770 @@
+/*
+ * KTSTFT.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTSTFT.hh"
+
+#include "KTEggHeader.hh"
+#include "KTFrequencySpectrumDataFFTW.hh"
+#include "KTFrequencySpectrumFFTW.hh"
+#include "KTLogger.hh"
+#include "KTRawTimeSeriesData.hh"
+#include "KTRectangularWindow.hh"
+#include "KTSliceHeader.hh"
+#include "KTTimeSeriesData.hh"
+#include "KTTimeSeriesFFTW.hh"
+#include "KTTimeSeriesReal.hh"
+#include "KTWindowFunction.hh"
+
+#include "factory.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+using std::string;
+
+namespace Katydid
+{
+    KTLOGGER(stftlog, "KTSTFT");
+
+    KT_REGISTER_PROCESSOR(KTSTFT, "stft");
+
+    KTSTFT::KTSTFT(const std::string& name) :
+            KTProcessor(name),
+            fWindowSize(4096),
+            fHopSize(1024),
+            fOutputPoolSize(4),
+            fMode(kFFT),
+            fMinFrequency(-std::numeric_limits< double >::max()),
+            fMaxFrequency(std::numeric_limits< double >::max()),
+            fResyncInterval(256),
+            fNSpectra(0),
+            fDAC(),
+            fForwardFFT(),
+            fWindowFunction(NULL),
+            fWeights(),
+            fValuesPerSample(1),
+            fNewSamplesPerSlice(0),
+            fRings(),
+            fRingCapacity(0),
+            fStagingArray(),
+            fRInputArray(NULL),
+            fCInputArray(NULL),
+            fStreamStarted(false),
+            fRingStartSample(0),
+            fSamplesToSkip(0),
+            fStreamStartTimeInRun(0.),
+            fStreamStartTimeInAcq(0.),
+            fTimeBinWidth(1.),
+            fOutputPool(),
+            fUseSlidingDFT(false),
+            fWindowIsEmitted(false),
+            fSDFTIsValid(false),
+            fSpectraSinceResync(0),
+            fSDFTBinWidth(0.),
+            fSDFTScale(1.),
+            fSDFTBins(),
+            fSDFTTwiddles(),
+            fSDFTStates(),
+            fFFTSignal("fft", this),
+            fHeaderSlot("header", this, &KTSTFT::InitializeWithHeader)
+    {
+        RegisterSlot("raw-ts", this, &KTSTFT::SlotFunctionRawTS);
+        RegisterSlot("ts", this, &KTSTFT::SlotFunctionTS);
+
+        SelectWindowFunction("rectangular");
+    }
+
+    KTSTFT::~KTSTFT()
+    {
+        FreeArrays();
+        delete fWindowFunction;
+    }
+
+    bool KTSTFT::Configure(const scarab::param_node* node)
+    {
+        if (node == NULL) return true;
+
+        SetWindowSize(node->get_value< unsigned >("window-size", fWindowSize));
+        SetHopSize(node->get_value< unsigned >("hop-size", fHopSize));
+        SetOutputPoolSize(node->get_value< unsigned >("output-pool-size", fOutputPoolSize));
+        if (fWindowSize == 0 || fHopSize == 0)
+        {
+            KTERROR(stftlog, "The window size and hop size must be positive");
+            return false;
+        }
+
+        if (node->has("mode"))
+        {
+            string mode = node->get_value("mode");
+            if (mode == "fft") SetMode(kFFT);
+            else if (mode == "sliding-dft") SetMode(kSlidingDFT);
+            else
+            {
+                KTERROR(stftlog, "Invalid mode given: <" << mode << ">; options are \"fft\" and \"sliding-dft\"");
+                return false;
+            }
+        }
+        SetMinFrequency(node->get_value("min-frequency", fMinFrequency));
+        SetMaxFrequency(node->get_value("max-frequency", fMaxFrequency));
+        SetResyncInterval(node->get_value< unsigned >("resync-interval", fResyncInterval));
+        if (fMinFrequency >= fMaxFrequency)
+        {
+            KTERROR(stftlog, "The minimum frequency (" << fMinFrequency << ") must be less than the maximum frequency (" << fMaxFrequency << ")");
+            return false;
+        }
+
+        if (node->has("dac") && ! fDAC.Configure(node->node_at("dac")))
+        {
+            return false;
+        }
+
+        if (! SelectWindowFunction(node->get_value("window-function-type", "rectangular")))
+        {
+            return false;
+        }
+        if (node->has("window-function") && ! fWindowFunction->Configure(node->node_at("window-function")))
+        {
+            return false;
+        }
+
+        if (! fForwardFFT.Configure(node->node_at("forward-fftw")))
+        {
+            return false;
+        }
+        if (fForwardFFT.GetSinglePrecision())
+        {
+            KTERROR(stftlog, "The STFT is only available in double precision");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool KTSTFT::SelectWindowFunction(const string& windowType)
+    {
+        KTWindowFunction* tempWF = scarab::factory< KTWindowFunction >::get_instance()->create(windowType);
+        if (tempWF == NULL)
+        {
+            KTERROR(stftlog, "Invalid window function type given: <" << windowType << ">.");
+            return false;
+        }
+        // the rectangular window defaults to a single-bin boxcar; here it covers the whole window unless "boxcar-size" is configured
+        KTRectangularWindow* rectangularWF = dynamic_cast< KTRectangularWindow* >(tempWF);
+        if (rectangularWF != NULL) rectangularWF->SetBoxcarSize(std::numeric_limits< unsigned >::max());
+        delete fWindowFunction;
+        fWindowFunction = tempWF;
+        return true;
+    }
+
+    bool KTSTFT::InitializeWithHeader(KTEggHeader& header)
+    {
+        // the window buffers, DoTransformArray() and the sliding DFT are double precision only
+        if (fForwardFFT.GetSinglePrecision())
+        {
+            KTERROR(stftlog, "The STFT is only available in double precision");
+            return false;
+        }
+
+        // the DAC may update the header (e.g. the bit depth), so it goes first
+        if (! fDAC.InitializeWithHeader(header))
+        {
+            KTERROR(stftlog, "Unable to initialize the DAC");
+            return false;
+        }
+        for (unsigned iChannel = 0; iChannel < fDAC.GetNChannels(); ++iChannel)
+        {
+            if (fDAC.GetChannelDAC(iChannel).GetBitDepthMode() == KTSingleChannelDAC::kIncreasing)
+            {
+                KTERROR(stftlog, "Increasing the bit depth is not supported by the STFT");
+                return false;
+            }
+        }
+
+        const KTChannelHeader* channelHeader = header.GetChannelHeader(0);
+        unsigned sliceSize = channelHeader->GetSliceSize();
+        unsigned stride = channelHeader->GetSliceStride();
+        if (stride == 0) stride = sliceSize;
+        if (stride > sliceSize)
+        {
+            KTERROR(stftlog, "The slices have gaps between them (stride: " << stride << "; slice size: " << sliceSize << "); the STFT requires contiguous samples");
+            return false;
+        }
+        if (stride < sliceSize)
+        {
+            KTWARN(stftlog, "The slices overlap (stride: " << stride << "; slice size: " << sliceSize << "); it is more efficient to use stride == slice size with the STFT");
+        }
+        fNewSamplesPerSlice = stride;
+
+        // the FFT size is the window size, not the slice size
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+        bool fftInitialized = false;
+        if (state == KTForwardFFTW::kNone)
+        {
+            if (channelHeader->GetTSDataType() == KTChannelHeader::kReal)
+            {
+                fftInitialized = fForwardFFT.InitializeForRealTDD(fWindowSize);
+            }
+            else // == KTChannelHeader::kComplex || KTChannelHeader::kIQ
+            {
+                fForwardFFT.SetComplexAsIQ(channelHeader->GetTSDataType() == KTChannelHeader::kIQ);
+                fftInitialized = fForwardFFT.InitializeForComplexTDD(fWindowSize);
+            }
+        }
+        else if (state == KTForwardFFTW::kR2C) fftInitialized = fForwardFFT.InitializeForRealTDD(fWindowSize);
+        else if (state == KTForwardFFTW::kRasC2C) fftInitialized = fForwardFFT.InitializeForRealAsComplexTDD(fWindowSize);
+        else fftInitialized = fForwardFFT.InitializeForComplexTDD(fWindowSize);
+        if (! fftInitialized)
+        {
+            KTERROR(stftlog, "Unable to initialize the forward FFT");
+            return false;
+        }
+        fValuesPerSample = fForwardFFT.GetState() == KTForwardFFTW::kC2C ? 2 : 1;
+
+        fWindowFunction->SetBinWidth(1. / header.GetAcquisitionRate());
+        fWindowFunction->SetSize(fWindowSize);
+        fWindowFunction->RebuildWindowFunction();
+        fWeights.resize(fWindowSize);
+        for (unsigned iBin = 0; iBin < fWindowSize; ++iBin)
+        {
+            fWeights[iBin] = fWindowFunction->GetWeight(iBin);
+        }
+
+        fUseSlidingDFT = false;
+        if (fMode == kSlidingDFT)
+        {
+            for (unsigned iBin = 0; iBin < fWindowSize; ++iBin)
+            {
+                if (fWeights[iBin] != 1.)
+                {
+                    KTERROR(stftlog, "The sliding DFT requires the rectangular window (with the full boxcar size)");
+                    return false;
+                }
+            }
+            if (fHopSize < fWindowSize)
+            {
+                fUseSlidingDFT = true;
+            }
+            else
+            {
+                KTWARN(stftlog, "The hop size is not smaller than the window size; every window will be transformed with the full FFT");
+            }
+        }
+        // the forward FFT scales R2C transforms by sqrt(2/N), and the others by sqrt(1/N)
+        fSDFTScale = sqrt((fForwardFFT.GetState() == KTForwardFFTW::kR2C ? 2. : 1.) / double(fWindowSize));
+        fSDFTBinWidth = 0.;
+
+        fOutputPool.clear();
+        fRings.clear();
+        if (! AllocateBuffers(sliceSize, header.GetNChannels()))
+        {
+            KTERROR(stftlog, "Unable to allocate the STFT buffers");
+            return false;
+        }
+        Reset();
+        fNSpectra = 0;
+
+        KTDEBUG(stftlog, "STFT initialized with header; window size: " << fWindowSize << "; hop size: " << fHopSize << "; new samples per slice: " << fNewSamplesPerSlice << "; sliding DFT: " << fUseSlidingDFT);
+        return true;
+    }
+
+    void KTSTFT::Reset()
+    {
+        for (std::vector< SampleRing >::iterator ringIt = fRings.begin(); ringIt != fRings.end(); ++ringIt)
+        {
+            ringIt->fStart = 0;
+            ringIt->fNSamples = 0;
+        }
+        fStreamStarted = false;
+        fRingStartSample = 0;
+        fSamplesToSkip = 0;
+        fWindowIsEmitted = false;
+        fSDFTIsValid = false;
+        return;
+    }
+
+    bool KTSTFT::AddRawData(KTSliceHeader& header, KTRawTimeSeriesData& rawData)
+    {
+        if (fRInputArray == NULL && fCInputArray == NULL)
+        {
+            KTERROR(stftlog, "The STFT must be initialized (with the egg header) before data can be added");
+            return false;
+        }
+
+        unsigned nComponents = rawData.GetNComponents();
+        // the raw time series sees each complex sample as 2 bins
+        unsigned sliceSize = rawData.GetTimeSeries(0)->size() / fValuesPerSample;
+        unsigned firstSample = StartSlice(header, sliceSize, nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTRawTimeSeries* rawTS = rawData.GetTimeSeries(iComponent);
+            if (rawTS->size() != sliceSize * fValuesPerSample)
+            {
+                KTERROR(stftlog, "Component <" << iComponent << "> has " << rawTS->size() << " bins; " << sliceSize * fValuesPerSample << " were expected");
+                Reset();
+                return false;
+            }
+            if (! fDAC.GetChannelDAC(iComponent).ConvertToArray(rawTS, fStagingArray.data()))
+            {
+                Reset();
+                return false;
+            }
+            PushSamples(iComponent, firstSample, sliceSize);
+        }
+
+        EmitWindows(header);
+        return true;
+    }
+
+    bool KTSTFT::AddTimeSeriesData(KTSliceHeader& header, KTTimeSeriesData& tsData)
+    {
+        if (fRInputArray == NULL && fCInputArray == NULL)
+        {
+            KTERROR(stftlog, "The STFT must be initialized (with the egg header) before data can be added");
+            return false;
+        }
+
+        unsigned nComponents = tsData.GetNComponents();
+        unsigned sliceSize = tsData.GetTimeSeries(0)->GetNTimeBins();
+        unsigned firstSample = StartSlice(header, sliceSize, nComponents);
+
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            const double* values = NULL;
+            if (fValuesPerSample == 2)
+            {
+                const KTTimeSeriesFFTW* ts = dynamic_cast< const KTTimeSeriesFFTW* >(tsData.GetTimeSeries(iComponent));
+                if (ts != NULL && ts->size() == sliceSize) values = reinterpret_cast< const double* >(ts->GetData());
+            }
+            else
+            {
+                const KTTimeSeriesReal* ts = dynamic_cast< const KTTimeSeriesReal* >(tsData.GetTimeSeries(iComponent));
+                if (ts != NULL && ts->size() == sliceSize) values = ts->begin();
+            }
+            if (values == NULL)
+            {
+                KTERROR(stftlog, "Component <" << iComponent << "> is not a " << (fValuesPerSample == 2 ? "complex" : "real") << " time series of " << sliceSize << " bins");
+                Reset();
+                return false;
+            }
+            std::copy(values, values + sliceSize * fValuesPerSample, fStagingArray.begin());
+            PushSamples(iComponent, firstSample, sliceSize);
+        }
+
+        EmitWindows(header);
+        return true;
+    }
+
+    unsigned KTSTFT::StartSlice(const KTSliceHeader& header, unsigned sliceSize, unsigned nComponents)
+    {
+        // the buffers must hold what's left from the previous slices (less than a window, plus a hop for the sliding DFT) plus the whole slice
+        unsigned requiredCapacity = fWindowSize + (fUseSlidingDFT ? fHopSize : 0) + sliceSize;
+        if (nComponents != fRings.size() || requiredCapacity > fRingCapacity || sliceSize * fValuesPerSample > fStagingArray.size())
+        {
+            KTDEBUG(stftlog, "Resizing the STFT buffers for " << nComponents << " component(s) and slices of " << sliceSize << " samples");
+            AllocateBuffers(sliceSize, nComponents);
+            Reset();
+        }
+
+        fTimeBinWidth = header.GetBinWidth();
+
+        unsigned firstSample = 0;
+        if (! fStreamStarted || header.GetIsNewAcquisition())
+        {
+            // windows never span a discontinuity
+            Reset();
+            fStreamStarted = true;
+            fStreamStartTimeInRun = header.GetTimeInRun();
+            fStreamStartTimeInAcq = header.GetTimeInAcq();
+        }
+        else if (sliceSize > fNewSamplesPerSlice)
+        {
+            // overlapping slices: the first part of the slice is already in the buffers
+            firstSample = sliceSize - fNewSamplesPerSlice;
+        }
+
+        // the buffers are empty while samples are being skipped
+        unsigned nSkip = std::min(fSamplesToSkip, sliceSize - firstSample);
+        fSamplesToSkip -= nSkip;
+        fRingStartSample += nSkip;
+        return firstSample + nSkip;
+    }
+
+    void KTSTFT::PushSamples(unsigned component, unsigned firstSample, unsigned sliceSize)
+    {
+        SampleRing& ring = fRings[component];
+        unsigned nValues = (sliceSize - firstSample) * fValuesPerSample;
+        unsigned ringValues = fRingCapacity * fValuesPerSample;
+        unsigned writePos = ((ring.fStart + ring.fNSamples) & (fRingCapacity - 1)) * fValuesPerSample;
+
+        // at most two segments: up to the end of the buffer, and then from the beginning
+        std::vector< double >::const_iterator from = fStagingArray.begin() + firstSample * fValuesPerSample;
+        unsigned nFirstSegment = std::min(nValues, ringValues - writePos);
+        std::copy(from, from + nFirstSegment, ring.fValues.begin() + writePos);
+        std::copy(from + nFirstSegment, from + nValues, ring.fValues.begin());
+
+        ring.fNSamples += sliceSize - firstSample;
+        return;
+    }
+
+    void KTSTFT::DropSamples(unsigned nSamples)
+    {
+        for (std::vector< SampleRing >::iterator ringIt = fRings.begin(); ringIt != fRings.end(); ++ringIt)
+        {
+            ringIt->fStart = (ringIt->fStart + nSamples) & (fRingCapacity - 1);
+            ringIt->fNSamples -= nSamples;
+        }
+        fRingStartSample += nSamples;
+        return;
+    }
+
+    void KTSTFT::EmitWindows(const KTSliceHeader& header)
+    {
+        unsigned nComponents = fRings.size();
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+        unsigned nEmitted = 0;
+
+        while (! fRings.empty())
+        {
+            if (fWindowIsEmitted)
+            {
+                // sliding DFT: the state can only move to the next window once all of its samples are buffered,
+                // since the samples leaving the window are needed as well as those entering it
+                if (fRings[0].fNSamples < fWindowSize + fHopSize) break;
+                // no need to update the state if the next window is due for resynchronization
+                if (fSpectraSinceResync < fResyncInterval) SlideWindows(fHopSize);
+                DropSamples(fHopSize);
+                fWindowIsEmitted = false;
+            }
+            if (fRings[0].fNSamples < fWindowSize) break;
+
+            Nymph::KTDataPtr newData = GetOutputData(nComponents, fTimeBinWidth);
+
+            KTSliceHeader& newHeader = newData->Of< KTSliceHeader >();
+            newHeader.CopySliceHeaderOnly(header);
+            newHeader.SetSliceSize(fWindowSize);
+            newHeader.SetRawSliceSize(fWindowSize);
+            newHeader.CalculateBinWidthAndSliceLength();
+            newHeader.SetNonOverlapFrac(std::min(1., double(fHopSize) / double(fWindowSize)));
+            newHeader.SetTimeInRun(fStreamStartTimeInRun + double(fRingStartSample) * fTimeBinWidth);
+            newHeader.SetTimeInAcq(fStreamStartTimeInAcq + double(fRingStartSample) * fTimeBinWidth);
+            newHeader.SetIsNewAcquisition(fRingStartSample == 0);
+            newHeader.SetSliceNumber(fNSpectra);
+            newHeader.SetNSlicesIncluded(1);
+
+            KTFrequencySpectrumDataFFTW& fsData = newData->Of< KTFrequencySpectrumDataFFTW >();
+            if (fUseSlidingDFT)
+            {
+                ComputeSlidingDFT(fsData);
+            }
+            else
+            {
+                for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+                {
+                    LoadWindow(iComponent);
+                    if (state == KTForwardFFTW::kR2C) fForwardFFT.DoTransformArray(fRInputArray, fsData.GetSpectrumFFTW(iComponent));
+                    else fForwardFFT.DoTransformArray(fCInputArray, fsData.GetSpectrumFFTW(iComponent));
+                }
+            }
+
+            fFFTSignal(newData);
+            ++fNSpectra;
+            ++nEmitted;
+
+            if (fUseSlidingDFT)
+            {
+                fWindowIsEmitted = true;
+            }
+            else if (fHopSize <= fRings[0].fNSamples)
+            {
+                DropSamples(fHopSize);
+            }
+            else
+            {
+                fSamplesToSkip = fHopSize - fRings[0].fNSamples;
+                DropSamples(fRings[0].fNSamples);
+            }
+        }
+
+        KTDEBUG(stftlog, nEmitted << " spectra emitted; " << (fRings.empty() ? 0 : fRings[0].fNSamples) << " samples buffered");
+        return;
+    }
+
+    void KTSTFT::LoadWindow(unsigned component)
+    {
+        const SampleRing& ring = fRings[component];
+        const unsigned mask = fRingCapacity - 1;
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+        if (state == KTForwardFFTW::kR2C)
+        {
+            for (unsigned iBin = 0; iBin < fWindowSize; ++iBin)
+            {
+                fRInputArray[iBin] = ring.fValues[(ring.fStart + iBin) & mask] * fWeights[iBin];
+            }
+        }
+        else if (state == KTForwardFFTW::kC2C)
+        {
+            for (unsigned iBin = 0; iBin < fWindowSize; ++iBin)
+            {
+                unsigned index = 2 * ((ring.fStart + iBin) & mask);
+                fCInputArray[iBin][0] = ring.fValues[index] * fWeights[iBin];
+                fCInputArray[iBin][1] = ring.fValues[index + 1] * fWeights[iBin];
+            }
+        }
+        else // state == KTForwardFFTW::kRasC2C
+        {
+            for (unsigned iBin = 0; iBin < fWindowSize; ++iBin)
+            {
+                fCInputArray[iBin][0] = ring.fValues[(ring.fStart + iBin) & mask] * fWeights[iBin];
+                fCInputArray[iBin][1] = 0.;
+            }
+        }
+        return;
+    }
+
+    void KTSTFT::ComputeSlidingDFT(KTFrequencySpectrumDataFFTW& fsData)
+    {
+        unsigned nComponents = fRings.size();
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+
+        if (fSDFTBinWidth != fTimeBinWidth || fSDFTStates.size() != nComponents)
+        {
+            SetUpSlidingDFTBand(*fsData.GetSpectrumFFTW(0));
+            fSDFTStates.assign(nComponents, std::vector< std::complex< double > >(fSDFTBins.size()));
+            fSDFTBinWidth = fTimeBinWidth;
+            fSDFTIsValid = false;
+        }
+
+        bool resync = ! fSDFTIsValid || fSpectraSinceResync >= fResyncInterval;
+        unsigned nBandBins = fSDFTBins.size();
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            KTFrequencySpectrumFFTW* spectrum = fsData.GetSpectrumFFTW(iComponent);
+            std::vector< std::complex< double > >& sdftState = fSDFTStates[iComponent];
+            fftw_complex* output = spectrum->GetData();
+            if (resync)
+            {
+                // the window is rectangular, so the FFT of the window is exactly the state
+                LoadWindow(iComponent);
+                if (state == KTForwardFFTW::kR2C) fForwardFFT.DoTransformArray(fRInputArray, spectrum);
+                else fForwardFFT.DoTransformArray(fCInputArray, spectrum);
+                for (unsigned iBandBin = 0; iBandBin < nBandBins; ++iBandBin)
+                {
+                    unsigned index = fSDFTBins[iBandBin];
+                    sdftState[iBandBin] = std::complex< double >(output[index][0], output[index][1]);
+                }
+            }
+            else
+            {
+                spectrum->SetNTimeBins(fWindowSize);
+            }
+
+            // the bins outside of the band are zero, whether or not this was a full FFT
+            std::fill(&output[0][0], &output[0][0] + 2 * spectrum->size(), 0.);
+            for (unsigned iBandBin = 0; iBandBin < nBandBins; ++iBandBin)
+            {
+                unsigned index = fSDFTBins[iBandBin];
+                output[index][0] = sdftState[iBandBin].real();
+                output[index][1] = sdftState[iBandBin].imag();
+            }
+        }
+
+        if (resync)
+        {
+            fSDFTIsValid = true;
+            fSpectraSinceResync = 0;
+        }
+        else
+        {
+            ++fSpectraSinceResync;
+        }
+        return;
+    }
+
+    void KTSTFT::SetUpSlidingDFTBand(const KTFrequencySpectrumFFTW& spectrum)
+    {
+        unsigned nBins = spectrum.size();
+        double minFrequency = std::max(fMinFrequency, spectrum.GetRangeMin());
+        double maxFrequency = std::min(fMaxFrequency, spectrum.GetRangeMax());
+        ssize_t minBin = std::max(spectrum.FindBin(minFrequency), ssize_t(0));
+        ssize_t maxBin = std::min(spectrum.FindBin(maxFrequency), ssize_t(nBins) - 1);
+
+        fSDFTBins.clear();
+        fSDFTTwiddles.clear();
+        for (ssize_t iBin = minBin; iBin <= maxBin; ++iBin)
+        {
+            // the state is kept in storage order; for C2C transforms the storage index of a negative frequency is k + N,
+            // which has the same twiddle factor as k
+            unsigned index = &spectrum(iBin) - spectrum.GetData();
+            fSDFTBins.push_back(index);
+            fSDFTTwiddles.push_back(std::polar(1., 2. * M_PI * double(index) / double(fWindowSize)));
+        }
+
+        KTDEBUG(stftlog, "Sliding DFT band: " << minFrequency << " - " << maxFrequency << " (" << fSDFTBins.size() << " bins)");
+        return;
+    }
+
+    void KTSTFT::SlideWindows(unsigned nSamples)
+    {
+        const unsigned mask = fRingCapacity - 1;
+        unsigned nBandBins = fSDFTBins.size();
+        for (unsigned iComponent = 0; iComponent < fRings.size(); ++iComponent)
+        {
+            const SampleRing& ring = fRings[iComponent];
+            std::vector< std::complex< double > >& sdftState = fSDFTStates[iComponent];
+            for (unsigned iSample = 0; iSample < nSamples; ++iSample)
+            {
+                unsigned oldIndex = ((ring.fStart + iSample) & mask) * fValuesPerSample;
+                unsigned newIndex = ((ring.fStart + iSample + fWindowSize) & mask) * fValuesPerSample;
+                std::complex< double > delta(ring.fValues[newIndex] - ring.fValues[oldIndex], 0.);
+                if (fValuesPerSample == 2) delta.imag(ring.fValues[newIndex + 1] - ring.fValues[oldIndex + 1]);
+                delta *= fSDFTScale;
+                for (unsigned iBandBin = 0; iBandBin < nBandBins; ++iBandBin)
+                {
+                    sdftState[iBandBin] = (sdftState[iBandBin] + delta) * fSDFTTwiddles[iBandBin];
+                }
+            }
+        }
+        return;
+    }
+
+    Nymph::KTDataPtr KTSTFT::GetOutputData(unsigned nComponents, double timeBinWidth)
+    {
+        unsigned frequencySize = fForwardFFT.GetFrequencySize();
+        double freqMin = fForwardFFT.GetMinFrequency(timeBinWidth);
+        double freqMax = fForwardFFT.GetMaxFrequency(timeBinWidth);
+
+        // a pooled data object can be reused if nothing else holds it
+        for (std::vector< Nymph::KTDataPtr >::iterator poolIt = fOutputPool.begin(); poolIt != fOutputPool.end(); ++poolIt)
+        {
+            if (poolIt->use_count() != 1) continue;
+
+            KTFrequencySpectrumDataFFTW& fsData = (*poolIt)->Of< KTFrequencySpectrumDataFFTW >();
+            bool compatible = fsData.GetNComponents() == nComponents;
+            for (unsigned iComponent = 0; compatible && iComponent < nComponents; ++iComponent)
+            {
+                const KTFrequencySpectrumFFTW* spectrum = fsData.GetSpectrumFFTW(iComponent);
+                compatible = spectrum != NULL && spectrum->size() == frequencySize && spectrum->GetRangeMin() == freqMin && spectrum->GetRangeMax() == freqMax;
+            }
+            if (! compatible) continue;
+
+            // the spectra (and their FFTW buffers) are moved to a new data object, so that the extensions added to the old one
+            // downstream are not passed on with the new window
+            Nymph::KTDataPtr newData(new Nymph::KTData());
+            KTFrequencySpectrumDataFFTW& newFSData = newData->Of< KTFrequencySpectrumDataFFTW >().SetNComponents(nComponents);
+            for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+            {
+                newFSData.SetSpectrum(std::move(*fsData.GetSpectrumFFTW(iComponent)), iComponent);
+            }
+            *poolIt = newData;
+            return newData;
+        }
+
+        Nymph::KTDataPtr newData(new Nymph::KTData());
+        KTFrequencySpectrumDataFFTW& fsData = newData->Of< KTFrequencySpectrumDataFFTW >().SetNComponents(nComponents);
+        bool arrayOrderIsFlipped = fForwardFFT.GetState() != KTForwardFFTW::kR2C;
+        for (unsigned iComponent = 0; iComponent < nComponents; ++iComponent)
+        {
+            fsData.SetSpectrum(new KTFrequencySpectrumFFTW(frequencySize, freqMin, freqMax, arrayOrderIsFlipped), iComponent);
+        }
+
+        if (fOutputPool.size() < fOutputPoolSize)
+        {
+            fOutputPool.push_back(newData);
+        }
+        return newData;
+    }
+
+    bool KTSTFT::AllocateBuffers(unsigned sliceSize, unsigned nComponents)
+    {
+        FreeArrays();
+
+        KTForwardFFTW::State state = fForwardFFT.GetState();
+        if (state == KTForwardFFTW::kR2C)
+        {
+            fRInputArray = (double*) fftw_malloc(sizeof(double) * fWindowSize);
+            if (fRInputArray == NULL) return false;
+        }
+        else
+        {
+            fCInputArray = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * fWindowSize);
+            if (fCInputArray == NULL) return false;
+        }
+
+        // a power of 2, so that positions in the buffers wrap around with a mask
+        fRingCapacity = 1;
+        while (fRingCapacity < fWindowSize + (fUseSlidingDFT ? fHopSize : 0) + sliceSize) fRingCapacity <<= 1;
+
+        fRings.resize(nComponents);
+        for (std::vector< SampleRing >::iterator ringIt = fRings.begin(); ringIt != fRings.end(); ++ringIt)
+        {
+            ringIt->fValues.assign(fRingCapacity * fValuesPerSample, 0.);
+            ringIt->fStart = 0;
+            ringIt->fNSamples = 0;
+        }
+        fStagingArray.resize(sliceSize * fValuesPerSample);
+        return true;
+    }
+
+    void KTSTFT::FreeArrays()
+    {
+        if (fRInputArray != NULL)
+        {
+            fftw_free(fRInputArray);
+            fRInputArray = NULL;
+        }
+        if (fCInputArray != NULL)
+        {
+            fftw_free(fCInputArray);
+            fCInputArray = NULL;
+        }
+        return;
+    }
+
+    void KTSTFT::SlotFunctionRawTS(Nymph::KTDataPtr data)
+    {
+        if (! data->Has< KTSliceHeader >())
+        {
+            KTERROR(stftlog, "Data not found with type < KTSliceHeader >!");
+            return;
+        }
+        if (! data->Has< KTRawTimeSeriesData >())
+        {
+            KTERROR(stftlog, "Data not found with type < KTRawTimeSeriesData >!");
+            return;
+        }
+
+        if (! AddRawData(data->Of< KTSliceHeader >(), data->Of< KTRawTimeSeriesData >()))
+        {
+            KTERROR(stftlog, "Something went wrong while adding raw data to the STFT");
+        }
+        return;
+    }
+
+    void KTSTFT::SlotFunctionTS(Nymph::KTDataPtr data)
+    {
+        if (! data->Has< KTSliceHeader >())
+        {
+            KTERROR(stftlog, "Data not found with type < KTSliceHeader >!");
+            return;
+        }
+        if (! data->Has< KTTimeSeriesData >())
+        {
+            KTERROR(stftlog, "Data not found with type < KTTimeSeriesData >!");
+            return;
+        }
+
+        if (! AddTimeSeriesData(data->Of< KTSliceHeader >(), data->Of< KTTimeSeriesData >()))
+        {
+            KTERROR(stftlog, "Something went wrong while adding a time series to the STFT");
+        }
+        return;
+    }
+
+} /* namespace Katydid */
@@ -0,0 +1,258 @@
+/**
+ @file KTSTFT.hh
+ @brief Contains KTSTFT
+ @details Short-time Fourier transform of a contiguous stream of samples, with any amount of overlap
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTSTFT_HH_
+#define KTSTFT_HH_
+
+#include "KTProcessor.hh"
+
+#include "KTData.hh"
+#include "KTDAC.hh"
+#include "KTForwardFFTW.hh"
+#include "KTMemberVariable.hh"
+#include "KTSlot.hh"
+
+#include <fftw3.h>
+
+#include <complex>
+#include <string>
+#include <vector>
+
+
+namespace Katydid
+{
+
+    class KTEggHeader;
+    class KTFrequencySpectrumDataFFTW;
+    class KTFrequencySpectrumFFTW;
+    class KTRawTimeSeriesData;
+    class KTSliceHeader;
+    class KTTimeSeriesData;
+    class KTWindowFunction;
+
+    /*!
+     @class KTSTFT
+     @author agent
+
+     @brief Short-time Fourier transform with an arbitrary hop size, from a stream of slices that are read only once.
+
+     @details
+     Overlapping spectra can be made by setting the egg processor's "stride" to less than its "slice-size", but then
+     the egg reader copies each sample into several slices, and each slice is converted and transformed from scratch.
+     Instead, this processor takes slices that do not overlap (stride == slice size; this is the most efficient), and keeps the samples
+     of each component in a ring buffer.  Every time "hop-size" new samples are available, the latest "window-size" samples are
+     windowed and transformed, and a new data object is emitted with the spectrum.  The window and FFT sizes do not depend on
+     the egg slice size, and the hop size can be smaller (overlapping windows) or larger (gaps between windows) than the window size.
+
+     If the input slices do overlap (stride < slice size), only the new samples of each slice are used.  Slices with gaps between them
+     (stride > slice size) are not supported.  The buffers are emptied at the start of each acquisition, so windows never span
+     a discontinuity; the samples left over at the end of an acquisition (less than a full window) are dropped.
+
+     Raw time series are converted to voltages by the DAC (as with dac-forward-fftw, increasing the bit depth is not supported).
+     Already-converted real or complex time series can be used instead, via the "ts" slot.
+
+     Each output data object contains a KTSliceHeader and a KTFrequencySpectrumDataFFTW.  The slice header describes the window:
+     the slice size is the window size, the time in run is that of the first sample in the window, the non-overlap fraction is
+     hop-size / window-size, and the slice numbers count the spectra emitted since the processor was initialized.
+     The record and sample numbers are those of the input slice that completed the window.
+
+     To avoid allocating new spectra for every window, up to "output-pool-size" output data objects are kept, and their spectra are
+     reused once nothing else holds them (i.e. once the processors downstream have finished with them and did not keep them).
+     The spectra are moved to a new data object, so each output has only its KTSliceHeader and KTFrequencySpectrumDataFFTW,
+     and none of the extensions that were added downstream to an earlier window.
+     Set "output-pool-size" to 0 to always emit new data objects.
+
+     The transform state is determined as by KTForwardFFTW: from the egg header, unless "transform-state" is given in the "forward-fftw" node.
+
+     With "mode" set to "sliding-dft", the spectrum of each window is updated from that of the previous window instead of being
+     recomputed: for every sample that enters and leaves the window, X_k <-- (X_k + x_new - x_old) exp(2 pi i k / N), which costs
+     hop-size operations per frequency bin.  This pays off for small hops, especially when the update is restricted to a band with
+     "min-frequency" and "max-frequency" (the bins outside of the band are set to zero).  Rounding errors accumulate in the recursive
+     update, so every "resync-interval" spectra the state is recomputed with a full FFT.  The recursive update is only exact for
+     the rectangular window, so other window functions cannot be used in this mode, and the hop size must be smaller than the window size.
+     The output and its normalization are the same as with the full FFT.
+
+     Configuration name: "stft"
+
+     Available configuration values:
+     - "window-size": unsigned int -- number of samples in each FFT (default: 4096)
+     - "hop-size": unsigned int -- number of samples between the starts of consecutive windows (default: 1024, i.e. 75% overlap)
+     - "output-pool-size": unsigned int -- maximum number of output data objects kept for reuse (default: 4)
+     - "mode": string -- "fft" to transform every window, or "sliding-dft" to update the spectrum recursively (default: fft)
+     - "min-frequency": double -- lower edge of the band updated in sliding-dft mode (default: the full spectrum)
+     - "max-frequency": double -- upper edge of the band updated in sliding-dft mode (default: the full spectrum)
+     - "resync-interval": unsigned int -- number of recursively-updated spectra between full FFTs in sliding-dft mode (default: 256)
+     - "dac": nested config -- See KTDAC
+     - "window-function-type": string -- sets the type of window function to be used (default: rectangular, covering the whole window)
+     - "window-function": nested config -- See the window function being used
+     - "forward-fftw": nested config -- See KTForwardFFTW; the STFT is always done in double precision, so "precision": "float" is rejected
+
+     Slots:
+     - "header": void (Nymph::KTDataPtr) -- Initializes the DAC, window function and FFT from an Egg header; Requires KTEggHeader
+     - "raw-ts": void (Nymph::KTDataPtr) -- Adds a slice of raw samples; Requires KTSliceHeader and KTRawTimeSeriesData; Emits signal "fft" for each complete window
+     - "ts": void (Nymph::KTDataPtr) -- Adds a slice of real or complex time series; Requires KTSliceHeader and KTTimeSeriesData; Emits signal "fft" for each complete window
+
+     Signals:
+     - "fft": void (Nymph::KTDataPtr) -- Emitted for each window; Guarantees KTSliceHeader and KTFrequencySpectrumDataFFTW.
+    */
+
+    class KTSTFT : public Nymph::KTProcessor
+    {
+        public:
+            KTSTFT(const std::string& name = "stft");
+            virtual ~KTSTFT();
+
+            bool Configure(const scarab::param_node* node);
+
+            enum Mode
+            {
+                kFFT,
+                kSlidingDFT
+            };
+
+            MEMBERVARIABLE(unsigned, WindowSize);
+            MEMBERVARIABLE(unsigned, HopSize);
+            MEMBERVARIABLE(unsigned, OutputPoolSize);
+
+            MEMBERVARIABLE(Mode, Mode);
+            MEMBERVARIABLE(double, MinFrequency);
+            MEMBERVARIABLE(double, MaxFrequency);
+            MEMBERVARIABLE(unsigned, ResyncInterval);
+
+            MEMBERVARIABLE_NOSET(uint64_t, NSpectra);
+
+            KTDAC* GetDAC();
+            KTForwardFFTW* GetForwardFFT();
+            KTWindowFunction* GetWindowFunction() const;
+
+            bool SelectWindowFunction(const std::string& windowType);
+
+        private:
+            KTDAC fDAC;
+            KTForwardFFTW fForwardFFT;
+            KTWindowFunction* fWindowFunction;
+
+        public:
+            bool InitializeWithHeader(KTEggHeader& header);
+
+            /// Converts a slice of raw samples into the buffers, and emits the spectra of any completed windows
+            bool AddRawData(KTSliceHeader& header, KTRawTimeSeriesData& rawData);
+            /// Copies a slice of real or complex time series into the buffers, and emits the spectra of any completed windows
+            bool AddTimeSeriesData(KTSliceHeader& header, KTTimeSeriesData& tsData);
+
+            /// Empties the buffers; the next slice starts a new stream
+            void Reset();
+
+        private:
+            /// Per-component circular buffer of samples; a complex sample is stored as 2 consecutive values
+            struct SampleRing
+            {
+                std::vector< double > fValues;
+                unsigned fStart; // index of the oldest sample
+                unsigned fNSamples;
+            };
+
+            bool AllocateBuffers(unsigned sliceSize, unsigned nComponents);
+            void FreeArrays();
+
+            /// Starts a slice; returns the number of leading samples of the slice that are already in the buffers (or to be ignored)
+            unsigned StartSlice(const KTSliceHeader& header, unsigned sliceSize, unsigned nComponents);
+            /// Adds the staged samples from firstSample onwards to a component's buffer
+            void PushSamples(unsigned component, unsigned firstSample, unsigned sliceSize);
+            /// Drops samples from the front of all of the buffers
+            void DropSamples(unsigned nSamples);
+            /// Transforms and emits every complete window
+            void EmitWindows(const KTSliceHeader& header);
+            /// Windows the oldest fWindowSize samples of a component into the FFT input array
+            void LoadWindow(unsigned component);
+
+            Nymph::KTDataPtr GetOutputData(unsigned nComponents, double timeBinWidth);
+
+            /// Fills the spectra for the window at the front of the buffers, from the sliding-DFT state or with a full FFT to resynchronize it
+            void ComputeSlidingDFT(KTFrequencySpectrumDataFFTW& fsData);
+            /// Selects the storage indices of the bins in the band, and their twiddle factors
+            void SetUpSlidingDFTBand(const KTFrequencySpectrumFFTW& spectrum);
+            /// Moves the sliding-DFT state forward by nSamples; the buffers must hold fWindowSize + nSamples samples
+            void SlideWindows(unsigned nSamples);
+
+            std::vector< double > fWeights;
+
+            /// 1 for real samples, 2 for complex samples
+            unsigned fValuesPerSample;
+            /// Number of new samples in each slice (the egg stride)
+            unsigned fNewSamplesPerSlice;
+
+            std::vector< SampleRing > fRings;
+            unsigned fRingCapacity; // in samples; a power of 2
+            std::vector< double > fStagingArray;
+
+            double*       fRInputArray;
+            fftw_complex* fCInputArray;
+
+            bool fStreamStarted;
+            /// Samples since the start of the stream, up to the oldest buffered sample
+            uint64_t fRingStartSample;
+            /// Samples that still have to be skipped when the hop is larger than the window
+            unsigned fSamplesToSkip;
+            double fStreamStartTimeInRun;
+            double fStreamStartTimeInAcq;
+            double fTimeBinWidth;
+
+            std::vector< Nymph::KTDataPtr > fOutputPool;
+
+            /// True if the sliding DFT is used (requested, rectangular window, and hop smaller than the window)
+            bool fUseSlidingDFT;
+            /// The window at the front of the buffers has been emitted, and is waiting for fHopSize more samples to slide
+            bool fWindowIsEmitted;
+            bool fSDFTIsValid;
+            unsigned fSpectraSinceResync;
+            double fSDFTBinWidth;
+            /// Same normalization as KTForwardFFTW applies to its output
+            double fSDFTScale;
+            /// Storage (FFTW-order) indices of the bins in the band
+            std::vector< unsigned > fSDFTBins;
+            std::vector< std::complex< double > > fSDFTTwiddles;
+            /// Per-component spectrum of the current window, for the bins in the band
+            std::vector< std::vector< std::complex< double > > > fSDFTStates;
+
+            //***************
+            // Signals
+            //***************
+
+        private:
+            Nymph::KTSignalData fFFTSignal;
+
+            //***************
+            // Slots
+            //***************
+
+        private:
+            Nymph::KTSlotDataOneType< KTEggHeader > fHeaderSlot;
+
+            void SlotFunctionRawTS(Nymph::KTDataPtr data);
+            void SlotFunctionTS(Nymph::KTDataPtr data);
+
+    };
+
+    inline KTDAC* KTSTFT::GetDAC()
+    {
+        return &fDAC;
+    }
+
+    inline KTForwardFFTW* KTSTFT::GetForwardFFT()
+    {
+        return &fForwardFFT;
+    }
+
+    inline KTWindowFunction* KTSTFT::GetWindowFunction() const
+    {
+        return fWindowFunction;
+    }
+
+} /* namespace Katydid */
+#endif /* KTSTFT_HH_ */
@@ -0,0 +1,662 @@
+/**
+ @file KTArrayExpression.hh
+ @brief Contains KTArrayExpression and the element-wise array expression nodes
+ @details Expression templates for element-wise arithmetic on 1-D arrays, evaluated in a single vectorized pass
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTARRAYEXPRESSION_HH_
+#define KTARRAYEXPRESSION_HH_
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace Katydid
+{
+    template< size_t NDims >
+    class KTAxisProperties;
+
+    //***************
+    // SIMD packs
+    //***************
+
+    /*!
+     @class KTSIMD
+     @author agent
+
+     @brief Loads, stores and arithmetic on packs of sWidth values of type XValueType.
+
+     @details
+     The generic version has a width of 1, and a pack is just a value; it only needs the compound assignment operators of XValueType.
+     For double and float, the AVX (4 doubles or 8 floats) or SSE2 (2 doubles or 4 floats) versions are used
+     when Katydid is compiled for a target that supports them.
+     Loads and stores are unaligned, so a pack can start at any element.
+    */
+    template< typename XValueType >
+    struct KTSIMD
+    {
+        typedef XValueType pack_type;
+        static const size_t sWidth = 1;
+
+        static pack_type Load(const XValueType* data) {return *data;}
+        static void Store(XValueType* data, const pack_type& pack) {*data = pack; return;}
+        static pack_type Broadcast(const XValueType& value) {return value;}
+
+        static pack_type Add(const pack_type& lhs, const pack_type& rhs) {pack_type result(lhs); result += rhs; return result;}
+        static pack_type Subtract(const pack_type& lhs, const pack_type& rhs) {pack_type result(lhs); result -= rhs; return result;}
+        static pack_type Multiply(const pack_type& lhs, const pack_type& rhs) {pack_type result(lhs); result *= rhs; return result;}
+        static pack_type Divide(const pack_type& lhs, const pack_type& rhs) {pack_type result(lhs); result /= rhs; return result;}
+        static pack_type Negate(const pack_type& value) {return -value;}
+        static pack_type Sqrt(const pack_type& value) {using std::sqrt; return sqrt(value);}
+    };
+
+#if defined(__AVX__)
+    template<>
+    struct KTSIMD< double >
+    {
+        typedef __m256d pack_type;
+        static const size_t sWidth = 4;
+
+        static pack_type Load(const double* data) {return _mm256_loadu_pd(data);}
+        static void Store(double* data, pack_type pack) {_mm256_storeu_pd(data, pack); return;}
+        static pack_type Broadcast(double value) {return _mm256_set1_pd(value);}
+
+        static pack_type Add(pack_type lhs, pack_type rhs) {return _mm256_add_pd(lhs, rhs);}
+        static pack_type Subtract(pack_type lhs, pack_type rhs) {return _mm256_sub_pd(lhs, rhs);}
+        static pack_type Multiply(pack_type lhs, pack_type rhs) {return _mm256_mul_pd(lhs, rhs);}
+        static pack_type Divide(pack_type lhs, pack_type rhs) {return _mm256_div_pd(lhs, rhs);}
+        static pack_type Negate(pack_type value) {return _mm256_xor_pd(value, _mm256_set1_pd(-0.));}
+        static pack_type Sqrt(pack_type value) {return _mm256_sqrt_pd(value);}
+    };
+
+    template<>
+    struct KTSIMD< float >
+    {
+        typedef __m256 pack_type;
+        static const size_t sWidth = 8;
+
+        static pack_type Load(const float* data) {return _mm256_loadu_ps(data);}
+        static void Store(float* data, pack_type pack) {_mm256_storeu_ps(data, pack); return;}
+        static pack_type Broadcast(float value) {return _mm256_set1_ps(value);}
+
+        static pack_type Add(pack_type lhs, pack_type rhs) {return _mm256_add_ps(lhs, rhs);}
+        static pack_type Subtract(pack_type lhs, pack_type rhs) {return _mm256_sub_ps(lhs, rhs);}
+        static pack_type Multiply(pack_type lhs, pack_type rhs) {return _mm256_mul_ps(lhs, rhs);}
+        static pack_type Divide(pack_type lhs, pack_type rhs) {return _mm256_div_ps(lhs, rhs);}
+        static pack_type Negate(pack_type value) {return _mm256_xor_ps(value, _mm256_set1_ps(-0.f));}
+        static pack_type Sqrt(pack_type value) {return _mm256_sqrt_ps(value);}
+    };
+#elif defined(__SSE2__)
+    template<>
+    struct KTSIMD< double >
+    {
+        typedef __m128d pack_type;
+        static const size_t sWidth = 2;
+
+        static pack_type Load(const double* data) {return _mm_loadu_pd(data);}
+        static void Store(double* data, pack_type pack) {_mm_storeu_pd(data, pack); return;}
+        static pack_type Broadcast(double value) {return _mm_set1_pd(value);}
+
+        static pack_type Add(pack_type lhs, pack_type rhs) {return _mm_add_pd(lhs, rhs);}
+        static pack_type Subtract(pack_type lhs, pack_type rhs) {return _mm_sub_pd(lhs, rhs);}
+        static pack_type Multiply(pack_type lhs, pack_type rhs) {return _mm_mul_pd(lhs, rhs);}
+        static pack_type Divide(pack_type lhs, pack_type rhs) {return _mm_div_pd(lhs, rhs);}
+        static pack_type Negate(pack_type value) {return _mm_xor_pd(value, _mm_set1_pd(-0.));}
+        static pack_type Sqrt(pack_type value) {return _mm_sqrt_pd(value);}
+    };
+
+    template<>
+    struct KTSIMD< float >
+    {
+        typedef __m128 pack_type;
+        static const size_t sWidth = 4;
+
+        static pack_type Load(const float* data) {return _mm_loadu_ps(data);}
+        static void Store(float* data, pack_type pack) {_mm_storeu_ps(data, pack); return;}
+        static pack_type Broadcast(float value) {return _mm_set1_ps(value);}
+
+        static pack_type Add(pack_type lhs, pack_type rhs) {return _mm_add_ps(lhs, rhs);}
+        static pack_type Subtract(pack_type lhs, pack_type rhs) {return _mm_sub_ps(lhs, rhs);}
+        static pack_type Multiply(pack_type lhs, pack_type rhs) {return _mm_mul_ps(lhs, rhs);}
+        static pack_type Divide(pack_type lhs, pack_type rhs) {return _mm_div_ps(lhs, rhs);}
+        static pack_type Negate(pack_type value) {return _mm_xor_ps(value, _mm_set1_ps(-0.f));}
+        static pack_type Sqrt(pack_type value) {return _mm_sqrt_ps(value);}
+    };
+#endif
+
+
+    //***************
+    // Operations
+    //***************
+
+    // Each operation applies to single values (Apply) and to packs (ApplyPack)
+
+    struct KTArrayAdd
+    {
+        template< typename XValueType >
+        static XValueType Apply(const XValueType& lhs, const XValueType& rhs) {XValueType result(lhs); result += rhs; return result;}
+        template< typename XValueType >
+        static typename KTSIMD< XValueType >::pack_type ApplyPack(const typename KTSIMD< XValueType >::pack_type& lhs, const typename KTSIMD< XValueType >::pack_type& rhs) {return KTSIMD< XValueType >::Add(lhs, rhs);}
+    };
+
+    struct KTArraySubtract
+    {
+        template< typename XValueType >
+        static XValueType Apply(const XValueType& lhs, const XValueType& rhs) {XValueType result(lhs); result -= rhs; return result;}
+        template< typename XValueType >
+        static typename KTSIMD< XValueType >::pack_type ApplyPack(const typename KTSIMD< XValueType >::pack_type& lhs, const typename KTSIMD< XValueType >::pack_type& rhs) {return KTSIMD< XValueType >::Subtract(lhs, rhs);}
+    };
+
+    struct KTArrayMultiply
+    {
+        template< typename XValueType >
+        static XValueType Apply(const XValueType& lhs, const XValueType& rhs) {XValueType result(lhs); result *= rhs; return result;}
+        template< typename XValueType >
+        static typename KTSIMD< XValueType >::pack_type ApplyPack(const typename KTSIMD< XValueType >::pack_type& lhs, const typename KTSIMD< XValueType >::pack_type& rhs) {return KTSIMD< XValueType >::Multiply(lhs, rhs);}
+    };
+
+    struct KTArrayDivide
+    {
+        template< typename XValueType >
+        static XValueType Apply(const XValueType& lhs, const XValueType& rhs) {XValueType result(lhs); result /= rhs; return result;}
+        template< typename XValueType >
+        static typename KTSIMD< XValueType >::pack_type ApplyPack(const typename KTSIMD< XValueType >::pack_type& lhs, const typename KTSIMD< XValueType >::pack_type& rhs) {return KTSIMD< XValueType >::Divide(lhs, rhs);}
+    };
+
+    struct KTArrayNegate
+    {
+        template< typename XValueType >
+        static XValueType Apply(const XValueType& value) {return -value;}
+        template< typename XValueType >
+        static typename KTSIMD< XValueType >::pack_type ApplyPack(const typename KTSIMD< XValueType >::pack_type& value) {return KTSIMD< XValueType >::Negate(value);}
+    };
+
+    struct KTArraySquareRoot
+    {
+        template< typename XValueType >
+        static XValueType Apply(const XValueType& value) {using std::sqrt; return sqrt(value);}
+        template< typename XValueType >
+        static typename KTSIMD< XValueType >::pack_type ApplyPack(const typename KTSIMD< XValueType >::pack_type& value) {return KTSIMD< XValueType >::Sqrt(value);}
+    };
+
+
+    //***************
+    // Expressions
+    //***************
+
+    /*!
+     @class KTArrayExpression
+     @author agent
+
+     @brief Base class of the nodes of element-wise array expressions.
+
+     @details
+     Arithmetic on 1-D arrays (KTPhysicalArray< 1, XDataType > and the classes derived from it) does not calculate anything right away;
+     it builds a light-weight expression object that refers to the arrays.  The expression is calculated when it is assigned to an array
+     (KTPhysicalArray< 1, XDataType >::operator=(), Assign(), or one of the compound assignment operators) or evaluated with KTArrayEvaluate().
+     The whole expression is calculated in a single pass over the bins, with no temporary arrays, using SIMD packs (see KTSIMD) for most of the bins.
+     For example,
+
+         normalized = mean + (spectrum - baseline) * KTArraySqrt(variance / baselineVariance);
+
+     reads each input bin once and writes each output bin once.
+
+     Available operations:
+     - +, -, *, / between two arrays or expressions, or between an array or expression and a scalar
+     - unary -
+     - KTArraySqrt()
+
+     All of the arrays in an expression must have the same value type and size; scalars are converted to the value type of the arrays.
+     As with the array operators that expressions replaced, an expression of arrays of different sizes has a size of 0, and gives an empty array.
+     An expression can also initialize a new array (e.g. KTPhysicalArray< 1, double > sum = a + b;), which takes the axis range and label
+     of the left-most array in the expression, as the result of a + b did before expressions were added.
+     Assigning an expression to an array of a different size resizes the array, and an expression can be printed (std::cout << a + b),
+     which evaluates it into a temporary array.
+     Expressions hold pointers to the arrays' data, so they should be evaluated before any of the arrays are resized or destroyed;
+     the output array may be one of the inputs.
+
+     Each node provides value_type, size(), Get(i) (the value of bin i), GetPack(i) (the values of bins i to i + KTSIMD< value_type >::sWidth - 1),
+     and GetAxis() (the axis of the left-most array in the node, or NULL if there is none).
+    */
+    template< typename XDerived >
+    class KTArrayExpression
+    {
+        public:
+            const XDerived& Derived() const;
+    };
+
+    /*!
+     @class KTArrayRef
+     @author agent
+
+     @brief Expression node for a contiguous range of array data
+
+     @details
+     Arrays are included in expressions with this node, along with their axes.  It can also be made directly, to use part of an array (e.g. a range of bins) in an expression;
+     in that case there is no axis unless one is given.
+    */
+    template< typename XValueType >
+    class KTArrayRef : public KTArrayExpression< KTArrayRef< XValueType > >
+    {
+        public:
+            typedef XValueType value_type;
+            typedef typename KTSIMD< XValueType >::pack_type pack_type;
+            static const bool sIsScalar = false;
+
+        public:
+            KTArrayRef(const XValueType* data, size_t size, const KTAxisProperties< 1 >* axis = NULL);
+
+            size_t size() const;
+            value_type Get(size_t i) const;
+            pack_type GetPack(size_t i) const;
+            const KTAxisProperties< 1 >* GetAxis() const;
+
+        private:
+            const XValueType* fData;
+            size_t fSize;
+            const KTAxisProperties< 1 >* fAxis;
+    };
+
+    /*!
+     @class KTArrayScalar
+     @author agent
+
+     @brief Expression node for a value that is the same for every bin
+    */
+    template< typename XValueType >
+    class KTArrayScalar : public KTArrayExpression< KTArrayScalar< XValueType > >
+    {
+        public:
+            typedef XValueType value_type;
+            typedef typename KTSIMD< XValueType >::pack_type pack_type;
+            static const bool sIsScalar = true;
+
+        public:
+            KTArrayScalar(const XValueType& value);
+
+            /// A scalar takes the size of the array it's combined with; this returns 0
+            size_t size() const;
+            value_type Get(size_t i) const;
+            pack_type GetPack(size_t i) const;
+            const KTAxisProperties< 1 >* GetAxis() const;
+
+        private:
+            XValueType fValue;
+    };
+
+    /*!
+     @class KTArrayBinaryExpression
+     @author agent
+
+     @brief Expression node for an operation with two operands
+    */
+    template< typename XOperation, typename XLeft, typename XRight >
+    class KTArrayBinaryExpression : public KTArrayExpression< KTArrayBinaryExpression< XOperation, XLeft, XRight > >
+    {
+            static_assert(std::is_same< typename XLeft::value_type, typename XRight::value_type >::value, "The arrays in an expression must have the same value type");
+
+        public:
+            typedef typename XLeft::value_type value_type;
+            typedef typename KTSIMD< value_type >::pack_type pack_type;
+            static const bool sIsScalar = false;
+
+        public:
+            KTArrayBinaryExpression(const XLeft& lhs, const XRight& rhs);
+
+            /// Returns 0 if the sizes of the two operands do not match
+            size_t size() const;
+            value_type Get(size_t i) const;
+            pack_type GetPack(size_t i) const;
+            const KTAxisProperties< 1 >* GetAxis() const;
+
+        private:
+            XLeft fLeft;
+            XRight fRight;
+            size_t fSize;
+    };
+
+    /*!
+     @class KTArrayUnaryExpression
+     @author agent
+
+     @brief Expression node for an operation with one operand
+    */
+    template< typename XOperation, typename XOperand >
+    class KTArrayUnaryExpression : public KTArrayExpression< KTArrayUnaryExpression< XOperation, XOperand > >
+    {
+        public:
+            typedef typename XOperand::value_type value_type;
+            typedef typename KTSIMD< value_type >::pack_type pack_type;
+            static const bool sIsScalar = false;
+
+        public:
+            KTArrayUnaryExpression(const XOperand& operand);
+
+            size_t size() const;
+            value_type Get(size_t i) const;
+            pack_type GetPack(size_t i) const;
+            const KTAxisProperties< 1 >* GetAxis() const;
+
+        private:
+            XOperand fOperand;
+    };
+
+
+    /// Calculates the expression and writes it to output, which must have room for expression.size() values
+    template< typename XValueType, typename XExpression >
+    void KTArrayEvaluate(XValueType* output, const KTArrayExpression< XExpression >& expression);
+
+
+    //***************
+    // Operands
+    //***************
+
+    // KTArrayOperand() converts anything that can be used in an expression to its expression node.
+    // Expressions are used as they are; KTPhysicalArray.hh adds the overload for 1-D arrays.
+
+    template< typename XExpression >
+    const XExpression& KTArrayOperand(const KTArrayExpression< XExpression >& expression);
+
+    // Kinds of operands: 0 = not an operand; 1 = array or expression; 2 = scalar
+    template< typename XOperand, typename = void >
+    struct KTArrayOperandKind
+    {
+        static const int value = std::is_arithmetic< XOperand >::value ? 2 : 0;
+    };
+
+    template< typename XOperand >
+    struct KTArrayOperandKind< XOperand, decltype(void(KTArrayOperand(std::declval< const XOperand& >()))) >
+    {
+        static const int value = 1;
+    };
+
+    template< typename XOperand >
+    struct KTArrayNode
+    {
+        typedef typename std::decay< decltype(KTArrayOperand(std::declval< const XOperand& >())) >::type type;
+    };
+
+    // Type and construction of the node for XOperation applied to XLeft and XRight; empty if neither is an array or expression
+    template< typename XOperation, typename XLeft, typename XRight, int XLeftKind = KTArrayOperandKind< XLeft >::value, int XRightKind = KTArrayOperandKind< XRight >::value >
+    struct KTArrayBinaryNode
+    {};
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    struct KTArrayBinaryNode< XOperation, XLeft, XRight, 1, 1 >
+    {
+        typedef KTArrayBinaryExpression< XOperation, typename KTArrayNode< XLeft >::type, typename KTArrayNode< XRight >::type > type;
+        static type Make(const XLeft& lhs, const XRight& rhs) {return type(KTArrayOperand(lhs), KTArrayOperand(rhs));}
+    };
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    struct KTArrayBinaryNode< XOperation, XLeft, XRight, 1, 2 >
+    {
+        typedef typename KTArrayNode< XLeft >::type left_type;
+        typedef KTArrayScalar< typename left_type::value_type > right_type;
+        typedef KTArrayBinaryExpression< XOperation, left_type, right_type > type;
+        static type Make(const XLeft& lhs, const XRight& rhs) {return type(KTArrayOperand(lhs), right_type(rhs));}
+    };
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    struct KTArrayBinaryNode< XOperation, XLeft, XRight, 2, 1 >
+    {
+        typedef typename KTArrayNode< XRight >::type right_type;
+        typedef KTArrayScalar< typename right_type::value_type > left_type;
+        typedef KTArrayBinaryExpression< XOperation, left_type, right_type > type;
+        static type Make(const XLeft& lhs, const XRight& rhs) {return type(left_type(lhs), KTArrayOperand(rhs));}
+    };
+
+    template< typename XOperation, typename XOperand, int XKind = KTArrayOperandKind< XOperand >::value >
+    struct KTArrayUnaryNode
+    {};
+
+    template< typename XOperation, typename XOperand >
+    struct KTArrayUnaryNode< XOperation, XOperand, 1 >
+    {
+        typedef KTArrayUnaryExpression< XOperation, typename KTArrayNode< XOperand >::type > type;
+        static type Make(const XOperand& operand) {return type(KTArrayOperand(operand));}
+    };
+
+
+    //***************
+    // Operators
+    //***************
+
+    template< typename XLeft, typename XRight >
+    typename KTArrayBinaryNode< KTArrayAdd, XLeft, XRight >::type operator+(const XLeft& lhs, const XRight& rhs);
+
+    template< typename XLeft, typename XRight >
+    typename KTArrayBinaryNode< KTArraySubtract, XLeft, XRight >::type operator-(const XLeft& lhs, const XRight& rhs);
+
+    template< typename XLeft, typename XRight >
+    typename KTArrayBinaryNode< KTArrayMultiply, XLeft, XRight >::type operator*(const XLeft& lhs, const XRight& rhs);
+
+    template< typename XLeft, typename XRight >
+    typename KTArrayBinaryNode< KTArrayDivide, XLeft, XRight >::type operator/(const XLeft& lhs, const XRight& rhs);
+
+    template< typename XOperand >
+    typename KTArrayUnaryNode< KTArrayNegate, XOperand >::type operator-(const XOperand& operand);
+
+    /// Element-wise square root of an array or expression
+    template< typename XOperand >
+    typename KTArrayUnaryNode< KTArraySquareRoot, XOperand >::type KTArraySqrt(const XOperand& operand);
+
+
+    //***************
+    // Implementation
+    //***************
+
+    template< typename XDerived >
+    inline const XDerived& KTArrayExpression< XDerived >::Derived() const
+    {
+        return static_cast< const XDerived& >(*this);
+    }
+
+
+    template< typename XValueType >
+    inline KTArrayRef< XValueType >::KTArrayRef(const XValueType* data, size_t size, const KTAxisProperties< 1 >* axis) :
+            fData(data),
+            fSize(size),
+            fAxis(axis)
+    {
+    }
+
+    template< typename XValueType >
+    inline size_t KTArrayRef< XValueType >::size() const
+    {
+        return fSize;
+    }
+
+    template< typename XValueType >
+    inline typename KTArrayRef< XValueType >::value_type KTArrayRef< XValueType >::Get(size_t i) const
+    {
+        return fData[i];
+    }
+
+    template< typename XValueType >
+    inline typename KTArrayRef< XValueType >::pack_type KTArrayRef< XValueType >::GetPack(size_t i) const
+    {
+        return KTSIMD< XValueType >::Load(fData + i);
+    }
+
+    template< typename XValueType >
+    inline const KTAxisProperties< 1 >* KTArrayRef< XValueType >::GetAxis() const
+    {
+        return fAxis;
+    }
+
+
+    template< typename XValueType >
+    inline KTArrayScalar< XValueType >::KTArrayScalar(const XValueType& value) :
+            fValue(value)
+    {
+    }
+
+    template< typename XValueType >
+    inline size_t KTArrayScalar< XValueType >::size() const
+    {
+        return 0;
+    }
+
+    template< typename XValueType >
+    inline typename KTArrayScalar< XValueType >::value_type KTArrayScalar< XValueType >::Get(size_t) const
+    {
+        return fValue;
+    }
+
+    template< typename XValueType >
+    inline typename KTArrayScalar< XValueType >::pack_type KTArrayScalar< XValueType >::GetPack(size_t) const
+    {
+        return KTSIMD< XValueType >::Broadcast(fValue);
+    }
+
+    template< typename XValueType >
+    inline const KTAxisProperties< 1 >* KTArrayScalar< XValueType >::GetAxis() const
+    {
+        return NULL;
+    }
+
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    inline KTArrayBinaryExpression< XOperation, XLeft, XRight >::KTArrayBinaryExpression(const XLeft& lhs, const XRight& rhs) :
+            fLeft(lhs),
+            fRight(rhs),
+            fSize(XLeft::sIsScalar ? rhs.size() : lhs.size())
+    {
+        if (! XLeft::sIsScalar && ! XRight::sIsScalar && lhs.size() != rhs.size())
+        {
+            fSize = 0;
+        }
+    }
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    inline size_t KTArrayBinaryExpression< XOperation, XLeft, XRight >::size() const
+    {
+        return fSize;
+    }
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    inline typename KTArrayBinaryExpression< XOperation, XLeft, XRight >::value_type KTArrayBinaryExpression< XOperation, XLeft, XRight >::Get(size_t i) const
+    {
+        return XOperation::template Apply< value_type >(fLeft.Get(i), fRight.Get(i));
+    }
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    inline typename KTArrayBinaryExpression< XOperation, XLeft, XRight >::pack_type KTArrayBinaryExpression< XOperation, XLeft, XRight >::GetPack(size_t i) const
+    {
+        return XOperation::template ApplyPack< value_type >(fLeft.GetPack(i), fRight.GetPack(i));
+    }
+
+    template< typename XOperation, typename XLeft, typename XRight >
+    inline const KTAxisProperties< 1 >* KTArrayBinaryExpression< XOperation, XLeft, XRight >::GetAxis() const
+    {
+        const KTAxisProperties< 1 >* axis = fLeft.GetAxis();
+        return axis != NULL ? axis : fRight.GetAxis();
+    }
+
+
+    template< typename XOperation, typename XOperand >
+    inline KTArrayUnaryExpression< XOperation, XOperand >::KTArrayUnaryExpression(const XOperand& operand) :
+            fOperand(operand)
+    {
+    }
+
+    template< typename XOperation, typename XOperand >
+    inline size_t KTArrayUnaryExpression< XOperation, XOperand >::size() const
+    {
+        return fOperand.size();
+    }
+
+    template< typename XOperation, typename XOperand >
+    inline typename KTArrayUnaryExpression< XOperation, XOperand >::value_type KTArrayUnaryExpression< XOperation, XOperand >::Get(size_t i) const
+    {
+        return XOperation::template Apply< value_type >(fOperand.Get(i));
+    }
+
+    template< typename XOperation, typename XOperand >
+    inline typename KTArrayUnaryExpression< XOperation, XOperand >::pack_type KTArrayUnaryExpression< XOperation, XOperand >::GetPack(size_t i) const
+    {
+        return XOperation::template ApplyPack< value_type >(fOperand.GetPack(i));
+    }
+
+    template< typename XOperation, typename XOperand >
+    inline const KTAxisProperties< 1 >* KTArrayUnaryExpression< XOperation, XOperand >::GetAxis() const
+    {
+        return fOperand.GetAxis();
+    }
+
+
+    template< typename XValueType, typename XExpression >
+    void KTArrayEvaluate(XValueType* output, const KTArrayExpression< XExpression >& expression)
+    {
+        static_assert(std::is_same< XValueType, typename XExpression::value_type >::value, "The output of an expression must have the same value type as the expression");
+        typedef KTSIMD< XValueType > XSIMD;
+
+        const XExpression& expr = expression.Derived();
+        size_t size = expr.size();
+        size_t nPacks = size / XSIMD::sWidth;
+#pragma omp parallel for
+        for (size_t iPack = 0; iPack < nPacks; ++iPack)
+        {
+            XSIMD::Store(output + iPack * XSIMD::sWidth, expr.GetPack(iPack * XSIMD::sWidth));
+        }
+        for (size_t iBin = nPacks * XSIMD::sWidth; iBin < size; ++iBin)
+        {
+            output[iBin] = expr.Get(iBin);
+        }
+        return;
+    }
+
+
+    template< typename XExpression >
+    inline const XExpression& KTArrayOperand(const KTArrayExpression< XExpression >& expression)
+    {
+        return expression.Derived();
+    }
+
+
+    template< typename XLeft, typename XRight >
+    inline typename KTArrayBinaryNode< KTArrayAdd, XLeft, XRight >::type operator+(const XLeft& lhs, const XRight& rhs)
+    {
+        return KTArrayBinaryNode< KTArrayAdd, XLeft, XRight >::Make(lhs, rhs);
+    }
+
+    template< typename XLeft, typename XRight >
+    inline typename KTArrayBinaryNode< KTArraySubtract, XLeft, XRight >::type operator-(const XLeft& lhs, const XRight& rhs)
+    {
+        return KTArrayBinaryNode< KTArraySubtract, XLeft, XRight >::Make(lhs, rhs);
+    }
+
+    template< typename XLeft, typename XRight >
+    inline typename KTArrayBinaryNode< KTArrayMultiply, XLeft, XRight >::type operator*(const XLeft& lhs, const XRight& rhs)
+    {
+        return KTArrayBinaryNode< KTArrayMultiply, XLeft, XRight >::Make(lhs, rhs);
+    }
+
+    template< typename XLeft, typename XRight >
+    inline typename KTArrayBinaryNode< KTArrayDivide, XLeft, XRight >::type operator/(const XLeft& lhs, const XRight& rhs)
+    {
+        return KTArrayBinaryNode< KTArrayDivide, XLeft, XRight >::Make(lhs, rhs);
+    }
+
+    template< typename XOperand >
+    inline typename KTArrayUnaryNode< KTArrayNegate, XOperand >::type operator-(const XOperand& operand)
+    {
+        return KTArrayUnaryNode< KTArrayNegate, XOperand >::Make(operand);
+    }
+
+    template< typename XOperand >
+    inline typename KTArrayUnaryNode< KTArraySquareRoot, XOperand >::type KTArraySqrt(const XOperand& operand)
+    {
+        return KTArrayUnaryNode< KTArraySquareRoot, XOperand >::Make(operand);
+    }
+
+} /* namespace Katydid */
+#endif /* KTARRAYEXPRESSION_HH_ */
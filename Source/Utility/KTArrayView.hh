@@ -0,0 +1,191 @@
+/**
+ @file KTArrayView.hh
+ @brief Contains KTArrayRowView and KTArrayBlockView
+ @details Non-owning views of rows and rectangular blocks of row-major 2-D storage
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTARRAYVIEW_HH_
+#define KTARRAYVIEW_HH_
+
+#include <cstddef>
+
+namespace Katydid
+{
+
+    /*!
+     @class KTArrayRowView
+     @author agent
+
+     @brief Non-owning view of one contiguous row of a 2-D array.
+
+     @details
+     The view is a pointer and a length; it is only valid as long as the array it was taken from is not resized or destroyed.
+     For a const array, use KTArrayRowView< const XDataType >.
+    */
+    template< typename XDataType >
+    class KTArrayRowView
+    {
+        public:
+            typedef XDataType value_type;
+            typedef XDataType* iterator;
+
+        public:
+            KTArrayRowView(XDataType* data, size_t size);
+
+            XDataType* GetData() const;
+            size_t size() const;
+            bool empty() const;
+
+            XDataType& operator[](size_t i) const;
+
+            iterator begin() const;
+            iterator end() const;
+
+        private:
+            XDataType* fData;
+            size_t fSize;
+    };
+
+    /*!
+     @class KTArrayBlockView
+     @author agent
+
+     @brief Non-owning view of a rectangular block (a range of rows and columns) of a row-major 2-D array.
+
+     @details
+     Element (iRow, iColumn) of the block is at GetData()[iRow * GetStride() + iColumn].  Each row of the block is contiguous;
+     the rows are GetStride() elements apart, and the stride can include padding after the last column, so even a block of whole rows
+     is not necessarily contiguous (see IsContiguous()).
+     The view is only valid as long as the array it was taken from is not resized or destroyed.
+     For a const array, use KTArrayBlockView< const XDataType >.
+    */
+    template< typename XDataType >
+    class KTArrayBlockView
+    {
+        public:
+            typedef XDataType value_type;
+
+        public:
+            KTArrayBlockView(XDataType* data, size_t nRows, size_t nColumns, size_t stride);
+
+            /// Pointer to the first element of the block
+            XDataType* GetData() const;
+            size_t GetNRows() const;
+            size_t GetNColumns() const;
+            /// Distance, in elements, between the starts of consecutive rows
+            size_t GetStride() const;
+
+            /// True if the block has no gaps between its rows
+            bool IsContiguous() const;
+
+            XDataType& operator()(size_t iRow, size_t iColumn) const;
+
+            KTArrayRowView< XDataType > GetRow(size_t iRow) const;
+
+        private:
+            XDataType* fData;
+            size_t fNRows;
+            size_t fNColumns;
+            size_t fStride;
+    };
+
+
+    template< typename XDataType >
+    KTArrayRowView< XDataType >::KTArrayRowView(XDataType* data, size_t size) :
+            fData(data),
+            fSize(size)
+    {
+    }
+
+    template< typename XDataType >
+    inline XDataType* KTArrayRowView< XDataType >::GetData() const
+    {
+        return fData;
+    }
+
+    template< typename XDataType >
+    inline size_t KTArrayRowView< XDataType >::size() const
+    {
+        return fSize;
+    }
+
+    template< typename XDataType >
+    inline bool KTArrayRowView< XDataType >::empty() const
+    {
+        return fSize == 0;
+    }
+
+    template< typename XDataType >
+    inline XDataType& KTArrayRowView< XDataType >::operator[](size_t i) const
+    {
+        return fData[i];
+    }
+
+    template< typename XDataType >
+    inline typename KTArrayRowView< XDataType >::iterator KTArrayRowView< XDataType >::begin() const
+    {
+        return fData;
+    }
+
+    template< typename XDataType >
+    inline typename KTArrayRowView< XDataType >::iterator KTArrayRowView< XDataType >::end() const
+    {
+        return fData + fSize;
+    }
+
+
+    template< typename XDataType >
+    KTArrayBlockView< XDataType >::KTArrayBlockView(XDataType* data, size_t nRows, size_t nColumns, size_t stride) :
+            fData(data),
+            fNRows(nRows),
+            fNColumns(nColumns),
+            fStride(stride)
+    {
+    }
+
+    template< typename XDataType >
+    inline XDataType* KTArrayBlockView< XDataType >::GetData() const
+    {
+        return fData;
+    }
+
+    template< typename XDataType >
+    inline size_t KTArrayBlockView< XDataType >::GetNRows() const
+    {
+        return fNRows;
+    }
+
+    template< typename XDataType >
+    inline size_t KTArrayBlockView< XDataType >::GetNColumns() const
+    {
+        return fNColumns;
+    }
+
+    template< typename XDataType >
+    inline size_t KTArrayBlockView< XDataType >::GetStride() const
+    {
+        return fStride;
+    }
+
+    template< typename XDataType >
+    inline bool KTArrayBlockView< XDataType >::IsContiguous() const
+    {
+        return fStride == fNColumns || fNRows <= 1;
+    }
+
+    template< typename XDataType >
+    inline XDataType& KTArrayBlockView< XDataType >::operator()(size_t iRow, size_t iColumn) const
+    {
+        return fData[iRow * fStride + iColumn];
+    }
+
+    template< typename XDataType >
+    inline KTArrayRowView< XDataType > KTArrayBlockView< XDataType >::GetRow(size_t iRow) const
+    {
+        return KTArrayRowView< XDataType >(fData + iRow * fStride, fNColumns);
+    }
+
+} /* namespace Katydid */
+#endif /* KTARRAYVIEW_HH_ */
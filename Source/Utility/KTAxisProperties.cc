@@ -49,7 +49,7 @@ namespace Katydid
 
     KTAxisProperties< 1 >& KTAxisProperties< 1 >::operator=(const KTAxisProperties< 1 >& orig)
     {
-        fGetNBinsFunc = orig.fGetNBinsFunc->Clone();
+        SetNBinsFunc(orig.fGetNBinsFunc->Clone());
         fBinWidth = orig.GetBinWidth();
         fRangeMin = orig.GetRangeMin();
         fRangeMax = orig.GetRangeMax();
@@ -57,6 +57,16 @@ namespace Katydid
         return *this;
     }
 
+    void KTAxisProperties< 1 >::SwapAxes(KTAxisProperties< 1 >& other)
+    {
+        std::swap(fGetNBinsFunc, other.fGetNBinsFunc);
+        std::swap(fBinWidth, other.fBinWidth);
+        std::swap(fRangeMin, other.fRangeMin);
+        std::swap(fRangeMax, other.fRangeMax);
+        fLabel.swap(other.fLabel);
+        return;
+    }
+
     bool KTAxisProperties< 1 >::empty() const
     {
         return size() == 0;
@@ -12,7 +12,9 @@
 #include "KTAxisProperties_GetNBins.hh"
 
 #include <cmath>
+#include <string>
 #include <sys/types.h>
+#include <utility>
 
 namespace Katydid
 {
@@ -71,6 +73,10 @@ namespace Katydid
             void SetRange(size_t dim, double min, double max);
             void SetRange(const double* mins, const double* maxes);
 
+        protected:
+            /// Exchanges the bin functor, ranges, and labels with another axis, without copying (for moves in derived classes)
+            void SwapAxes(KTAxisProperties< NDims >& other);
+
         protected:
             const KTNBinsFunctor< NDims >* fGetNBinsFunc;
             double fBinWidths[NDims];
@@ -155,10 +161,24 @@ namespace Katydid
         return NDims;
     }
 
+    template< size_t NDims >
+    void KTAxisProperties< NDims >::SwapAxes(KTAxisProperties< NDims >& other)
+    {
+        std::swap(fGetNBinsFunc, other.fGetNBinsFunc);
+        for (size_t arrPos=0; arrPos < NDims; arrPos++)
+        {
+            std::swap(fBinWidths[arrPos], other.fBinWidths[arrPos]);
+            std::swap(fRangeMin[arrPos], other.fRangeMin[arrPos]);
+            std::swap(fRangeMax[arrPos], other.fRangeMax[arrPos]);
+            fLabels[arrPos].swap(other.fLabels[arrPos]);
+        }
+        return;
+    }
+
     template< size_t NDims >
     KTAxisProperties< NDims >& KTAxisProperties< NDims >::operator=(const KTAxisProperties< NDims >& orig)
     {
-        fGetNBinsFunc = orig.fGetNBinsFunc->Clone();
+        SetNBinsFunc(orig.fGetNBinsFunc->Clone());
         size_t arrPos;
         for (size_t iDim=1; iDim <= NDims; iDim++)
         {
@@ -303,7 +323,7 @@ namespace Katydid
     ssize_t KTAxisProperties< NDims >::FindBin(size_t dim, double pos) const
     {
         return pos < fRangeMin[dim-1] ? 0 :
-                pos >= fRangeMax[dim-1] ? size(dim-1) - 1 :
+                pos >= fRangeMax[dim-1] ? size(dim) - 1 :
                         (ssize_t)(floor((pos - fRangeMin[dim-1]) / fBinWidths[dim-1]));
     }
 
@@ -374,6 +394,10 @@ namespace Katydid
             void SetRangeMax(double max);
             void SetRange(double min, double max);
 
+        protected:
+            /// Exchanges the bin functor, range, and label with another axis, without copying (for moves in derived classes)
+            void SwapAxes(KTAxisProperties< 1 >& other);
+
         protected:
             KTNBinsFunctor< 1 >* fGetNBinsFunc;
             double fBinWidth;
@@ -144,7 +144,10 @@ namespace Katydid
                     fNBins[arrPos] = nBins[arrPos];
                 }
             }
-            virtual ~KTNBinsInArray() {}
+            virtual ~KTNBinsInArray()
+            {
+                delete [] fNBins;
+            }
 
             virtual size_t operator()(size_t dim=1) const
             {
@@ -0,0 +1,312 @@
+/*
+ * KTBufferPool.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTBufferPool.hh"
+
+#include "KTLogger.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+namespace Katydid
+{
+    KTLOGGER(poollog, "KTBufferPool");
+
+    namespace
+    {
+        const size_t sAlignment = 64;
+        // each block starts with a header (one alignment unit) that records its size class; the magic number is cleared when
+        // the block is released, so that a second release can be caught
+        const size_t sHeaderSize = sAlignment;
+
+        // four classes per power of 2, from 256 bytes to 1 GiB; every class size is a multiple of the alignment
+        const unsigned sSubClassesPerOctave = 4;
+        const unsigned sMinShift = 8;
+        const unsigned sMaxShift = 30;
+        const unsigned sNClasses = (sMaxShift - sMinShift) * sSubClassesPerOctave + 1;
+        const unsigned sUnpooled = sNClasses;
+
+        const uint32_t sMagic = 0x4b54424d;
+
+        struct BlockHeader
+        {
+            uint32_t fMagic;
+            uint32_t fClass;
+            size_t fSize;
+        };
+
+        size_t ClassSize(unsigned sizeClass)
+        {
+            size_t octaveBase = size_t(1) << (sMinShift + sizeClass / sSubClassesPerOctave);
+            return octaveBase / sSubClassesPerOctave * (sSubClassesPerOctave + sizeClass % sSubClassesPerOctave);
+        }
+
+        unsigned FindClass(size_t blockSize)
+        {
+            if (blockSize <= (size_t(1) << sMinShift)) return 0;
+            if (blockSize > (size_t(1) << sMaxShift)) return sUnpooled;
+            // 2^shift < blockSize <= 2^(shift+1)
+            unsigned shift = 0;
+            for (size_t remainder = blockSize - 1; remainder > 1; remainder >>= 1) ++shift;
+            size_t octaveBase = size_t(1) << shift;
+            size_t step = octaveBase / sSubClassesPerOctave;
+            size_t subClass = (blockSize - octaveBase + step - 1) / step; // 1 to sSubClassesPerOctave
+            return (shift - sMinShift) * sSubClassesPerOctave + subClass;
+        }
+
+        void* NewBlock(size_t blockSize)
+        {
+            void* block = NULL;
+            if (posix_memalign(&block, sAlignment, blockSize) != 0) return NULL;
+            return block;
+        }
+
+        std::atomic< size_t > sThreadCacheLimit(64 * 1024 * 1024);
+        std::atomic< size_t > sSharedCacheLimit(256 * 1024 * 1024);
+
+        // blocks can be released during static destruction, after the caches are gone
+        bool sSharedCacheAlive = false;
+
+        class SharedCache
+        {
+            public:
+                SharedCache() :
+                    fMutex(),
+                    fBlocks(sNClasses),
+                    fNBytes(0)
+                {
+                    sSharedCacheAlive = true;
+                }
+                ~SharedCache()
+                {
+                    sSharedCacheAlive = false;
+                    Clear();
+                }
+
+                void* Take(unsigned sizeClass)
+                {
+                    std::unique_lock< std::mutex > lock(fMutex);
+                    std::vector< void* >& blocks = fBlocks[sizeClass];
+                    if (blocks.empty()) return NULL;
+                    void* block = blocks.back();
+                    blocks.pop_back();
+                    fNBytes -= ClassSize(sizeClass);
+                    return block;
+                }
+
+                bool Put(void* block, unsigned sizeClass)
+                {
+                    std::unique_lock< std::mutex > lock(fMutex);
+                    if (fNBytes + ClassSize(sizeClass) > sSharedCacheLimit.load()) return false;
+                    fBlocks[sizeClass].push_back(block);
+                    fNBytes += ClassSize(sizeClass);
+                    return true;
+                }
+
+                void Clear()
+                {
+                    std::unique_lock< std::mutex > lock(fMutex);
+                    for (std::vector< std::vector< void* > >::iterator classIt = fBlocks.begin(); classIt != fBlocks.end(); ++classIt)
+                    {
+                        for (std::vector< void* >::iterator blockIt = classIt->begin(); blockIt != classIt->end(); ++blockIt)
+                        {
+                            free(*blockIt);
+                        }
+                        classIt->clear();
+                    }
+                    fNBytes = 0;
+                    return;
+                }
+
+                size_t GetNBytes()
+                {
+                    std::unique_lock< std::mutex > lock(fMutex);
+                    return fNBytes;
+                }
+
+            private:
+                std::mutex fMutex;
+                std::vector< std::vector< void* > > fBlocks;
+                size_t fNBytes;
+        };
+
+        SharedCache& GetSharedCache()
+        {
+            static SharedCache sCache;
+            return sCache;
+        }
+
+        thread_local bool sThreadCacheAlive = false;
+
+        class ThreadCache
+        {
+            public:
+                ThreadCache() :
+                    fBlocks(sNClasses),
+                    fNBytes(0)
+                {
+                    // make sure that the shared cache outlives this thread's cache
+                    GetSharedCache();
+                    sThreadCacheAlive = true;
+                }
+                ~ThreadCache()
+                {
+                    sThreadCacheAlive = false;
+                    Flush();
+                }
+
+                void* Take(unsigned sizeClass)
+                {
+                    std::vector< void* >& blocks = fBlocks[sizeClass];
+                    if (blocks.empty()) return NULL;
+                    void* block = blocks.back();
+                    blocks.pop_back();
+                    fNBytes -= ClassSize(sizeClass);
+                    return block;
+                }
+
+                bool Put(void* block, unsigned sizeClass)
+                {
+                    if (fNBytes + ClassSize(sizeClass) > sThreadCacheLimit.load()) return false;
+                    fBlocks[sizeClass].push_back(block);
+                    fNBytes += ClassSize(sizeClass);
+                    return true;
+                }
+
+                /// Moves the cached blocks to the shared cache (or frees them if it's full)
+                void Flush()
+                {
+                    for (unsigned sizeClass = 0; sizeClass < sNClasses; ++sizeClass)
+                    {
+                        std::vector< void* >& blocks = fBlocks[sizeClass];
+                        for (std::vector< void* >::iterator blockIt = blocks.begin(); blockIt != blocks.end(); ++blockIt)
+                        {
+                            if (! sSharedCacheAlive || ! GetSharedCache().Put(*blockIt, sizeClass)) free(*blockIt);
+                        }
+                        blocks.clear();
+                    }
+                    fNBytes = 0;
+                    return;
+                }
+
+                size_t GetNBytes() const
+                {
+                    return fNBytes;
+                }
+
+            private:
+                std::vector< std::vector< void* > > fBlocks;
+                size_t fNBytes;
+        };
+
+        ThreadCache* GetThreadCache()
+        {
+            static thread_local ThreadCache sCache;
+            return sThreadCacheAlive ? &sCache : NULL;
+        }
+    }
+
+    void* KTBufferPool::Allocate(size_t nBytes)
+    {
+        size_t blockSize = nBytes + sHeaderSize;
+        unsigned sizeClass = FindClass(blockSize);
+
+        void* block = NULL;
+        if (sizeClass == sUnpooled)
+        {
+            block = NewBlock(blockSize);
+        }
+        else
+        {
+            blockSize = ClassSize(sizeClass);
+            ThreadCache* threadCache = GetThreadCache();
+            if (threadCache != NULL) block = threadCache->Take(sizeClass);
+            if (block == NULL && sSharedCacheAlive) block = GetSharedCache().Take(sizeClass);
+            if (block == NULL) block = NewBlock(blockSize);
+        }
+        if (block == NULL) return NULL;
+
+        BlockHeader* header = static_cast< BlockHeader* >(block);
+        header->fMagic = sMagic;
+        header->fClass = sizeClass;
+        header->fSize = blockSize;
+        return static_cast< char* >(block) + sHeaderSize;
+    }
+
+    void KTBufferPool::Release(void* data)
+    {
+        if (data == NULL) return;
+
+        // data must be from Allocate(), so the header can be read
+        void* block = static_cast< char* >(data) - sHeaderSize;
+        BlockHeader* header = static_cast< BlockHeader* >(block);
+        if (header->fMagic != sMagic)
+        {
+            // the block is cached, so it has already been released; caching it twice would give it to two arrays
+            KTERROR(poollog, "Block at " << data << " has already been released; it will not be released again");
+            return;
+        }
+        header->fMagic = 0;
+
+        unsigned sizeClass = header->fClass;
+        if (sizeClass != sUnpooled)
+        {
+            ThreadCache* threadCache = GetThreadCache();
+            if (threadCache != NULL && threadCache->Put(block, sizeClass)) return;
+            if (sSharedCacheAlive && GetSharedCache().Put(block, sizeClass)) return;
+        }
+        free(block);
+        return;
+    }
+
+    void KTBufferPool::Trim()
+    {
+        ThreadCache* threadCache = GetThreadCache();
+        if (threadCache != NULL) threadCache->Flush();
+        if (sSharedCacheAlive) GetSharedCache().Clear();
+        return;
+    }
+
+    size_t KTBufferPool::GetAlignment()
+    {
+        return sAlignment;
+    }
+
+    size_t KTBufferPool::GetThreadCacheLimit()
+    {
+        return sThreadCacheLimit.load();
+    }
+
+    void KTBufferPool::SetThreadCacheLimit(size_t nBytes)
+    {
+        sThreadCacheLimit.store(nBytes);
+        return;
+    }
+
+    size_t KTBufferPool::GetSharedCacheLimit()
+    {
+        return sSharedCacheLimit.load();
+    }
+
+    void KTBufferPool::SetSharedCacheLimit(size_t nBytes)
+    {
+        sSharedCacheLimit.store(nBytes);
+        return;
+    }
+
+    size_t KTBufferPool::GetNCachedBytes()
+    {
+        size_t nBytes = sSharedCacheAlive ? GetSharedCache().GetNBytes() : 0;
+        ThreadCache* threadCache = GetThreadCache();
+        if (threadCache != NULL) nBytes += threadCache->GetNBytes();
+        return nBytes;
+    }
+
+} /* namespace Katydid */
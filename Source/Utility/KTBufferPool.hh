@@ -0,0 +1,107 @@
+/**
+ @file KTBufferPool.hh
+ @brief Contains KTBufferPool
+ @details Pool of aligned memory blocks for the data arrays, so that they are recycled from slice to slice
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTBUFFERPOOL_HH_
+#define KTBUFFERPOOL_HH_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace Katydid
+{
+
+    /*!
+     @class KTBufferPool
+     @author agent
+
+     @brief Provides aligned memory blocks for the arrays in the data classes, and keeps released blocks for reuse.
+
+     @details
+     Every slice creates new time series and spectra, and destroys them when the data object is released, so without a pool
+     the same few sizes are allocated and freed over and over.  Blocks are grouped in size classes (four per power of 2,
+     so at most 25% of a block is unused), and a released block is kept for the next allocation of the same class.
+
+     Each thread keeps its own cache of released blocks, which is used without locking.  When a thread's cache is full,
+     released blocks go to a shared cache (protected by a mutex), and when that is full as well, they are freed.
+     Allocations look in the thread's cache first, then in the shared cache, and only then allocate a new block.
+     In a steady state (the same array sizes for every slice), no new blocks are allocated once the caches are warm.
+     A thread's cache is moved to the shared cache when the thread exits.
+
+     Blocks are aligned to 64 bytes, which satisfies FFTW's alignment requirements (so they can replace fftw_malloc)
+     and keeps each array on its own cache lines.  Blocks larger than the largest size class are not pooled.
+
+     The cache limits are in bytes, and can be changed at any time; 0 disables the corresponding cache.
+
+     Only blocks from Allocate() may be given to Release().  The size class is read from a header just before the block,
+     so releasing any other pointer is undefined behavior; there is no registry of the blocks to check it against.
+     The header is marked when a block is released, so releasing a block a second time while it is cached is reported and ignored.
+    */
+
+    class KTBufferPool
+    {
+        public:
+            /// Returns a block of at least nBytes bytes, aligned to GetAlignment() bytes; returns NULL if the allocation fails
+            static void* Allocate(size_t nBytes);
+            /// Returns a block from Allocate() to the pool; NULL is ignored.  The block must be from Allocate() (see above).
+            static void Release(void* block);
+
+            /// Allocates and default-initializes an array of nElements objects
+            template< typename XDataType >
+            static XDataType* AllocateArray(size_t nElements);
+            /// Destroys and releases an array from AllocateArray(); nElements must be the size it was allocated with
+            template< typename XDataType >
+            static void ReleaseArray(XDataType* array, size_t nElements);
+
+            /// Frees the blocks cached for the calling thread and in the shared cache
+            static void Trim();
+
+            static size_t GetAlignment();
+
+            static size_t GetThreadCacheLimit();
+            static void SetThreadCacheLimit(size_t nBytes);
+
+            static size_t GetSharedCacheLimit();
+            static void SetSharedCacheLimit(size_t nBytes);
+
+            /// Number of bytes in blocks that are currently cached (calling thread's cache + shared cache)
+            static size_t GetNCachedBytes();
+    };
+
+    template< typename XDataType >
+    XDataType* KTBufferPool::AllocateArray(size_t nElements)
+    {
+        XDataType* array = static_cast< XDataType* >(Allocate(nElements * sizeof(XDataType)));
+        if (array == NULL) throw std::bad_alloc();
+        if (! std::is_trivially_default_constructible< XDataType >::value)
+        {
+            for (size_t iElement = 0; iElement < nElements; ++iElement)
+            {
+                new (array + iElement) XDataType();
+            }
+        }
+        return array;
+    }
+
+    template< typename XDataType >
+    void KTBufferPool::ReleaseArray(XDataType* array, size_t nElements)
+    {
+        if (array == NULL) return;
+        if (! std::is_trivially_destructible< XDataType >::value)
+        {
+            for (size_t iElement = 0; iElement < nElements; ++iElement)
+            {
+                array[iElement].~XDataType();
+            }
+        }
+        Release(array);
+        return;
+    }
+
+} /* namespace Katydid */
+#endif /* KTBUFFERPOOL_HH_ */
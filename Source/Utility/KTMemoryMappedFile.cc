@@ -0,0 +1,110 @@
+/*
+ * KTMemoryMappedFile.cc
+ *
+ *  Created on: Oct 18, 2026
+ *      Author: agent
+ */
+
+#include "KTMemoryMappedFile.hh"
+
+#include "KTLogger.hh"
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Katydid
+{
+    KTLOGGER(mmaplog, "KTMemoryMappedFile");
+
+    KTMemoryMappedFile::KTMemoryMappedFile() :
+            fFilename(),
+            fIsOpen(false),
+            fData(NULL),
+            fSize(0),
+            fReleased(0)
+    {
+    }
+
+    KTMemoryMappedFile::~KTMemoryMappedFile()
+    {
+        Close();
+    }
+
+    bool KTMemoryMappedFile::Open(const std::string& filename)
+    {
+        Close();
+
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            KTERROR(mmaplog, "Unable to open file <" << filename << ">: " << strerror(errno));
+            return false;
+        }
+
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0)
+        {
+            KTERROR(mmaplog, "Unable to get the size of file <" << filename << ">: " << strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        std::size_t size = std::size_t(fileStat.st_size);
+        if (size > 0)
+        {
+            void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                KTERROR(mmaplog, "Unable to map file <" << filename << ">: " << strerror(errno));
+                close(fd);
+                return false;
+            }
+            fData = static_cast< char* >(data);
+            // the map remains valid after the descriptor is closed
+            madvise(fData, size, MADV_SEQUENTIAL);
+        }
+        close(fd);
+
+        fFilename = filename;
+        fSize = size;
+        fReleased = 0;
+        fIsOpen = true;
+        KTDEBUG(mmaplog, "Mapped file <" << fFilename << "> (" << fSize << " bytes)");
+        return true;
+    }
+
+    void KTMemoryMappedFile::Close()
+    {
+        if (fData != NULL)
+        {
+            munmap(fData, fSize);
+        }
+        fData = NULL;
+        fSize = 0;
+        fReleased = 0;
+        fIsOpen = false;
+        fFilename.clear();
+        return;
+    }
+
+    void KTMemoryMappedFile::ReleaseBefore(std::size_t offset)
+    {
+        if (fData == NULL) return;
+        if (offset > fSize) offset = fSize;
+
+        // madvise works on whole pages
+        static const std::size_t sPageSize = std::size_t(sysconf(_SC_PAGESIZE));
+        std::size_t end = offset - offset % sPageSize;
+        if (end <= fReleased) return;
+
+        madvise(fData + fReleased, end - fReleased, MADV_DONTNEED);
+        fReleased = end;
+        return;
+    }
+
+} /* namespace Katydid */
@@ -0,0 +1,85 @@
+/**
+ @file KTMemoryMappedFile.hh
+ @brief Contains KTMemoryMappedFile
+ @details Read-only memory map of a whole file
+ @author: agent
+ @date: Oct 18, 2026
+ */
+
+#ifndef KTMEMORYMAPPEDFILE_HH_
+#define KTMEMORYMAPPEDFILE_HH_
+
+#include <cstddef>
+#include <string>
+
+namespace Katydid
+{
+
+    /*!
+     @class KTMemoryMappedFile
+     @author agent
+
+     @brief Maps a file into memory, read-only
+
+     @details
+     The contents of the file are available through GetData() for as long as the file is open; the operating system pages
+     them in as they're used, so no read buffers are needed and nothing is copied.
+     The map is made with a hint that the file will be read in order; ReleaseBefore() can be used while streaming through
+     a large file to let the operating system drop the pages that have already been used.
+
+     An empty file can be opened; GetData() will return NULL and GetSize() will return 0.
+    */
+    class KTMemoryMappedFile
+    {
+        public:
+            KTMemoryMappedFile();
+            virtual ~KTMemoryMappedFile();
+
+            /// Maps the file; any previously-mapped file is closed first
+            bool Open(const std::string& filename);
+            /// Unmaps the file
+            void Close();
+
+            bool IsOpen() const;
+
+            const std::string& GetFilename() const;
+            const char* GetData() const;
+            std::size_t GetSize() const;
+
+            /// Hints that the first offset bytes of the file won't be needed again
+            void ReleaseBefore(std::size_t offset);
+
+        private:
+            KTMemoryMappedFile(const KTMemoryMappedFile&);
+            KTMemoryMappedFile& operator=(const KTMemoryMappedFile&);
+
+            std::string fFilename;
+            bool fIsOpen;
+            char* fData;
+            std::size_t fSize;
+            std::size_t fReleased;
+    };
+
+    inline bool KTMemoryMappedFile::IsOpen() const
+    {
+        return fIsOpen;
+    }
+
+    inline const std::string& KTMemoryMappedFile::GetFilename() const
+    {
+        return fFilename;
+    }
+
+    inline const char* KTMemoryMappedFile::GetData() const
+    {
+        return fData;
+    }
+
+    inline std::size_t KTMemoryMappedFile::GetSize() const
+    {
+        return fSize;
+    }
+
+} /* namespace Katydid */
+
+#endif /* KTMEMORYMAPPEDFILE_HH_ */
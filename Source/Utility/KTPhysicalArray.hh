@@ -8,16 +8,19 @@
 #ifndef KTPHYSICALARRAY_HH_
 #define KTPHYSICALARRAY_HH_
 
+#include "KTArrayExpression.hh"
+#include "KTArrayView.hh"
 #include "KTAxisProperties.hh"
+#include "KTBufferPool.hh"
 
 #include <boost/numeric/ublas/vector.hpp>
-#include <boost/numeric/ublas/matrix.hpp>
-#include <boost/numeric/ublas/io.hpp>
 #include <boost/bind.hpp>
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
 
 #ifdef USE_OPENMP
 #include <omp.h>
@@ -223,17 +226,33 @@ namespace Katydid
             explicit KTPhysicalArray(size_t nBins, double rangeMin=0., double rangeMax=1.);
             explicit KTPhysicalArray(XDataType value, size_t nBins, double rangeMin=0., double rangeMax=1.);
             KTPhysicalArray(const KTPhysicalArray< 1, value_type >& orig);
+            /// Takes the data buffer from orig without copying; orig is left empty
+            KTPhysicalArray(KTPhysicalArray< 1, value_type >&& orig);
+            /// Calculates an element-wise expression (see KTArrayExpression) into a new array, with the axis range and label of the left-most array in the expression
+            /// (or a range of [0, 1) if there is none)
+            template< typename XExpression >
+            KTPhysicalArray(const KTArrayExpression< XExpression >& expression);
+            /// Calculates an element-wise expression (see KTArrayExpression) into a new array with the given axis range
+            template< typename XExpression >
+            KTPhysicalArray(const KTArrayExpression< XExpression >& expression, double rangeMin, double rangeMax);
             virtual ~KTPhysicalArray();
 
         public:
             const array_type& GetData() const;
             array_type& GetData();
 
+            /// Makes the array a view of external data, which must hold size() values and outlive the array (or be replaced first).
+            /// The array's own buffer is released; the values are not copied.
+            void SetExternalData(XDataType* data);
+            /// False if the array is a view of external data
+            bool GetOwnsData() const;
+
             const std::string& GetDataLabel() const;
             void SetDataLabel(const std::string& label);
 
         protected:
             array_type fData;
+            bool fOwnsData;
             std::string fLabel;
 
         public:
@@ -243,7 +262,21 @@ namespace Katydid
         public:
             bool IsCompatibleWith(const KTPhysicalArray< 1, value_type >& rhs) const;
 
+            /// Copies rhs; if the sizes match, the values are copied into the existing buffer (so a view stays a view)
             KTPhysicalArray< 1, XDataType >& operator=(const KTPhysicalArray< 1, value_type >& rhs);
+            /// Exchanges contents with rhs, so the old buffer is released along with rhs
+            KTPhysicalArray< 1, XDataType >& operator=(KTPhysicalArray< 1, value_type >&& rhs);
+
+            /// Exchanges the data buffers, labels, and axes of the two arrays without copying
+            void swap(KTPhysicalArray< 1, XDataType >& other);
+
+            /// Calculates an element-wise expression (see KTArrayExpression) into this array, in a single pass;
+            /// if the sizes differ, the array is replaced by a new one, with the size, axis range and label that the expression would give a new array
+            template< typename XExpression >
+            KTPhysicalArray< 1, XDataType >& operator=(const KTArrayExpression< XExpression >& rhs);
+            /// Same as operator=(const KTArrayExpression&); for use with derived classes, whose assignment operators hide the template
+            template< typename XExpression >
+            KTPhysicalArray< 1, XDataType >& Assign(const KTArrayExpression< XExpression >& rhs);
 
             KTPhysicalArray< 1, XDataType >& operator+=(const KTPhysicalArray< 1, value_type >& rhs);
             KTPhysicalArray< 1, XDataType >& operator-=(const KTPhysicalArray< 1, value_type >& rhs);
@@ -255,6 +288,21 @@ namespace Katydid
             KTPhysicalArray< 1, XDataType >& operator*=(const value_type& rhs);
             KTPhysicalArray< 1, XDataType >& operator/=(const value_type& rhs);
 
+            template< typename XExpression >
+            KTPhysicalArray< 1, XDataType >& operator+=(const KTArrayExpression< XExpression >& rhs);
+            template< typename XExpression >
+            KTPhysicalArray< 1, XDataType >& operator-=(const KTArrayExpression< XExpression >& rhs);
+            template< typename XExpression >
+            KTPhysicalArray< 1, XDataType >& operator*=(const KTArrayExpression< XExpression >& rhs);
+            template< typename XExpression >
+            KTPhysicalArray< 1, XDataType >& operator/=(const KTArrayExpression< XExpression >& rhs);
+
+        private:
+            typedef KTArrayRef< XDataType > XRef;
+            typedef KTArrayScalar< XDataType > XScalar;
+
+            XRef AsExpression() const;
+
         public:
             const_iterator begin() const;
             const_iterator end() const;
@@ -268,10 +316,15 @@ namespace Katydid
 
     };
 
+    /// Includes a 1-D array in an element-wise expression (see KTArrayExpression)
+    template< typename XDataType >
+    KTArrayRef< XDataType > KTArrayOperand(const KTPhysicalArray< 1, XDataType >& array);
+
     template< typename XDataType >
     KTPhysicalArray< 1, XDataType >::KTPhysicalArray() :
             KTAxisProperties< 1 >(),
             fData(NULL),
+            fOwnsData(true),
             fLabel()
     {
         SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(0));
@@ -281,10 +334,11 @@ namespace Katydid
     KTPhysicalArray< 1, XDataType >::KTPhysicalArray(size_t nBins, double rangeMin, double rangeMax) :
             KTAxisProperties< 1 >(rangeMin, rangeMax),
             fData(NULL),
+            fOwnsData(true),
             fLabel()
     {
         SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(nBins));
-        fData = new XDataType[ nBins ];
+        fData = KTBufferPool::AllocateArray< XDataType >(nBins);
     }
 
     template< typename XDataType >
@@ -301,19 +355,53 @@ namespace Katydid
     KTPhysicalArray< 1, XDataType >::KTPhysicalArray(const KTPhysicalArray< 1, value_type >& orig) :
             KTAxisProperties< 1 >(orig),
             fData(orig.fData),
+            fOwnsData(true),
             fLabel(orig.fLabel)
     {
         SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(orig.size()));
-        fData = new XDataType[ orig.size() ];
+        fData = KTBufferPool::AllocateArray< XDataType >(orig.size());
         memcpy( fData, orig.fData, orig.size() * sizeof( XDataType ) );
     }
 
+    template< typename XDataType >
+    KTPhysicalArray< 1, XDataType >::KTPhysicalArray(KTPhysicalArray< 1, value_type >&& orig) :
+            KTPhysicalArray< 1, XDataType >()
+    {
+        swap(orig);
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    KTPhysicalArray< 1, XDataType >::KTPhysicalArray(const KTArrayExpression< XExpression >& expression) :
+            KTPhysicalArray(expression, 0., 1.)
+    {
+        const KTAxisProperties< 1 >* axis = expression.Derived().GetAxis();
+        if (axis != NULL)
+        {
+            SetRange(axis->GetRangeMin(), axis->GetRangeMax());
+            SetAxisLabel(axis->GetAxisLabel());
+        }
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    KTPhysicalArray< 1, XDataType >::KTPhysicalArray(const KTArrayExpression< XExpression >& expression, double rangeMin, double rangeMax) :
+            KTAxisProperties< 1 >(rangeMin, rangeMax),
+            fData(NULL),
+            fOwnsData(true),
+            fLabel()
+    {
+        SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(expression.Derived().size()));
+        fData = KTBufferPool::AllocateArray< XDataType >(expression.Derived().size());
+        KTArrayEvaluate(fData, expression);
+    }
+
     template< typename XDataType >
     KTPhysicalArray< 1, XDataType >::~KTPhysicalArray()
     {
-        if (fData != NULL)
+        if (fData != NULL && fOwnsData)
         {
-            delete [] fData;
+            KTBufferPool::ReleaseArray(fData, size());
         }
     }
 
@@ -329,6 +417,24 @@ namespace Katydid
         return fData;
     }
 
+    template< typename XDataType >
+    void KTPhysicalArray< 1, XDataType >::SetExternalData(XDataType* data)
+    {
+        if (fData != NULL && fOwnsData)
+        {
+            KTBufferPool::ReleaseArray(fData, size());
+        }
+        fData = data;
+        fOwnsData = false;
+        return;
+    }
+
+    template< typename XDataType >
+    inline bool KTPhysicalArray< 1, XDataType >::GetOwnsData() const
+    {
+        return fOwnsData;
+    }
+
     template< typename XDataType >
     inline const std::string& KTPhysicalArray< 1, XDataType >::GetDataLabel() const
     {
@@ -382,108 +488,146 @@ namespace Katydid
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator=(const KTPhysicalArray< 1, value_type>& rhs)
     {
-        if( fData != NULL )
+        if (this == &rhs) return *this;
+        if (fData == NULL || size() != rhs.size())
         {
-            delete [] fData;
+            if (fData != NULL && fOwnsData)
+            {
+                KTBufferPool::ReleaseArray(fData, size());
+            }
+            SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(rhs.size()));
+            fData = KTBufferPool::AllocateArray< XDataType >(rhs.size());
+            fOwnsData = true;
         }
         fLabel = rhs.fLabel;
-        SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(rhs.size()));
-        fData = new XDataType[ rhs.size() ];
         memcpy( fData, rhs.fData, rhs.size() * sizeof( XDataType ) );
         KTAxisProperties< 1 >::operator=(rhs);
         return *this;
     }
 
     template< typename XDataType >
-    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator+=(const KTPhysicalArray< 1, value_type>& rhs)
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator=(KTPhysicalArray< 1, value_type>&& rhs)
     {
-        if (! this->IsCompatibleWith(rhs)) return *this;
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
+        swap(rhs);
+        return *this;
+    }
+
+    template< typename XDataType >
+    inline void KTPhysicalArray< 1, XDataType >::swap(KTPhysicalArray< 1, XDataType >& other)
+    {
+        std::swap(fData, other.fData);
+        std::swap(fOwnsData, other.fOwnsData);
+        fLabel.swap(other.fLabel);
+        SwapAxes(other);
+        return;
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator=(const KTArrayExpression< XExpression >& rhs)
+    {
+        return Assign(rhs);
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::Assign(const KTArrayExpression< XExpression >& rhs)
+    {
+        if (rhs.Derived().size() != size())
         {
-            fData[iBin] += rhs.fData[iBin];
+            // as with assignment of an array of a different size; the inputs can't include this array, since their size is that of the expression
+            KTPhysicalArray< 1, XDataType > result(rhs);
+            swap(result);
+            return *this;
         }
+        KTArrayEvaluate(fData, rhs);
         return *this;
     }
 
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 1, XDataType >::XRef KTPhysicalArray< 1, XDataType >::AsExpression() const
+    {
+        return XRef(fData, size(), this);
+    }
+
+    template< typename XDataType >
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator+=(const KTPhysicalArray< 1, value_type>& rhs)
+    {
+        if (! this->IsCompatibleWith(rhs)) return *this;
+        return Assign(KTArrayBinaryExpression< KTArrayAdd, XRef, XRef >(AsExpression(), rhs.AsExpression()));
+    }
+
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator-=(const KTPhysicalArray< 1, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] -= rhs.fData[iBin];
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArraySubtract, XRef, XRef >(AsExpression(), rhs.AsExpression()));
     }
 
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator*=(const KTPhysicalArray< 1, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] *= rhs.fData[iBin];
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArrayMultiply, XRef, XRef >(AsExpression(), rhs.AsExpression()));
     }
 
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator/=(const KTPhysicalArray< 1, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] /= rhs.fData[iBin];
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArrayDivide, XRef, XRef >(AsExpression(), rhs.AsExpression()));
     }
 
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator+=(const value_type& rhs)
     {
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] += rhs;
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArrayAdd, XRef, XScalar >(AsExpression(), XScalar(rhs)));
     }
 
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator-=(const value_type& rhs)
     {
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] -= rhs;
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArraySubtract, XRef, XScalar >(AsExpression(), XScalar(rhs)));
     }
 
     template< typename XDataType >
     inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator*=(const value_type& rhs)
     {
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] *= rhs;
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArrayMultiply, XRef, XScalar >(AsExpression(), XScalar(rhs)));
     }
 
     template< typename XDataType >
-    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator/=(const XDataType& rhs)
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator/=(const value_type& rhs)
     {
-#pragma omp parallel for
-        for (size_t iBin=0; iBin<size(); ++iBin)
-        {
-            fData[iBin] /= rhs;
-        }
-        return *this;
+        return Assign(KTArrayBinaryExpression< KTArrayDivide, XRef, XScalar >(AsExpression(), XScalar(rhs)));
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator+=(const KTArrayExpression< XExpression >& rhs)
+    {
+        return Assign(KTArrayBinaryExpression< KTArrayAdd, XRef, XExpression >(AsExpression(), rhs.Derived()));
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator-=(const KTArrayExpression< XExpression >& rhs)
+    {
+        return Assign(KTArrayBinaryExpression< KTArraySubtract, XRef, XExpression >(AsExpression(), rhs.Derived()));
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator*=(const KTArrayExpression< XExpression >& rhs)
+    {
+        return Assign(KTArrayBinaryExpression< KTArrayMultiply, XRef, XExpression >(AsExpression(), rhs.Derived()));
+    }
+
+    template< typename XDataType >
+    template< typename XExpression >
+    inline KTPhysicalArray< 1, XDataType >& KTPhysicalArray< 1, XDataType >::operator/=(const KTArrayExpression< XExpression >& rhs)
+    {
+        return Assign(KTArrayBinaryExpression< KTArrayDivide, XRef, XExpression >(AsExpression(), rhs.Derived()));
     }
 
     template< typename XDataType >
@@ -535,55 +679,89 @@ namespace Katydid
         return fData - 1;
     }
 
+    template< typename XDataType >
+    inline KTArrayRef< XDataType > KTArrayOperand(const KTPhysicalArray< 1, XDataType >& array)
+    {
+        return KTArrayRef< XDataType >(array.GetData(), array.size(), &array);
+    }
+
 
     //*************************
     // 2-D array implementation
     //*************************
 
+    /*!
+     The bins are stored in a single row-major block from KTBufferPool (aligned to KTBufferPool::GetAlignment() bytes):
+     bin (i, j) is at GetData()[i * GetStride() + j], so for each bin along axis 1 the bins along axis 2 form a contiguous row.
+     The stride is size(2) rounded up to a multiple of the alignment (when the alignment is a multiple of sizeof(XDataType)),
+     so that every row starts on an aligned boundary; the padding at the end of each row is not part of the array.
+     Rows and rectangular blocks of bins can be used without copying through GetRow(), GetBlock() and GetColumnBlock().
+    */
     template< typename XDataType >
     class KTPhysicalArray< 2, XDataType > : public KTAxisProperties< 2 >
     {
         public:
             typedef XDataType value_type;
-            typedef typename boost::numeric::ublas::matrix< XDataType > matrix_type;
-            typedef typename matrix_type::const_iterator1 const_iterator1;
-            typedef typename matrix_type::iterator1 iterator1;
-            typedef typename matrix_type::const_reverse_iterator1 const_reverse_iterator1;
-            typedef typename matrix_type::reverse_iterator1 reverse_iterator1;
-            typedef typename matrix_type::const_iterator2 const_iterator2;
-            typedef typename matrix_type::iterator2 iterator2;
-            typedef typename matrix_type::const_reverse_iterator2 const_reverse_iterator2;
-            typedef typename matrix_type::reverse_iterator2 reverse_iterator2;
+            typedef XDataType* array_type;
+            typedef const XDataType* const_iterator;
+            typedef XDataType* iterator;
+            typedef KTArrayRowView< XDataType > row_view;
+            typedef KTArrayRowView< const XDataType > const_row_view;
+            typedef KTArrayBlockView< XDataType > block_view;
+            typedef KTArrayBlockView< const XDataType > const_block_view;
 
         private:
-            typedef KTNBinsInArray< 2, matrix_type > XNBinsFunctor;
+            typedef KTNBinsInArray< 2, FixedSize > XNBinsFunctor;
 
         public:
             KTPhysicalArray();
             KTPhysicalArray(size_t xNBins, double xRangeMin, double xRangeMax, size_t yNBins, double yRangeMin, double yRangeMax);
             KTPhysicalArray(XDataType value, size_t xNBins, double xRangeMin, double xRangeMax, size_t yNBins, double yRangeMin, double yRangeMax);
             KTPhysicalArray(const KTPhysicalArray< 2, value_type >& orig);
+            /// Takes the data buffer from orig without copying; orig is left empty
+            KTPhysicalArray(KTPhysicalArray< 2, value_type >&& orig);
             virtual ~KTPhysicalArray();
 
         public:
-            const matrix_type& GetData() const;
-            matrix_type& GetData();
+            /// Pointer to bin (0, 0); see GetStride() for the layout
+            const value_type* GetData() const;
+            value_type* GetData();
+            /// Distance, in elements, between bins (i, j) and (i+1, j); at least size(2), and padded to keep the rows aligned
+            size_t GetStride() const;
 
             const std::string& GetDataLabel() const;
             void SetDataLabel(const std::string& label);
 
         protected:
-            matrix_type fData;
+            array_type fData;
+            size_t fStride;
             std::string fLabel;
 
         public:
             const value_type& operator()(unsigned i, unsigned j) const;
             value_type& operator()(unsigned i, unsigned j);
 
+            /// Bins (i, 0) to (i, size(2)-1), without copying
+            const_row_view GetRow(unsigned i) const;
+            row_view GetRow(unsigned i);
+
+            /// Bins (firstI, firstJ) to (firstI + nI - 1, firstJ + nJ - 1), without copying
+            const_block_view GetBlock(unsigned firstI, unsigned nI, unsigned firstJ, unsigned nJ) const;
+            block_view GetBlock(unsigned firstI, unsigned nI, unsigned firstJ, unsigned nJ);
+
+            /// Bins firstJ to firstJ + nJ - 1 along axis 2, for all bins along axis 1, without copying
+            const_block_view GetColumnBlock(unsigned firstJ, unsigned nJ) const;
+            block_view GetColumnBlock(unsigned firstJ, unsigned nJ);
+
         public:
             bool IsCompatibleWith(const KTPhysicalArray< 2, value_type >& rhs) const;
 
             KTPhysicalArray< 2, XDataType >& operator=(const KTPhysicalArray< 2, value_type >& rhs);
+            /// Exchanges contents with rhs, so the old buffer is released along with rhs
+            KTPhysicalArray< 2, XDataType >& operator=(KTPhysicalArray< 2, value_type >&& rhs);
+
+            /// Exchanges the data buffers, labels, and axes of the two arrays without copying
+            void swap(KTPhysicalArray< 2, XDataType >& other);
 
             KTPhysicalArray< 2, XDataType >& operator+=(const KTPhysicalArray< 2, value_type >& rhs);
             KTPhysicalArray< 2, XDataType >& operator-=(const KTPhysicalArray< 2, value_type >& rhs);
@@ -597,102 +775,106 @@ namespace Katydid
             KTPhysicalArray< 2, XDataType >& operator/=(const value_type& rhs);
 
         public:
-            const_iterator1 begin1() const;
-            const_iterator2 begin2() const;
-            const_iterator1 end1() const;
-            const_iterator2 end2() const;
-            iterator1 begin1();
-            iterator2 begin2();
-            iterator1 end1();
-            iterator2 end2();
-
-            const_reverse_iterator1 rbegin1() const;
-            const_reverse_iterator2 rbegin2() const;
-            const_reverse_iterator1 rend1() const;
-            const_reverse_iterator2 rend2() const;
-            reverse_iterator1 rbegin1();
-            reverse_iterator2 rbegin2();
-            reverse_iterator1 rend1();
-            reverse_iterator2 rend2();
+            /// Iteration over the whole storage, including the padding at the end of each row (see GetStride())
+            const_iterator begin() const;
+            const_iterator end() const;
+            iterator begin();
+            iterator end();
 
         public:
             value_type GetMaximumBin(unsigned& maxXBin, unsigned& maxYBin) const;
             value_type GetMinimumBin(unsigned& minXBin, unsigned& minYBin) const;
             /// Returns the pair (min value, max value)
             std::pair< value_type, value_type > GetMinMaxBin(unsigned& minXBin, unsigned& minYBin, unsigned& maxXBin, unsigned& maxYBin);
+
+        private:
+            /// Number of elements in the storage, including the padding
+            size_t GetNTotalBins() const;
+
+            /// Row length rounded up so that every row starts on an alignment boundary (if the element size allows it)
+            static size_t AlignedStride(size_t nColumns);
     };
 
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >::KTPhysicalArray() :
             KTAxisProperties< 2 >(),
-            fData(),
+            fData(NULL),
+            fStride(0),
             fLabel()
     {
-        size_t (matrix_type::*sizeArray[2])() const = {&matrix_type::size1, &matrix_type::size2};
-        SetNBinsFunc(new KTNBinsInArray< 2, matrix_type >(&fData, sizeArray));
-        //std::cout << "You have created a 2-D physical array" << std::endl;
+        size_t nBins[2] = {0, 0};
+        SetNBinsFunc(new XNBinsFunctor(nBins));
     }
 
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >::KTPhysicalArray(size_t xNBins, double xRangeMin, double xRangeMax, size_t yNBins, double yRangeMin, double yRangeMax) :
             KTAxisProperties< 2 >(),
-            fData(xNBins, yNBins),
+            fData(NULL),
+            fStride(AlignedStride(yNBins)),
             fLabel()
     {
-        size_t (matrix_type::*sizeArray[2])() const = {&matrix_type::size1, &matrix_type::size2};
-        SetNBinsFunc(new KTNBinsInArray< 2, matrix_type >(&fData, sizeArray));
-        //SetNBinsFunc(new KTNBinsInArray< 2, matrix_type >((matrix_type*)this, (size_t (matrix_type::*[])()){&matrix_type::size1, &matrix_type::size2}));
+        size_t nBins[2] = {xNBins, yNBins};
+        SetNBinsFunc(new XNBinsFunctor(nBins));
+        if (xNBins * yNBins != 0) fData = KTBufferPool::AllocateArray< XDataType >(xNBins * fStride);
         SetRangeMin(1, xRangeMin);
         SetRangeMin(2, yRangeMin);
         SetRangeMax(1, xRangeMax);
         SetRangeMax(2, yRangeMax);
-        //KTDEBUG(utillog_physarr, "created matrix with (" << fData.size1() << ", " << fData.size2() << ")");
     }
 
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >::KTPhysicalArray(XDataType value, size_t xNBins, double xRangeMin, double xRangeMax, size_t yNBins, double yRangeMin, double yRangeMax) :
             KTPhysicalArray(xNBins, xRangeMin, xRangeMax, yNBins, yRangeMin, yRangeMax)
     {
-        for (unsigned xIndex = 0; xIndex < xNBins; ++xIndex)
-        {
-            for (unsigned yIndex = 0; yIndex < yNBins; ++yIndex)
-            {
-                fData(xIndex, yIndex) = value;
-            }
-        }
+        std::fill(begin(), end(), value);
     }
 
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >::KTPhysicalArray(const KTPhysicalArray< 2, value_type >& orig) :
-            KTAxisProperties< 2 >(),
-            fData(orig.fData),
+            KTAxisProperties< 2 >(orig),
+            fData(NULL),
+            fStride(orig.fStride),
             fLabel(orig.fLabel)
     {
-        size_t (matrix_type::*sizeArray[2])() const = {&matrix_type::size1, &matrix_type::size2};
-        SetNBinsFunc(new KTNBinsInArray< 2, matrix_type >(&fData, sizeArray));
-        SetRangeMin(1, orig.GetRangeMin(1));
-        SetRangeMin(2, orig.GetRangeMin(2));
-        SetRangeMax(1, orig.GetRangeMax(1));
-        SetRangeMax(2, orig.GetRangeMax(2));
+        size_t nBins = orig.GetNTotalBins();
+        if (nBins != 0)
+        {
+            fData = KTBufferPool::AllocateArray< XDataType >(nBins);
+            std::copy(orig.begin(), orig.end(), fData);
+        }
+    }
+
+    template< typename XDataType >
+    KTPhysicalArray< 2, XDataType >::KTPhysicalArray(KTPhysicalArray< 2, value_type >&& orig) :
+            KTPhysicalArray< 2, XDataType >()
+    {
+        swap(orig);
     }
 
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >::~KTPhysicalArray()
     {
+        KTBufferPool::ReleaseArray(fData, GetNTotalBins());
     }
 
     template< typename XDataType >
-    inline const typename KTPhysicalArray< 2, XDataType >::matrix_type& KTPhysicalArray< 2, XDataType >::GetData() const
+    inline const typename KTPhysicalArray< 2, XDataType >::value_type* KTPhysicalArray< 2, XDataType >::GetData() const
     {
         return fData;
     }
 
     template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::matrix_type& KTPhysicalArray< 2, XDataType >::GetData()
+    inline typename KTPhysicalArray< 2, XDataType >::value_type* KTPhysicalArray< 2, XDataType >::GetData()
     {
         return fData;
     }
 
+    template< typename XDataType >
+    inline size_t KTPhysicalArray< 2, XDataType >::GetStride() const
+    {
+        return fStride;
+    }
+
     template< typename XDataType >
     inline const std::string& KTPhysicalArray< 2, XDataType >::GetDataLabel() const
     {
@@ -706,6 +888,21 @@ namespace Katydid
         return;
     }
 
+    template< typename XDataType >
+    inline size_t KTPhysicalArray< 2, XDataType >::GetNTotalBins() const
+    {
+        return size(1) * fStride;
+    }
+
+    template< typename XDataType >
+    inline size_t KTPhysicalArray< 2, XDataType >::AlignedStride(size_t nColumns)
+    {
+        size_t alignment = KTBufferPool::GetAlignment();
+        if (nColumns == 0 || alignment % sizeof(XDataType) != 0) return nColumns;
+        size_t nPerAlignment = alignment / sizeof(XDataType);
+        return (nColumns + nPerAlignment - 1) / nPerAlignment * nPerAlignment;
+    }
+
     template< typename XDataType >
     inline const typename KTPhysicalArray< 2, XDataType >::value_type& KTPhysicalArray< 2, XDataType >::operator()(unsigned i, unsigned j) const
     {
@@ -725,7 +922,7 @@ namespace Katydid
             throw std::out_of_range(msg.str());
         }
 #endif
-        return fData(i,j);
+        return fData[i * fStride + j];
     }
 
     template< typename XDataType >
@@ -747,7 +944,61 @@ namespace Katydid
             throw std::out_of_range(msg.str());
         }
 #endif
-        return fData(i,j);
+        return fData[i * fStride + j];
+    }
+
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 2, XDataType >::const_row_view KTPhysicalArray< 2, XDataType >::GetRow(unsigned i) const
+    {
+        return GetBlock(i, 1, 0, size(2)).GetRow(0);
+    }
+
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 2, XDataType >::row_view KTPhysicalArray< 2, XDataType >::GetRow(unsigned i)
+    {
+        return GetBlock(i, 1, 0, size(2)).GetRow(0);
+    }
+
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 2, XDataType >::const_block_view KTPhysicalArray< 2, XDataType >::GetBlock(unsigned firstI, unsigned nI, unsigned firstJ, unsigned nJ) const
+    {
+#ifdef Katydid_DEBUG
+        if (firstI + nI > size(1) || firstJ + nJ > size(2))
+        {
+            std::stringstream msg;
+            msg << "Block out of bounds: [" << firstI << ", " << firstI + nI << ") x [" << firstJ << ", " << firstJ + nJ << ") in a " << size(1) << " x " << size(2) << " array";
+            KTERROR(utillog_physarr, msg.str());
+            throw std::out_of_range(msg.str());
+        }
+#endif
+        return const_block_view(fData + firstI * fStride + firstJ, nI, nJ, fStride);
+    }
+
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 2, XDataType >::block_view KTPhysicalArray< 2, XDataType >::GetBlock(unsigned firstI, unsigned nI, unsigned firstJ, unsigned nJ)
+    {
+#ifdef Katydid_DEBUG
+        if (firstI + nI > size(1) || firstJ + nJ > size(2))
+        {
+            std::stringstream msg;
+            msg << "Block out of bounds: [" << firstI << ", " << firstI + nI << ") x [" << firstJ << ", " << firstJ + nJ << ") in a " << size(1) << " x " << size(2) << " array";
+            KTERROR(utillog_physarr, msg.str());
+            throw std::out_of_range(msg.str());
+        }
+#endif
+        return block_view(fData + firstI * fStride + firstJ, nI, nJ, fStride);
+    }
+
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 2, XDataType >::const_block_view KTPhysicalArray< 2, XDataType >::GetColumnBlock(unsigned firstJ, unsigned nJ) const
+    {
+        return GetBlock(0, size(1), firstJ, nJ);
+    }
+
+    template< typename XDataType >
+    inline typename KTPhysicalArray< 2, XDataType >::block_view KTPhysicalArray< 2, XDataType >::GetColumnBlock(unsigned firstJ, unsigned nJ)
+    {
+        return GetBlock(0, size(1), firstJ, nJ);
     }
 
     template< typename XDataType >
@@ -762,27 +1013,55 @@ namespace Katydid
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator=(const KTPhysicalArray< 2, value_type>& rhs)
     {
-        fData = rhs.fData;
+        if (this == &rhs) return *this;
+        if (GetNTotalBins() != rhs.GetNTotalBins())
+        {
+            KTBufferPool::ReleaseArray(fData, GetNTotalBins());
+            fData = rhs.GetNTotalBins() == 0 ? NULL : KTBufferPool::AllocateArray< XDataType >(rhs.GetNTotalBins());
+        }
+        std::copy(rhs.begin(), rhs.end(), fData);
+        fStride = rhs.fStride;
         fLabel = rhs.fLabel;
-        KTAxisProperties< 2 >::operator=(rhs);
-        size_t (matrix_type::*sizeArray[2])() const = {&matrix_type::size1, &matrix_type::size2};
-        SetNBinsFunc(new KTNBinsInArray< 2, matrix_type >((matrix_type*)this, sizeArray));
+        size_t nBins[2] = {rhs.size(1), rhs.size(2)};
+        SetNBinsFunc(new XNBinsFunctor(nBins));
         SetRangeMin(1, rhs.GetRangeMin(1));
         SetRangeMin(2, rhs.GetRangeMin(2));
         SetRangeMax(1, rhs.GetRangeMax(1));
         SetRangeMax(2, rhs.GetRangeMax(2));
+        SetAxisLabel(1, rhs.GetAxisLabel(1));
+        SetAxisLabel(2, rhs.GetAxisLabel(2));
+        return *this;
+    }
+
+    template< typename XDataType >
+    inline KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator=(KTPhysicalArray< 2, value_type>&& rhs)
+    {
+        swap(rhs);
         return *this;
     }
 
+    template< typename XDataType >
+    inline void KTPhysicalArray< 2, XDataType >::swap(KTPhysicalArray< 2, XDataType >& other)
+    {
+        std::swap(fData, other.fData);
+        std::swap(fStride, other.fStride);
+        fLabel.swap(other.fLabel);
+        SwapAxes(other);
+        return;
+    }
+
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator+=(const KTPhysicalArray< 2, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nRows = size(1), nColumns = size(2);
+        for (size_t iRow=0; iRow<nRows; ++iRow)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
+            XDataType* row = fData + iRow * fStride;
+            const XDataType* rhsRow = rhs.fData + iRow * rhs.fStride;
+            for (size_t iBin=0; iBin<nColumns; ++iBin)
             {
-                fData(iBinX, iBinY) += rhs(iBinX, iBinY);
+                row[iBin] += rhsRow[iBin];
             }
         }
         return *this;
@@ -792,11 +1071,14 @@ namespace Katydid
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator-=(const KTPhysicalArray< 2, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nRows = size(1), nColumns = size(2);
+        for (size_t iRow=0; iRow<nRows; ++iRow)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
+            XDataType* row = fData + iRow * fStride;
+            const XDataType* rhsRow = rhs.fData + iRow * rhs.fStride;
+            for (size_t iBin=0; iBin<nColumns; ++iBin)
             {
-                fData(iBinX, iBinY) -= rhs(iBinX, iBinY);
+                row[iBin] -= rhsRow[iBin];
             }
         }
         return *this;
@@ -806,11 +1088,14 @@ namespace Katydid
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator*=(const KTPhysicalArray< 2, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nRows = size(1), nColumns = size(2);
+        for (size_t iRow=0; iRow<nRows; ++iRow)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
+            XDataType* row = fData + iRow * fStride;
+            const XDataType* rhsRow = rhs.fData + iRow * rhs.fStride;
+            for (size_t iBin=0; iBin<nColumns; ++iBin)
             {
-                fData(iBinX, iBinY) *= rhs(iBinX, iBinY);
+                row[iBin] *= rhsRow[iBin];
             }
         }
         return *this;
@@ -820,25 +1105,33 @@ namespace Katydid
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator/=(const KTPhysicalArray< 2, value_type>& rhs)
     {
         if (! this->IsCompatibleWith(rhs)) return *this;
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nRows = size(1), nColumns = size(2);
+        for (size_t iRow=0; iRow<nRows; ++iRow)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
+            XDataType* row = fData + iRow * fStride;
+            const XDataType* rhsRow = rhs.fData + iRow * rhs.fStride;
+            for (size_t iBin=0; iBin<nColumns; ++iBin)
             {
-                fData(iBinX, iBinY) /= rhs(iBinX, iBinY);
+                row[iBin] /= rhsRow[iBin];
             }
         }
         return *this;
     }
 
+    template< typename XDataType >
+    KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator=(const value_type& rhs)
+    {
+        std::fill(begin(), end(), rhs);
+        return *this;
+    }
+
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator+=(const value_type& rhs)
     {
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nBins = GetNTotalBins();
+        for (size_t iBin=0; iBin<nBins; ++iBin)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
-            {
-                fData(iBinX, iBinY) += rhs;
-            }
+            fData[iBin] += rhs;
         }
         return *this;
     }
@@ -846,12 +1139,10 @@ namespace Katydid
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator-=(const value_type& rhs)
     {
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nBins = GetNTotalBins();
+        for (size_t iBin=0; iBin<nBins; ++iBin)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
-            {
-                fData(iBinX, iBinY) -= rhs;
-            }
+            fData[iBin] -= rhs;
         }
         return *this;
     }
@@ -859,12 +1150,10 @@ namespace Katydid
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator*=(const value_type& rhs)
     {
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nBins = GetNTotalBins();
+        for (size_t iBin=0; iBin<nBins; ++iBin)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
-            {
-                fData(iBinX, iBinY) *= rhs;
-            }
+            fData[iBin] *= rhs;
         }
         return *this;
     }
@@ -872,246 +1161,123 @@ namespace Katydid
     template< typename XDataType >
     KTPhysicalArray< 2, XDataType >& KTPhysicalArray< 2, XDataType >::operator/=(const value_type& rhs)
     {
-        for (size_t iBinX=0; iBinX<fData.size1(); ++iBinX)
+        size_t nBins = GetNTotalBins();
+        for (size_t iBin=0; iBin<nBins; ++iBin)
         {
-            for (size_t iBinY=0; iBinY<fData.size2(); ++iBinY)
-            {
-                fData(iBinX, iBinY) /= rhs;
-            }
+            fData[iBin] /= rhs;
         }
         return *this;
     }
 
     template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_iterator1 KTPhysicalArray< 2, XDataType >::begin1() const
-    {
-        return fData.begin1();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_iterator2 KTPhysicalArray< 2, XDataType >::begin2() const
-    {
-        return fData.begin2();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_iterator1 KTPhysicalArray< 2, XDataType >::end1() const
-    {
-        return fData.end1();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_iterator2 KTPhysicalArray< 2, XDataType >::end2() const
-    {
-        return fData.end2();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::iterator1 KTPhysicalArray< 2, XDataType >::begin1()
+    inline typename KTPhysicalArray< 2, XDataType >::const_iterator KTPhysicalArray< 2, XDataType >::begin() const
     {
-        return fData.begin1();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::iterator2 KTPhysicalArray< 2, XDataType >::begin2()
-    {
-        return fData.begin2();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::iterator1 KTPhysicalArray< 2, XDataType >::end1()
-    {
-        return fData.end1();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::iterator2 KTPhysicalArray< 2, XDataType >::end2()
-    {
-        return fData.end2();
-    }
-
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_reverse_iterator1 KTPhysicalArray< 2, XDataType >::rbegin1() const
-    {
-        return fData.rbegin1();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_reverse_iterator2 KTPhysicalArray< 2, XDataType >::rbegin2() const
-    {
-        return fData.rbegin2();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_reverse_iterator1 KTPhysicalArray< 2, XDataType >::rend1() const
-    {
-        return fData.rend1();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::const_reverse_iterator2 KTPhysicalArray< 2, XDataType >::rend2() const
-    {
-        return fData.rend2();
-    }
-
-    template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::reverse_iterator1 KTPhysicalArray< 2, XDataType >::rbegin1()
-    {
-        return fData.rbegin1();
+        return fData;
     }
 
     template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::reverse_iterator2 KTPhysicalArray< 2, XDataType >::rbegin2()
+    inline typename KTPhysicalArray< 2, XDataType >::const_iterator KTPhysicalArray< 2, XDataType >::end() const
     {
-        return fData.rbegin2();
+        return fData + GetNTotalBins();
     }
 
     template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::reverse_iterator1 KTPhysicalArray< 2, XDataType >::rend1()
+    inline typename KTPhysicalArray< 2, XDataType >::iterator KTPhysicalArray< 2, XDataType >::begin()
     {
-        return fData.rend1();
+        return fData;
     }
 
     template< typename XDataType >
-    inline typename KTPhysicalArray< 2, XDataType >::reverse_iterator2 KTPhysicalArray< 2, XDataType >::rend2()
+    inline typename KTPhysicalArray< 2, XDataType >::iterator KTPhysicalArray< 2, XDataType >::end()
     {
-        return fData.rend2();
+        return fData + GetNTotalBins();
     }
 
     template< typename XDataType >
     XDataType KTPhysicalArray< 2, XDataType >::GetMaximumBin(unsigned& maxXBin, unsigned& maxYBin) const
     {
-        typename KTPhysicalArray< 2, XDataType >::const_iterator1 xBinIt = fData.begin1();
-        typename KTPhysicalArray< 2, XDataType >::const_iterator2 yBinIt = std::max_element(xBinIt.begin(), xBinIt.end());
-        maxXBin = 0;
-        maxYBin = yBinIt.index2();
-        double maxYValue = *yBinIt;
-        double value;
-        for (; xBinIt != fData.end1(); ++xBinIt)
+        if (fData == NULL)
         {
-            yBinIt = std::max_element(xBinIt.begin(), xBinIt.end());
-            value = *yBinIt;
-            if (value > maxYValue)
-            {
-                maxXBin = xBinIt.index1();
-                maxYBin = yBinIt.index2();
-                maxYValue = value;
-            }
+            maxXBin = 0;
+            maxYBin = 0;
+            return XDataType();
         }
-        return maxYValue;
+        const_iterator maxIt = fData;
+        for (size_t iRow=0; iRow<size(1); ++iRow)
+        {
+            const_iterator rowMaxIt = std::max_element(fData + iRow * fStride, fData + iRow * fStride + size(2));
+            if (*maxIt < *rowMaxIt) maxIt = rowMaxIt;
+        }
+        maxXBin = (maxIt - fData) / fStride;
+        maxYBin = (maxIt - fData) % fStride;
+        return *maxIt;
     }
 
     template< typename XDataType >
     XDataType KTPhysicalArray< 2, XDataType >::GetMinimumBin(unsigned& minXBin, unsigned& minYBin) const
     {
-        typename KTPhysicalArray< 2, XDataType >::const_iterator1 xBinIt = fData.begin1();
-        typename KTPhysicalArray< 2, XDataType >::const_iterator2 yBinIt = std::min_element(xBinIt.begin(), xBinIt.end());
-        minXBin = 0;
-        minYBin = yBinIt.index2();
-        double minYValue = *yBinIt;
-        double value;
-        for (; xBinIt != fData.end1(); ++xBinIt)
+        if (fData == NULL)
         {
-            yBinIt = std::min_element(xBinIt.begin(), xBinIt.end());
-            value = *yBinIt;
-            if (value < minYValue)
-            {
-                minXBin = xBinIt.index1();
-                minYBin = yBinIt.index2();
-                minYValue = value;
-            }
+            minXBin = 0;
+            minYBin = 0;
+            return XDataType();
+        }
+        const_iterator minIt = fData;
+        for (size_t iRow=0; iRow<size(1); ++iRow)
+        {
+            const_iterator rowMinIt = std::min_element(fData + iRow * fStride, fData + iRow * fStride + size(2));
+            if (*rowMinIt < *minIt) minIt = rowMinIt;
         }
-        return minYValue;
+        minXBin = (minIt - fData) / fStride;
+        minYBin = (minIt - fData) % fStride;
+        return *minIt;
     }
 
     template< typename XDataType >
     std::pair< XDataType, XDataType > KTPhysicalArray< 2, XDataType >::GetMinMaxBin(unsigned& minXBin, unsigned& minYBin, unsigned& maxXBin, unsigned& maxYBin)
     {
-        typename KTPhysicalArray< 2, XDataType >::const_iterator1 xBinIt = fData.begin1();
-        std::pair< typename KTPhysicalArray< 2, XDataType >::const_iterator2, typename KTPhysicalArray< 2, XDataType >::const_iterator2 > yBinIts = std::minmax_element(xBinIt.begin(), xBinIt.end());
-        minXBin = 0;
-        minYBin = yBinIts.first.index2();
-        maxXBin = 0;
-        maxYBin = yBinIts.second.index2();
-        double minYValue = *yBinIts.first;
-        double maxYValue = *yBinIts.second;
-        double value;
-        for (; xBinIt != fData.end1(); ++xBinIt)
+        if (fData == NULL)
         {
-            yBinIts = std::minmax_element(xBinIt.begin(), xBinIt.end());
-            value = *yBinIts.first;
-            if (value < minYValue)
-            {
-                minXBin = xBinIt.index1();
-                minYBin = yBinIts.first.index2();
-                minYValue = value;
-            }
-            value = *yBinIts.second;
-            if (value > maxYValue)
-            {
-                maxXBin = xBinIt.index1();
-                maxYBin = yBinIts.second.index2();
-                maxYValue = value;
-            }
+            minXBin = 0;
+            minYBin = 0;
+            maxXBin = 0;
+            maxYBin = 0;
+            return std::make_pair(XDataType(), XDataType());
         }
-        return std::make_pair(minYValue, maxYValue);
+        std::pair< const_iterator, const_iterator > minMaxIts(fData, fData);
+        for (size_t iRow=0; iRow<size(1); ++iRow)
+        {
+            std::pair< const_iterator, const_iterator > rowMinMaxIts = std::minmax_element(fData + iRow * fStride, fData + iRow * fStride + size(2));
+            if (*rowMinMaxIts.first < *minMaxIts.first) minMaxIts.first = rowMinMaxIts.first;
+            if (! (*rowMinMaxIts.second < *minMaxIts.second)) minMaxIts.second = rowMinMaxIts.second;
+        }
+        minXBin = (minMaxIts.first - fData) / fStride;
+        minYBin = (minMaxIts.first - fData) % fStride;
+        maxXBin = (minMaxIts.second - fData) / fStride;
+        maxYBin = (minMaxIts.second - fData) % fStride;
+        return std::make_pair(*minMaxIts.first, *minMaxIts.second);
     }
 
 
-
     //*************************
     // Operator implementations
     //*************************
 
-    /// Add two 1-D KTPhysicalArrays; requires lhs.size() == rhs.size(); axis range set to that of lhs.
-    template< typename XDataType >
-    KTPhysicalArray< 1, XDataType > operator+(const KTPhysicalArray< 1, XDataType >& lhs, const KTPhysicalArray< 1, XDataType >& rhs)
-    {
-        if (! lhs.IsCompatibleWith(rhs)) return KTPhysicalArray< 1, XDataType >();
-
-        KTPhysicalArray< 1, XDataType > returnVal(lhs);
-        returnVal += rhs;
-        return returnVal;
-    }
-
-    /// Subtracts two 1-D KTPhysicalArrays; requires lhs.size() == rhs.size(); axis range set to that of lhs.
-    template< typename XDataType >
-    KTPhysicalArray< 1, XDataType > operator-(const KTPhysicalArray< 1, XDataType >& lhs, const KTPhysicalArray< 1, XDataType >& rhs)
-    {
-        if (! lhs.IsCompatibleWith(rhs)) return KTPhysicalArray< 1, XDataType >();
-
-        KTPhysicalArray< 1, XDataType > returnVal(lhs);
-        returnVal -= rhs;
-        return returnVal;
-    }
+    // Element-wise arithmetic on 1-D KTPhysicalArrays (+, -, *, /, unary -, and KTArraySqrt()) is provided by KTArrayExpression.hh.
+    // The results are expressions, which are calculated when assigned to an array; arrays of different sizes give an empty result.
 
-    /// Multiplies two 1-D KTPhysicalArrays; requires lhs.size() == rhs.size(); axis range set to that of lhs.
     template< typename XDataType >
-    KTPhysicalArray< 1, XDataType > operator*(const KTPhysicalArray< 1, XDataType >& lhs, const KTPhysicalArray< 1, XDataType >& rhs)
-    {
-        if (! lhs.IsCompatibleWith(rhs)) return KTPhysicalArray< 1, XDataType >();
-
-        KTPhysicalArray< 1, XDataType > returnVal(lhs);
-        returnVal *= rhs;
-        return returnVal;
-    }
-
-    /// Divides two 1-D KTPhysicalArrays; requires lhs.size() == rhs.size(); axis range set to that of lhs.
-    template< typename XDataType >
-    KTPhysicalArray< 1, XDataType > operator/(const KTPhysicalArray< 1, XDataType >& lhs, const KTPhysicalArray< 1, XDataType >& rhs)
+    std::ostream& operator<< (std::ostream& ostr, const KTPhysicalArray< 1, XDataType >& rhs)
     {
-        if (! lhs.IsCompatibleWith(rhs)) return KTPhysicalArray< 1, XDataType >();
-
-        KTPhysicalArray< 1, XDataType > returnVal(lhs);
-        returnVal /= rhs;
-        return returnVal;
+        ostr << rhs.GetData();
+        return ostr;
     }
 
-    template< typename XDataType >
-    std::ostream& operator<< (std::ostream& ostr, const KTPhysicalArray< 1, XDataType >& rhs)
+    /// Prints the result of an element-wise expression, as the result of a + b was printed before expressions were added
+    template< typename XExpression >
+    std::ostream& operator<< (std::ostream& ostr, const KTArrayExpression< XExpression >& rhs)
     {
-        ostr << rhs.GetData();
+        ostr << KTPhysicalArray< 1, typename XExpression::value_type >(rhs);
         return ostr;
     }
 
@@ -1162,7 +1328,17 @@ namespace Katydid
     template< typename XDataType >
     std::ostream& operator<< (std::ostream& ostr, const KTPhysicalArray< 2, XDataType >& rhs)
     {
-        ostr << rhs.GetData();
+        ostr << "[" << rhs.size(1) << "," << rhs.size(2) << "](";
+        for (size_t iBinX=0; iBinX<rhs.size(1); ++iBinX)
+        {
+            ostr << (iBinX == 0 ? "(" : ",(");
+            for (size_t iBinY=0; iBinY<rhs.size(2); ++iBinY)
+            {
+                ostr << (iBinY == 0 ? "" : ",") << rhs(iBinX, iBinY);
+            }
+            ostr << ")";
+        }
+        ostr << ")";
         return ostr;
     }
 
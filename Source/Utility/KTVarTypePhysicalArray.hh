@@ -14,6 +14,7 @@
 #include "KTException.hh"
 
 #include <cstring> // for memcpy
+#include <utility>
 
 namespace Katydid
 {
@@ -154,6 +155,11 @@ namespace Katydid
                        It is the template argument for the class.
                        If you want to change the interface type, you need to create a new interface object with the interface-only constructor (copyData = false).
 
+     Storage borrowed with the borrowed-data constructor is read-only (it may be, e.g., a read-only memory map of a file).
+     GetStorage() only gives read access; the first write (SetAt() or GetWritableStorage()) replaces borrowed storage with an owned copy.
+     An interface object shares the storage of the array it was made from, and a write through it is made in that array's storage
+     (copied first if it is read-only), so the original array sees the write.
+     An interface object made before the original array's own first write keeps reading the borrowed storage.
     */
     template< typename XInterfaceType >
     class KTVarTypePhysicalArray : public KTAxisProperties< 1 >
@@ -183,25 +189,57 @@ namespace Katydid
             /// Axis range values do not have default values to avoid ambiguous function signatures
             KTVarTypePhysicalArray(size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax);
 
+            /// Borrowed-data constructor w/ data type & format specified
+            /// The array uses the given storage without copying it, and never deletes or writes to it; the storage must outlive the array
+            KTVarTypePhysicalArray(const storage_value_type* data, size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax);
+
             /// Interface-only (copyData = false) or copy (copyData = true; default) constructor
             template< typename XOrigInterfaceType >
             KTVarTypePhysicalArray(const KTVarTypePhysicalArray< XOrigInterfaceType >& orig, bool copyData = true);
 
+            /// Copy constructor; the data is always copied
+            KTVarTypePhysicalArray(const KTVarTypePhysicalArray< XInterfaceType >& orig);
+
+            /// Move constructor; takes over the storage of orig (owned or borrowed) without copying it
+            KTVarTypePhysicalArray(KTVarTypePhysicalArray< XInterfaceType >&& orig);
+
             virtual ~KTVarTypePhysicalArray();
 
             template< typename XOrigInterfaceType >
             KTVarTypePhysicalArray& operator=(const KTVarTypePhysicalArray< XOrigInterfaceType >& rhs);
 
+            KTVarTypePhysicalArray& operator=(const KTVarTypePhysicalArray< XInterfaceType >& rhs);
+
+            /// Exchanges contents with rhs, so the old storage is released along with rhs
+            KTVarTypePhysicalArray& operator=(KTVarTypePhysicalArray< XInterfaceType >&& rhs);
+
+            /// Exchanges the storage, data format, and axis of the two arrays without copying
+            void swap(KTVarTypePhysicalArray< XInterfaceType >& other);
+
         public:
-            const storage_type& GetStorage() const;
-            storage_type& GetStorage();
+            const storage_value_type* GetStorage() const;
+            /// Copies the storage first if it is read-only
+            storage_type GetWritableStorage();
 
             size_t GetNBytes() const;
             size_t GetDataTypeSize() const;
             uint32_t GetDataFormat() const;
 
+            bool GetOwnsStorage() const;
+            bool GetReadOnlyStorage() const;
+
         protected:
+            /// Replaces read-only storage with writable storage: an owned copy, or, for an interface object, the storage of the original array
+            void MakeStorageWritable();
+
+            template< typename XSourceInterfaceType >
+            static storage_type GetWritableSourceStorage(void* source);
+
             bool fOwnsStorage;
+            bool fReadOnlyStorage;
+            // the array an interface object of read-only storage was made from, and the function that makes its storage writable
+            void* fStorageSource;
+            storage_type (*fWritableSourceStorageFcn)(void*);
 
             // storage_type is always uint8_t
             union
@@ -263,6 +301,9 @@ namespace Katydid
     KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray() :
             KTAxisProperties< 1 >(),
             fOwnsStorage(true),
+            fReadOnlyStorage(false),
+            fStorageSource(NULL),
+            fWritableSourceStorageFcn(NULL),
             fUByteData(new uint8_t [1]),
             fNBytes(0),
             fDataTypeSize(0),
@@ -279,6 +320,9 @@ namespace Katydid
     KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray(size_t nBins, double rangeMin, double rangeMax) :
             KTAxisProperties< 1 >(rangeMin, rangeMax),
             fOwnsStorage(true),
+            fReadOnlyStorage(false),
+            fStorageSource(NULL),
+            fWritableSourceStorageFcn(NULL),
             fUByteData(reinterpret_cast< uint8_t* >(new XDataType[ nBins ])),
             fNBytes(nBins * sizeof(XDataType)),
             fDataTypeSize(0),
@@ -310,6 +354,9 @@ namespace Katydid
     KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray(size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax) :
             KTAxisProperties< 1 >(rangeMin, rangeMax),
             fOwnsStorage(true),
+            fReadOnlyStorage(false),
+            fStorageSource(NULL),
+            fWritableSourceStorageFcn(NULL),
             fUByteData(new uint8_t[ nBins * dataTypeSize ]),
             fNBytes(nBins * dataTypeSize),
             fDataTypeSize(dataTypeSize),
@@ -326,11 +373,37 @@ namespace Katydid
     }
 
 
+    template< typename XInterfaceType >
+    KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray(const storage_value_type* data, size_t dataTypeSize, uint32_t dataFormat, size_t nBins, double rangeMin, double rangeMax) :
+            KTAxisProperties< 1 >(rangeMin, rangeMax),
+            fOwnsStorage(false),
+            fReadOnlyStorage(true),
+            fStorageSource(NULL),
+            fWritableSourceStorageFcn(NULL),
+            fUByteData(const_cast< storage_type >(data)),
+            fNBytes(nBins * dataTypeSize),
+            fDataTypeSize(dataTypeSize),
+            fDataFormat(dataFormat),
+            fArrayGetFcn(NULL),
+            fArraySetFcn(NULL)
+    {
+        try
+        {
+            SetInterfaceFunctions( dataTypeSize, dataFormat );
+        }
+        catch( Nymph::KTException& e ) {throw e;}
+        SetNBinsFunc(new KTNBinsInArray< 1, FixedSize >(nBins));
+    }
+
+
     template< typename XInterfaceType >
     template< typename XOrigInterfaceType >
     KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray(const KTVarTypePhysicalArray< XOrigInterfaceType >& orig, bool copyData) :
             KTAxisProperties< 1 >(orig),
             fOwnsStorage(copyData),
+            fReadOnlyStorage(! copyData && orig.GetReadOnlyStorage()),
+            fStorageSource(fReadOnlyStorage ? const_cast< KTVarTypePhysicalArray< XOrigInterfaceType >* >(&orig) : NULL),
+            fWritableSourceStorageFcn(fReadOnlyStorage ? &KTVarTypePhysicalArray< XInterfaceType >::template GetWritableSourceStorage< XOrigInterfaceType > : NULL),
             fUByteData(NULL),
             fNBytes(orig.GetNBytes()),
             fDataTypeSize(orig.GetDataTypeSize()),
@@ -347,11 +420,27 @@ namespace Katydid
         }
         else
         {
-            fUByteData = orig.GetStorage();
+            // writes through the interface go to the original's storage
+            fUByteData = const_cast< storage_type >(orig.GetStorage());
         }
     }
 
 
+    template< typename XInterfaceType >
+    KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray(const KTVarTypePhysicalArray< XInterfaceType >& orig) :
+            KTVarTypePhysicalArray< XInterfaceType >(orig, true)
+    {
+    }
+
+
+    template< typename XInterfaceType >
+    KTVarTypePhysicalArray< XInterfaceType >::KTVarTypePhysicalArray(KTVarTypePhysicalArray< XInterfaceType >&& orig) :
+            KTVarTypePhysicalArray< XInterfaceType >()
+    {
+        swap(orig);
+    }
+
+
     template< typename XInterfaceType >
     KTVarTypePhysicalArray< XInterfaceType >::~KTVarTypePhysicalArray()
     {
@@ -372,15 +461,56 @@ namespace Katydid
         fDataFormat = rhs.GetDataFormat();
         SetInterfaceFunctions( fDataTypeSize, fDataFormat );
 
+        // the old storage is released only after the copy, in case rhs is an interface to it
+        storage_type oldData = fOwnsStorage ? fUByteData : NULL;
+
         fOwnsStorage = true;
+        fReadOnlyStorage = false;
+        fStorageSource = NULL;
+        fWritableSourceStorageFcn = NULL;
         fNBytes = rhs.GetNBytes();
         fUByteData = new uint8_t[ fNBytes ];
         memcpy( fUByteData, rhs.GetStorage(), fNBytes );
 
+        delete [] oldData;
+
         return *this;
     }
 
 
+    template< typename XInterfaceType >
+    KTVarTypePhysicalArray< XInterfaceType >& KTVarTypePhysicalArray< XInterfaceType >::operator=(const KTVarTypePhysicalArray< XInterfaceType >& rhs)
+    {
+        return this->template operator=< XInterfaceType >(rhs);
+    }
+
+
+    template< typename XInterfaceType >
+    KTVarTypePhysicalArray< XInterfaceType >& KTVarTypePhysicalArray< XInterfaceType >::operator=(KTVarTypePhysicalArray< XInterfaceType >&& rhs)
+    {
+        swap(rhs);
+        return *this;
+    }
+
+
+    template< typename XInterfaceType >
+    void KTVarTypePhysicalArray< XInterfaceType >::swap(KTVarTypePhysicalArray< XInterfaceType >& other)
+    {
+        std::swap(fOwnsStorage, other.fOwnsStorage);
+        std::swap(fReadOnlyStorage, other.fReadOnlyStorage);
+        std::swap(fStorageSource, other.fStorageSource);
+        std::swap(fWritableSourceStorageFcn, other.fWritableSourceStorageFcn);
+        std::swap(fUByteData, other.fUByteData);
+        std::swap(fNBytes, other.fNBytes);
+        std::swap(fDataTypeSize, other.fDataTypeSize);
+        std::swap(fDataFormat, other.fDataFormat);
+        std::swap(fArrayGetFcn, other.fArrayGetFcn);
+        std::swap(fArraySetFcn, other.fArraySetFcn);
+        SwapAxes(other);
+        return;
+    }
+
+
     template< typename XInterfaceType >
     void KTVarTypePhysicalArray< XInterfaceType >::SetInterfaceFunctions( unsigned aDataTypeSize, uint32_t aDataFormat )
     {
@@ -464,18 +594,47 @@ namespace Katydid
 
 
     template< typename XInterfaceType >
-    inline const typename KTVarTypePhysicalArray< XInterfaceType >::storage_type& KTVarTypePhysicalArray< XInterfaceType >::GetStorage() const
+    inline const typename KTVarTypePhysicalArray< XInterfaceType >::storage_value_type* KTVarTypePhysicalArray< XInterfaceType >::GetStorage() const
     {
         return fUByteData;
     }
 
 
     template< typename XInterfaceType >
-    inline typename KTVarTypePhysicalArray< XInterfaceType >::storage_type& KTVarTypePhysicalArray< XInterfaceType >::GetStorage()
+    inline typename KTVarTypePhysicalArray< XInterfaceType >::storage_type KTVarTypePhysicalArray< XInterfaceType >::GetWritableStorage()
     {
+        if (fReadOnlyStorage) MakeStorageWritable();
         return fUByteData;
     }
 
+    template< typename XInterfaceType >
+    void KTVarTypePhysicalArray< XInterfaceType >::MakeStorageWritable()
+    {
+        if (fStorageSource != NULL)
+        {
+            // pass the write on to the original array, and share its writable storage
+            fUByteData = (*fWritableSourceStorageFcn)(fStorageSource);
+            fStorageSource = NULL;
+            fWritableSourceStorageFcn = NULL;
+        }
+        else
+        {
+            storage_type data = new uint8_t[ fNBytes ];
+            memcpy( data, fUByteData, fNBytes );
+            fUByteData = data;
+            fOwnsStorage = true;
+        }
+        fReadOnlyStorage = false;
+        return;
+    }
+
+    template< typename XInterfaceType >
+    template< typename XSourceInterfaceType >
+    typename KTVarTypePhysicalArray< XInterfaceType >::storage_type KTVarTypePhysicalArray< XInterfaceType >::GetWritableSourceStorage(void* source)
+    {
+        return static_cast< KTVarTypePhysicalArray< XSourceInterfaceType >* >(source)->GetWritableStorage();
+    }
+
 
     template< typename XInterfaceType >
     inline size_t KTVarTypePhysicalArray< XInterfaceType >::GetNBytes() const
@@ -483,6 +642,18 @@ namespace Katydid
         return fNBytes;
     }
 
+    template< typename XInterfaceType >
+    inline bool KTVarTypePhysicalArray< XInterfaceType >::GetOwnsStorage() const
+    {
+        return fOwnsStorage;
+    }
+
+    template< typename XInterfaceType >
+    inline bool KTVarTypePhysicalArray< XInterfaceType >::GetReadOnlyStorage() const
+    {
+        return fReadOnlyStorage;
+    }
+
     template< typename XInterfaceType >
     inline size_t KTVarTypePhysicalArray< XInterfaceType >::GetDataTypeSize() const
     {
@@ -505,6 +676,7 @@ namespace Katydid
     template< typename XInterfaceType >
     inline void KTVarTypePhysicalArray< XInterfaceType >::SetAt(XInterfaceType value, unsigned i)
     {
+        if (fReadOnlyStorage) MakeStorageWritable();
         (this->*fArraySetFcn)( value, i );
         return;
     }